@@ -9,6 +9,8 @@ layout(binding = 0, std430) buffer OutputIndices
 };
 layout(binding = 0, r32ui) uniform uimage3D InputIndices;	// index per cell in 3d texture
 uniform sampler3D InputVolume;
+uniform int EmitOffset = 2;				// first cell that outputs quads
+uniform vec4 EmitCount = vec4(1024);	// cells per axis that output quads (xyz)
 
 void OutputQuad(uint v0,uint v1,uint v2,uint v3)
 {
@@ -26,13 +28,12 @@ void OutputQuad(uint v0,uint v1,uint v2,uint v3)
 void main() 
 {
 	// get index in global work group i.e x,y position
-	const uint skipLayers = 2;
-	ivec3 p = ivec3(gl_GlobalInvocationID.xyz) + ivec3(skipLayers);
+	ivec3 p = ivec3(gl_GlobalInvocationID.xyz) + ivec3(EmitOffset);
 	
-	// we need to skip 2 outer 'layers' of the samples to ensure no sampling artifacts due to filtering
-	
-	ivec3 maxSample = ivec3(m_dimensions[0]-skipLayers,m_dimensions[1]-skipLayers,m_dimensions[2]-skipLayers);
-	if(p.x < skipLayers || p.y < skipLayers || p.z < skipLayers)
+	// we skip the outer 'layers' of the samples to ensure no sampling artifacts due to filtering
+	// and only output quads for edges inside the node, so neighbouring nodes of the same lod meet exactly
+	ivec3 maxCell = ivec3(EmitOffset) + ivec3(EmitCount.xyz);
+	if(p.x >= maxCell.x || p.y >= maxCell.y || p.z >= maxCell.z)
 	{
 		return;
 	}
@@ -0,0 +1,41 @@
+#include "ant_spatial_index.h"
+#include "core/profiler.h"
+
+void AntSpatialIndex::Clear()
+{
+	for (auto& it : m_layers)
+	{
+		it.second.Reset();
+	}
+}
+
+void AntSpatialIndex::Add(uint32_t layerKey, glm::vec3 position, EntityHandle e)
+{
+	auto found = m_layers.find(layerKey);
+	if (found == m_layers.end())
+	{
+		found = m_layers.emplace(layerKey, Layer(glm::vec2(m_cellSize))).first;
+	}
+	found->second.AddEntry(position, position, { position, e });
+}
+
+size_t AntSpatialIndex::GetEntryCount(uint32_t layerKey) const
+{
+	const Layer* l = FindLayer(layerKey);
+	return l ? l->GetEntryCount() : 0;
+}
+
+const AntSpatialIndex::Layer* AntSpatialIndex::FindLayer(uint32_t layerKey) const
+{
+	auto found = m_layers.find(layerKey);
+	return found != m_layers.end() ? &found->second : nullptr;
+}
+
+void AntSpatialIndex::Build()
+{
+	SDE_PROF_EVENT();
+	for (auto& it : m_layers)
+	{
+		it.second.Build();
+	}
+}
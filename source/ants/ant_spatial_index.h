@@ -0,0 +1,45 @@
+#pragma once
+#include "core/glm_headers.h"
+#include "entity/entity_handle.h"
+#include "engine/entity_grid.h"
+#include <robin_hood.h>
+#include <vector>
+
+// Per-frame spatial index of entity positions, used by ant behaviour nodes instead of iterating every entity
+// Entities are added to layers keyed by tag hash, each layer is a WorldGrid built once per frame
+// Closest/k-nearest queries walk cells in rings outwards from the query point and stop once nothing closer can exist
+// Filters are applied per candidate at query time, so state that changes mid-frame (picked up, etc) is respected
+class AntSpatialIndex
+{
+public:
+	struct Entry
+	{
+		glm::vec3 m_position;
+		EntityHandle m_entity;
+	};
+
+	AntSpatialIndex(float cellSize = 32.0f) : m_cellSize(cellSize) {}
+	void Clear();											// removes all entries, layer storage is kept
+	void Add(uint32_t layerKey, glm::vec3 position, EntityHandle e);
+	void Build();											// call after adding entries, before any queries
+
+	// filters are bool(const Entry&), return false to skip the entry
+	template<class FilterFn>
+	EntityHandle FindClosest(uint32_t layerKey, glm::vec3 position, FilterFn&& filter) const;
+	template<class FilterFn>
+	void FindKNearest(uint32_t layerKey, glm::vec3 position, uint32_t k, std::vector<Entry>& results, FilterFn&& filter) const;		// closest first
+	template<class FilterFn>
+	void FindInRadius(uint32_t layerKey, glm::vec3 position, float radius, std::vector<Entry>& results, FilterFn&& filter) const;
+
+	size_t GetLayerCount() const { return m_layers.size(); }
+	size_t GetEntryCount(uint32_t layerKey) const;
+
+private:
+	using Layer = WorldGrid<Entry>;
+	const Layer* FindLayer(uint32_t layerKey) const;
+
+	float m_cellSize = 32.0f;
+	robin_hood::unordered_map<uint32_t, Layer> m_layers;
+};
+
+#include "ant_spatial_index.inl"
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <cfloat>
+
+template<class FilterFn>
+EntityHandle AntSpatialIndex::FindClosest(uint32_t layerKey, glm::vec3 position, FilterFn&& filter) const
+{
+	EntityHandle closestFound;
+	const Layer* l = FindLayer(layerKey);
+	if (l == nullptr)
+	{
+		return closestFound;
+	}
+	float closestDistance = FLT_MAX;
+	l->ForEachByDistance(position, [&](const Entry& e) {
+		const float distance = glm::distance(e.m_position, position);
+		if (distance < closestDistance && filter(e))
+		{
+			closestFound = e.m_entity;
+			closestDistance = distance;
+		}
+	}, [&](float nextRingDistance) {
+		return closestDistance <= nextRingDistance;
+	});
+	return closestFound;
+}
+
+template<class FilterFn>
+void AntSpatialIndex::FindKNearest(uint32_t layerKey, glm::vec3 position, uint32_t k, std::vector<Entry>& results, FilterFn&& filter) const
+{
+	const Layer* l = FindLayer(layerKey);
+	if (l == nullptr || k == 0)
+	{
+		return;
+	}
+	// max-heap on distance holding the best k so far
+	std::vector<std::pair<float, Entry>> best;
+	best.reserve(k + 1);
+	auto furthestFirst = [](const std::pair<float, Entry>& a, const std::pair<float, Entry>& b) {
+		return a.first < b.first;
+	};
+	l->ForEachByDistance(position, [&](const Entry& e) {
+		const float distance = glm::distance(e.m_position, position);
+		if ((best.size() < k || distance < best.front().first) && filter(e))
+		{
+			best.push_back({ distance, e });
+			std::push_heap(best.begin(), best.end(), furthestFirst);
+			if (best.size() > k)
+			{
+				std::pop_heap(best.begin(), best.end(), furthestFirst);
+				best.pop_back();
+			}
+		}
+	}, [&](float nextRingDistance) {
+		return best.size() == k && best.front().first <= nextRingDistance;
+	});
+	std::sort_heap(best.begin(), best.end(), furthestFirst);
+	for (const auto& b : best)
+	{
+		results.push_back(b.second);
+	}
+}
+
+template<class FilterFn>
+void AntSpatialIndex::FindInRadius(uint32_t layerKey, glm::vec3 position, float radius, std::vector<Entry>& results, FilterFn&& filter) const
+{
+	const Layer* l = FindLayer(layerKey);
+	if (l == nullptr)
+	{
+		return;
+	}
+	l->ForEachNearby(position - radius, position + radius, [&](const Entry& e) {
+		if (glm::distance(e.m_position, position) <= radius && filter(e))
+		{
+			results.push_back(e);
+		}
+	});
+}
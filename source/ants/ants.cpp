@@ -1,6 +1,7 @@
 #include "ants.h"
 #include "core/file_io.h"
 #include "core/random.h"
+#include "core/string_hashing.h"
 #include "entity/entity_system.h"
 #include "entity/component.h"
 #include "entity/component_inspector.h"
@@ -17,6 +18,8 @@
 
 const float c_nestRadius = 64.0f;
 const float c_queenTowerRadius = 48.0f;
+const uint32_t c_foodLayerKey = Core::StringHashing::GetHash("@AntFood");		// spatial index layer for AntFoodComponent
+const uint32_t c_anyTagLayerKey = Core::StringHashing::GetHash("");			// every entity with Tags, other layers are keyed by tag hash
 
 class AntFoodComponent
 {
@@ -254,21 +257,11 @@ namespace Behaviours
 			Transform* targetAntCmp = entities->GetWorld()->GetComponent<Transform>(targetAnt);
 			if (targetAntCmp && bti.m_bb.IsKey(m_foundEntity))
 			{
-				static auto foodIt = entities->GetWorld()->MakeIterator<AntFoodComponent, Transform>();
+				static auto ants = Engine::GetSystem<AntsSystem>("Ants");
 				glm::vec3 antPos = targetAntCmp->GetPosition();
-				EntityHandle closestFound;
-				float closestDistance = FLT_MAX;
-				foodIt.ForEach([&](AntFoodComponent& afc, Transform& t, EntityHandle owner) {
-					float distance = glm::distance(t.GetPosition(), antPos);
-					if (distance < closestDistance)
-					{
-						auto pickupCmp = entities->GetWorld()->GetComponent<AntPickupComponent>(owner);
-						if (pickupCmp && !pickupCmp->m_heldBy.IsValid())
-						{
-							closestFound = owner;
-							closestDistance = distance;
-						}
-					}
+				EntityHandle closestFound = ants->GetSpatialIndex().FindClosest(c_foodLayerKey, antPos, [&](const AntSpatialIndex::Entry& e) {
+					auto pickupCmp = entities->GetWorld()->GetComponent<AntPickupComponent>(e.m_entity);
+					return pickupCmp && !pickupCmp->m_heldBy.IsValid();
 				});
 				bti.m_bb.SetEntity(m_foundEntity.c_str(), closestFound);
 				return closestFound.GetID() != -1 ? RunningState::Success : RunningState::Failed;
@@ -360,38 +353,25 @@ namespace Behaviours
 			if (targetAntCmp && bti.m_bb.IsKey(m_foundEntity))
 			{
 				glm::vec3 antPos = targetAntCmp->GetPosition();
-				static auto tagIt = entities->GetWorld()->MakeIterator<Tags, Transform>();
-				EntityHandle closestFound;
-				float closestDistance = FLT_MAX;
-				const Engine::Tag searchTag(m_searchTag.c_str());
-				tagIt.ForEach([&](Tags& tags, Transform& t, EntityHandle owner) {
-					bool filteredByTag = (m_searchTag.size() > 0 && !tags.ContainsTag(searchTag));
-					if (filteredByTag)
-					{
-						return;
-					}
-					float distance = glm::distance(t.GetPosition(), antPos);
-					if (distance >= closestDistance)
-					{
-						return;
-					}
+				static auto ants = Engine::GetSystem<AntsSystem>("Ants");
+				const uint32_t layerKey = m_searchTag.size() > 0 ? Engine::Tag(m_searchTag.c_str()).GetHash() : c_anyTagLayerKey;
+				EntityHandle closestFound = ants->GetSpatialIndex().FindClosest(layerKey, antPos, [&](const AntSpatialIndex::Entry& e) {
 					if (!m_allowCloseToNest && nestTransform)
 					{
-						if (glm::distance(nestTransform->GetPosition(), t.GetPosition()) < (c_nestRadius * 1.8f))
+						if (glm::distance(nestTransform->GetPosition(), e.m_position) < (c_nestRadius * 1.8f))
 						{
-							return;
+							return false;
 						}
 					}
 					if (!m_allowPickedUp)
 					{
-						auto pickupCmp = entities->GetWorld()->GetComponent<AntPickupComponent>(owner);
+						auto pickupCmp = entities->GetWorld()->GetComponent<AntPickupComponent>(e.m_entity);
 						if (pickupCmp && pickupCmp->m_heldBy.IsValid())		// already held
 						{
-							return;
+							return false;
 						}
 					}
-					closestFound = owner;
-					closestDistance = distance;
+					return true;
 				});
 				bti.m_bb.SetEntity(m_foundEntity.c_str(), closestFound);
 				return closestFound.GetID() != -1 ? RunningState::Success : RunningState::Failed;
@@ -984,6 +964,26 @@ bool AntsSystem::PostInit()
 	return true;
 }
 
+void AntsSystem::BuildSpatialIndex()
+{
+	SDE_PROF_EVENT();
+	auto entities = Engine::GetSystem<EntitySystem>("Entities");
+	static auto foodIt = entities->GetWorld()->MakeIterator<AntFoodComponent, Transform>();
+	static auto tagIt = entities->GetWorld()->MakeIterator<Tags, Transform>();
+	m_spatialIndex.Clear();
+	foodIt.ForEach([&](AntFoodComponent& afc, Transform& t, EntityHandle owner) {
+		m_spatialIndex.Add(c_foodLayerKey, t.GetPosition(), owner);
+	});
+	tagIt.ForEach([&](Tags& tags, Transform& t, EntityHandle owner) {
+		m_spatialIndex.Add(c_anyTagLayerKey, t.GetPosition(), owner);
+		for (const auto& tag : tags.AllTags())
+		{
+			m_spatialIndex.Add(tag.GetHash(), t.GetPosition(), owner);
+		}
+	});
+	m_spatialIndex.Build();
+}
+
 void AntsSystem::KillAnt(const EntityHandle& e)
 {
 	auto entities = Engine::GetSystem<EntitySystem>("Entities");
@@ -1005,6 +1005,7 @@ bool AntsSystem::Tick(float timeDelta)
 	auto behSys = Engine::GetSystem<Behaviours::BehaviourTreeSystem>("Behaviours");
 	auto nestEntity = entities->GetFirstEntityWithTag("Nest");
 	auto queenEntity = entities->GetFirstEntityWithTag("AntQueen");
+	BuildSpatialIndex();
 	entities->GetWorld()->ForEachComponent<AntComponent>([&](AntComponent& ac, EntityHandle e) {
 		if (ac.m_treeInstance == nullptr && ac.m_behaviourTree.size() > 0)
 		{
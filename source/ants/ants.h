@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/system.h"
+#include "ant_spatial_index.h"
 
 class AntsSystem : public Engine::System
 {
@@ -8,6 +9,9 @@ public:
 	bool PostInit();
 	bool Tick(float timeDelta);
 	void DropAllItems(const class EntityHandle& ant);
+	const AntSpatialIndex& GetSpatialIndex() const { return m_spatialIndex; }	// rebuilt each tick before any ants update
 private:
 	void KillAnt(const class EntityHandle& e);
+	void BuildSpatialIndex();
+	AntSpatialIndex m_spatialIndex;
 };
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "bench.h"
+#include "ants/ant_spatial_index.h"
+#include "core/random_stream.h"
+#include "core/timer.h"
+#include "core/log.h"
+#include <cfloat>
+#include <vector>
+
+// compares the index against brute force closest-food searches with random positions, no entities are created
+// LeanBench AntSpatialIndex [ant count] [food count]
+BENCHMARK(AntSpatialIndex)
+{
+	const int antCount = args.GetInt(0, 10000);
+	const int foodCount = args.GetInt(1, 10000);
+	const uint32_t c_foodLayerKey = 0;
+	const float c_worldSize = 4096.0f;
+	Core::RandomStream random(1234);
+	auto randomPosition = [&]() {
+		return glm::vec3(random.NextFloat(-c_worldSize, c_worldSize), 0.0f, random.NextFloat(-c_worldSize, c_worldSize));
+	};
+	std::vector<glm::vec3> ants(antCount);
+	std::vector<AntSpatialIndex::Entry> food(foodCount);
+	std::vector<uint8_t> foodHeld(foodCount);		// a few items are held to exercise the filter
+	for (auto& a : ants)
+	{
+		a = randomPosition();
+	}
+	for (int f = 0; f < foodCount; ++f)
+	{
+		food[f] = { randomPosition(), EntityHandle(f) };
+		foodHeld[f] = random.NextFloat() < 0.1f;
+	}
+	auto notHeld = [&](const AntSpatialIndex::Entry& e) {
+		return foodHeld[e.m_entity.GetID()] == 0;
+	};
+
+	double bruteForceTime = 0.0, buildTime = 0.0, closestTime = 0.0;
+	std::vector<EntityHandle> bruteForceResults(antCount), indexResults(antCount);
+	{
+		Core::ScopedTimer t(bruteForceTime);
+		for (int a = 0; a < antCount; ++a)
+		{
+			float closestDistance = FLT_MAX;
+			for (const auto& f : food)
+			{
+				float distance = glm::distance(f.m_position, ants[a]);
+				if (distance < closestDistance && notHeld(f))
+				{
+					bruteForceResults[a] = f.m_entity;
+					closestDistance = distance;
+				}
+			}
+		}
+	}
+	AntSpatialIndex index;
+	{
+		Core::ScopedTimer t(buildTime);
+		for (const auto& f : food)
+		{
+			index.Add(c_foodLayerKey, f.m_position, f.m_entity);
+		}
+		index.Build();
+	}
+	{
+		Core::ScopedTimer t(closestTime);
+		for (int a = 0; a < antCount; ++a)
+		{
+			indexResults[a] = index.FindClosest(c_foodLayerKey, ants[a], notHeld);
+		}
+	}
+
+	// ties may pick different entities, so compare distances
+	int mismatches = 0;
+	for (int a = 0; a < antCount; ++a)
+	{
+		const bool bothFound = bruteForceResults[a].IsValid() && indexResults[a].IsValid();
+		if (bruteForceResults[a].IsValid() != indexResults[a].IsValid() ||
+			(bothFound && glm::distance(food[bruteForceResults[a].GetID()].m_position, ants[a]) != glm::distance(food[indexResults[a].GetID()].m_position, ants[a])))
+		{
+			++mismatches;
+		}
+	}
+	SDE_LOG("Ant spatial index, %d ants, %d food: brute force %.3fms, build %.3fms, closest %.3fms, %d mismatches",
+		antCount, foodCount, bruteForceTime * 1000.0, buildTime * 1000.0, closestTime * 1000.0, mismatches);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdio>
+
+// Minimal benchmark harness, benchmarks register themselves and are run by name from the command line
+// Results are logged, nothing is checked. Benchmarks must not need a window or gl context
+// A job system is registered as "Jobs" before any benchmark runs
+
+namespace Bench
+{
+	// integer arguments passed after the benchmark name, missing ones use the default
+	class Args
+	{
+	public:
+		Args(int count, char** values) : m_count(count), m_values(values) {}
+		int GetInt(int index, int defaultValue) const;
+	private:
+		int m_count;
+		char** m_values;
+	};
+
+	using BenchFn = void(*)(const Args&);
+	bool Register(const char* name, BenchFn fn);
+}
+
+// the function is prefixed so benchmarks can be named after the class they measure
+#define BENCHMARK(name)	\
+	static void Bench_##name(const Bench::Args& args);	\
+	static bool s_registered_##name = Bench::Register(#name, Bench_##name);	\
+	static void Bench_##name(const Bench::Args& args)
@@ -0,0 +1,62 @@
+#include "bench.h"
+#include "engine/system_manager.h"
+#include "engine/job_system.h"
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+
+namespace Bench
+{
+	struct BenchEntry
+	{
+		const char* m_name;
+		BenchFn m_fn;
+	};
+
+	std::vector<BenchEntry>& GetAllBenchmarks()
+	{
+		static std::vector<BenchEntry> s_allBenchmarks;
+		return s_allBenchmarks;
+	}
+
+	bool Register(const char* name, BenchFn fn)
+	{
+		GetAllBenchmarks().push_back({ name, fn });
+		return true;
+	}
+
+	int Args::GetInt(int index, int defaultValue) const
+	{
+		return index < m_count ? atoi(m_values[index]) : defaultValue;
+	}
+}
+
+// LeanBench [benchmark name [args...]], runs everything with default arguments if no name is passed
+int main(int argc, char** argv)
+{
+	Engine::JobSystem jobs;
+	Engine::SystemManager::GetInstance().RegisterSystem("Jobs", &jobs);
+	jobs.PostInit();
+
+	int benchmarksRun = 0;
+	for (const auto& bench : Bench::GetAllBenchmarks())
+	{
+		if (argc < 2 || strcmp(argv[1], bench.m_name) == 0)
+		{
+			++benchmarksRun;
+			printf("%s\n", bench.m_name);
+			bench.m_fn(argc < 2 ? Bench::Args(0, nullptr) : Bench::Args(argc - 2, argv + 2));
+		}
+	}
+	if (benchmarksRun == 0)
+	{
+		printf("No benchmarks matched, available benchmarks:\n");
+		for (const auto& bench : Bench::GetAllBenchmarks())
+		{
+			printf("\t%s\n", bench.m_name);
+		}
+	}
+
+	jobs.PostShutdown();
+	return benchmarksRun > 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+#include "bench.h"
+#include "engine/system_manager.h"
+#include "engine/job_system.h"
+#include "playground/creatures/creature_vision.h"
+#include "playground/creatures/component_creature.h"
+#include "core/random_stream.h"
+#include "core/timer.h"
+#include "core/log.h"
+#include <vector>
+
+// creatures spread over a square at a fixed density, every one of them looks around with no tag filter
+// LeanBench CreatureVision [creature count]
+BENCHMARK(CreatureVision)
+{
+	const int creatureCount = args.GetInt(0, 20000);
+	const float c_visionRadius = 64.0f;
+	const uint32_t c_maxVisible = 16;
+	const float worldSize = sqrtf((float)creatureCount) * 16.0f;
+	Core::RandomStream random(1234);
+	std::vector<Creature> creatures(creatureCount);
+	CreatureVision vision;
+	for (int c = 0; c < creatureCount; ++c)
+	{
+		creatures[c].SetVisionRadius(c_visionRadius);
+		creatures[c].SetMaxVisibleEntities(c_maxVisible);
+		const glm::vec3 position(random.NextFloat(0.0f, worldSize), 0.0f, random.NextFloat(0.0f, worldSize));
+		vision.Add(position, creatures[c], nullptr, EntityHandle(c), true);
+	}
+
+	double buildTime = 0.0, naiveTime = 0.0, jobsTime = 0.0;
+	{
+		Core::ScopedTimer t(buildTime);
+		vision.Build();
+	}
+	{
+		Core::ScopedTimer t(naiveTime);
+		vision.UpdateAll(nullptr);
+	}
+	{
+		Core::ScopedTimer t(jobsTime);
+		vision.UpdateAll(Engine::GetSystem<Engine::JobSystem>("Jobs"));
+	}
+	SDE_LOG("Creature vision, %d creatures: build grid %.3fms, vision %.3fms, vision (jobs) %.3fms",
+		creatureCount, buildTime * 1000.0, naiveTime * 1000.0, jobsTime * 1000.0);
+}
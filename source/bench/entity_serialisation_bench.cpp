@@ -0,0 +1,152 @@
+#include "bench.h"
+#include "engine/components/component_transform.h"
+#include "engine/components/component_tags.h"
+#include "entity/entity_system.h"
+#include "core/timer.h"
+#include "core/thread.h"
+#include "core/log.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// the entity system only needs the world and the job system for serialisation and scene loads
+static void RegisterBenchComponents(EntitySystem& entities)
+{
+	entities.GetWorld()->RegisterComponentType<Transform>();
+	entities.GetWorld()->RegisterComponentType<Tags>();
+}
+
+static std::vector<uint32_t> AddBenchEntities(World& world, int first, int count, const char* tag)
+{
+	std::vector<uint32_t> ids;
+	ids.reserve(count);
+	for (int i = 0; i < count; ++i)
+	{
+		EntityHandle e = world.AddEntity();
+		world.AddComponent(e, Transform::GetType());
+		world.AddComponent(e, Tags::GetType());
+		world.GetComponent<Transform>(e)->SetPosition({ (float)(first + i), 0.0f, (float)i * 0.5f });
+		world.GetComponent<Tags>(e)->AddTag(tag);
+		ids.push_back(e.GetID());
+	}
+	return ids;
+}
+
+static void RemoveBenchEntities(World& world, const std::vector<uint32_t>& ids)
+{
+	for (uint32_t id : ids)
+	{
+		world.RemoveEntity(id);
+	}
+	world.CollectGarbage();
+}
+
+// json vs binary archives vs CloneEntity on Transform + Tags entities
+// component storage is limited to c_maxComponents of each type, so large counts are done in batches
+// LeanBench EntitySerialisation [entity count]
+BENCHMARK(EntitySerialisation)
+{
+	const int entityCount = args.GetInt(0, 100000);
+	const int c_batchSize = 8192;
+	EntitySystem entities;
+	RegisterBenchComponents(entities);
+	World& world = *entities.GetWorld();
+	double jsonWriteTime = 0.0, jsonReadTime = 0.0, binaryWriteTime = 0.0, binaryReadTime = 0.0, cloneTime = 0.0;
+	uint64_t jsonBytes = 0, binaryBytes = 0;
+	Engine::BinaryArchive archive;
+	for (int batchStart = 0; batchStart < entityCount; batchStart += c_batchSize)
+	{
+		const int batchCount = std::min(c_batchSize, entityCount - batchStart);
+		std::vector<uint32_t> srcIDs = AddBenchEntities(world, batchStart, batchCount, "SerialisationBenchmark");
+
+		double t = 0.0;
+		nlohmann::json json;
+		std::vector<uint32_t> newIDs;
+		{
+			Core::ScopedTimer timer(t);
+			json = entities.SerialiseEntities(srcIDs);
+		}
+		jsonWriteTime += t;
+		jsonBytes += json.dump().size();
+		{
+			Core::ScopedTimer timer(t);
+			newIDs = entities.SerialiseEntities(json);
+		}
+		jsonReadTime += t;
+		RemoveBenchEntities(world, newIDs);
+
+		archive.Reset();
+		{
+			Core::ScopedTimer timer(t);
+			entities.SerialiseEntities(srcIDs, archive);
+		}
+		binaryWriteTime += t;
+		binaryBytes += archive.Data().size();
+		archive.BeginReading();
+		{
+			Core::ScopedTimer timer(t);
+			newIDs = entities.SerialiseEntities(archive);
+		}
+		binaryReadTime += t;
+		RemoveBenchEntities(world, newIDs);
+
+		newIDs.clear();
+		{
+			Core::ScopedTimer timer(t);
+			for (uint32_t id : srcIDs)
+			{
+				newIDs.push_back(entities.CloneEntity(id).GetID());
+			}
+		}
+		cloneTime += t;
+		RemoveBenchEntities(world, newIDs);
+		RemoveBenchEntities(world, srcIDs);
+	}
+	SDE_LOG("Serialisation, %d entities (Transform + Tags)", entityCount);
+	SDE_LOG("\tJson: write %.3fms, read %.3fms, %.2fMb", jsonWriteTime * 1000.0, jsonReadTime * 1000.0, jsonBytes / (1024.0 * 1024.0));
+	SDE_LOG("\tBinary: write %.3fms, read %.3fms, %.2fMb", binaryWriteTime * 1000.0, binaryReadTime * 1000.0, binaryBytes / (1024.0 * 1024.0));
+	SDE_LOG("\tCloneEntity: %.3fms", cloneTime * 1000.0);
+}
+
+// a blocking load of a generated scene vs an async one driven frame by frame with the default budget
+// everything stays under c_maxComponents since the source entities and one loaded copy can exist at once
+// LeanBench SceneLoad [entity count]
+BENCHMARK(SceneLoad)
+{
+	const int entityCount = std::min(args.GetInt(0, 30000), 30000);
+	EntitySystem entities;
+	RegisterBenchComponents(entities);
+	World& world = *entities.GetWorld();
+	std::vector<uint32_t> srcIDs = AddBenchEntities(world, 0, entityCount, "SceneLoadBenchmark");
+	std::string sceneText = entities.SerialiseEntities(srcIDs).dump();
+	RemoveBenchEntities(world, srcIDs);
+
+	double blockingTime = 0.0;
+	std::vector<uint32_t> loadedIDs;
+	{
+		Core::ScopedTimer timer(blockingTime);
+		nlohmann::json sceneJson = nlohmann::json::parse(sceneText);
+		loadedIDs = entities.SerialiseEntities(sceneJson);
+	}
+	RemoveBenchEntities(world, loadedIDs);
+
+	Core::Timer timer;
+	const double asyncStart = timer.GetSeconds();
+	double asyncTime = 0.0, longestFrame = 0.0;
+	int frames = 0;
+	entities.LoadSceneTextAsync(std::move(sceneText), "SceneLoadBenchmark", false, nullptr, [&](bool, std::vector<uint32_t> ids) {
+		asyncTime = timer.GetSeconds() - asyncStart;
+		loadedIDs = std::move(ids);
+	});
+	while (entities.IsLoadingScene())
+	{
+		const double frameStart = timer.GetSeconds();
+		entities.UpdateSceneLoads();
+		longestFrame = std::max(longestFrame, timer.GetSeconds() - frameStart);
+		++frames;
+		Core::Thread::Sleep(1);		// the rest of the frame, gives the parse job time to run
+	}
+	RemoveBenchEntities(world, loadedIDs);
+	SDE_LOG("Scene load, %d entities: blocking load %.2fms in one frame, async load %.2fms over %d frames (longest %.2fms, budget %.2fms)", entityCount,
+		blockingTime * 1000.0, asyncTime * 1000.0, frames, longestFrame * 1000.0, entities.GetSceneLoadBudget() * 1000.0);
+}
@@ -0,0 +1,133 @@
+#include "bench.h"
+#include "engine/system_manager.h"
+#include "engine/job_system.h"
+#include "engine/entity_grid.h"
+#include "survivors/monster_avoidance.h"
+#include "core/random_stream.h"
+#include "core/timer.h"
+#include "core/log.h"
+#include <cstring>
+#include <vector>
+
+const float c_monsterGridSize = 16.0f;		// matches SurvivorsMain
+
+// monsters packed into a disc around the origin at roughly in-game density, each one queries its own bounds (like avoidance)
+// LeanBench MonsterGrid
+BENCHMARK(MonsterGrid)
+{
+	const uint32_t c_monsterCounts[] = { 10000, 50000, 200000 };
+	const int c_iterations = 4;
+	for (uint32_t monsterCount : c_monsterCounts)
+	{
+		Core::RandomStream random(1234);
+		const float discRadius = sqrtf((float)monsterCount) * 4.0f;
+		std::vector<glm::vec4> monsters(monsterCount);	// xyz + radius
+		for (auto& m : monsters)
+		{
+			const float r = discRadius * sqrtf(random.NextFloat());
+			const float a = random.NextFloat(0.0f, glm::two_pi<float>());
+			m = glm::vec4(cosf(a) * r, 0.0f, sinf(a) * r, random.NextFloat(1.0f, 3.0f));
+		}
+
+		WorldGrid<uint32_t> grid({ c_monsterGridSize, c_monsterGridSize });
+		double buildTime = 0.0, queryTime = 0.0;
+		uint64_t neighboursFound = 0;
+		for (int i = 0; i < c_iterations; ++i)
+		{
+			double thisBuildTime = 0.0;
+			{
+				Core::ScopedTimer t(thisBuildTime);
+				grid.Reset();
+				for (uint32_t m = 0; m < monsterCount; ++m)
+				{
+					const glm::vec3 radius(monsters[m].w, 0.0f, monsters[m].w);
+					grid.AddEntry(glm::vec3(monsters[m]) - radius, glm::vec3(monsters[m]) + radius, m);
+				}
+				grid.Build();
+			}
+			buildTime += thisBuildTime;
+			double thisQueryTime = 0.0;
+			{
+				Core::ScopedTimer t(thisQueryTime);
+				for (uint32_t m = 0; m < monsterCount; ++m)
+				{
+					const glm::vec3 radius(monsters[m].w, 0.0f, monsters[m].w);
+					grid.ForEachNearby(glm::vec3(monsters[m]) - radius, glm::vec3(monsters[m]) + radius, [&](uint32_t& other) {
+						neighboursFound += other != m ? 1 : 0;
+					});
+				}
+			}
+			queryTime += thisQueryTime;
+		}
+		SDE_LOG("Monster grid, %d monsters: build %.3fms, query all %.3fms (%d cells, %.1f candidates per monster)", monsterCount,
+			(buildTime / c_iterations) * 1000.0, (queryTime / c_iterations) * 1000.0, (int)grid.GetCellCount(), (double)neighboursFound / ((double)monsterCount * c_iterations));
+	}
+}
+
+// headless crowd walking towards the player at the origin, runs twice to check the results are identical
+// LeanBench MonsterAvoidance [monster count] [frame count] [iterations]
+BENCHMARK(MonsterAvoidance)
+{
+	struct Monster
+	{
+		glm::vec3 m_targetPosition;
+		float m_radius;
+	};
+	const int monsterCount = args.GetInt(0, 20000);
+	const int frameCount = args.GetInt(1, 60);
+	const int iterations = args.GetInt(2, 1);
+	const float c_maxDistance = 350.0f;
+	const float c_monsterSpeed = 4.0f;
+	const float c_timeDelta = 1.0f / 60.0f;
+	const float discRadius = sqrtf((float)monsterCount) * 4.0f;
+	auto jobs = Engine::GetSystem<Engine::JobSystem>("Jobs");
+	std::vector<glm::vec3> finalPositions[2];
+	double buildTime = 0.0, solveTime = 0.0;
+	for (int run = 0; run < 2; ++run)
+	{
+		Core::RandomStream random(1234);
+		std::vector<Monster> monsters(monsterCount);
+		for (auto& m : monsters)
+		{
+			const float r = discRadius * sqrtf(random.NextFloat());
+			const float a = random.NextFloat(0.0f, glm::two_pi<float>());
+			m = { glm::vec3(cosf(a) * r, 0.0f, sinf(a) * r), random.NextFloat(1.0f, 3.0f) };
+		}
+		WorldGrid<uint32_t> grid({ c_monsterGridSize, c_monsterGridSize });
+		Survivors::MonsterAvoidance avoidance;
+		for (int frame = 0; frame < frameCount; ++frame)
+		{
+			double frameBuildTime = 0.0, frameSolveTime = 0.0;
+			{
+				Core::ScopedTimer t(frameBuildTime);
+				grid.Reset();
+				for (int m = 0; m < monsterCount; ++m)
+				{
+					auto& monster = monsters[m];
+					const float distanceToPlayer = glm::length(monster.m_targetPosition);
+					if (distanceToPlayer > 0.0f)
+					{
+						monster.m_targetPosition -= (monster.m_targetPosition / distanceToPlayer) * glm::min(distanceToPlayer, c_monsterSpeed * c_timeDelta);
+					}
+					const glm::vec3 radius(monster.m_radius, 0.0f, monster.m_radius);
+					grid.AddEntry(monster.m_targetPosition - radius, monster.m_targetPosition + radius, m);
+				}
+				grid.Build();
+			}
+			{
+				Core::ScopedTimer t(frameSolveTime);
+				avoidance.Solve(monsters, grid, glm::vec3(0.0f), c_maxDistance, iterations, *jobs);
+			}
+			buildTime += frameBuildTime;
+			solveTime += frameSolveTime;
+		}
+		for (const auto& m : monsters)
+		{
+			finalPositions[run].push_back(m.m_targetPosition);
+		}
+	}
+	const bool deterministic = memcmp(finalPositions[0].data(), finalPositions[1].data(), finalPositions[0].size() * sizeof(glm::vec3)) == 0;
+	const double framesRun = (double)frameCount * 2.0;
+	SDE_LOG("Avoidance, %d monsters, %d iterations: grid %.3fms, solve %.3fms per frame (%s)", monsterCount, iterations,
+		(buildTime / framesRun) * 1000.0, (solveTime / framesRun) * 1000.0, deterministic ? "deterministic" : "NOT deterministic");
+}
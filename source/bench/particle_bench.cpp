@@ -0,0 +1,91 @@
+#include "bench.h"
+#include "engine/system_manager.h"
+#include "engine/job_system.h"
+#include "particles/emitter_descriptor.h"
+#include "particles/update_pipeline.h"
+#include "particles/particle_container.h"
+#include "particles/behaviours/gravity_update.h"
+#include "particles/behaviours/euler_position_update.h"
+#include "particles/behaviours/update_particle_lifetime.h"
+#include "core/timer.h"
+#include "core/log.h"
+#include <cfloat>
+#include <memory>
+#include <vector>
+
+// gravity + euler + lifetime split into emitter-sized containers, per-behaviour updates vs fused pipelines
+// LeanBench ParticleUpdate [particle count]
+BENCHMARK(ParticleUpdate)
+{
+	using namespace Particles;
+	const uint32_t particleCount = (uint32_t)args.GetInt(0, 1000000);
+
+	EmitterDescriptor desc;
+	desc.GetUpdaters().push_back(std::make_unique<GravityUpdate>());
+	desc.GetUpdaters().push_back(std::make_unique<EulerPositionUpdater>());
+	auto lifetime = std::make_unique<UpdateParticleLifetime>();
+	lifetime->m_killAttachedEmitters = false;
+	desc.GetUpdaters().push_back(std::move(lifetime));
+	UpdatePipeline pipeline;
+	pipeline.Compile(desc);
+
+	const uint32_t c_particlesPerEmitter = 4096;
+	const uint32_t emitterCount = (particleCount + c_particlesPerEmitter - 1) / c_particlesPerEmitter;
+	std::vector<std::unique_ptr<ParticleContainer>> containers(emitterCount);
+	for (uint32_t e = 0; e < emitterCount; ++e)
+	{
+		const uint32_t count = glm::min(c_particlesPerEmitter, particleCount - e * c_particlesPerEmitter);
+		containers[e] = std::make_unique<ParticleContainer>(count);
+		containers[e]->Wake(count, 0.0f);
+		for (uint32_t p = 0; p < count; ++p)
+		{
+			containers[e]->Positions().GetValue(p) = _mm_set_ps(0.0f, (float)p, 0.0f, (float)e);
+			containers[e]->Velocities().GetValue(p) = _mm_set_ps(0.0f, 0.0f, 1.0f, 0.0f);
+			containers[e]->Colours().GetValue(p) = _mm_set1_ps(1.0f);
+			containers[e]->Lifetimes().GetValue(p) = FLT_MAX;	// nothing dies, the live count stays constant
+		}
+	}
+
+	const int c_iterations = 8;
+	const float c_deltaTime = 0.016f;
+	const glm::vec3 c_pos(0.0f);
+	const glm::quat c_rot;
+	auto jobs = Engine::GetSystem<Engine::JobSystem>("Jobs");
+	double perBehaviourTime = 0.0, fusedTime = 0.0, fusedJobsTime = 0.0;
+	{
+		Core::ScopedTimer t(perBehaviourTime);
+		for (int i = 0; i < c_iterations; ++i)
+		{
+			for (auto& c : containers)
+			{
+				for (const auto& it : desc.GetUpdaters())
+				{
+					it->Update(c_pos, c_rot, i * c_deltaTime, c_deltaTime, *c);
+				}
+			}
+		}
+	}
+	{
+		Core::ScopedTimer t(fusedTime);
+		for (int i = 0; i < c_iterations; ++i)
+		{
+			for (auto& c : containers)
+			{
+				pipeline.Run(c_pos, c_rot, i * c_deltaTime, c_deltaTime, *c);
+			}
+		}
+	}
+	{
+		Core::ScopedTimer t(fusedJobsTime);
+		for (int i = 0; i < c_iterations; ++i)
+		{
+			jobs->ForEachAsync(0, emitterCount, 1, 8, [&](int32_t e) {
+				pipeline.Run(c_pos, c_rot, i * c_deltaTime, c_deltaTime, *containers[e]);
+			});
+		}
+	}
+	const double totalParticles = (double)particleCount * c_iterations;
+	SDE_LOG("Particle update (%d particles, %d emitters): per-behaviour %.2fms, fused %.2fms, fused + jobs %.2fms per frame (%.0f particles/s)",
+		particleCount, emitterCount, perBehaviourTime * 1000.0 / c_iterations, fusedTime * 1000.0 / c_iterations, fusedJobsTime * 1000.0 / c_iterations,
+		totalParticles / fusedJobsTime);
+}
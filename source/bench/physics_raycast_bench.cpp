@@ -0,0 +1,78 @@
+#include "bench.h"
+#include "engine/system_manager.h"
+#include "engine/job_system.h"
+#include "engine/physics_system.h"
+#include "core/random_stream.h"
+#include "core/timer.h"
+#include "core/log.h"
+#include <PxPhysicsAPI.h>
+#include <vector>
+
+// grid of static boxes over a ground plane, rays are fired down from random points above them
+// serial queries vs PhysicsSystem::RaycastBatch, the results must match exactly
+// LeanBench PhysicsRaycasts [ray count]
+BENCHMARK(PhysicsRaycasts)
+{
+	const uint32_t rayCount = (uint32_t)args.GetInt(0, 100000);
+	const int c_boxesPerSide = 64;
+	const float c_boxSpacing = 8.0f;
+	const float c_worldHalfSize = c_boxesPerSide * c_boxSpacing * 0.5f;
+
+	physx::PxDefaultAllocator allocator;
+	physx::PxDefaultErrorCallback errors;
+	physx::PxFoundation* foundation = PxCreateFoundation(PX_PHYSICS_VERSION, allocator, errors);
+	physx::PxPhysics* physics = PxCreatePhysics(PX_PHYSICS_VERSION, *foundation, physx::PxTolerancesScale());
+	physx::PxDefaultCpuDispatcher* dispatcher = physx::PxDefaultCpuDispatcherCreate(1);	// the scene is never simulated
+	physx::PxSceneDesc sceneDesc(physics->getTolerancesScale());
+	sceneDesc.cpuDispatcher = dispatcher;
+	sceneDesc.filterShader = physx::PxDefaultSimulationFilterShader;
+	physx::PxScene* scene = physics->createScene(sceneDesc);
+	physx::PxMaterial* material = physics->createMaterial(0.5f, 0.5f, 0.5f);
+	scene->addActor(*physx::PxCreatePlane(*physics, physx::PxPlane(0.0f, 1.0f, 0.0f, 0.0f), *material));
+	for (int z = 0; z < c_boxesPerSide; ++z)
+	{
+		for (int x = 0; x < c_boxesPerSide; ++x)
+		{
+			const physx::PxVec3 pos(x * c_boxSpacing - c_worldHalfSize, 2.0f, z * c_boxSpacing - c_worldHalfSize);
+			scene->addActor(*physx::PxCreateStatic(*physics, physx::PxTransform(pos), physx::PxBoxGeometry(2.0f, 2.0f, 2.0f), *material));
+		}
+	}
+
+	std::vector<glm::vec3> starts(rayCount), ends(rayCount);
+	Core::RandomStream random(1234);
+	for (uint32_t r = 0; r < rayCount; ++r)
+	{
+		starts[r] = { random.NextFloat(-c_worldHalfSize, c_worldHalfSize), 50.0f, random.NextFloat(-c_worldHalfSize, c_worldHalfSize) };
+		ends[r] = starts[r] + glm::vec3(random.NextFloat(-20.0f, 20.0f), -100.0f, random.NextFloat(-20.0f, 20.0f));
+	}
+
+	using Engine::PhysicsSystem;
+	auto jobs = Engine::GetSystem<Engine::JobSystem>("Jobs");
+	PhysicsSystem::RaycastBatchResults serialResults, batchResults;
+	serialResults.Resize(rayCount);
+	double serialTime = 0.0, batchTime = 0.0;
+	{
+		Core::ScopedTimer t(serialTime);
+		for (uint32_t r = 0; r < rayCount; ++r)
+		{
+			serialResults.m_hitEntity[r] = PhysicsSystem::RaycastScene(*scene, starts[r], ends[r], serialResults.m_tHit[r], serialResults.m_hitNormal[r]);
+		}
+	}
+	{
+		Core::ScopedTimer t(batchTime);
+		PhysicsSystem::RaycastBatch(*scene, *jobs, starts.data(), ends.data(), rayCount, batchResults);
+	}
+	uint32_t mismatches = 0;
+	for (uint32_t r = 0; r < rayCount; ++r)
+	{
+		mismatches += (serialResults.m_hitEntity[r] == batchResults.m_hitEntity[r] && serialResults.m_tHit[r] == batchResults.m_tHit[r]) ? 0 : 1;
+	}
+	SDE_LOG("Physics raycasts, %u rays: serial %.3fms (%.0f rays/s), batched %.3fms (%.0f rays/s), %u mismatches", rayCount,
+		serialTime * 1000.0, rayCount / serialTime, batchTime * 1000.0, rayCount / batchTime, mismatches);
+
+	scene->release();
+	material->release();
+	dispatcher->release();
+	physics->release();
+	foundation->release();
+}
@@ -0,0 +1,62 @@
+#include "bench.h"
+#include "engine/system_manager.h"
+#include "engine/job_system.h"
+#include "engine/sdf.h"
+#include "engine/sdf_mesh_raycast.h"
+#include "core/timer.h"
+#include "core/log.h"
+#include <algorithm>
+#include <vector>
+
+// rays fired through a unit sphere from points on a shell, ~half will hit. scalar vs batched vs batched across jobs
+// LeanBench SDFRaycasts [ray count]
+BENCHMARK(SDFRaycasts)
+{
+	using namespace Engine;
+	const uint32_t rayCount = (uint32_t)args.GetInt(0, 1000000);
+
+	SDF::SampleFn sphere = [](float x, float y, float z) -> std::tuple<float, int> {
+		return { sqrtf(x * x + y * y + z * z) - 1.0f, 0 };
+	};
+	SDF::BatchSampleFn sphereBatch = [](__m128 x, __m128 y, __m128 z) -> __m128 {
+		const __m128 lenSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		return _mm_sub_ps(_mm_sqrt_ps(lenSq), _mm_set1_ps(1.0f));
+	};
+	std::vector<glm::vec3> starts(rayCount), ends(rayCount);
+	std::vector<float> results(rayCount);
+	for (uint32_t i = 0; i < rayCount; ++i)
+	{
+		const float a = (float)i * 2.399963f;	// golden angle spiral
+		const float y = 1.0f - 2.0f * (i + 0.5f) / rayCount;
+		const glm::vec3 dir = glm::vec3(cosf(a) * sqrtf(1.0f - y * y), y, sinf(a) * sqrtf(1.0f - y * y));
+		starts[i] = dir * 4.0f;
+		ends[i] = -dir * 4.0f + glm::vec3(0.0f, 1.5f * ((i & 1) ? 1.0f : -1.0f), 0.0f);
+	}
+
+	auto jobs = Engine::GetSystem<Engine::JobSystem>("Jobs");
+	double scalarTime = 0.0, batchTime = 0.0, jobsTime = 0.0;
+	{
+		Core::ScopedTimer t(scalarTime);
+		for (uint32_t i = 0; i < rayCount; ++i)
+		{
+			int mat = 0;
+			if (!SDF::Raycast(starts[i], ends[i], SDF::c_meshRayMaxStep, sphere, results[i], mat))
+			{
+				results[i] = -1.0f;
+			}
+		}
+	}
+	{
+		Core::ScopedTimer t(batchTime);
+		SDF::RaycastBatch(starts.data(), ends.data(), rayCount, SDF::c_meshRayMinStep, SDF::c_meshRayMaxStep, sphereBatch, results.data());
+	}
+	{
+		Core::ScopedTimer t(jobsTime);
+		const int jobCount = (rayCount + SDF::c_meshRaysPerJob - 1) / SDF::c_meshRaysPerJob;
+		jobs->ForEachAsync(0, jobCount, 1, 1, [&](int32_t job) {
+			const uint32_t first = job * SDF::c_meshRaysPerJob;
+			SDF::RaycastBatch(&starts[first], &ends[first], std::min(SDF::c_meshRaysPerJob, rayCount - first), SDF::c_meshRayMinStep, SDF::c_meshRayMaxStep, sphereBatch, &results[first]);
+		});
+	}
+	SDE_LOG("CPU SDF raycasts (%d rays): scalar %.0f rays/s, batch %.0f rays/s, batch + jobs %.0f rays/s", rayCount, rayCount / scalarTime, rayCount / batchTime, rayCount / jobsTime);
+}
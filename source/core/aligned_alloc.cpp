@@ -0,0 +1,33 @@
+#include "aligned_alloc.h"
+#include <stdlib.h>
+
+namespace Core
+{
+	void* AlignedAlloc(size_t sizeBytes, size_t alignment)
+	{
+#ifdef _MSC_VER
+		return _aligned_malloc(sizeBytes, alignment);
+#else
+		// posix_memalign requires at least pointer alignment
+		void* result = nullptr;
+		if (alignment < sizeof(void*))
+		{
+			alignment = sizeof(void*);
+		}
+		if (posix_memalign(&result, alignment, sizeBytes) != 0)
+		{
+			return nullptr;
+		}
+		return result;
+#endif
+	}
+
+	void AlignedFree(void* ptr)
+	{
+#ifdef _MSC_VER
+		_aligned_free(ptr);
+#else
+		free(ptr);
+#endif
+	}
+}
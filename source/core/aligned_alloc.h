@@ -0,0 +1,10 @@
+#pragma once
+#include <stddef.h>
+
+namespace Core
+{
+	// Portable aligned allocation, alignment must be a power of 2
+	// Memory from AlignedAlloc must be released with AlignedFree
+	void* AlignedAlloc(size_t sizeBytes, size_t alignment);
+	void AlignedFree(void* ptr);
+}
@@ -0,0 +1,294 @@
+#include "file_watcher.h"
+#include "profiler.h"
+#include "log.h"
+#include <filesystem>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <Windows.h>
+#else
+	#include <sys/inotify.h>
+	#include <poll.h>
+	#include <unistd.h>
+#endif
+
+namespace Core
+{
+	const double c_settleSeconds = 0.1;		// a file must be quiet for this long before it is reported
+	const int c_pollTimeoutMs = 100;		// how often the watch thread checks for Stop()
+
+#if defined(_WIN32)
+	struct FileWatchData
+	{
+		HANDLE m_directory = INVALID_HANDLE_VALUE;
+		OVERLAPPED m_overlapped = {};
+		alignas(DWORD) uint8_t m_buffer[64 * 1024];
+	};
+
+	static bool OpenWatch(FileWatchData& p, const std::string& rootPath)
+	{
+		p.m_directory = CreateFileA(rootPath.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+		if (p.m_directory == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		p.m_overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+		return p.m_overlapped.hEvent != nullptr;
+	}
+
+	static void CloseWatch(FileWatchData& p)
+	{
+		if (p.m_directory != INVALID_HANDLE_VALUE)
+		{
+			CancelIoEx(p.m_directory, &p.m_overlapped);
+			DWORD bytes = 0;
+			GetOverlappedResult(p.m_directory, &p.m_overlapped, &bytes, TRUE);
+			CloseHandle(p.m_directory);
+			p.m_directory = INVALID_HANDLE_VALUE;
+		}
+		if (p.m_overlapped.hEvent != nullptr)
+		{
+			CloseHandle(p.m_overlapped.hEvent);
+			p.m_overlapped.hEvent = nullptr;
+		}
+	}
+
+	static bool BeginRead(FileWatchData& p)
+	{
+		const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE;
+		ResetEvent(p.m_overlapped.hEvent);
+		return ReadDirectoryChangesW(p.m_directory, p.m_buffer, sizeof(p.m_buffer), TRUE, filter, nullptr, &p.m_overlapped, nullptr);
+	}
+
+	int32_t FileWatcher::WatchThread()
+	{
+		FileWatchData& p = *m_platform;
+		if (!BeginRead(p))
+		{
+			SDE_LOG("Failed to watch directory '%s'", m_rootPath.c_str());
+			return 1;
+		}
+		char path[MAX_PATH * 4] = { '\0' };
+		while (!m_stopRequested)
+		{
+			if (WaitForSingleObject(p.m_overlapped.hEvent, c_pollTimeoutMs) != WAIT_OBJECT_0)
+			{
+				continue;
+			}
+			DWORD bytesRead = 0;
+			if (!GetOverlappedResult(p.m_directory, &p.m_overlapped, &bytesRead, FALSE))
+			{
+				break;
+			}
+			// 0 bytes means the buffer overflowed and events were lost, nothing we can do about that
+			size_t offset = 0;
+			while (bytesRead > 0)
+			{
+				auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(p.m_buffer + offset);
+				if (info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+				{
+					const int nameChars = (int)(info->FileNameLength / sizeof(WCHAR));
+					const int pathLength = WideCharToMultiByte(CP_UTF8, 0, info->FileName, nameChars, path, sizeof(path) - 1, nullptr, nullptr);
+					if (pathLength > 0)
+					{
+						OnFileChanged(std::string_view(path, pathLength));
+					}
+				}
+				if (info->NextEntryOffset == 0)
+				{
+					break;
+				}
+				offset += info->NextEntryOffset;
+			}
+			if (!BeginRead(p))
+			{
+				break;
+			}
+		}
+		return 0;
+	}
+#else
+	struct FileWatchData
+	{
+		int m_inotify = -1;
+		std::unordered_map<int, std::string> m_watchToDirectory;	// relative to the root
+	};
+
+	const uint32_t c_watchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+
+	// inotify is not recursive, each directory needs its own watch
+	static void AddWatches(FileWatchData& p, const std::string& rootPath, const std::string& relativeDirectory)
+	{
+		const std::filesystem::path fullPath = relativeDirectory.empty() ? std::filesystem::path(rootPath) : std::filesystem::path(rootPath) / relativeDirectory;
+		const int watch = inotify_add_watch(p.m_inotify, fullPath.string().c_str(), c_watchMask);
+		if (watch < 0)
+		{
+			SDE_LOG("Failed to watch directory '%s'", fullPath.string().c_str());
+			return;
+		}
+		p.m_watchToDirectory[watch] = relativeDirectory;
+
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(fullPath, ec))
+		{
+			if (entry.is_directory(ec))
+			{
+				const std::string name = entry.path().filename().string();
+				AddWatches(p, rootPath, relativeDirectory.empty() ? name : relativeDirectory + "/" + name);
+			}
+		}
+	}
+
+	static bool OpenWatch(FileWatchData& p, const std::string& rootPath)
+	{
+		p.m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (p.m_inotify < 0)
+		{
+			return false;
+		}
+		AddWatches(p, rootPath, "");
+		return p.m_watchToDirectory.size() > 0;
+	}
+
+	static void CloseWatch(FileWatchData& p)
+	{
+		if (p.m_inotify >= 0)
+		{
+			close(p.m_inotify);		// removes all watches
+			p.m_inotify = -1;
+		}
+		p.m_watchToDirectory.clear();
+	}
+
+	int32_t FileWatcher::WatchThread()
+	{
+		FileWatchData& p = *m_platform;
+		alignas(inotify_event) char buffer[64 * 1024];
+		while (!m_stopRequested)
+		{
+			pollfd pfd = { p.m_inotify, POLLIN, 0 };
+			if (poll(&pfd, 1, c_pollTimeoutMs) <= 0)
+			{
+				continue;
+			}
+			const ssize_t bytesRead = read(p.m_inotify, buffer, sizeof(buffer));
+			for (ssize_t offset = 0; offset < bytesRead; )
+			{
+				auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				offset += sizeof(inotify_event) + event->len;
+
+				const auto foundDirectory = p.m_watchToDirectory.find(event->wd);
+				if (foundDirectory == p.m_watchToDirectory.end() || event->len == 0)
+				{
+					continue;
+				}
+				std::string relativePath = foundDirectory->second.empty() ? event->name : foundDirectory->second + "/" + event->name;
+				if (event->mask & IN_ISDIR)
+				{
+					if (event->mask & (IN_CREATE | IN_MOVED_TO))
+					{
+						AddWatches(p, m_rootPath, relativePath);
+					}
+				}
+				else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+				{
+					OnFileChanged(relativePath);
+				}
+			}
+		}
+		return 0;
+	}
+#endif
+
+	FileWatcher::FileWatcher()
+	{
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		Stop();
+	}
+
+	std::string FileWatcher::NormalisePath(std::string_view path)
+	{
+		std::string result(path);
+		for (auto& c : result)
+		{
+			if (c == '\\')
+			{
+				c = '/';
+			}
+		}
+		while (result.compare(0, 2, "./") == 0)
+		{
+			result.erase(0, 2);
+		}
+		return result;
+	}
+
+	bool FileWatcher::Start(const std::string& rootPath)
+	{
+		SDE_PROF_EVENT();
+
+		Stop();
+		m_rootPath = rootPath;
+		m_platform = std::make_unique<FileWatchData>();
+		if (!OpenWatch(*m_platform, rootPath))
+		{
+			SDE_LOG("Failed to start watching '%s'", rootPath.c_str());
+			CloseWatch(*m_platform);
+			m_platform = nullptr;
+			return false;
+		}
+		m_stopRequested = false;
+		m_thread.Create("FileWatcher", [this]() {
+			return WatchThread();
+		});
+		return true;
+	}
+
+	void FileWatcher::Stop()
+	{
+		if (m_platform == nullptr)
+		{
+			return;
+		}
+		m_stopRequested = true;
+		m_thread.WaitForFinish();
+		CloseWatch(*m_platform);
+		m_platform = nullptr;
+		Core::ScopedMutex guard(m_changesMutex);
+		m_pendingChanges.clear();
+	}
+
+	void FileWatcher::OnFileChanged(std::string_view relativePath)
+	{
+		std::string path = NormalisePath(m_rootPath.empty() ? std::string(relativePath) : m_rootPath + "/" + std::string(relativePath));
+		const double eventTime = m_timer.GetSeconds();
+		Core::ScopedMutex guard(m_changesMutex);
+		m_pendingChanges[std::move(path)] = eventTime;
+	}
+
+	std::vector<std::string> FileWatcher::PollChanges()
+	{
+		SDE_PROF_EVENT();
+
+		std::vector<std::string> results;
+		const double currentTime = m_timer.GetSeconds();
+		Core::ScopedMutex guard(m_changesMutex);
+		for (auto it = m_pendingChanges.begin(); it != m_pendingChanges.end();)
+		{
+			if (currentTime - it->second >= c_settleSeconds)
+			{
+				results.push_back(it->first);
+				it = m_pendingChanges.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		return results;
+	}
+}
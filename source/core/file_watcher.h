@@ -0,0 +1,46 @@
+#pragma once
+#include "mutex.h"
+#include "thread.h"
+#include "timer.h"
+#include <stdint.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+
+// Watches a directory tree on a background thread and reports files that were written, created or renamed
+// Uses inotify on linux and ReadDirectoryChangesW on windows
+// Editors often write a file more than once when saving, so changes are only reported once a file has been quiet for a short time
+namespace Core
+{
+	struct FileWatchData;		// platform specific
+
+	class FileWatcher
+	{
+	public:
+		FileWatcher();
+		~FileWatcher();
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		bool Start(const std::string& rootPath);		// watches rootPath and all sub-directories
+		void Stop();
+		bool IsRunning() const { return m_platform != nullptr; }
+		std::vector<std::string> PollChanges();		// each changed file is reported once, paths are normalised
+		static std::string NormalisePath(std::string_view path);	// forward slashes, no leading "./"
+
+	private:
+		int32_t WatchThread();
+		void OnFileChanged(std::string_view relativePath);	// called from the watch thread
+
+		std::unique_ptr<FileWatchData> m_platform;
+		Core::Thread m_thread;
+		std::atomic<bool> m_stopRequested = false;
+		std::string m_rootPath;
+		Core::Timer m_timer;
+		Core::Mutex m_changesMutex;
+		std::unordered_map<std::string, double> m_pendingChanges;	// path -> time of the last event
+	};
+}
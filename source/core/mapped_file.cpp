@@ -0,0 +1,69 @@
+#include "mapped_file.h"
+#include "profiler.h"
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+namespace Core
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(const std::string& path)
+	{
+		SDE_PROF_EVENT();
+		Close();
+
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)		// empty files can't be mapped
+		{
+			CloseHandle(file);
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr)
+		{
+			CloseHandle(file);
+			return false;
+		}
+		const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+		m_fileHandle = file;
+		m_mappingHandle = mapping;
+		m_data = static_cast<const uint8_t*>(view);
+		m_size = (size_t)fileSize.QuadPart;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_data != nullptr)
+		{
+			UnmapViewOfFile(m_data);
+			m_data = nullptr;
+		}
+		if (m_mappingHandle != nullptr)
+		{
+			CloseHandle(m_mappingHandle);
+			m_mappingHandle = nullptr;
+		}
+		if (m_fileHandle != nullptr)
+		{
+			CloseHandle(m_fileHandle);
+			m_fileHandle = nullptr;
+		}
+		m_size = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+#include <stdint.h>
+
+// Read-only memory mapped file, data is valid until Close() or destruction
+namespace Core
+{
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const std::string& path);
+		void Close();
+		const uint8_t* Data() const { return m_data; }
+		size_t Size() const { return m_size; }
+
+	private:
+		void* m_fileHandle = nullptr;
+		void* m_mappingHandle = nullptr;
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "offset_allocator.h"
+#include <cassert>
+
+namespace Core
+{
+	OffsetAllocator::OffsetAllocator(uint32_t totalSize)
+	{
+		Reset(totalSize);
+	}
+
+	void OffsetAllocator::Reset(uint32_t totalSize)
+	{
+		m_freeByOffset.clear();
+		m_freeBySize.clear();
+		m_allocations.clear();
+		m_totalSize = totalSize;
+		m_usedSize = 0;
+		if (totalSize > 0)
+		{
+			AddFreeBlock(0, totalSize);
+		}
+	}
+
+	void OffsetAllocator::AddFreeBlock(uint32_t offset, uint32_t size)
+	{
+		auto bySize = m_freeBySize.emplace(size, offset);
+		m_freeByOffset.emplace(offset, FreeBlock{ size, bySize });
+	}
+
+	void OffsetAllocator::RemoveFreeBlock(OffsetToBlock::iterator block)
+	{
+		m_freeBySize.erase(block->second.m_bySize);
+		m_freeByOffset.erase(block);
+	}
+
+	uint32_t OffsetAllocator::TakeFromBlock(OffsetToBlock::iterator block, uint32_t size)
+	{
+		const uint32_t offset = block->first;
+		const uint32_t blockSize = block->second.m_size;
+		assert(blockSize >= size);
+		RemoveFreeBlock(block);
+		if (blockSize > size)
+		{
+			AddFreeBlock(offset + size, blockSize - size);
+		}
+		m_allocations[offset] = size;
+		m_usedSize += size;
+		return offset;
+	}
+
+	uint32_t OffsetAllocator::Allocate(uint32_t size)
+	{
+		if (size == 0)
+		{
+			return c_invalidOffset;
+		}
+		auto bestFit = m_freeBySize.lower_bound(size);
+		if (bestFit == m_freeBySize.end())
+		{
+			return c_invalidOffset;
+		}
+		return TakeFromBlock(m_freeByOffset.find(bestFit->second), size);
+	}
+
+	uint32_t OffsetAllocator::AllocateLowest(uint32_t size)
+	{
+		if (size == 0)
+		{
+			return c_invalidOffset;
+		}
+		for (auto it = m_freeByOffset.begin(); it != m_freeByOffset.end(); ++it)
+		{
+			if (it->second.m_size >= size)
+			{
+				return TakeFromBlock(it, size);
+			}
+		}
+		return c_invalidOffset;
+	}
+
+	uint32_t OffsetAllocator::AllocateBelow(uint32_t offset)
+	{
+		const uint32_t size = GetAllocationSize(offset);
+		if (size == 0)
+		{
+			return c_invalidOffset;
+		}
+		for (auto it = m_freeByOffset.begin(); it != m_freeByOffset.end() && it->first < offset; ++it)
+		{
+			if (it->second.m_size >= size)
+			{
+				return TakeFromBlock(it, size);
+			}
+		}
+		return c_invalidOffset;
+	}
+
+	void OffsetAllocator::Free(uint32_t offset)
+	{
+		auto found = m_allocations.find(offset);
+		assert(found != m_allocations.end());
+		if (found == m_allocations.end())
+		{
+			return;
+		}
+		uint32_t size = found->second;
+		m_allocations.erase(found);
+		m_usedSize -= size;
+
+		// merge with the free blocks either side
+		auto next = m_freeByOffset.lower_bound(offset);
+		if (next != m_freeByOffset.end() && offset + size == next->first)
+		{
+			size += next->second.m_size;
+			RemoveFreeBlock(next);
+		}
+		auto previous = m_freeByOffset.lower_bound(offset);
+		if (previous != m_freeByOffset.begin())
+		{
+			--previous;
+			if (previous->first + previous->second.m_size == offset)
+			{
+				offset = previous->first;
+				size += previous->second.m_size;
+				RemoveFreeBlock(previous);
+			}
+		}
+		AddFreeBlock(offset, size);
+	}
+
+	uint32_t OffsetAllocator::GetAllocationSize(uint32_t offset) const
+	{
+		auto found = m_allocations.find(offset);
+		return found != m_allocations.end() ? found->second : 0;
+	}
+
+	OffsetAllocator::Stats OffsetAllocator::GetStats() const
+	{
+		Stats result;
+		result.m_totalSize = m_totalSize;
+		result.m_usedSize = m_usedSize;
+		result.m_allocationCount = (uint32_t)m_allocations.size();
+		result.m_freeBlockCount = (uint32_t)m_freeByOffset.size();
+		result.m_largestFreeBlock = m_freeBySize.empty() ? 0 : m_freeBySize.rbegin()->first;
+		return result;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+#include <map>
+#include <unordered_map>
+
+namespace Core
+{
+	// Hands out ranges of a fixed size space (e.g. elements of a gpu buffer), it never touches the memory itself
+	// Free blocks are sorted by size for best-fit allocation and by offset so neighbours can be merged when freed
+	// Not thread safe
+	class OffsetAllocator
+	{
+	public:
+		static constexpr uint32_t c_invalidOffset = (uint32_t)-1;
+		struct Stats
+		{
+			uint32_t m_totalSize = 0;
+			uint32_t m_usedSize = 0;
+			uint32_t m_allocationCount = 0;
+			uint32_t m_freeBlockCount = 0;
+			uint32_t m_largestFreeBlock = 0;
+		};
+
+		explicit OffsetAllocator(uint32_t totalSize = 0);
+		void Reset(uint32_t totalSize);				// everything is freed
+		uint32_t Allocate(uint32_t size);			// best fit, returns c_invalidOffset if there is no space
+		uint32_t AllocateLowest(uint32_t size);		// first fit from offset 0, slower but useful when compacting
+		uint32_t AllocateBelow(uint32_t offset);	// lowest space for a copy of the allocation at offset that is below it, the old one is not freed
+		void Free(uint32_t offset);
+		uint32_t GetAllocationSize(uint32_t offset) const;	// 0 if nothing was allocated at this offset
+		Stats GetStats() const;
+
+	private:
+		using SizeToOffset = std::multimap<uint32_t, uint32_t>;
+		struct FreeBlock
+		{
+			uint32_t m_size;
+			SizeToOffset::iterator m_bySize;
+		};
+		using OffsetToBlock = std::map<uint32_t, FreeBlock>;
+		uint32_t TakeFromBlock(OffsetToBlock::iterator block, uint32_t size);
+		void AddFreeBlock(uint32_t offset, uint32_t size);
+		void RemoveFreeBlock(OffsetToBlock::iterator block);
+
+		uint32_t m_totalSize = 0;
+		uint32_t m_usedSize = 0;
+		OffsetToBlock m_freeByOffset;
+		SizeToOffset m_freeBySize;
+		std::unordered_map<uint32_t, uint32_t> m_allocations;	// offset -> size
+	};
+}
@@ -0,0 +1,99 @@
+#include "random_stream.h"
+
+namespace Core
+{
+	const uint32_t c_philoxM0 = 0xD2511F53;
+	const uint32_t c_philoxM1 = 0xCD9E8D57;
+	const uint32_t c_philoxW0 = 0x9E3779B9;
+	const uint32_t c_philoxW1 = 0xBB67AE85;
+	const float c_uintToFloat = 1.0f / 16777216.0f;	// top 24 bits -> [0,1)
+
+	RandomStream::RandomStream(uint64_t seed, uint64_t streamId)
+	{
+		Reset(seed, streamId);
+	}
+
+	void RandomStream::Reset(uint64_t seed, uint64_t streamId)
+	{
+		m_key[0] = (uint32_t)seed;
+		m_key[1] = (uint32_t)(seed >> 32);
+		m_streamId = streamId;
+		m_position = 0;
+		m_bufferBlock = -1;
+	}
+
+	void RandomStream::Skip(uint64_t count)
+	{
+		m_position += count;
+	}
+
+	void RandomStream::Philox(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4])
+	{
+		uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+		uint32_t k0 = key[0], k1 = key[1];
+		for (int round = 0; round < 10; ++round)
+		{
+			const uint64_t p0 = (uint64_t)c_philoxM0 * c0;
+			const uint64_t p1 = (uint64_t)c_philoxM1 * c2;
+			const uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+			const uint32_t n1 = (uint32_t)p1;
+			const uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+			const uint32_t n3 = (uint32_t)p0;
+			c0 = n0; c1 = n1; c2 = n2; c3 = n3;
+			k0 += c_philoxW0;
+			k1 += c_philoxW1;
+		}
+		result[0] = c0; result[1] = c1; result[2] = c2; result[3] = c3;
+	}
+
+	void RandomStream::GenerateBlock(uint64_t blockIndex)
+	{
+		const uint32_t counter[4] = { (uint32_t)blockIndex, (uint32_t)(blockIndex >> 32), (uint32_t)m_streamId, (uint32_t)(m_streamId >> 32) };
+		Philox(counter, m_key, m_buffer);
+		m_bufferBlock = blockIndex;
+	}
+
+	uint32_t RandomStream::NextUInt()
+	{
+		const uint64_t block = m_position >> 2;
+		if (block != m_bufferBlock)
+		{
+			GenerateBlock(block);
+		}
+		return m_buffer[m_position++ & 3];
+	}
+
+	uint64_t RandomStream::NextUInt64()
+	{
+		const uint64_t lo = NextUInt();
+		return lo | ((uint64_t)NextUInt() << 32);
+	}
+
+	float RandomStream::NextFloat(float minVal, float maxVal)
+	{
+		const float t = (NextUInt() >> 8) * c_uintToFloat;
+		return minVal + (maxVal - minVal) * t;
+	}
+
+	__m128i RandomStream::NextUInt4()
+	{
+		const uint64_t block = (m_position + 3) >> 2;
+		if (block != m_bufferBlock)
+		{
+			GenerateBlock(block);
+		}
+		m_position = (block + 1) << 2;
+		return _mm_load_si128(reinterpret_cast<const __m128i*>(m_buffer));
+	}
+
+	__m128 RandomStream::NextFloat4()
+	{
+		const __m128i bits = _mm_srli_epi32(NextUInt4(), 8);
+		return _mm_mul_ps(_mm_cvtepi32_ps(bits), _mm_set1_ps(c_uintToFloat));
+	}
+
+	__m128 RandomStream::NextFloat4(__m128 minVal, __m128 maxVal)
+	{
+		return _mm_add_ps(minVal, _mm_mul_ps(_mm_sub_ps(maxVal, minVal), NextFloat4()));
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+#include <emmintrin.h>
+
+namespace Core
+{
+	// Counter-based random number stream (Philox4x32-10)
+	// Each output block is a pure function of (seed, stream id, counter), so streams need no shared state,
+	// are reproducible from a seed, and can jump ahead in O(1). Values are generated 4 at a time
+	class RandomStream
+	{
+	public:
+		RandomStream(uint64_t seed = 0, uint64_t streamId = 0);
+		void Reset(uint64_t seed, uint64_t streamId);
+		void Skip(uint64_t count);			// jump ahead count values
+		uint64_t GetPosition() const { return m_position; }
+
+		uint32_t NextUInt();
+		uint64_t NextUInt64();
+		float NextFloat(float minVal = 0.0f, float maxVal = 1.0f);
+
+		// 4 values at once, always starts at a new block (any leftover values in the current block are skipped)
+		__m128i NextUInt4();
+		__m128 NextFloat4();									// [0,1)
+		__m128 NextFloat4(__m128 minVal, __m128 maxVal);		// [min,max)
+
+		static void Philox(const uint32_t counter[4], const uint32_t key[2], uint32_t result[4]);
+
+	private:
+		void GenerateBlock(uint64_t blockIndex);
+		uint32_t m_key[2];
+		uint64_t m_streamId = 0;
+		uint64_t m_position = 0;		// values consumed
+		uint64_t m_bufferBlock = -1;	// block index currently in m_buffer
+		alignas(16) uint32_t m_buffer[4];
+	};
+}
@@ -6,10 +6,18 @@
 Command::Result EditorImportSceneCommand::Execute()
 {
 	SDE_PROF_EVENT();
+	if (m_loadStarted)
+	{
+		return m_loadResult;	// waiting until the scene has finished streaming in
+	}
 	std::string scenePath = Engine::ShowFilePicker("Import Scene", "", "Scene Files (.scn)\0*.scn\0");
 	if (scenePath != "")
 	{
-		return m_editor->ImportScene(scenePath.c_str(), m_makeNewWorld) ? Command::Result::Succeeded : Command::Result::Failed;
+		m_loadStarted = true;
+		m_editor->ImportSceneAsync(scenePath.c_str(), m_makeNewWorld, [this](bool success) {
+			m_loadResult = success ? Command::Result::Succeeded : Command::Result::Failed;
+		});
+		return Command::Result::Waiting;
 	}
 	return Command::Result::Failed;
 }
\ No newline at end of file
@@ -24,4 +24,6 @@ public:
 private:
 	Editor* m_editor = nullptr;
 	bool m_makeNewWorld = false;
+	bool m_loadStarted = false;
+	Result m_loadResult = Result::Waiting;
 };
\ No newline at end of file
@@ -155,6 +155,23 @@ bool Editor::ImportScene(const char* fileName, bool makeNewWorld)
 	return true;
 }
 
+void Editor::ImportSceneAsync(const char* fileName, bool makeNewWorld, std::function<void(bool)> onFinished)
+{
+	SDE_PROF_EVENT();
+
+	if (makeNewWorld)
+	{
+		m_entitySystem->NewWorld();
+		m_sceneFilepath = fileName;
+	}
+	auto readSceneName = [this](nlohmann::json& sceneJson) {
+		Engine::FromJson("SceneName", m_sceneName, sceneJson);
+	};
+	m_entitySystem->LoadSceneAsync(fileName, makeNewWorld, nullptr, [onFinished](bool success, std::vector<uint32_t>) {
+		onFinished(success);
+	}, readSceneName);		// restore the old ids if making a new world
+}
+
 bool Editor::SaveScene(const char* fileName)
 {
 	SDE_PROF_EVENT();
@@ -28,6 +28,7 @@ public:
 	void NewScene(const char* sceneName);
 	bool SaveScene(const char* fileName);
 	bool ImportScene(const char* fileName, bool makeNewWorld = false);
+	void ImportSceneAsync(const char* fileName, bool makeNewWorld, std::function<void(bool)> onFinished);	// entities are created over several frames
 
 	const std::vector<EntityHandle>& SelectedEntities() { return m_selectedEntities; }
 	void SelectEntity(const EntityHandle h);
@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cassert>
+#include <stdint.h>
+
+// Append-only array of asset descriptors that can be read from any thread without a lock
+// Elements live in fixed size chunks that never move, a new element is initialised before the count that exposes it is published
+// Add and Clear must be serialised by the owner (the asset managers call them with the registry mutex held)
+// Clear frees the chunks, nothing may be reading while it runs
+namespace Engine
+{
+	template<class T, uint32_t ChunkSize = 256, uint32_t MaxChunks = 1024>
+	class AssetArray
+	{
+	public:
+		static constexpr uint32_t c_maxCount = ChunkSize * MaxChunks;
+		AssetArray() = default;
+		AssetArray(const AssetArray&) = delete;
+		AssetArray& operator=(const AssetArray&) = delete;
+
+		uint32_t Size() const { return m_count.load(std::memory_order_acquire); }
+		T* TryGet(uint32_t index) const;		// nullptr if index was not added yet
+		T& operator[](uint32_t index) const;
+
+		// initFn(T&) fills in the new element before it is visible to readers, returns the new index
+		template<class InitFn>
+		uint32_t Add(InitFn&& initFn);
+		void Clear();
+
+	private:
+		std::unique_ptr<T[]> m_chunks[MaxChunks];
+		std::atomic<uint32_t> m_count = 0;
+	};
+
+	template<class T, uint32_t ChunkSize, uint32_t MaxChunks>
+	T* AssetArray<T, ChunkSize, MaxChunks>::TryGet(uint32_t index) const
+	{
+		if (index >= Size())
+		{
+			return nullptr;
+		}
+		return &m_chunks[index / ChunkSize][index % ChunkSize];
+	}
+
+	template<class T, uint32_t ChunkSize, uint32_t MaxChunks>
+	T& AssetArray<T, ChunkSize, MaxChunks>::operator[](uint32_t index) const
+	{
+		assert(index < Size());
+		return m_chunks[index / ChunkSize][index % ChunkSize];
+	}
+
+	template<class T, uint32_t ChunkSize, uint32_t MaxChunks>
+	template<class InitFn>
+	uint32_t AssetArray<T, ChunkSize, MaxChunks>::Add(InitFn&& initFn)
+	{
+		const uint32_t index = m_count.load(std::memory_order_relaxed);
+		assert(index < c_maxCount);
+		if (m_chunks[index / ChunkSize] == nullptr)
+		{
+			m_chunks[index / ChunkSize] = std::make_unique<T[]>(ChunkSize);
+		}
+		initFn(m_chunks[index / ChunkSize][index % ChunkSize]);
+		m_count.store(index + 1, std::memory_order_release);
+		return index;
+	}
+
+	template<class T, uint32_t ChunkSize, uint32_t MaxChunks>
+	void AssetArray<T, ChunkSize, MaxChunks>::Clear()
+	{
+		m_count.store(0, std::memory_order_release);
+		for (auto& chunk : m_chunks)
+		{
+			chunk = nullptr;
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#include "asset_registry.h"
+
+namespace Engine
+{
+	uint32_t AssetRegistry::Find(std::string_view path) const
+	{
+		Core::ScopedMutex guard(m_mutex);
+		auto found = m_pathToIndex.find(path);
+		return found != m_pathToIndex.end() ? found->second : c_invalidIndex;
+	}
+
+	void AssetRegistry::Add(std::string_view path, uint32_t index)
+	{
+		Core::ScopedMutex guard(m_mutex);
+		auto found = m_pathToIndex.find(path);
+		if (found != m_pathToIndex.end())
+		{
+			found->second = index;
+		}
+		else
+		{
+			m_pathToIndex.emplace(std::string(path), index);
+		}
+	}
+
+	void AssetRegistry::Clear()
+	{
+		Core::ScopedMutex guard(m_mutex);
+		m_pathToIndex.clear();
+	}
+
+	size_t AssetRegistry::Count() const
+	{
+		Core::ScopedMutex guard(m_mutex);
+		return m_pathToIndex.size();
+	}
+}
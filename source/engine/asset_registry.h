@@ -0,0 +1,58 @@
+#pragma once
+#include "core/mutex.h"
+#include <robin_hood.h>
+#include <string>
+#include <string_view>
+#include <stdint.h>
+
+// Hashed path -> handle index lookup shared by the asset managers, replaces linear searches over loaded assets
+// Each path string is stored once here. Lookups take a string_view so callers don't allocate
+// FindOrAdd is atomic, two threads asking for the same path get the same index and only one of them creates the asset
+namespace Engine
+{
+	class AssetRegistry
+	{
+	public:
+		static constexpr uint32_t c_invalidIndex = -1u;
+
+		uint32_t Find(std::string_view path) const;			// c_invalidIndex if not registered
+		void Add(std::string_view path, uint32_t index);	// replaces any existing entry
+		void Clear();
+		size_t Count() const;
+
+		// managers serialise adding assets and changing their state with this, addFn below runs while it is held
+		// lookups of existing assets (AssetArray) do not need it
+		// it is not recursive, never call into the registry while holding it
+		Core::Mutex& GetMutex() const { return m_mutex; }
+
+		// returns the existing index for path, or calls uint32_t addFn() while the registry is locked and registers the result
+		// wasAdded is true if addFn was called
+		template<class AddFn>
+		uint32_t FindOrAdd(std::string_view path, AddFn&& addFn, bool& wasAdded);
+
+	private:
+		struct PathHash
+		{
+			using is_transparent = void;
+			size_t operator()(std::string_view s) const { return robin_hood::hash_bytes(s.data(), s.size()); }
+		};
+		mutable Core::Mutex m_mutex;
+		robin_hood::unordered_map<std::string, uint32_t, PathHash, std::equal_to<>> m_pathToIndex;
+	};
+
+	template<class AddFn>
+	uint32_t AssetRegistry::FindOrAdd(std::string_view path, AddFn&& addFn, bool& wasAdded)
+	{
+		Core::ScopedMutex guard(m_mutex);
+		auto found = m_pathToIndex.find(path);
+		if (found != m_pathToIndex.end())
+		{
+			wasAdded = false;
+			return found->second;
+		}
+		const uint32_t newIndex = addFn();
+		m_pathToIndex.emplace(std::string(path), newIndex);
+		wasAdded = true;
+		return newIndex;
+	}
+}
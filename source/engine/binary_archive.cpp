@@ -0,0 +1,234 @@
+#include "serialisation.h"
+#include "core/string_hashing.h"
+#include <cstring>
+
+namespace Engine
+{
+	thread_local BinaryArchive* t_activeArchive = nullptr;
+	const uint32_t c_archiveHeaderSize = sizeof(uint32_t) * 2;		// magic, version
+	const uint32_t c_classNameHash = Core::StringHashing::GetHash("ClassName");
+
+	BinaryArchive::BindScope::BindScope(BinaryArchive* a)
+		: m_previous(t_activeArchive)
+	{
+		t_activeArchive = a;
+	}
+
+	BinaryArchive::BindScope::~BindScope()
+	{
+		t_activeArchive = m_previous;
+	}
+
+	BinaryArchive::BinaryArchive()
+	{
+		Reset();
+	}
+
+	BinaryArchive::BinaryArchive(const uint8_t* data, size_t size)
+	{
+		BeginReading(data, size);
+	}
+
+	void BinaryArchive::Reset()
+	{
+		m_data.clear();
+		m_writeStack.clear();
+		m_readStack.clear();
+		m_readData = nullptr;
+		m_readSize = 0;
+		m_isValid = true;
+		const uint32_t header[2] = { c_magic, c_version };
+		WriteBytes(header, sizeof(header));
+	}
+
+	void BinaryArchive::BeginReading()
+	{
+		assert(m_writeStack.size() == 0);
+		m_readData = m_data.data();
+		m_readSize = m_data.size();
+		m_readStack.clear();
+		m_readStack.push_back({ c_archiveHeaderSize, m_readSize, c_archiveHeaderSize });
+	}
+
+	void BinaryArchive::BeginReading(const uint8_t* data, size_t size)
+	{
+		m_readData = data;
+		m_readSize = size;
+		uint32_t header[2] = { 0, 0 };
+		if (size >= c_archiveHeaderSize)
+		{
+			memcpy(header, data, sizeof(header));
+		}
+		m_isValid = header[0] == c_magic && header[1] == c_version;
+		m_readStack.clear();
+		m_readStack.push_back({ c_archiveHeaderSize, m_isValid ? size : c_archiveHeaderSize, c_archiveHeaderSize });
+	}
+
+	BinaryArchive* BinaryArchive::Get(const nlohmann::json& json)
+	{
+		return (t_activeArchive != nullptr && &t_activeArchive->m_placeholder == &json) ? t_activeArchive : nullptr;
+	}
+
+	uint32_t BinaryArchive::HashName(const char* name)
+	{
+		return name != nullptr ? Core::StringHashing::GetHash(name) : 0;
+	}
+
+	void BinaryArchive::WriteBytes(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		m_data.insert(m_data.end(), bytes, bytes + size);
+	}
+
+	void BinaryArchive::BeginWriteField(const char* name)
+	{
+		const uint32_t field[2] = { HashName(name), 0 };
+		WriteBytes(field, sizeof(field));
+		m_writeStack.push_back(m_data.size() - sizeof(uint32_t));
+	}
+
+	void BinaryArchive::EndWriteField()
+	{
+		assert(m_writeStack.size() > 0);
+		const size_t sizeOffset = m_writeStack.back();
+		m_writeStack.pop_back();
+		const uint32_t payloadSize = (uint32_t)(m_data.size() - sizeOffset - sizeof(uint32_t));
+		memcpy(m_data.data() + sizeOffset, &payloadSize, sizeof(payloadSize));
+	}
+
+	void BinaryArchive::WriteClassName(const char* className)
+	{
+		if (m_classNameDepth == m_writeStack.size())
+		{
+			Write("ClassName", className);
+		}
+	}
+
+	bool BinaryArchive::BeginReadField(const char* name)
+	{
+		if (m_readStack.size() == 0)
+		{
+			return false;
+		}
+		ReadScope& scope = m_readStack.back();
+		const uint32_t nameHash = HashName(name);
+		auto tryEnter = [&](size_t fieldOffset) {
+			if (fieldOffset + c_fieldHeaderSize > scope.m_end)
+			{
+				return false;
+			}
+			uint32_t field[2];
+			memcpy(field, m_readData + fieldOffset, sizeof(field));
+			const size_t payloadBegin = fieldOffset + c_fieldHeaderSize;
+			if (field[0] != nameHash)
+			{
+				return false;
+			}
+			if (field[1] > scope.m_end - payloadBegin)
+			{
+				m_isValid = false;		// truncated or corrupt
+				return false;
+			}
+			scope.m_cursor = payloadBegin + field[1];
+			m_readStack.push_back({ payloadBegin, scope.m_cursor, payloadBegin });
+			return true;
+		};
+
+		// fields are usually read in the order they were written
+		if (tryEnter(scope.m_cursor))
+		{
+			return true;
+		}
+		if (name == nullptr)
+		{
+			return false;
+		}
+
+		// otherwise search the whole object
+		size_t offset = scope.m_begin;
+		while (offset + c_fieldHeaderSize <= scope.m_end)
+		{
+			if (tryEnter(offset))
+			{
+				return true;
+			}
+			uint32_t payloadSize = 0;
+			memcpy(&payloadSize, m_readData + offset + sizeof(uint32_t), sizeof(payloadSize));
+			offset += c_fieldHeaderSize + payloadSize;
+		}
+		return false;
+	}
+
+	void BinaryArchive::EndReadField()
+	{
+		assert(m_readStack.size() > 1);
+		m_readStack.pop_back();
+	}
+
+	bool BinaryArchive::FindLastField(uint32_t nameHash, size_t& payloadBegin, size_t& payloadEnd) const
+	{
+		const ReadScope& scope = m_readStack.back();
+		bool found = false;
+		size_t offset = scope.m_begin;
+		while (offset + c_fieldHeaderSize <= scope.m_end)
+		{
+			uint32_t field[2];
+			memcpy(field, m_readData + offset, sizeof(field));
+			const size_t begin = offset + c_fieldHeaderSize;
+			if (field[1] > scope.m_end - begin)
+			{
+				break;
+			}
+			if (field[0] == nameHash)
+			{
+				payloadBegin = begin;
+				payloadEnd = begin + field[1];
+				found = true;
+			}
+			offset = begin + field[1];
+		}
+		return found;
+	}
+
+	// derived classes write their name after their parents, so the last one wins
+	bool BinaryArchive::ReadClassName(std::string& className)
+	{
+		size_t begin = 0, end = 0;
+		if (m_readStack.size() == 0 || !FindLastField(c_classNameHash, begin, end))
+		{
+			return false;
+		}
+		className.assign(reinterpret_cast<const char*>(m_readData + begin), end - begin);
+		return true;
+	}
+
+	size_t BinaryArchive::ReadRemaining() const
+	{
+		const ReadScope& scope = m_readStack.back();
+		return scope.m_end - scope.m_cursor;
+	}
+
+	const uint8_t* BinaryArchive::ReadPtr() const
+	{
+		return m_readData + m_readStack.back().m_cursor;
+	}
+
+	void BinaryArchive::SkipBytes(size_t size)
+	{
+		ReadScope& scope = m_readStack.back();
+		scope.m_cursor = std::min(scope.m_cursor + size, scope.m_end);
+	}
+
+	bool BinaryArchive::ReadBytes(void* data, size_t size)
+	{
+		if (m_readStack.size() == 0 || ReadRemaining() < size)
+		{
+			memset(data, 0, size);
+			m_isValid = false;
+			return false;
+		}
+		memcpy(data, ReadPtr(), size);
+		SkipBytes(size);
+		return true;
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <nlohmann/json.hpp>
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+namespace Engine
+{
+	enum class SerialiseType;
+
+	// Compact binary alternative to json for anything with a Serialise function
+	// Values are written as tagged fields (name hash, payload size, payload), objects are nested lists of fields
+	// Readers look fields up by name, so reordered or unknown fields are skipped and missing ones leave values untouched
+	// Serialise functions still take a json reference, when it is the archive placeholder the ToJson/FromJson helpers
+	// (and so the SERIALISE_PROPERTY macros) read and write the archive instead of building json
+	class BinaryArchive
+	{
+	public:
+		static constexpr uint32_t c_magic = 0x4e494253;		// 'SBIN'
+		static constexpr uint32_t c_version = 1;			// bump when the field encoding changes
+		static constexpr uint32_t c_fieldHeaderSize = sizeof(uint32_t) * 2;		// name hash, payload size
+
+		BinaryArchive();										// empty archive for writing
+		BinaryArchive(const uint8_t* data, size_t size);		// reads from data, which must outlive the archive
+		BinaryArchive(const BinaryArchive&) = delete;
+		BinaryArchive& operator=(const BinaryArchive&) = delete;
+
+		void Reset();											// back to an empty archive for writing, storage is kept
+		void BeginReading();									// read back what was written
+		void BeginReading(const uint8_t* data, size_t size);	// read from data instead, which must outlive the reads
+		bool IsValid() const { return m_isValid; }				// false if the header is wrong or a read ran off the end of a field
+		const std::vector<uint8_t>& Data() const { return m_data; }
+
+		// returns the archive if json is its placeholder, i.e. we are inside a Serialise call made by the archive
+		static BinaryArchive* Get(const nlohmann::json& json);
+
+		// named values in the current object (name = nullptr for array elements)
+		template<class T> void Write(const char* name, T& v);
+		template<class T> bool Read(const char* name, T& v);		// false if there is no field with this name
+
+		// values stored directly in the current field
+		template<class T> void WriteValue(T& v);
+		template<class T> void ReadValue(T& v);
+
+		// fields can be used directly to build nested objects and lists
+		void BeginWriteField(const char* name);
+		void EndWriteField();
+		bool BeginReadField(const char* name);		// array elements are read in order, named fields are searched for
+		void EndReadField();
+
+		template<class Map> void SerialiseMap(const char* name, Map& m, SerialiseType op);	// robin hood maps
+		void WriteClassName(const char* className);		// called from SERIALISE_END
+
+	private:
+		struct ReadScope
+		{
+			size_t m_begin;
+			size_t m_end;
+			size_t m_cursor;
+		};
+		class BindScope		// makes this the active archive while Serialise functions run
+		{
+		public:
+			BindScope(BinaryArchive* a);
+			~BindScope();
+		private:
+			BinaryArchive* m_previous;
+		};
+		static uint32_t HashName(const char* name);
+		void WriteBytes(const void* data, size_t size);
+		bool ReadBytes(void* data, size_t size);
+		size_t ReadRemaining() const;
+		const uint8_t* ReadPtr() const;
+		void SkipBytes(size_t size);
+		bool FindLastField(uint32_t nameHash, size_t& payloadBegin, size_t& payloadEnd) const;
+		bool ReadClassName(std::string& className);
+
+		nlohmann::json m_placeholder;				// passed to Serialise functions, never written to
+		std::vector<uint8_t> m_data;				// written data
+		std::vector<size_t> m_writeStack;			// offsets of the size of each open field
+		const uint8_t* m_readData = nullptr;
+		size_t m_readSize = 0;
+		std::vector<ReadScope> m_readStack;
+		size_t m_classNameDepth = (size_t)-1;		// class names are only written for objects behind pointers (at this depth)
+		bool m_isValid = true;
+	};
+}
@@ -0,0 +1,229 @@
+#include <memory>
+#include <type_traits>
+
+namespace Engine
+{
+	namespace Serialisation
+	{
+		template<class T> struct IsVector : std::false_type {};
+		template<class T, class A> struct IsVector<std::vector<T, A>> : std::true_type {};
+		template<class T> struct IsUniquePtr : std::false_type {};
+		template<class T, class D> struct IsUniquePtr<std::unique_ptr<T, D>> : std::true_type {};
+		template<class T> struct IsSharedPtr : std::false_type {};
+		template<class T> struct IsSharedPtr<std::shared_ptr<T>> : std::true_type {};
+
+		// types that are stored as their raw bytes
+		template<class T> struct IsRawBinary
+		{
+			static constexpr bool value = std::is_arithmetic<T>::value || std::is_enum<T>::value ||
+				std::is_same<T, glm::vec2>::value || std::is_same<T, glm::vec3>::value || std::is_same<T, glm::vec4>::value ||
+				std::is_same<T, glm::ivec2>::value || std::is_same<T, glm::ivec3>::value || std::is_same<T, glm::quat>::value ||
+				std::is_same<T, glm::mat3>::value || std::is_same<T, glm::mat4>::value;
+		};
+	}
+
+	template<class T>
+	void BinaryArchive::Write(const char* name, T& v)
+	{
+		BeginWriteField(name);
+		WriteValue(v);
+		EndWriteField();
+	}
+
+	template<class T>
+	bool BinaryArchive::Read(const char* name, T& v)
+	{
+		if (!BeginReadField(name))
+		{
+			return false;
+		}
+		ReadValue(v);
+		EndReadField();
+		return true;
+	}
+
+	template<class T>
+	void BinaryArchive::WriteValue(T& v)
+	{
+		using Type = typename std::remove_const<T>::type;
+		if constexpr (Serialisation::HasSerialiser<Type>::value)
+		{
+			BindScope bind(this);
+			const_cast<Type&>(v).Serialise(m_placeholder, SerialiseType::Write);
+		}
+		else if constexpr (Serialisation::IsRawBinary<Type>::value)
+		{
+			WriteBytes(&v, sizeof(v));
+		}
+		else if constexpr (std::is_same<Type, std::string>::value)
+		{
+			WriteBytes(v.data(), v.size());
+		}
+		else if constexpr (std::is_same<Type, const char*>::value || std::is_same<Type, char*>::value)
+		{
+			WriteBytes(v, strlen(v));
+		}
+		else if constexpr (Serialisation::IsVector<Type>::value)
+		{
+			using ElementType = typename Type::value_type;
+			const uint32_t count = (uint32_t)v.size();
+			WriteBytes(&count, sizeof(count));
+			if constexpr (Serialisation::IsRawBinary<ElementType>::value && !std::is_same<ElementType, bool>::value)
+			{
+				WriteBytes(v.data(), v.size() * sizeof(ElementType));
+			}
+			else
+			{
+				for (auto& it : v)
+				{
+					BeginWriteField(nullptr);
+					WriteValue(it);
+					EndWriteField();
+				}
+			}
+		}
+		else if constexpr (Serialisation::IsUniquePtr<Type>::value || Serialisation::IsSharedPtr<Type>::value)
+		{
+			const uint8_t isSet = v != nullptr ? 1 : 0;
+			WriteBytes(&isSet, sizeof(isSet));
+			if (isSet)
+			{
+				const size_t previousDepth = m_classNameDepth;
+				m_classNameDepth = m_writeStack.size();		// the class name is needed to recreate the object
+				WriteValue(*v);
+				m_classNameDepth = previousDepth;
+			}
+		}
+		else
+		{
+			// anything else goes via json, slow but handles everything the json path does
+			nlohmann::json j = v;
+			const auto packed = nlohmann::json::to_msgpack(j);
+			WriteBytes(packed.data(), packed.size());
+		}
+	}
+
+	template<class T>
+	void BinaryArchive::ReadValue(T& v)
+	{
+		if constexpr (Serialisation::HasSerialiser<T>::value)
+		{
+			BindScope bind(this);
+			v.Serialise(m_placeholder, SerialiseType::Read);
+		}
+		else if constexpr (Serialisation::IsRawBinary<T>::value)
+		{
+			ReadBytes(&v, sizeof(v));
+		}
+		else if constexpr (std::is_same<T, std::string>::value)
+		{
+			v.assign(reinterpret_cast<const char*>(ReadPtr()), ReadRemaining());
+			SkipBytes(ReadRemaining());
+		}
+		else if constexpr (Serialisation::IsVector<T>::value)
+		{
+			// appends like FromJson does
+			using ElementType = typename T::value_type;
+			uint32_t count = 0;
+			if (!ReadBytes(&count, sizeof(count)))
+			{
+				return;
+			}
+			if constexpr (Serialisation::IsRawBinary<ElementType>::value && !std::is_same<ElementType, bool>::value)
+			{
+				const size_t firstNew = v.size();
+				if ((size_t)count * sizeof(ElementType) <= ReadRemaining())
+				{
+					v.resize(firstNew + count);
+					ReadBytes(v.data() + firstNew, (size_t)count * sizeof(ElementType));
+				}
+				else
+				{
+					m_isValid = false;
+				}
+			}
+			else
+			{
+				// every element is at least a field header, a count that can't fit is corrupt and must not drive the reserve
+				if ((size_t)count * c_fieldHeaderSize > ReadRemaining())
+				{
+					m_isValid = false;
+					return;
+				}
+				v.reserve(v.size() + count);
+				while (BeginReadField(nullptr))
+				{
+					ElementType newVal;
+					ReadValue(newVal);
+					v.push_back(std::move(newVal));
+					EndReadField();
+				}
+			}
+		}
+		else if constexpr (Serialisation::IsUniquePtr<T>::value || Serialisation::IsSharedPtr<T>::value)
+		{
+			using ElementType = typename T::element_type;
+			uint8_t isSet = 0;
+			ReadBytes(&isSet, sizeof(isSet));
+			v.reset();
+			if (isSet && m_readStack.size() > 0)
+			{
+				m_readStack.back().m_begin = m_readStack.back().m_cursor;	// the object fields start after the flag
+				if constexpr (Serialisation::HasSerialiser<ElementType>::value)
+				{
+					std::string className;
+					if (ReadClassName(className))
+					{
+						ElementType* object = Serialisation::ObjectFactory<ElementType>::CreateObject(className);
+						ReadValue(*object);
+						v.reset(object);
+					}
+				}
+				else
+				{
+					v.reset(new ElementType());
+					ReadValue(*v);
+				}
+			}
+		}
+		else
+		{
+			nlohmann::json j = nlohmann::json::from_msgpack(ReadPtr(), ReadPtr() + ReadRemaining(), true, false);
+			SkipBytes(ReadRemaining());
+			if (!j.is_discarded())
+			{
+				v = j;
+			}
+		}
+	}
+
+	template<class Map>
+	void BinaryArchive::SerialiseMap(const char* name, Map& m, SerialiseType op)
+	{
+		if (op == SerialiseType::Write)
+		{
+			BeginWriteField(name);
+			for (auto& it : m)
+			{
+				BeginWriteField(nullptr);
+				Write(nullptr, it.first);
+				Write(nullptr, it.second);
+				EndWriteField();
+			}
+			EndWriteField();
+		}
+		else if (BeginReadField(name))
+		{
+			while (BeginReadField(nullptr))
+			{
+				typename Map::key_type key;
+				typename Map::mapped_type value;
+				Read(nullptr, key);
+				Read(nullptr, value);
+				m[key] = std::move(value);
+				EndReadField();
+			}
+			EndReadField();
+		}
+	}
+}
@@ -73,8 +73,27 @@ namespace Engine
 		// get global gravity value from world
 		glm::vec3 gravity = physics->GetGlobalGravity();
 		
+		// sweep every falling controller in one batch first
 		static auto s_it = world->MakeIterator<CharacterController, Transform>();
-		s_it.ForEach([this, graphics, physics, timeDelta, gravity](CharacterController& c, Transform& t, EntityHandle e) {
+		m_sweeps.clear();
+		m_sweepIndices.clear();
+		s_it.ForEach([this, timeDelta](CharacterController& c, Transform& t, EntityHandle e) {
+			if (!c.GetEnabled() || c.GetCurrentVelocity().y >= 0.0f)
+			{
+				m_sweepIndices.push_back(-1);
+				return;
+			}
+			glm::mat4 matrix = glm::translate(glm::identity<glm::mat4>(), t.GetPosition() + glm::vec3(0.0f, c.GetVerticalOffset(), 0.0f));
+			matrix = matrix * glm::toMat4(t.GetOrientation());
+			const glm::vec3 worldSpacePos = glm::vec3(matrix[3]);
+			m_sweepIndices.push_back((int32_t)m_sweeps.size());
+			m_sweeps.push_back({ c.GetRadius(), c.GetHalfHeight(), worldSpacePos, t.GetOrientation(), { 0.0f,-1.0f,0.0f }, -c.GetCurrentVelocity().y * timeDelta, e });
+		});
+		physics->SweepCapsuleBatch(m_sweeps.data(), (uint32_t)m_sweeps.size(), m_sweepResults);
+
+		int32_t controllerIndex = 0;
+		s_it.ForEach([this, graphics, physics, timeDelta, gravity, &controllerIndex](CharacterController& c, Transform& t, EntityHandle e) {
+			const int32_t sweepIndex = m_sweepIndices[controllerIndex++];
 			if (!c.GetEnabled())
 			{
 				return;
@@ -86,12 +105,13 @@ namespace Engine
 			glm::vec3 newPosition = t.GetPosition();
 			glm::vec3 currentVelocity = c.GetCurrentVelocity();
 			glm::vec3 up(0.0f, 1.0f, 0.0f);
-			if (currentVelocity.y < 0.0f)	// falling?
+			if (sweepIndex != -1)	// falling?
 			{
-				glm::vec3 hitPos, hitNormal;
-				float hitDepth;
-				EntityHandle hitEntity;
-				bool hit = physics->SweepCapsule(c.GetRadius(), c.GetHalfHeight(), worldSpacePos, t.GetOrientation(), { 0.0f,-1.0f,0.0f }, -currentVelocity.y * timeDelta, hitPos, hitNormal, hitDepth, hitEntity, e);
+				const glm::vec3 hitPos = m_sweepResults.m_hitPos[sweepIndex];
+				const glm::vec3 hitNormal = m_sweepResults.m_hitNormal[sweepIndex];
+				const float hitDepth = m_sweepResults.m_hitDistance[sweepIndex];
+				const EntityHandle hitEntity = m_sweepResults.m_hitEntity[sweepIndex];
+				const bool hit = m_sweepResults.m_hit[sweepIndex] != 0;
 				if (hit && hitEntity.GetID() != e.GetID())
 				{
 					capsuleColour = { 0.0f,0.5f,0.5f,1.0f };
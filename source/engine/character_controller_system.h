@@ -2,6 +2,8 @@
 #include "engine/system.h"
 #include "entity/entity_handle.h"
 #include "core/glm_headers.h"
+#include "engine/physics_system.h"
+#include <vector>
 
 namespace Engine
 {
@@ -18,5 +20,8 @@ namespace Engine
 		void RegisterScripts();
 		void RegisterComponents();
 		bool m_enableDebug = false;
+		std::vector<PhysicsSystem::CapsuleSweep> m_sweeps;		// one per falling controller
+		std::vector<int32_t> m_sweepIndices;					// per controller in iteration order, -1 if not swept
+		PhysicsSystem::SweepBatchResults m_sweepResults;
 	};
 }
\ No newline at end of file
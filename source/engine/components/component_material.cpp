@@ -24,6 +24,37 @@ if (op == Engine::SerialiseType::Write)
 	bool isTransparent = m_material->GetIsTransparent();
 	Engine::ToJson("IsTransparent", isTransparent, json);
 	
+	if (auto archive = Engine::BinaryArchive::Get(json))
+	{
+		auto writeUniforms = [archive](const char* name, auto& uniforms) {
+			archive->BeginWriteField(name);
+			for (auto& v : uniforms)
+			{
+				archive->BeginWriteField(nullptr);
+				archive->Write("Name", v.second.m_name);
+				archive->Write("Value", v.second.m_value);
+				archive->EndWriteField();
+			}
+			archive->EndWriteField();
+		};
+		writeUniforms("Float", m_material->GetUniforms().FloatValues());
+		writeUniforms("Vec4", m_material->GetUniforms().Vec4Values());
+		writeUniforms("Mat4", m_material->GetUniforms().Mat4Values());
+		writeUniforms("Int", m_material->GetUniforms().IntValues());
+
+		archive->BeginWriteField("Samplers");
+		for (const auto& sampler : m_material->GetSamplers())
+		{
+			archive->BeginWriteField(nullptr);
+			archive->Write("Name", sampler.second.m_name);
+			Engine::TextureHandle texHandle{ sampler.second.m_handle };
+			archive->Write("Texture", texHandle);
+			archive->EndWriteField();
+		}
+		archive->EndWriteField();
+		return;
+	}
+
 	auto writeUniformsToJson = [](const char* name, nlohmann::json& target, auto& uniforms) {
 		std::vector<nlohmann::json> uniformsJson;
 		uniformsJson.reserve(uniforms.size());
@@ -60,6 +91,43 @@ else
 	SetCastShadows(castShadow);
 	SetIsTransparent(isTransparent);
 
+	if (auto archive = Engine::BinaryArchive::Get(json))
+	{
+		auto readUniforms = [this, archive](const char* name, auto& uniforms) {
+			if (archive->BeginReadField(name))
+			{
+				while (archive->BeginReadField(nullptr))
+				{
+					typename std::decay<decltype(uniforms)>::type::mapped_type newUniform;
+					archive->Read("Name", newUniform.m_name);
+					archive->Read("Value", newUniform.m_value);
+					m_material->GetUniforms().SetValue(newUniform.m_name, newUniform.m_value);
+					archive->EndReadField();
+				}
+				archive->EndReadField();
+			}
+		};
+		readUniforms("Float", m_material->GetUniforms().FloatValues());
+		readUniforms("Vec4", m_material->GetUniforms().Vec4Values());
+		readUniforms("Mat4", m_material->GetUniforms().Mat4Values());
+		readUniforms("Int", m_material->GetUniforms().IntValues());
+
+		if (archive->BeginReadField("Samplers"))
+		{
+			while (archive->BeginReadField(nullptr))
+			{
+				std::string samplerName = "";
+				Engine::TextureHandle texture;
+				archive->Read("Name", samplerName);
+				archive->Read("Texture", texture);
+				SetSampler(samplerName.c_str(), texture);
+				archive->EndReadField();
+			}
+			archive->EndReadField();
+		}
+		return;
+	}
+
 	auto readUniforms = [this](const char* name, nlohmann::json& src, auto& uniforms)
 	{
 		nlohmann::json& uniformsJson = src[name];
@@ -2,6 +2,7 @@
 #include "engine/sdf_mesh_octree.h"
 #include "engine/debug_gui_system.h"
 #include "render/mesh.h"
+#include "core/log.h"
 
 COMPONENT_SCRIPTS(SDFMesh,
 	"SetBounds", &SDFMesh::SetBounds,
@@ -9,9 +10,12 @@ COMPONENT_SCRIPTS(SDFMesh,
 	"SetRenderShader", &SDFMesh::SetRenderShader,
 	"SetSDFShaderPath", &SDFMesh::SetSDFShaderPath,
 	"Remesh", &SDFMesh::Remesh,
+	"RemeshRegion", &SDFMesh::RemeshRegion,
 	"SetMaterialEntity", &SDFMesh::SetMaterialEntity,
 	"SetOctreeDepth", &SDFMesh::SetOctreeDepth,
-	"SetLOD", &SDFMesh::SetLOD
+	"SetLOD", &SDFMesh::SetLOD,
+	"SetUseCPUBackend", &SDFMesh::SetUseCPUBackend,
+	"SetSampleFunction", &SDFMesh::SetSampleScriptFunction
 )
 
 SERIALISE_BEGIN(SDFMesh)
@@ -44,6 +48,14 @@ COMPONENT_INSPECTOR_IMPL(SDFMesh, Engine::DebugGuiSystem& gui)
 		{
 			m.SetOctreeDepth(d);
 		}
+		if (m.GetSampleFunction() != nullptr)
+		{
+			bool useCPU = gui.Checkbox("Use CPU Backend", m.GetBackend() == SDFMesh::Backend::CPU);
+			if (useCPU != (m.GetBackend() == SDFMesh::Backend::CPU))
+			{
+				m.SetUseCPUBackend(useCPU);
+			}
+		}
 		if (gui.Button("Remesh Now"))
 		{
 			m.Remesh(true);
@@ -96,6 +108,46 @@ void SDFMesh::Remesh(bool destroyAll)
 	m_octree->Invalidate(destroyAll);
 }
 
+void SDFMesh::RemeshRegion(glm::vec3 regionMin, glm::vec3 regionMax)
+{
+	// nodes sample past their bounds, so edits near the edges also touch neighbours
+	const float padding = (float)c_extraSampleLayers / (float)glm::compMin(m_meshResolution);
+	m_octree->InvalidateRegion(regionMin, regionMax, padding);
+}
+
+void SDFMesh::SetSampleFunction(Engine::SDF::SampleFn fn)
+{
+	m_sampleFunction = fn;
+	m_batchSampleFunction = fn != nullptr ? Engine::SDF::MakeBatchSampleFn(fn) : nullptr;	// a custom batch function can be set afterwards
+	m_sampleFunctionIsScript = false;
+	m_octree->Invalidate();
+}
+
+void SDFMesh::SetSampleScriptFunction(sol::protected_function fn)
+{
+	auto wrappedFn = [fn](float x, float y, float z) -> std::tuple<float, int> {
+		sol::protected_function_result result = fn(x, y, z);
+		if (!result.valid())
+		{
+			SDE_LOG("Failed to call sample function");
+			return { 1.0f, 0 };
+		}
+		std::tuple<float, int> r = result;
+		return r;
+	};
+	SetSampleFunction(std::move(wrappedFn));
+	m_sampleFunctionIsScript = true;	// no lua in jobs!
+}
+
+void SDFMesh::SetBackend(Backend b)
+{
+	if (b != m_backend)
+	{
+		m_backend = b;
+		m_octree->Invalidate();
+	}
+}
+
 void SDFMesh::SetOctreeDepth(uint32_t d)
 {
 	assert(d < 9);
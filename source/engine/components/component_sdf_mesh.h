@@ -4,6 +4,7 @@
 #include "entity/entity_handle.h"
 #include "core/glm_headers.h"
 #include "engine/shader_manager.h"
+#include "engine/sdf.h"
 #include <functional>
 
 namespace Render
@@ -22,7 +23,11 @@ public:
 	COMPONENT(SDFMesh);
 	COMPONENT_INSPECTOR(Engine::DebugGuiSystem& gui);
 
+	// extra samples around each node so meshes can have seamless edges
+	static constexpr uint32_t c_extraSampleLayers = 4;
+
 	void Remesh(bool destroyAll=false);
+	void RemeshRegion(glm::vec3 regionMin, glm::vec3 regionMax);	// only rebuilds nodes touching the region
 	Engine::SDFMeshOctree& GetOctree() { return *m_octree; }
 
 	// note that uniforms from materials will be sent to the SDF shader!
@@ -40,11 +45,32 @@ public:
 	uint32_t GetOctreeDepth() { return m_octreeDepth; }
 	void SetOctreeDepth(uint32_t d);
 
+	// meshes are built via compute by default, the cpu backend uses the sample function on jobs instead
+	// if compute is unavailable, meshes with a sample function will fall back to the cpu
+	enum class Backend
+	{
+		Compute,
+		CPU
+	};
+	void SetBackend(Backend b);
+	Backend GetBackend() const { return m_backend; }
+	void SetUseCPUBackend(bool useCPU) { SetBackend(useCPU ? Backend::CPU : Backend::Compute); }
+	void SetSampleFunction(Engine::SDF::SampleFn fn);
+	void SetSampleScriptFunction(sol::protected_function fn);		// lua functions are sampled on the main thread
+	bool IsSampleFunctionScript() const { return m_sampleFunctionIsScript; }
+	const Engine::SDF::SampleFn& GetSampleFunction() const { return m_sampleFunction; }
+	void SetBatchSampleFunction(Engine::SDF::BatchSampleFn fn) { m_batchSampleFunction = fn; }	// optional simd version used by raycasts
+	const Engine::SDF::BatchSampleFn& GetBatchSampleFunction() const { return m_batchSampleFunction; }
+
 	using LODData = std::tuple<uint32_t, float>;	// depth, max distance
 	std::vector<LODData>& GetLODs() { return m_lods; }
 	void SetLOD(uint32_t depth, float distance);
 
 private:
+	Backend m_backend = Backend::Compute;
+	Engine::SDF::SampleFn m_sampleFunction;
+	Engine::SDF::BatchSampleFn m_batchSampleFunction;
+	bool m_sampleFunctionIsScript = false;
 	std::vector<LODData> m_lods;
 	std::unique_ptr<Engine::SDFMeshOctree> m_octree;
 	EntityHandle m_materialEntity;
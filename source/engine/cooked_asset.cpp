@@ -0,0 +1,70 @@
+#include "cooked_asset.h"
+#include "core/file_io.h"
+#include "core/profiler.h"
+#include <filesystem>
+#include <atomic>
+
+namespace Engine
+{
+	const char* c_cookedDirectory = "cooked";
+
+	bool GetCookedSourceInfo(const std::string& sourcePath, CookedSourceInfo& info)
+	{
+		std::error_code ec;
+		const auto timestamp = std::filesystem::last_write_time(sourcePath, ec);
+		if (ec)
+		{
+			return false;
+		}
+		const auto size = std::filesystem::file_size(sourcePath, ec);
+		if (ec)
+		{
+			return false;
+		}
+		info.m_timestamp = (uint64_t)timestamp.time_since_epoch().count();
+		info.m_size = (uint64_t)size;
+		return true;
+	}
+
+	std::string GetCookedPath(const std::string& sourcePath, const char* extension)
+	{
+		// drop drive letters, roots and '..' so every source maps to somewhere inside the cooked directory
+		std::filesystem::path cookedPath(c_cookedDirectory);
+		for (const auto& part : std::filesystem::path(sourcePath).lexically_normal().relative_path())
+		{
+			if (part != ".." && part != ".")
+			{
+				cookedPath /= part;
+			}
+		}
+		return cookedPath.u8string() + extension;
+	}
+
+	bool IsCookedPath(const std::string& path)
+	{
+		const auto normalPath = std::filesystem::path(path).lexically_normal();
+		return normalPath.begin() != normalPath.end() && *normalPath.begin() == c_cookedDirectory;
+	}
+
+	bool SaveCookedFile(const std::string& cookedPath, const std::vector<uint8_t>& data)
+	{
+		SDE_PROF_EVENT();
+
+		static std::atomic<uint32_t> s_tempFileCounter = 0;
+		std::error_code ec;
+		const std::filesystem::path path(cookedPath);
+		std::filesystem::create_directories(path.parent_path(), ec);
+		const std::string tempPath = cookedPath + ".tmp" + std::to_string(s_tempFileCounter++);
+		if (!Core::SaveBinaryFile(tempPath, data))
+		{
+			return false;
+		}
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+// Helpers for cooked (preprocessed) versions of source assets, stored under a cache directory mirroring the source paths
+// Cooked files record the timestamp and size of the source they were built from, a mismatch means the source changed
+namespace Engine
+{
+	struct CookedSourceInfo
+	{
+		uint64_t m_timestamp = 0;
+		uint64_t m_size = 0;
+		bool operator==(const CookedSourceInfo& o) const { return m_timestamp == o.m_timestamp && m_size == o.m_size; }
+		bool operator!=(const CookedSourceInfo& o) const { return !(*this == o); }
+	};
+
+	bool GetCookedSourceInfo(const std::string& sourcePath, CookedSourceInfo& info);		// false if the source does not exist
+	std::string GetCookedPath(const std::string& sourcePath, const char* extension);		// cooked/<source path><extension>
+	bool IsCookedPath(const std::string& path);		// true for anything inside the cooked directory
+	bool SaveCookedFile(const std::string& cookedPath, const std::vector<uint8_t>& data);	// writes a temp file then renames, so readers never see partial files
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "cooked_model.h"
+#include "model_asset.h"
+#include "core/mapped_file.h"
+#include "core/profiler.h"
+#include "core/log.h"
+#include <cstring>
+
+namespace Engine
+{
+	namespace Assets
+	{
+		const uint64_t c_blobAlignment = 16;
+
+		static uint64_t AlignOffset(uint64_t offset)
+		{
+			return (offset + c_blobAlignment - 1) & ~(c_blobAlignment - 1);
+		}
+
+		bool SaveCookedModel(const Model& model, const std::string& cookedPath, const CookedSourceInfo& source)
+		{
+			SDE_PROF_EVENT();
+
+			CookedModelHeader header;
+			header.m_source = source;
+			header.m_meshCount = (uint32_t)model.Meshes().size();
+			header.m_vertexCount = 0;
+			header.m_indexCount = 0;
+			header.m_texturePathCount = 0;
+
+			std::vector<CookedMesh> meshes(header.m_meshCount);
+			std::vector<uint32_t> texturePathOffsets;
+			std::string strings;
+			auto addPaths = [&](const std::vector<std::string>& paths) {
+				for (const auto& p : paths)
+				{
+					texturePathOffsets.push_back((uint32_t)strings.size());
+					strings.append(p.c_str(), p.size() + 1);
+				}
+				return (uint32_t)paths.size();
+			};
+			for (uint32_t m = 0; m < header.m_meshCount; ++m)
+			{
+				const auto& src = model.Meshes()[m];
+				const auto& mat = src.Material();
+				auto& dst = meshes[m];
+				memcpy(dst.m_transform, glm::value_ptr(src.Transform()), sizeof(dst.m_transform));
+				memcpy(dst.m_boundsMin, glm::value_ptr(src.BoundsMin()), sizeof(dst.m_boundsMin));
+				memcpy(dst.m_boundsMax, glm::value_ptr(src.BoundsMax()), sizeof(dst.m_boundsMax));
+				dst.m_firstVertex = header.m_vertexCount;
+				dst.m_vertexCount = src.VertexCount();
+				dst.m_firstIndex = header.m_indexCount;
+				dst.m_indexCount = src.IndexCount();
+				const glm::vec3 diffuse = mat.DiffuseColour(), ambient = mat.AmbientColour(), specular = mat.SpecularColour();
+				memcpy(dst.m_diffuseColour, glm::value_ptr(diffuse), sizeof(dst.m_diffuseColour));
+				memcpy(dst.m_ambientColour, glm::value_ptr(ambient), sizeof(dst.m_ambientColour));
+				memcpy(dst.m_specularColour, glm::value_ptr(specular), sizeof(dst.m_specularColour));
+				dst.m_shininess = mat.Shininess();
+				dst.m_shininessStrength = mat.ShininessStrength();
+				dst.m_opacity = mat.Opacity();
+				dst.m_firstTexturePath = (uint32_t)texturePathOffsets.size();
+				dst.m_diffuseMapCount = addPaths(mat.DiffuseMaps());
+				dst.m_normalMapCount = addPaths(mat.NormalMaps());
+				dst.m_specularMapCount = addPaths(mat.SpecularMaps());
+				header.m_vertexCount += dst.m_vertexCount;
+				header.m_indexCount += dst.m_indexCount;
+			}
+			header.m_texturePathCount = (uint32_t)texturePathOffsets.size();
+
+			header.m_meshesOffset = AlignOffset(sizeof(CookedModelHeader));
+			header.m_texturePathsOffset = AlignOffset(header.m_meshesOffset + meshes.size() * sizeof(CookedMesh));
+			header.m_verticesOffset = AlignOffset(header.m_texturePathsOffset + texturePathOffsets.size() * sizeof(uint32_t));
+			header.m_indicesOffset = AlignOffset(header.m_verticesOffset + (uint64_t)header.m_vertexCount * sizeof(MeshVertex));
+			header.m_stringsOffset = AlignOffset(header.m_indicesOffset + (uint64_t)header.m_indexCount * sizeof(uint32_t));
+			header.m_fileSize = header.m_stringsOffset + strings.size();
+
+			std::vector<uint8_t> data(header.m_fileSize, 0);
+			memcpy(data.data(), &header, sizeof(header));
+			if (meshes.size() > 0)
+			{
+				memcpy(data.data() + header.m_meshesOffset, meshes.data(), meshes.size() * sizeof(CookedMesh));
+			}
+			if (texturePathOffsets.size() > 0)
+			{
+				memcpy(data.data() + header.m_texturePathsOffset, texturePathOffsets.data(), texturePathOffsets.size() * sizeof(uint32_t));
+			}
+			if (strings.size() > 0)
+			{
+				memcpy(data.data() + header.m_stringsOffset, strings.data(), strings.size());
+			}
+			for (uint32_t m = 0; m < header.m_meshCount; ++m)
+			{
+				const auto& src = model.Meshes()[m];
+				if (src.VertexCount() > 0)
+				{
+					memcpy(data.data() + header.m_verticesOffset + (uint64_t)meshes[m].m_firstVertex * sizeof(MeshVertex), src.VertexData(), (size_t)src.VertexCount() * sizeof(MeshVertex));
+				}
+				if (src.IndexCount() > 0)
+				{
+					memcpy(data.data() + header.m_indicesOffset + (uint64_t)meshes[m].m_firstIndex * sizeof(uint32_t), src.IndexData(), (size_t)src.IndexCount() * sizeof(uint32_t));
+				}
+			}
+			return SaveCookedFile(cookedPath, data);
+		}
+
+		std::unique_ptr<Model> LoadCookedModel(const std::string& cookedPath, const CookedSourceInfo& source)
+		{
+			SDE_PROF_EVENT();
+
+			// the file stays mapped for as long as the model, mesh geometry points straight into it
+			auto mappedFile = std::make_shared<Core::MappedFile>();
+			Core::MappedFile& file = *mappedFile;
+			if (!file.Open(cookedPath) || file.Size() < sizeof(CookedModelHeader))
+			{
+				return nullptr;
+			}
+			const uint8_t* data = file.Data();
+			CookedModelHeader header;
+			memcpy(&header, data, sizeof(header));
+			if (header.m_magic != CookedModelHeader::c_magic || header.m_version != CookedModelHeader::c_version || header.m_source != source)
+			{
+				return nullptr;
+			}
+
+			// validate everything before touching it, a truncated or corrupt file just means we cook again
+			const uint64_t fileSize = file.Size();
+			auto inRange = [fileSize](uint64_t offset, uint64_t bytes) {
+				return offset <= fileSize && bytes <= fileSize - offset;
+			};
+			if (header.m_fileSize != fileSize ||
+				!inRange(header.m_meshesOffset, (uint64_t)header.m_meshCount * sizeof(CookedMesh)) ||
+				!inRange(header.m_texturePathsOffset, (uint64_t)header.m_texturePathCount * sizeof(uint32_t)) ||
+				!inRange(header.m_verticesOffset, (uint64_t)header.m_vertexCount * sizeof(MeshVertex)) ||
+				!inRange(header.m_indicesOffset, (uint64_t)header.m_indexCount * sizeof(uint32_t)) ||
+				!inRange(header.m_stringsOffset, 0))
+			{
+				SDE_LOG("Cooked model '%s' is corrupt", cookedPath.c_str());
+				return nullptr;
+			}
+			const auto meshes = reinterpret_cast<const CookedMesh*>(data + header.m_meshesOffset);
+			const auto texturePathOffsets = reinterpret_cast<const uint32_t*>(data + header.m_texturePathsOffset);
+			const auto vertices = reinterpret_cast<const MeshVertex*>(data + header.m_verticesOffset);
+			const auto indices = reinterpret_cast<const uint32_t*>(data + header.m_indicesOffset);
+			const auto strings = reinterpret_cast<const char*>(data + header.m_stringsOffset);
+			const uint64_t stringBytes = fileSize - header.m_stringsOffset;
+
+			auto result = std::make_unique<Model>();
+			result->Meshes().reserve(header.m_meshCount);
+			for (uint32_t m = 0; m < header.m_meshCount; ++m)
+			{
+				const CookedMesh& src = meshes[m];
+				const uint32_t texturePathCount = src.m_diffuseMapCount + src.m_normalMapCount + src.m_specularMapCount;
+				if ((uint64_t)src.m_firstVertex + src.m_vertexCount > header.m_vertexCount ||
+					(uint64_t)src.m_firstIndex + src.m_indexCount > header.m_indexCount ||
+					(uint64_t)src.m_firstTexturePath + texturePathCount > header.m_texturePathCount)
+				{
+					SDE_LOG("Cooked model '%s' is corrupt", cookedPath.c_str());
+					return nullptr;
+				}
+
+				ModelMesh newMesh;
+				newMesh.Transform() = glm::make_mat4(src.m_transform);
+				newMesh.BoundsMin() = glm::make_vec3(src.m_boundsMin);
+				newMesh.BoundsMax() = glm::make_vec3(src.m_boundsMax);
+				newMesh.SetGeometryView(vertices + src.m_firstVertex, src.m_vertexCount, indices + src.m_firstIndex, src.m_indexCount);
+
+				MeshMaterial newMaterial;
+				uint32_t pathIndex = src.m_firstTexturePath;
+				auto readPaths = [&](uint32_t count, std::vector<std::string>& paths) {
+					for (uint32_t p = 0; p < count; ++p)
+					{
+						const uint32_t offset = texturePathOffsets[pathIndex++];
+						if (offset < stringBytes)
+						{
+							paths.push_back(std::string(strings + offset, strnlen(strings + offset, stringBytes - offset)));
+						}
+					}
+				};
+				readPaths(src.m_diffuseMapCount, newMaterial.DiffuseMaps());
+				readPaths(src.m_normalMapCount, newMaterial.NormalMaps());
+				readPaths(src.m_specularMapCount, newMaterial.SpecularMaps());
+				newMaterial.DiffuseColour() = glm::make_vec3(src.m_diffuseColour);
+				newMaterial.AmbientColour() = glm::make_vec3(src.m_ambientColour);
+				newMaterial.SpecularColour() = glm::make_vec3(src.m_specularColour);
+				newMaterial.Shininess() = src.m_shininess;
+				newMaterial.ShininessStrength() = src.m_shininessStrength;
+				newMaterial.Opacity() = src.m_opacity;
+				newMesh.SetMaterial(std::move(newMaterial));
+
+				result->Meshes().push_back(std::move(newMesh));
+			}
+			result->SetGeometryStorage(std::move(mappedFile));
+			return result;
+		}
+	}
+}
\ No newline at end of file
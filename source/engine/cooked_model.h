@@ -0,0 +1,58 @@
+#pragma once
+#include "cooked_asset.h"
+#include <memory>
+#include <string>
+
+// Binary cooked model format, written after the first assimp import so later loads can skip it entirely
+// Layout: header | mesh table | texture path offsets | all vertices | all indices | texture path strings
+// Vertices and indices for all meshes are single contiguous blobs, loaded meshes reference them in the mapped file directly
+namespace Engine
+{
+	namespace Assets
+	{
+		class Model;
+
+		struct CookedModelHeader
+		{
+			static constexpr uint32_t c_magic = 0x4c444d53;		// 'SMDL'
+			static constexpr uint32_t c_version = 1;			// bump when the layout or import settings change
+			uint32_t m_magic = c_magic;
+			uint32_t m_version = c_version;
+			CookedSourceInfo m_source;
+			uint64_t m_fileSize;
+			uint32_t m_meshCount;
+			uint32_t m_texturePathCount;
+			uint32_t m_vertexCount;
+			uint32_t m_indexCount;
+			uint64_t m_meshesOffset;			// all offsets are from the start of the file
+			uint64_t m_texturePathsOffset;
+			uint64_t m_verticesOffset;
+			uint64_t m_indicesOffset;
+			uint64_t m_stringsOffset;
+		};
+
+		struct CookedMesh
+		{
+			float m_transform[16];
+			float m_boundsMin[3];
+			float m_boundsMax[3];
+			uint32_t m_firstVertex;				// into the vertex blob, indices are relative to this
+			uint32_t m_vertexCount;
+			uint32_t m_firstIndex;
+			uint32_t m_indexCount;
+			float m_diffuseColour[3];
+			float m_ambientColour[3];
+			float m_specularColour[3];
+			float m_shininess;
+			float m_shininessStrength;
+			float m_opacity;
+			uint32_t m_firstTexturePath;		// diffuse, then normal, then specular maps
+			uint32_t m_diffuseMapCount;
+			uint32_t m_normalMapCount;
+			uint32_t m_specularMapCount;
+		};
+
+		bool SaveCookedModel(const Model& model, const std::string& cookedPath, const CookedSourceInfo& source);
+		std::unique_ptr<Model> LoadCookedModel(const std::string& cookedPath, const CookedSourceInfo& source);	// null if missing, stale or invalid
+	}
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "cooked_texture.h"
+#include "texture_compression.h"
+#include "stb_image.h"
+#include "render/texture_source.h"
+#include "core/mapped_file.h"
+#include "core/profiler.h"
+#include "core/log.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Engine
+{
+	using Format = Render::TextureSource::Format;
+
+	// bytes per pixel for raw formats, 0 for block compressed
+	static uint32_t GetCookedPixelBytes(Format f)
+	{
+		switch (f)
+		{
+		case Format::R8:
+			return 1;
+		case Format::RGB8:
+			return 3;
+		case Format::RGBA8:
+			return 4;
+		default:
+			return 0;
+		}
+	}
+
+	// expected size of a mip, or 0 if the format can't be cooked
+	static size_t GetCookedMipSize(Format f, uint32_t w, uint32_t h)
+	{
+		switch (f)
+		{
+		case Format::DXT1:
+			return GetBlockCompressedSize(w, h, 8);
+		case Format::DXT5:
+			return GetBlockCompressedSize(w, h, 16);
+		default:
+			return (size_t)w * h * GetCookedPixelBytes(f);
+		}
+	}
+
+	// 2x2 box filter, odd edges repeat the last row/column
+	static void DownsampleMip(std::vector<uint8_t>& pixels, uint32_t components, uint32_t& w, uint32_t& h)
+	{
+		const uint32_t newW = std::max(w / 2, 1u), newH = std::max(h / 2, 1u);
+		std::vector<uint8_t> result((size_t)newW * newH * components);
+		for (uint32_t y = 0; y < newH; ++y)
+		{
+			const size_t row0 = (size_t)std::min(y * 2, h - 1) * w, row1 = (size_t)std::min(y * 2 + 1, h - 1) * w;
+			for (uint32_t x = 0; x < newW; ++x)
+			{
+				const uint32_t x0 = std::min(x * 2, w - 1), x1 = std::min(x * 2 + 1, w - 1);
+				uint8_t* dst = result.data() + ((size_t)y * newW + x) * components;
+				for (uint32_t c = 0; c < components; ++c)
+				{
+					const uint32_t sum = pixels[(row0 + x0) * components + c] + pixels[(row0 + x1) * components + c] +
+						pixels[(row1 + x0) * components + c] + pixels[(row1 + x1) * components + c];
+					dst[c] = (uint8_t)((sum + 2) / 4);
+				}
+			}
+		}
+		pixels.swap(result);
+		w = newW;
+		h = newH;
+	}
+
+	std::unique_ptr<Render::TextureSource> CookTexture(const std::string& sourcePath, bool allowCompression)
+	{
+		SDE_PROF_EVENT();
+
+		int w, h, components;
+		stbi_set_flip_vertically_on_load(true);
+		unsigned char* loadedData = stbi_load(sourcePath.c_str(), &w, &h, &components, 0);
+		if (loadedData == nullptr)
+		{
+			return nullptr;
+		}
+		if (components != 1 && components != 3 && components != 4)
+		{
+			stbi_image_free(loadedData);
+			return nullptr;
+		}
+		std::vector<uint8_t> pixels(loadedData, loadedData + (size_t)w * h * components);
+		stbi_image_free(loadedData);
+
+		// block compression needs whole blocks at the top level, smaller mips are padded by the encoder
+		const bool compress = allowCompression && components >= 3 && (w % 4) == 0 && (h % 4) == 0;
+		bool hasAlpha = false;
+		if (components == 4)
+		{
+			for (size_t p = 3; p < pixels.size() && !hasAlpha; p += 4)
+			{
+				hasAlpha = pixels[p] != 255;
+			}
+		}
+		Format format = Format::Unsupported;
+		if (compress)
+		{
+			format = hasAlpha ? Format::DXT5 : Format::DXT1;
+		}
+		else
+		{
+			format = components == 1 ? Format::R8 : (components == 3 ? Format::RGB8 : Format::RGBA8);
+		}
+
+		std::vector<Render::TextureSource::MipDesc> mips;
+		std::vector<uint8_t> mipData;
+		uint32_t mipW = (uint32_t)w, mipH = (uint32_t)h;
+		while (true)
+		{
+			const size_t offset = mipData.size();
+			if (format == Format::DXT1)
+			{
+				CompressBC1(pixels.data(), components, mipW, mipH, mipData);
+			}
+			else if (format == Format::DXT5)
+			{
+				CompressBC3(pixels.data(), components, mipW, mipH, mipData);
+			}
+			else
+			{
+				mipData.insert(mipData.end(), pixels.begin(), pixels.end());
+			}
+			mips.push_back({ mipW, mipH, offset, mipData.size() - offset });
+			if (mipW == 1 && mipH == 1)
+			{
+				break;
+			}
+			DownsampleMip(pixels, components, mipW, mipH);
+		}
+
+		auto result = std::make_unique<Render::TextureSource>((uint32_t)w, (uint32_t)h, format, mips, mipData);
+		if (!compress)
+		{
+			result->SetDataRowAlignment(1);		// mip rows are tightly packed
+		}
+		return result;
+	}
+
+	bool SaveCookedTexture(const Render::TextureSource& texture, const std::string& cookedPath, const CookedSourceInfo& source)
+	{
+		SDE_PROF_EVENT();
+
+		CookedTextureHeader header;
+		header.m_source = source;
+		header.m_width = texture.Width();
+		header.m_height = texture.Height();
+		header.m_format = (uint32_t)texture.SourceFormat();
+		header.m_mipCount = texture.MipCount();
+		header.m_mipsOffset = sizeof(CookedTextureHeader);
+		header.m_dataOffset = header.m_mipsOffset + header.m_mipCount * sizeof(CookedTextureMip);
+
+		std::vector<CookedTextureMip> mips(header.m_mipCount);
+		uint64_t dataSize = 0;
+		for (uint32_t m = 0; m < header.m_mipCount; ++m)
+		{
+			size_t size = 0;
+			texture.MipLevel(m, mips[m].m_width, mips[m].m_height, size);
+			mips[m].m_offset = dataSize;
+			mips[m].m_size = size;
+			dataSize += size;
+		}
+		header.m_fileSize = header.m_dataOffset + dataSize;
+
+		std::vector<uint8_t> data(header.m_fileSize, 0);
+		memcpy(data.data(), &header, sizeof(header));
+		if (mips.size() > 0)
+		{
+			memcpy(data.data() + header.m_mipsOffset, mips.data(), mips.size() * sizeof(CookedTextureMip));
+		}
+		for (uint32_t m = 0; m < header.m_mipCount; ++m)
+		{
+			uint32_t w = 0, h = 0;
+			size_t size = 0;
+			const uint8_t* mipData = texture.MipLevel(m, w, h, size);
+			memcpy(data.data() + header.m_dataOffset + mips[m].m_offset, mipData, size);
+		}
+		return SaveCookedFile(cookedPath, data);
+	}
+
+	std::unique_ptr<Render::TextureSource> LoadCookedTexture(const std::string& cookedPath, const CookedSourceInfo& source)
+	{
+		SDE_PROF_EVENT();
+
+		Core::MappedFile file;
+		if (!file.Open(cookedPath) || file.Size() < sizeof(CookedTextureHeader))
+		{
+			return nullptr;
+		}
+		const uint8_t* data = file.Data();
+		CookedTextureHeader header;
+		memcpy(&header, data, sizeof(header));
+		if (header.m_magic != CookedTextureHeader::c_magic || header.m_version != CookedTextureHeader::c_version || header.m_source != source)
+		{
+			return nullptr;
+		}
+
+		// validate everything before touching it, a truncated or corrupt file just means we cook again
+		const uint64_t fileSize = file.Size();
+		const Format format = (Format)header.m_format;
+		const bool isCompressed = format == Format::DXT1 || format == Format::DXT5;
+		if (header.m_fileSize != fileSize || header.m_mipCount == 0 || header.m_mipCount > 32 ||
+			(!isCompressed && GetCookedPixelBytes(format) == 0) ||
+			header.m_mipsOffset > fileSize || (uint64_t)header.m_mipCount * sizeof(CookedTextureMip) > fileSize - header.m_mipsOffset ||
+			header.m_dataOffset > fileSize)
+		{
+			SDE_LOG("Cooked texture '%s' is corrupt", cookedPath.c_str());
+			return nullptr;
+		}
+		const auto cookedMips = reinterpret_cast<const CookedTextureMip*>(data + header.m_mipsOffset);
+		const uint64_t dataSize = fileSize - header.m_dataOffset;
+		std::vector<Render::TextureSource::MipDesc> mips(header.m_mipCount);
+		for (uint32_t m = 0; m < header.m_mipCount; ++m)
+		{
+			const CookedTextureMip& src = cookedMips[m];
+			if (src.m_size != GetCookedMipSize(format, src.m_width, src.m_height) || src.m_offset > dataSize || src.m_size > dataSize - src.m_offset)
+			{
+				SDE_LOG("Cooked texture '%s' is corrupt", cookedPath.c_str());
+				return nullptr;
+			}
+			mips[m] = { src.m_width, src.m_height, (uintptr_t)src.m_offset, (size_t)src.m_size };
+		}
+
+		auto result = std::make_unique<Render::TextureSource>(header.m_width, header.m_height, format, mips, data + header.m_dataOffset, (size_t)dataSize);
+		if (!isCompressed)
+		{
+			result->SetDataRowAlignment(1);
+		}
+		return result;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "cooked_asset.h"
+#include <memory>
+#include <string>
+
+namespace Render
+{
+	class TextureSource;
+}
+
+// Binary cooked texture format, written after the first decode so later loads skip decoding and mip generation
+// Layout: header | mip table | mip data (smallest mips last)
+// 3 and 4 component images are stored as BC1/BC3 blocks unless compression is disallowed, everything else (or sizes that are not a multiple of 4) as raw pixels
+namespace Engine
+{
+	struct CookedTextureHeader
+	{
+		static constexpr uint32_t c_magic = 0x58455453;		// 'STEX'
+		static constexpr uint32_t c_version = 1;			// bump when the layout or encoders change
+		uint32_t m_magic = c_magic;
+		uint32_t m_version = c_version;
+		CookedSourceInfo m_source;
+		uint64_t m_fileSize;
+		uint32_t m_width;
+		uint32_t m_height;
+		uint32_t m_format;				// Render::TextureSource::Format
+		uint32_t m_mipCount;
+		uint64_t m_mipsOffset;			// all offsets are from the start of the file
+		uint64_t m_dataOffset;
+	};
+
+	struct CookedTextureMip
+	{
+		uint32_t m_width;
+		uint32_t m_height;
+		uint64_t m_offset;				// from m_dataOffset
+		uint64_t m_size;
+	};
+
+	std::unique_ptr<Render::TextureSource> CookTexture(const std::string& sourcePath, bool allowCompression);		// decode + mips + compression, null if the source can't be decoded
+	bool SaveCookedTexture(const Render::TextureSource& texture, const std::string& cookedPath, const CookedSourceInfo& source);
+	std::unique_ptr<Render::TextureSource> LoadCookedTexture(const std::string& cookedPath, const CookedSourceInfo& source);	// null if missing, stale or invalid
+}
@@ -5,6 +5,7 @@
 #include "render/mesh.h"
 #include "core/log.h"
 #include "core/profiler.h"
+#include "core/aligned_alloc.h"
 #include "shader_manager.h"
 #include "system_manager.h"
 #include <cassert>
@@ -15,16 +16,16 @@ namespace Engine
 	{
 		auto deleter = [](glm::vec4* p)
 		{
-			_aligned_free(p);
+			Core::AlignedFree(p);
 		};
 
-		void* rawBuffer = _aligned_malloc(c_maxLines * sizeof(glm::vec4) * 2, 16);
+		void* rawBuffer = Core::AlignedAlloc(c_maxLines * sizeof(glm::vec4) * 2, 16);
 		if (rawBuffer != nullptr)
 		{
 			memset(rawBuffer, 0, c_maxLines * sizeof(glm::vec4) * 2);
 			m_posBuffer = std::unique_ptr<glm::vec4[], decltype(deleter)>((glm::vec4*)rawBuffer, deleter);
 		}
-		rawBuffer = _aligned_malloc(c_maxLines * sizeof(glm::vec4) * 2, 16);
+		rawBuffer = Core::AlignedAlloc(c_maxLines * sizeof(glm::vec4) * 2, 16);
 		if (rawBuffer != nullptr)
 		{
 			memset(rawBuffer, 0, c_maxLines * sizeof(glm::vec4) * 2);
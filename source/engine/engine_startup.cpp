@@ -1,6 +1,7 @@
 #include "engine_startup.h"
 #include "system_manager.h"
 #include "event_system.h"
+#include "file_watcher_system.h"
 #include "job_system.h"
 #include "shader_manager.h"
 #include "texture_manager.h"
@@ -90,6 +91,9 @@ namespace Engine
 	// Application entry point
 	int Run(std::function<void()> systemCreation, std::function<void(FrameGraph&)> frameGraphBuildCb, int argc, char* args[])
 	{
+		Core::Timer startupTimer;
+		const double startupTime = startupTimer.GetSeconds();
+
 		// Initialise platform stuff
 		Platform::InitResult result = Platform::Initialise(argc, args);
 		assert(result == Platform::InitResult::InitOK);
@@ -111,6 +115,7 @@ namespace Engine
 		SystemManager& sysManager = SystemManager::GetInstance();
 		sysManager.RegisterSystem("Time", new TimeSystem);
 		sysManager.RegisterSystem("Events", new EventSystem);
+		sysManager.RegisterSystem("FileWatcher", new FileWatcherSystem);
 		sysManager.RegisterSystem("Jobs", new JobSystem);
 		sysManager.RegisterSystem("Input", new InputSystem);
 		sysManager.RegisterSystem("DebugGui", new DebugGuiSystem);
@@ -132,6 +137,9 @@ namespace Engine
 		sysManager.RegisterSystem("Physics", physics);
 		sysManager.RegisterSystem("RenderPresent", render->MakePresenter());
 		sysManager.RegisterSystem("ShaderHotreload", new ShaderManager::HotReloader);
+
+		// Only needed where a worker thread init phase is used by another system in the same phase
+		sysManager.AddInitDependency("Graphics", "Text");
 		systemCreation();
 
 		auto frameGraph = MakeDefaultFrameGraph();
@@ -148,12 +156,18 @@ namespace Engine
 			double startTime = engineTime.GetSeconds();
 			double lastTickTime = startTime;
 			bool running = true;
+			bool firstFrame = true;
 			while (running)
 			{
 				double thisTime = engineTime.GetSeconds();
 				double deltaTime = glm::clamp(thisTime - lastTickTime, 0.0047, 0.033);
 				lastTickTime = thisTime;
 				running = RunUpdateGraph(*frameGraph);
+				if (firstFrame)
+				{
+					SDE_LOGC(Engine, "First frame finished %.2fms after startup", (startupTimer.GetSeconds() - startupTime) * 1000.0);
+					firstFrame = false;
+				}
 			}
 		}
 
@@ -0,0 +1,369 @@
+#pragma once
+#include "core/glm_headers.h"
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+// Flat 2d (xz) grid rebuilt from scratch each frame
+// Entries are added to a pending list, Build() then counting-sorts them into one array ordered by cell
+// (count per cell, prefix sum for cell offsets, scatter) in O(n), over the tile bounds of everything added
+// Entries that overlap multiple tiles are stored in each, queries visit each entry once
+// The cell array is capped at c_maxCells, if the bounds are bigger (e.g. one entry far away from the rest) the grid only
+// covers a window around the median entry and anything not fully inside it goes to an overflow list checked by every query
+// Shared by anything that needs per-frame spatial queries (survivors monsters, ant sensing, creature vision)
+template<class PerTileData>
+class WorldGrid
+{
+public:
+	static constexpr uint32_t c_maxCells = 1024 * 1024;
+	WorldGrid(glm::vec2 tileSize = { 32.0f,32.0f })
+		: m_tileSize(tileSize)
+	{
+	}
+	void Reset(bool removeOldTiles=false);		// clears all entries (storage is kept unless removeOldTiles)
+	void SetTileSize(glm::vec2 t);
+	void AddEntry(glm::vec3 aabMin, glm::vec3 aabMax, const PerTileData& d);
+	void Build();								// call after adding entries, before any queries
+	void FindEntries(glm::vec3 aabMin, glm::vec3 aabMax, std::vector<PerTileData>& results);
+	template<class VisitorFn>
+	void ForEachNearby(glm::vec3 aabMin, glm::vec3 aabMax, VisitorFn&& fn);		// fn(PerTileData&)
+	template<class VisitorFn>
+	void ForEachNearby(glm::vec3 aabMin, glm::vec3 aabMax, VisitorFn&& fn) const;	// fn(const PerTileData&)
+	// visits entries in rings of tiles outwards from position, fn(const PerTileData&)
+	// done(d) is called after each ring, d is the closest (xz) anything not visited yet can be, return true to stop
+	template<class VisitorFn, class DoneFn>
+	void ForEachByDistance(glm::vec3 position, VisitorFn&& fn, DoneFn&& done) const;
+	size_t GetEntryCount() const { return m_entries.size(); }
+	size_t GetCellCount() const { return m_cellStart.size() > 0 ? m_cellStart.size() - 1 : 0; }
+	size_t GetOverflowCount() const { return m_overflow.size(); }
+
+private:
+	struct PendingEntry
+	{
+		glm::ivec2 m_tileMin;
+		glm::ivec2 m_tileMax;
+		PerTileData m_data;
+	};
+	struct Entry
+	{
+		glm::ivec2 m_tileMin;	// used to visit multi-tile entries once
+		glm::ivec2 m_tileMax;
+		PerTileData m_data;
+	};
+
+	glm::ivec2 PositionToTileIndex(glm::vec3 p) const;
+	void ChooseGridWindow(glm::ivec2& tileMin, glm::ivec2& tileMax) const;
+	inline uint32_t CellIndex(int x, int z) const { return (uint32_t)((z - m_gridMin.y) * m_gridSize.x + (x - m_gridMin.x)); }
+
+	glm::vec2 m_tileSize = { 32.0f, 32.0f };
+	bool m_isBuilt = true;
+	std::vector<PendingEntry> m_pending;
+	std::vector<Entry> m_entries;				// sorted by cell
+	std::vector<uint32_t> m_cellStart;			// entries for cell c are [m_cellStart[c], m_cellStart[c+1])
+	std::vector<Entry> m_overflow;				// entries not fully inside the grid window
+	glm::ivec2 m_gridMin = { 0, 0 };			// tile bounds covered by m_cellStart
+	glm::ivec2 m_gridSize = { 0, 0 };
+};
+
+template<class PerTileData>
+void WorldGrid<PerTileData>::SetTileSize(glm::vec2 t)
+{
+	if (t != m_tileSize)
+	{
+		Reset(true);
+		m_tileSize = t;
+	}
+}
+
+template<class PerTileData>
+glm::ivec2 WorldGrid<PerTileData>::PositionToTileIndex(glm::vec3 p) const
+{
+	// clamped so differences between tile indices can never overflow
+	const float c_maxTileIndex = (float)(1 << 28);
+	return glm::ivec2(glm::clamp(glm::floor(glm::vec2(p.x, p.z) / m_tileSize), -c_maxTileIndex, c_maxTileIndex));
+}
+
+template<class PerTileData>
+void WorldGrid<PerTileData>::Reset(bool removeOldTiles)
+{
+	m_pending.clear();
+	m_entries.clear();
+	m_cellStart.clear();
+	m_overflow.clear();
+	m_gridMin = { 0, 0 };
+	m_gridSize = { 0, 0 };
+	m_isBuilt = true;
+	if (removeOldTiles)
+	{
+		m_pending.shrink_to_fit();
+		m_entries.shrink_to_fit();
+		m_cellStart.shrink_to_fit();
+		m_overflow.shrink_to_fit();
+	}
+}
+
+template<class PerTileData>
+void WorldGrid<PerTileData>::AddEntry(glm::vec3 aabMin, glm::vec3 aabMax, const PerTileData& d)
+{
+	m_pending.push_back({ PositionToTileIndex(aabMin), PositionToTileIndex(aabMax), d });
+	m_isBuilt = false;
+}
+
+template<class PerTileData>
+void WorldGrid<PerTileData>::ChooseGridWindow(glm::ivec2& tileMin, glm::ivec2& tileMax) const
+{
+	// square window of c_maxCells around the median entry, shrunk to the bounds of everything added
+	std::vector<int> centres(m_pending.size());
+	glm::ivec2 median;
+	for (int axis = 0; axis < 2; ++axis)
+	{
+		for (size_t i = 0; i < m_pending.size(); ++i)
+		{
+			centres[i] = m_pending[i].m_tileMin[axis] + (m_pending[i].m_tileMax[axis] - m_pending[i].m_tileMin[axis]) / 2;
+		}
+		std::nth_element(centres.begin(), centres.begin() + centres.size() / 2, centres.end());
+		median[axis] = centres[centres.size() / 2];
+	}
+	int windowSize = 1;
+	while ((uint64_t)(windowSize * 2) * (uint64_t)(windowSize * 2) <= c_maxCells)
+	{
+		windowSize *= 2;
+	}
+	tileMin = glm::max(tileMin, median - windowSize / 2);
+	tileMax = glm::min(tileMax, median - windowSize / 2 + windowSize - 1);
+}
+
+template<class PerTileData>
+void WorldGrid<PerTileData>::Build()
+{
+	m_entries.clear();
+	m_cellStart.clear();
+	m_overflow.clear();
+	m_isBuilt = true;
+	if (m_pending.size() == 0)
+	{
+		m_gridSize = { 0, 0 };
+		return;
+	}
+
+	// tile bounds of everything added, limited to a window if the cell array would be too big
+	glm::ivec2 tileMin = m_pending[0].m_tileMin, tileMax = m_pending[0].m_tileMax;
+	for (const auto& p : m_pending)
+	{
+		tileMin = glm::min(tileMin, p.m_tileMin);
+		tileMax = glm::max(tileMax, p.m_tileMax);
+	}
+	if ((uint64_t)(tileMax.x - tileMin.x + 1) * (uint64_t)(tileMax.y - tileMin.y + 1) > c_maxCells)
+	{
+		ChooseGridWindow(tileMin, tileMax);
+	}
+	m_gridMin = tileMin;
+	m_gridSize = tileMax - tileMin + 1;
+	const uint64_t cellCount = (uint64_t)m_gridSize.x * (uint64_t)m_gridSize.y;
+	assert(cellCount > 0 && cellCount <= c_maxCells);
+	auto insideGrid = [&](const PendingEntry& p) {
+		return glm::all(glm::greaterThanEqual(p.m_tileMin, tileMin)) && glm::all(glm::lessThanEqual(p.m_tileMax, tileMax));
+	};
+
+	// count entries per cell (+1 so the prefix sum leaves the end offset in the last slot)
+	m_cellStart.resize(cellCount + 1, 0);
+	uint32_t totalEntries = 0;
+	for (const auto& p : m_pending)
+	{
+		if (!insideGrid(p))
+		{
+			m_overflow.push_back({ p.m_tileMin, p.m_tileMax, p.m_data });
+			continue;
+		}
+		for (int z = p.m_tileMin.y; z <= p.m_tileMax.y; ++z)
+		{
+			for (int x = p.m_tileMin.x; x <= p.m_tileMax.x; ++x)
+			{
+				m_cellStart[CellIndex(x, z)]++;
+				++totalEntries;
+			}
+		}
+	}
+
+	// exclusive prefix sum -> cell offsets
+	uint32_t offset = 0;
+	for (uint32_t c = 0; c <= cellCount; ++c)
+	{
+		const uint32_t count = m_cellStart[c];
+		m_cellStart[c] = offset;
+		offset += count;
+	}
+
+	// scatter, each cell start is bumped as it fills and then restored
+	m_entries.resize(totalEntries);
+	for (const auto& p : m_pending)
+	{
+		if (!insideGrid(p))
+		{
+			continue;
+		}
+		for (int z = p.m_tileMin.y; z <= p.m_tileMax.y; ++z)
+		{
+			for (int x = p.m_tileMin.x; x <= p.m_tileMax.x; ++x)
+			{
+				m_entries[m_cellStart[CellIndex(x, z)]++] = { p.m_tileMin, p.m_tileMax, p.m_data };
+			}
+		}
+	}
+	for (uint32_t c = (uint32_t)cellCount; c > 0; --c)
+	{
+		m_cellStart[c] = m_cellStart[c - 1];
+	}
+	m_cellStart[0] = 0;
+}
+
+template<class PerTileData>
+template<class VisitorFn>
+void WorldGrid<PerTileData>::ForEachNearby(glm::vec3 aabMin, glm::vec3 aabMax, VisitorFn&& fn)
+{
+	static_cast<const WorldGrid&>(*this).ForEachNearby(aabMin, aabMax, [&fn](const PerTileData& d) {
+		fn(const_cast<PerTileData&>(d));
+	});
+}
+
+template<class PerTileData>
+template<class VisitorFn>
+void WorldGrid<PerTileData>::ForEachNearby(glm::vec3 aabMin, glm::vec3 aabMax, VisitorFn&& fn) const
+{
+	assert(m_isBuilt);
+	const glm::ivec2 queryMin = PositionToTileIndex(aabMin);
+	const glm::ivec2 queryMax = PositionToTileIndex(aabMax);
+	const glm::ivec2 tileMin = glm::max(queryMin, m_gridMin);
+	const glm::ivec2 tileMax = glm::min(queryMax, m_gridMin + m_gridSize - 1);
+	for (int z = tileMin.y; z <= tileMax.y; ++z)
+	{
+		for (int x = tileMin.x; x <= tileMax.x; ++x)
+		{
+			const uint32_t cell = CellIndex(x, z);
+			const uint32_t lastEntry = m_cellStart[cell + 1];
+			for (uint32_t e = m_cellStart[cell]; e < lastEntry; ++e)
+			{
+				// an entry is only visited from the first tile it shares with the query
+				const Entry& entry = m_entries[e];
+				if (glm::max(entry.m_tileMin.x, queryMin.x) == x && glm::max(entry.m_tileMin.y, queryMin.y) == z)
+				{
+					fn(entry.m_data);
+				}
+			}
+		}
+	}
+	for (const Entry& entry : m_overflow)
+	{
+		if (glm::all(glm::lessThanEqual(entry.m_tileMin, queryMax)) && glm::all(glm::greaterThanEqual(entry.m_tileMax, queryMin)))
+		{
+			fn(entry.m_data);
+		}
+	}
+}
+
+template<class PerTileData>
+template<class VisitorFn, class DoneFn>
+void WorldGrid<PerTileData>::ForEachByDistance(glm::vec3 position, VisitorFn&& fn, DoneFn&& done) const
+{
+	assert(m_isBuilt);
+	if (m_entries.size() == 0 && m_overflow.size() == 0)
+	{
+		return;
+	}
+	const glm::ivec2 centre = PositionToTileIndex(position);
+	const glm::ivec2 gridMax = m_gridMin + m_gridSize - 1;
+	const glm::ivec2 toMin = glm::abs(centre - m_gridMin), toMax = glm::abs(centre - gridMax);
+	const glm::ivec2 outside = glm::max(glm::max(m_gridMin - centre, centre - gridMax), glm::ivec2(0));
+	const int gridFirstRing = glm::max(outside.x, outside.y);
+	const int gridLastRing = glm::max(glm::max(toMin.x, toMin.y), glm::max(toMax.x, toMax.y));
+	const float ringSize = glm::min(m_tileSize.x, m_tileSize.y);
+	auto visitCell = [&](int x, int z) {
+		const uint32_t cell = CellIndex(x, z);
+		const uint32_t lastEntry = m_cellStart[cell + 1];
+		for (uint32_t e = m_cellStart[cell]; e < lastEntry; ++e)
+		{
+			// an entry is only visited from its tile closest to the query, which is in the earliest ring
+			const Entry& entry = m_entries[e];
+			if (glm::clamp(centre, entry.m_tileMin, entry.m_tileMax) == glm::ivec2(x, z))
+			{
+				fn(entry.m_data);
+			}
+		}
+	};
+
+	// overflow entries are visited in the ring of their closest tile, sorted by ring so they merge into the walk below
+	std::vector<std::pair<int, const Entry*>> overflow;
+	overflow.reserve(m_overflow.size());
+	for (const Entry& entry : m_overflow)
+	{
+		const glm::ivec2 d = glm::abs(glm::clamp(centre, entry.m_tileMin, entry.m_tileMax) - centre);
+		overflow.push_back({ glm::max(d.x, d.y), &entry });
+	}
+	std::sort(overflow.begin(), overflow.end(), [](const auto& a, const auto& b) {
+		return a.first < b.first;
+	});
+	size_t nextOverflow = 0;
+	const bool hasGridEntries = m_entries.size() > 0;
+	int firstRing = hasGridEntries ? gridFirstRing : INT_MAX;
+	int lastRing = hasGridEntries ? gridLastRing : 0;
+	if (overflow.size() > 0)
+	{
+		firstRing = glm::min(firstRing, overflow.front().first);
+		lastRing = glm::max(lastRing, overflow.back().first);
+	}
+
+	for (int ring = firstRing; ring <= lastRing; ++ring)
+	{
+		if (hasGridEntries && ring >= gridFirstRing && ring <= gridLastRing)
+		{
+			const int xMin = glm::max(centre.x - ring, m_gridMin.x), xMax = glm::min(centre.x + ring, gridMax.x);
+			const int zMin = glm::max(centre.y - ring, m_gridMin.y), zMax = glm::min(centre.y + ring, gridMax.y);
+			for (int z = zMin; z <= zMax; ++z)
+			{
+				if (z == centre.y - ring || z == centre.y + ring)
+				{
+					for (int x = xMin; x <= xMax; ++x)
+					{
+						visitCell(x, z);
+					}
+				}
+				else
+				{
+					if (centre.x - ring >= m_gridMin.x && centre.x - ring <= gridMax.x)
+					{
+						visitCell(centre.x - ring, z);
+					}
+					if (ring > 0 && centre.x + ring >= m_gridMin.x && centre.x + ring <= gridMax.x)
+					{
+						visitCell(centre.x + ring, z);
+					}
+				}
+			}
+		}
+		for (; nextOverflow < overflow.size() && overflow[nextOverflow].first == ring; ++nextOverflow)
+		{
+			fn(overflow[nextOverflow].second->m_data);
+		}
+		if (done(ring * ringSize))
+		{
+			return;
+		}
+
+		// skip the empty rings outside the grid before the next grid or overflow ring
+		int nextRing = nextOverflow < overflow.size() ? overflow[nextOverflow].first : INT_MAX;
+		if (hasGridEntries && ring < gridLastRing)
+		{
+			nextRing = glm::min(nextRing, glm::max(ring + 1, gridFirstRing));
+		}
+		ring = glm::min(nextRing, lastRing + 1) - 1;
+	}
+}
+
+template<class PerTileData>
+void WorldGrid<PerTileData>::FindEntries(glm::vec3 aabMin, glm::vec3 aabMax, std::vector<PerTileData>& results)
+{
+	ForEachNearby(aabMin, aabMax, [&results](PerTileData& d) {
+		results.push_back(d);
+	});
+}
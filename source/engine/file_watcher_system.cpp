@@ -0,0 +1,55 @@
+#include "file_watcher_system.h"
+#include "cooked_asset.h"
+#include "core/profiler.h"
+#include "core/log.h"
+
+namespace Engine
+{
+	void FileWatcherSystem::RegisterChangeHandler(ChangeHandler h)
+	{
+		m_handlers.push_back(h);
+	}
+
+	void FileWatcherSystem::SetEnabled(bool enabled)
+	{
+		if (enabled && !m_watcher.IsRunning())
+		{
+			m_watcher.Start(".");
+		}
+		else if (!enabled)
+		{
+			m_watcher.Stop();
+		}
+	}
+
+	bool FileWatcherSystem::Initialise()
+	{
+		SDE_PROF_EVENT();
+		SetEnabled(true);
+		return true;	// not fatal, assets just won't reload automatically
+	}
+
+	bool FileWatcherSystem::Tick(float timeDelta)
+	{
+		SDE_PROF_EVENT();
+		for (const auto& path : m_watcher.PollChanges())
+		{
+			if (IsCookedPath(path))	// written by the asset managers themselves
+			{
+				continue;
+			}
+			SDE_LOG("File changed: %s", path.c_str());
+			for (auto& it : m_handlers)
+			{
+				it(path);
+			}
+		}
+		return true;
+	}
+
+	void FileWatcherSystem::Shutdown()
+	{
+		m_watcher.Stop();
+		m_handlers.clear();
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "system.h"
+#include "core/file_watcher.h"
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace Engine
+{
+	// Watches the working directory and passes changed files to the handlers once per frame (on the main thread)
+	// Asset managers use this to reload only the assets that changed
+	class FileWatcherSystem : public System
+	{
+	public:
+		using ChangeHandler = std::function<void(const std::string&)>;	// path is normalised, see Core::FileWatcher
+		void RegisterChangeHandler(ChangeHandler h);
+		void SetEnabled(bool enabled);
+		bool IsEnabled() const { return m_watcher.IsRunning(); }
+
+		virtual bool Initialise();
+		virtual bool CanInitOnWorkerThread(InitPhase phase) const { return phase == InitPhase::Initialise; }	// initial directory scan
+		virtual bool Tick(float timeDelta);
+		virtual void Shutdown();
+
+	private:
+		Core::FileWatcher m_watcher;
+		std::vector<ChangeHandler> m_handlers;
+	};
+}
@@ -14,6 +14,27 @@ namespace Render
 
 namespace Engine
 {
+	// A range of vertices + indices in the ModelManager global buffers, the space is released when this is destroyed
+	// Indices are relative to m_firstVertex, use it as the base vertex when drawing
+	class GeometryAllocation
+	{
+	public:
+		GeometryAllocation() = default;
+		GeometryAllocation(GeometryAllocation&& other);
+		GeometryAllocation& operator=(GeometryAllocation&& other);
+		GeometryAllocation(const GeometryAllocation&) = delete;
+		GeometryAllocation& operator=(const GeometryAllocation&) = delete;
+		~GeometryAllocation();
+
+		void Release();
+		bool IsValid() const { return m_firstVertex != -1 && m_firstIndex != -1; }
+
+		uint32_t m_firstVertex = -1;
+		uint32_t m_vertexCount = 0;
+		uint32_t m_firstIndex = -1;
+		uint32_t m_indexCount = 0;
+	};
+
 	class Model
 	{
 	public:
@@ -44,9 +65,12 @@ namespace Engine
 		};
 		const std::vector<MeshPart>& MeshParts() const { return m_meshParts; }
 		std::vector<MeshPart>& MeshParts() { return m_meshParts; }
+		GeometryAllocation& Geometry() { return m_geometry; }
+		const GeometryAllocation& Geometry() const { return m_geometry; }
 
 	private:
 		std::vector<MeshPart> m_meshParts;
+		GeometryAllocation m_geometry;		// all parts share one allocation
 		glm::vec3 m_boundsMin = glm::vec3(FLT_MAX);
 		glm::vec3 m_boundsMax = glm::vec3(-FLT_MAX);
 	};
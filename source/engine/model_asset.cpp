@@ -1,6 +1,7 @@
 #include "model_asset.h"
 #include "core/profiler.h"
 #include "core/log.h"
+#include "cooked_model.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -20,6 +21,16 @@ namespace Engine
 			};
 		}
 
+		void ModelMesh::SetGeometryView(const MeshVertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+		{
+			m_vertices.clear();
+			m_indices.clear();
+			m_vertexView = vertices;
+			m_vertexViewCount = vertexCount;
+			m_indexView = indices;
+			m_indexViewCount = indexCount;
+		}
+
 		void Model::CalculateAABB(glm::vec3& minb, glm::vec3& maxb) const
 		{
 			glm::vec3 boundsMin(FLT_MAX), boundsMax(-FLT_MAX);
@@ -170,7 +181,40 @@ namespace Engine
 			}
 		}
 
-		std::unique_ptr<Model> Model::Load(const char* path)
+		std::unique_ptr<Model> Model::Load(const char* path, bool* loadedFromCooked)
+		{
+			SDE_PROF_EVENT();
+
+			if (loadedFromCooked)
+			{
+				*loadedFromCooked = false;
+			}
+			CookedSourceInfo sourceInfo;
+			const bool sourceExists = GetCookedSourceInfo(path, sourceInfo);
+			const std::string cookedPath = GetCookedPath(path, ".smdl");
+			if (sourceExists)
+			{
+				auto cooked = LoadCookedModel(cookedPath, sourceInfo);
+				if (cooked != nullptr)
+				{
+					cooked->SetPath(path);
+					if (loadedFromCooked)
+					{
+						*loadedFromCooked = true;
+					}
+					return cooked;
+				}
+			}
+
+			auto result = LoadFromSource(path);
+			if (result != nullptr && sourceExists && !SaveCookedModel(*result, cookedPath, sourceInfo))
+			{
+				SDE_LOG("Failed to write cooked model '%s'", cookedPath.c_str());
+			}
+			return result;
+		}
+
+		std::unique_ptr<Model> Model::LoadFromSource(const char* path)
 		{
 			SDE_PROF_EVENT();
 
@@ -16,6 +16,10 @@
 struct aiNode;
 struct aiScene;
 struct aiMesh;
+namespace Core
+{
+	class MappedFile;
+}
 
 namespace Engine
 {
@@ -83,6 +87,13 @@ namespace Engine
 			std::vector<uint32_t>& Indices() { return m_indices; }
 			const std::vector<uint32_t>& Indices() const { return m_indices; }
 
+			// geometry either lives in the vectors above or is a view into memory owned by the model (e.g. a mapped cooked file)
+			void SetGeometryView(const MeshVertex* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+			const MeshVertex* VertexData() const { return m_vertexView != nullptr ? m_vertexView : m_vertices.data(); }
+			uint32_t VertexCount() const { return m_vertexView != nullptr ? m_vertexViewCount : (uint32_t)m_vertices.size(); }
+			const uint32_t* IndexData() const { return m_indexView != nullptr ? m_indexView : m_indices.data(); }
+			uint32_t IndexCount() const { return m_indexView != nullptr ? m_indexViewCount : (uint32_t)m_indices.size(); }
+
 			void SetMaterial(MeshMaterial&& m) { m_material = std::move(m); }
 			const MeshMaterial& Material() const { return m_material; }
 
@@ -98,6 +109,10 @@ namespace Engine
 		private:
 			std::vector<MeshVertex> m_vertices;	// verts are in mesh space
 			std::vector<uint32_t> m_indices;
+			const MeshVertex* m_vertexView = nullptr;
+			uint32_t m_vertexViewCount = 0;
+			const uint32_t* m_indexView = nullptr;
+			uint32_t m_indexViewCount = 0;
 			MeshMaterial m_material;
 			glm::mat4 m_transform;
 			glm::vec3 m_boundsMin;		// bounds are in mesh space
@@ -113,18 +128,24 @@ namespace Engine
 			Model(const Model&) = delete;
 			Model(Model&&) = default;
 
-			static std::unique_ptr<Model> Load(const char* path);
+			// uses the cooked version if it is up to date, otherwise imports the source and cooks it for next time
+			static std::unique_ptr<Model> Load(const char* path, bool* loadedFromCooked = nullptr);
 
 			std::vector<ModelMesh>& Meshes() { return m_meshes; }
 			const std::vector<ModelMesh>& Meshes() const { return m_meshes; }
 			const std::string& GetPath() const { return m_path; }
 			void CalculateAABB(glm::vec3& minb, glm::vec3& maxb) const;
 
+			// keeps the memory referenced by mesh geometry views alive for the lifetime of the model
+			void SetGeometryStorage(std::shared_ptr<Core::MappedFile> storage) { m_geometryStorage = std::move(storage); }
+
 		private:
+			static std::unique_ptr<Model> LoadFromSource(const char* path);
 			static void ParseSceneNode(const aiScene* scene, const aiNode* node, Model& model, glm::mat4 parentTransform);
 			static void ProcessMesh(const aiScene* scene, const aiMesh* mesh, Model& model, glm::mat4 parentTransform);
 			void SetPath(const char* p) { m_path = p; }
 			std::vector<ModelMesh> m_meshes;
+			std::shared_ptr<Core::MappedFile> m_geometryStorage;
 			std::string m_path;
 		};
 
@@ -7,18 +7,23 @@
 #include "file_picker_dialog.h"
 #include "debug_gui_system.h"
 #include "debug_gui_menubar.h"
+#include "file_watcher_system.h"
 #include "core/profiler.h"
+#include "core/timer.h"
+#include "core/log.h"
 #include "core/thread.h"
 #include "engine/system_manager.h"
 #include "render/device.h"
 #include "render/mesh.h"
 #include "render/render_buffer.h"
 #include "render/vertex_array.h"
+#include <algorithm>
 
 namespace Engine
 {
 	const uint32_t c_maxVertices = 1024 * 1024 * 16;
 	const uint32_t c_maxIndices = 1024 * 1024 * 64;
+	const uint32_t c_framesBeforeReuse = 3;		// released geometry may still be in use by frames in flight
 
 	SERIALISE_BEGIN(ModelHandle)
 		static ModelManager* mm = GetSystem<ModelManager>("Models");
@@ -34,6 +39,42 @@ namespace Engine
 		}
 	SERIALISE_END()
 
+	GeometryAllocation::GeometryAllocation(GeometryAllocation&& other)
+	{
+		*this = std::move(other);
+	}
+
+	GeometryAllocation& GeometryAllocation::operator=(GeometryAllocation&& other)
+	{
+		if (this != &other)
+		{
+			Release();
+			m_firstVertex = other.m_firstVertex;
+			m_vertexCount = other.m_vertexCount;
+			m_firstIndex = other.m_firstIndex;
+			m_indexCount = other.m_indexCount;
+			other.m_firstVertex = -1;
+			other.m_vertexCount = 0;
+			other.m_firstIndex = -1;
+			other.m_indexCount = 0;
+		}
+		return *this;
+	}
+
+	GeometryAllocation::~GeometryAllocation()
+	{
+		Release();
+	}
+
+	void GeometryAllocation::Release()
+	{
+		if (IsValid())
+		{
+			static ModelManager* mm = GetSystem<ModelManager>("Models");
+			mm->ReleaseGeometry(*this);
+		}
+	}
+
 	bool ModelManager::ShowGui(DebugGuiSystem& gui)
 	{
 		SDE_PROF_EVENT();
@@ -56,11 +97,54 @@ namespace Engine
 			int32_t inFlight = m_inFlightModels;
 			sprintf_s(text, "Loading: %d", inFlight);
 			gui.Text(text);
+			LoadStats stats;
+			{
+				Core::ScopedMutex guard(m_loadedModelsMutex);
+				stats = m_loadStats;
+			}
+			sprintf_s(text, "Cold loads (source + cook): %d, %.2fms total, %.2fms avg", stats.m_coldLoads,
+				stats.m_coldLoadSeconds * 1000.0, stats.m_coldLoads > 0 ? (stats.m_coldLoadSeconds * 1000.0) / stats.m_coldLoads : 0.0);
+			gui.Text(text);
+			sprintf_s(text, "Warm loads (cooked): %d, %.2fms total, %.2fms avg", stats.m_warmLoads,
+				stats.m_warmLoadSeconds * 1000.0, stats.m_warmLoads > 0 ? (stats.m_warmLoadSeconds * 1000.0) / stats.m_warmLoads : 0.0);
+			gui.Text(text);
+			gui.Separator();
+			Core::OffsetAllocator::Stats vertexStats, indexStats;
+			size_t pendingFrees = 0;
+			uint32_t failedAllocations = 0;
+			{
+				Core::ScopedMutex guard(m_allocatorMutex);
+				vertexStats = m_vertexAllocator.GetStats();
+				indexStats = m_indexAllocator.GetStats();
+				pendingFrees = m_pendingFrees.size();
+				failedAllocations = m_failedAllocations;
+			}
+			auto showAllocatorStats = [&](const char* name, const Core::OffsetAllocator::Stats& s, size_t elementSize) {
+				const uint32_t freeSize = s.m_totalSize - s.m_usedSize;
+				const float fragmentation = freeSize > 0 ? 100.0f * (1.0f - (float)s.m_largestFreeBlock / (float)freeSize) : 0.0f;
+				sprintf_s(text, "%s: %u / %u used (%.1fMB), %u allocations", name, s.m_usedSize, s.m_totalSize,
+					((double)s.m_usedSize * elementSize) / (1024.0 * 1024.0), s.m_allocationCount);
+				gui.Text(text);
+				sprintf_s(text, "    %u free blocks, largest %u, %.1f%% fragmented", s.m_freeBlockCount, s.m_largestFreeBlock, fragmentation);
+				gui.Text(text);
+			};
+			showAllocatorStats("Vertices", vertexStats, sizeof(Assets::MeshVertex));
+			showAllocatorStats("Indices", indexStats, sizeof(uint32_t));
+			sprintf_s(text, "Waiting to be freed: %d, failed allocations: %u", (int)pendingFrees, failedAllocations);
+			gui.Text(text);
+			sprintf_s(text, "Last defragment: %u models, %u vertices, %u indices moved in %.2fms", m_lastDefragment.m_modelsMoved,
+				m_lastDefragment.m_verticesMoved, m_lastDefragment.m_indicesMoved, m_lastDefragment.m_seconds * 1000.0);
+			gui.Text(text);
+			if (gui.Button("Defragment"))
+			{
+				Defragment();
+			}
 			gui.Separator();
 			auto& textures = *Engine::GetSystem<Engine::TextureManager>("Textures");
 			if (gui.TreeNode("All Models", true))
 			{
-				for (int t = 0; t < m_models.size(); ++t)
+				Core::ScopedMutex guard(m_registry.GetMutex());
+				for (uint32_t t = 0; t < m_models.Size(); ++t)
 				{
 					sprintf_s(text, "%s", m_models[t].m_name.c_str());
 					if (m_models[t].m_renderModel.get() && gui.TreeNode(text))
@@ -130,16 +214,16 @@ namespace Engine
 			Core::ScopedMutex guard(m_loadedModelsMutex);
 			m_loadedModels.clear();
 		}
-		// reset allocators
-		m_nextVertex = 0;
-		m_nextIndex = 0;
 
-		// now load the models again
-		auto currentModels = std::move(m_models);
-		for (int m = 0; m < currentModels.size(); ++m)
+		// release the old models first so their space can be reused by the new ones, then load them again in place
+		Core::ScopedMutex guard(m_registry.GetMutex());
+		for (uint32_t m = 0; m < m_models.Size(); ++m)
 		{
-			auto newHandle = LoadModel(currentModels[m].m_name.c_str());
-			assert(m == newHandle.m_index);
+			auto& desc = m_models[m];
+			desc.m_current = nullptr;
+			desc.m_renderModel = nullptr;
+			desc.m_isLoading = true;
+			StartModelLoad(desc.m_name, { m });
 		}
 	}
 
@@ -163,6 +247,7 @@ namespace Engine
 			dd.m_specular = packedSpecular;
 			dd.m_shininess.r = mat.Shininess();
 			dd.m_diffuseTexture = tm.LoadTexture(diffusePath.c_str());
+			tm.SetCompressionEnabled(normalPath, false);	// BC1 artifacts are very visible in lighting
 			dd.m_normalsTexture = tm.LoadTexture(normalPath.c_str());
 			dd.m_specularTexture = tm.LoadTexture(specPath.c_str());
 			dd.m_castsShadows = true;
@@ -183,28 +268,180 @@ namespace Engine
 		for (auto& loadedModel : loadedModels)
 		{
 			assert(loadedModel.m_destinationHandle.m_index != -1);
-			if (loadedModel.m_renderModel != nullptr)
+			const bool loaded = loadedModel.m_renderModel != nullptr;
+			if (loaded)
 			{
 				FinaliseModel(*loadedModel.m_model, *loadedModel.m_renderModel);
-				m_models[loadedModel.m_destinationHandle.m_index].m_renderModel = std::move(loadedModel.m_renderModel);
-				if (loadedModel.m_onFinish != nullptr)
+			}
+			std::vector<OnFinishFn> onFinish;
+			{
+				Core::ScopedMutex guard(m_registry.GetMutex());
+				auto& desc = m_models[loadedModel.m_destinationHandle.m_index];
+				if (loaded)
 				{
-					loadedModel.m_onFinish(true, loadedModel.m_destinationHandle);
+					desc.m_current = loadedModel.m_renderModel.get();
+					desc.m_renderModel = std::move(loadedModel.m_renderModel);
 				}
+				desc.m_isLoading = false;
+				onFinish = std::move(desc.m_onFinish);
+				desc.m_onFinish.clear();
+			}
+			for (auto& fn : onFinish)	// callbacks may load more models, so no lock here
+			{
+				fn(loaded, loadedModel.m_destinationHandle);
 			}
 		}
 	}
 
-	uint32_t ModelManager::AllocateIndices(uint32_t count)
+	GeometryAllocation ModelManager::AllocateGeometry(uint32_t vertexCount, uint32_t indexCount)
 	{
-		uint64_t newIndex = m_nextIndex.fetch_add(count);
-		return newIndex < c_maxIndices ? newIndex : -1;
+		SDE_PROF_EVENT();
+		GeometryAllocation result;
+		if (vertexCount == 0 || indexCount == 0)
+		{
+			return result;
+		}
+		Core::ScopedMutex guard(m_allocatorMutex);
+		const uint32_t firstVertex = m_vertexAllocator.Allocate(vertexCount);
+		const uint32_t firstIndex = m_indexAllocator.Allocate(indexCount);
+		if (firstVertex == Core::OffsetAllocator::c_invalidOffset || firstIndex == Core::OffsetAllocator::c_invalidOffset)
+		{
+			if (firstVertex != Core::OffsetAllocator::c_invalidOffset)
+			{
+				m_vertexAllocator.Free(firstVertex);
+			}
+			if (firstIndex != Core::OffsetAllocator::c_invalidOffset)
+			{
+				m_indexAllocator.Free(firstIndex);
+			}
+			++m_failedAllocations;
+			return result;
+		}
+		result.m_firstVertex = firstVertex;
+		result.m_vertexCount = vertexCount;
+		result.m_firstIndex = firstIndex;
+		result.m_indexCount = indexCount;
+		return result;
+	}
+
+	void ModelManager::UploadVertices(const GeometryAllocation& g, uint32_t firstVertex, uint32_t count, const Assets::MeshVertex* vertices)
+	{
+		assert(g.IsValid() && firstVertex + count <= g.m_vertexCount);
+		const size_t vertexSize = sizeof(Assets::MeshVertex);
+		m_globalVertexData->SetData((g.m_firstVertex + firstVertex) * vertexSize, count * vertexSize, vertices);
+	}
+
+	void ModelManager::UploadIndices(const GeometryAllocation& g, uint32_t firstIndex, uint32_t count, const uint32_t* indices)
+	{
+		assert(g.IsValid() && firstIndex + count <= g.m_indexCount);
+		m_globalIndexData->SetData((g.m_firstIndex + firstIndex) * sizeof(uint32_t), count * sizeof(uint32_t), indices);
 	}
 
-	uint32_t ModelManager::AllocateVertices(uint32_t count)
+	void ModelManager::ReleaseGeometry(GeometryAllocation& g)
 	{
-		uint64_t newIndex = m_nextVertex.fetch_add(count);
-		return newIndex < c_maxVertices ? newIndex : -1;
+		if (g.IsValid())
+		{
+			Core::ScopedMutex guard(m_allocatorMutex);
+			m_pendingFrees.push_back({ g.m_firstVertex, g.m_firstIndex, c_framesBeforeReuse });
+		}
+		g.m_firstVertex = -1;
+		g.m_vertexCount = 0;
+		g.m_firstIndex = -1;
+		g.m_indexCount = 0;
+	}
+
+	void ModelManager::ProcessPendingFrees()
+	{
+		SDE_PROF_EVENT();
+		Core::ScopedMutex guard(m_allocatorMutex);
+		for (int i = 0; i < m_pendingFrees.size();)
+		{
+			auto& pending = m_pendingFrees[i];
+			if (--pending.m_framesRemaining == 0)
+			{
+				if (pending.m_firstVertex != -1)
+				{
+					m_vertexAllocator.Free(pending.m_firstVertex);
+				}
+				if (pending.m_firstIndex != -1)
+				{
+					m_indexAllocator.Free(pending.m_firstIndex);
+				}
+				pending = m_pendingFrees.back();
+				m_pendingFrees.pop_back();
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	// Each model is moved into the lowest free range that fits, if one exists below it
+	// Data is copied on the gpu and the chunks are patched, the old ranges are released as normal
+	// Only model geometry is moved, anything else using the buffers owns its own allocations
+	void ModelManager::Defragment()
+	{
+		SDE_PROF_EVENT();
+		DefragmentStats stats;
+		{
+			Core::ScopedTimer timeDefrag(stats.m_seconds);
+			std::vector<Model*> modelsToMove;
+			{
+				Core::ScopedMutex guard(m_registry.GetMutex());
+				for (uint32_t m = 0; m < m_models.Size(); ++m)
+				{
+					const auto& desc = m_models[m];
+					if (desc.m_renderModel != nullptr && desc.m_renderModel->Geometry().IsValid())
+					{
+						modelsToMove.push_back(desc.m_renderModel.get());
+					}
+				}
+			}
+			std::sort(modelsToMove.begin(), modelsToMove.end(), [](const Model* m0, const Model* m1) {
+				return m0->Geometry().m_firstVertex < m1->Geometry().m_firstVertex;
+			});
+
+			const size_t vertexSize = sizeof(Assets::MeshVertex);
+			Core::ScopedMutex guard(m_allocatorMutex);
+			for (Model* model : modelsToMove)
+			{
+				GeometryAllocation& g = model->Geometry();
+				int64_t vertexDelta = 0, indexDelta = 0;
+				const uint32_t newVertex = m_vertexAllocator.AllocateBelow(g.m_firstVertex);
+				if (newVertex != Core::OffsetAllocator::c_invalidOffset)
+				{
+					m_globalVertexData->CopyData(*m_globalVertexData, g.m_firstVertex * vertexSize, newVertex * vertexSize, g.m_vertexCount * vertexSize);
+					m_pendingFrees.push_back({ g.m_firstVertex, (uint32_t)-1, c_framesBeforeReuse });
+					vertexDelta = (int64_t)newVertex - (int64_t)g.m_firstVertex;
+					g.m_firstVertex = newVertex;
+					stats.m_verticesMoved += g.m_vertexCount;
+				}
+				const uint32_t newIndex = m_indexAllocator.AllocateBelow(g.m_firstIndex);
+				if (newIndex != Core::OffsetAllocator::c_invalidOffset)
+				{
+					m_globalIndexData->CopyData(*m_globalIndexData, g.m_firstIndex * sizeof(uint32_t), newIndex * sizeof(uint32_t), g.m_indexCount * sizeof(uint32_t));
+					m_pendingFrees.push_back({ (uint32_t)-1, g.m_firstIndex, c_framesBeforeReuse });
+					indexDelta = (int64_t)newIndex - (int64_t)g.m_firstIndex;
+					g.m_firstIndex = newIndex;
+					stats.m_indicesMoved += g.m_indexCount;
+				}
+				if (vertexDelta != 0 || indexDelta != 0)
+				{
+					for (auto& part : model->MeshParts())
+					{
+						for (auto& chunk : part.m_chunks)
+						{
+							chunk.m_firstVertex = (uint32_t)(chunk.m_firstVertex + indexDelta);
+							chunk.m_baseVertex = (int32_t)(chunk.m_baseVertex + vertexDelta);
+						}
+					}
+					++stats.m_modelsMoved;
+				}
+			}
+		}
+		m_lastDefragment = stats;
+		SDE_LOG("Defragmented model buffers, moved %u models (%u vertices, %u indices) in %.2fms", stats.m_modelsMoved, stats.m_verticesMoved, stats.m_indicesMoved, stats.m_seconds * 1000.0);
 	}
 
 	std::unique_ptr<Model> ModelManager::CreateNewModel(const Assets::Model& model)
@@ -216,41 +453,43 @@ namespace Engine
 		const auto meshCount = model.Meshes().size();
 		for (int index = 0; index < meshCount; ++index)
 		{
-			totalIndices += model.Meshes()[index].Indices().size();
-			totalVertices += model.Meshes()[index].Vertices().size();
+			totalIndices += model.Meshes()[index].IndexCount();
+			totalVertices += model.Meshes()[index].VertexCount();
+		}
+		GeometryAllocation geometry = AllocateGeometry(totalVertices, totalIndices);
+		if (!geometry.IsValid() && totalVertices > 0 && totalIndices > 0)
+		{
+			SDE_LOG("No space for %u vertices + %u indices in the global model buffers", totalVertices, totalIndices);
+			return nullptr;
 		}
-		const uint32_t indexBufferOffset = AllocateIndices(totalIndices);
-		const uint32_t vertexBufferOffset = AllocateVertices(totalVertices);
-		std::vector<uint32_t> indicesToUpload;	// upload all parts in one go
-		indicesToUpload.reserve(totalIndices);
-		std::vector<Assets::MeshVertex> verticesToUpload;
-		verticesToUpload.reserve(totalVertices);
-		uint32_t currentIndexOffset = indexBufferOffset;
-		uint32_t currentVertexOffset = vertexBufferOffset;
+		uint32_t currentIndexOffset = 0;	// relative to the allocation
+		uint32_t currentVertexOffset = 0;
 		auto resultModel = std::make_unique<Model>();
 		for (int index = 0; index < meshCount; ++index)
 		{
+			// indices are relative to each part, the base vertex in the chunk does the fixup so everything goes straight to the gpu
 			const auto& loadedMesh = model.Meshes()[index];
-			verticesToUpload.insert(verticesToUpload.end(), loadedMesh.Vertices().begin(), loadedMesh.Vertices().end());
-			for (const auto i : loadedMesh.Indices())
+			const uint32_t vertexCount = loadedMesh.VertexCount();
+			const uint32_t indexCount = loadedMesh.IndexCount();
+			if (vertexCount > 0 && indexCount > 0)
 			{
-				indicesToUpload.push_back(currentVertexOffset + i);
+				UploadVertices(geometry, currentVertexOffset, vertexCount, loadedMesh.VertexData());
+				UploadIndices(geometry, currentIndexOffset, indexCount, loadedMesh.IndexData());
 			}
 			
 			Model::MeshPart newPart;
 			newPart.m_transform = loadedMesh.Transform();
 			newPart.m_boundsMin = loadedMesh.BoundsMin();
 			newPart.m_boundsMax = loadedMesh.BoundsMax();
-			Render::MeshChunk chunk { currentIndexOffset, (uint32_t)loadedMesh.Indices().size(), Render::PrimitiveType::Triangles };
+			Render::MeshChunk chunk { geometry.m_firstIndex + currentIndexOffset, indexCount, Render::PrimitiveType::Triangles, (int32_t)(geometry.m_firstVertex + currentVertexOffset) };
 			newPart.m_chunks.push_back(chunk);
 			
 			resultModel->MeshParts().push_back(std::move(newPart));
 
-			currentIndexOffset += loadedMesh.Indices().size();
-			currentVertexOffset += loadedMesh.Vertices().size();
+			currentIndexOffset += indexCount;
+			currentVertexOffset += vertexCount;
 		}
-		m_globalIndexData->SetData(indexBufferOffset * sizeof(uint32_t), indicesToUpload.size() * sizeof(uint32_t), &indicesToUpload[0]);
-		m_globalVertexData->SetData(vertexBufferOffset * sizeof(Assets::MeshVertex), verticesToUpload.size() * sizeof(Assets::MeshVertex), &verticesToUpload[0]);
+		resultModel->Geometry() = std::move(geometry);
 	
 		// Ensure any writes are shared with all contexts
 		Render::Device::FlushContext();
@@ -267,69 +506,115 @@ namespace Engine
 	{
 		SDE_PROF_EVENT();
 
-		for (uint64_t i = 0; i < m_models.size(); ++i)
+		// always make a valid handle
+		bool wasAdded = false;
+		const uint32_t index = m_registry.FindOrAdd(path, [&]() {
+			return m_models.Add([&](ModelDesc& newModel) {
+				newModel.m_name = path;
+				newModel.m_isLoading = true;
+				if (onFinish)
+				{
+					newModel.m_onFinish.push_back(onFinish);
+				}
+			});
+		}, wasAdded);
+		auto newHandle = ModelHandle{ index };
+		if (wasAdded)
 		{
-			if (m_models[i].m_name == path)
+			StartModelLoad(path, newHandle);
+			return newHandle;
+		}
+
+		// already requested, if the first load is still in flight wait for it
+		if (onFinish)
+		{
+			bool isLoaded = false;
 			{
-				ModelHandle result = { static_cast<uint32_t>(i) };
-				if (onFinish)
-					onFinish(true, result);
-				return result;
+				Core::ScopedMutex guard(m_registry.GetMutex());
+				auto& desc = m_models[index];
+				if (desc.m_isLoading)
+				{
+					desc.m_onFinish.push_back(std::move(onFinish));
+					return newHandle;
+				}
+				isLoaded = desc.m_renderModel != nullptr;
 			}
+			onFinish(isLoaded, newHandle);
 		}
+		return newHandle;
+	}
 
-		// always make a valid handle
-		m_models.push_back({nullptr, path });
-		auto newHandle = ModelHandle{ static_cast<uint32_t>(m_models.size() - 1) };
+	void ModelManager::ReloadModel(const std::string& path)
+	{
+		SDE_PROF_EVENT();
+		const std::string changedPath = Core::FileWatcher::NormalisePath(path);
+		Core::ScopedMutex guard(m_registry.GetMutex());
+		for (uint32_t m = 0; m < m_models.Size(); ++m)
+		{
+			if (Core::FileWatcher::NormalisePath(m_models[m].m_name) == changedPath)
+			{
+				// the old model is used until the new one arrives, then its vertex + index space is released
+				SDE_LOG("Reloading model '%s'", m_models[m].m_name.c_str());
+				StartModelLoad(m_models[m].m_name, { m });
+			}
+		}
+	}
+
+	// results always go through m_loadedModels, even failures, so callbacks only ever run on the main thread
+	void ModelManager::StartModelLoad(const std::string& path, ModelHandle newHandle)
+	{
 		m_inFlightModels += 1;
 
 		std::string pathString = path;
-		GetSystem<JobSystem>("Jobs")->PushSlowJob([this, pathString, newHandle, onFinish](void*) {
+		GetSystem<JobSystem>("Jobs")->PushSlowJob([this, pathString, newHandle](void*) {
 			char debugName[1024] = { '\0' };
 			sprintf_s(debugName, "LoadModel %s", pathString.c_str());
 			SDE_PROF_EVENT_DYN(debugName);
 
-			auto loadedAsset = Assets::Model::Load(pathString.c_str());
-			if (loadedAsset != nullptr)
+			double loadTime = 0.0;
+			bool loadedFromCooked = false;
+			std::unique_ptr<Assets::Model> loadedAsset;
+			{
+				Core::ScopedTimer timeLoad(loadTime);
+				loadedAsset = Assets::Model::Load(pathString.c_str(), &loadedFromCooked);
+			}
+			std::unique_ptr<Model> newModel = loadedAsset != nullptr ? CreateNewModel(*loadedAsset) : nullptr;
+			if (newModel != nullptr)
 			{
-				auto testModel = CreateNewModel(*loadedAsset);
 				{
 					Core::ScopedMutex guard(m_loadedModelsMutex);
-					m_loadedModels.push_back({ std::move(loadedAsset), std::move(testModel), newHandle });
+					m_loadedModels.push_back({ std::move(loadedAsset), std::move(newModel), newHandle });
+					if (loadedFromCooked)
+					{
+						m_loadStats.m_warmLoads++;
+						m_loadStats.m_warmLoadSeconds += loadTime;
+					}
+					else
+					{
+						m_loadStats.m_coldLoads++;
+						m_loadStats.m_coldLoadSeconds += loadTime;
+					}
 				}
 			}
-			else if (onFinish != nullptr)
+			else
 			{
-				onFinish(false, newHandle);
+				Core::ScopedMutex guard(m_loadedModelsMutex);
+				m_loadedModels.push_back({ nullptr, nullptr, newHandle });
 			}
 			m_inFlightModels -= 1;
 		});
-		
-		return newHandle;
 	}
 
 	std::string ModelManager::GetModelPath(const ModelHandle& h)
 	{
-		if (h.m_index != -1 && h.m_index < m_models.size())
-		{
-			return m_models[h.m_index].m_name;
-		}
-		else
-		{
-			return "<Empty Handle>";
-		}
+		const ModelDesc* desc = m_models.TryGet(h.m_index);
+		return desc != nullptr ? desc->m_name : "<Empty Handle>";
 	}
 
 	Model* ModelManager::GetModel(const ModelHandle& h)
 	{
-		if (h.m_index != -1 && h.m_index < m_models.size())
-		{
-			return m_models[h.m_index].m_renderModel.get();
-		}
-		else
-		{
-			return nullptr;
-		}
+		const ModelDesc* desc = m_models.TryGet(h.m_index);
+		return desc != nullptr ? desc->m_current.load(std::memory_order_acquire) : nullptr;
 	}
 
 	bool ModelManager::Initialise()
@@ -349,6 +634,21 @@ namespace Engine
 		m_globalVertexArray->AddBuffer(3, vertexBuffer, Render::VertexDataType::Float, 2, sizeof(float) * 9, vertexSize);	// uv
 		m_globalVertexArray->Create();
 
+		m_vertexAllocator.Reset(c_maxVertices);
+		m_indexAllocator.Reset(c_maxIndices);
+
+		return true;
+	}
+
+	bool ModelManager::PostInit()
+	{
+		auto fileWatcher = GetSystem<FileWatcherSystem>("FileWatcher");
+		if (fileWatcher != nullptr)
+		{
+			fileWatcher->RegisterChangeHandler([this](const std::string& path) {
+				ReloadModel(path);
+			});
+		}
 		return true;
 	}
 
@@ -356,6 +656,7 @@ namespace Engine
 	{
 		SDE_PROF_EVENT();
 
+		ProcessPendingFrees();
 		ProcessLoadedModels();
 		ShowGui(*Engine::GetSystem<Engine::DebugGuiSystem>("DebugGui"));
 
@@ -375,7 +676,17 @@ namespace Engine
 			Core::ScopedMutex guard(m_loadedModelsMutex);
 			m_loadedModels.clear();
 		}
-		m_models.clear();
+		{
+			Core::ScopedMutex guard(m_registry.GetMutex());
+			m_models.Clear();
+		}
+		m_registry.Clear();
+		{
+			Core::ScopedMutex guard(m_allocatorMutex);
+			m_pendingFrees.clear();
+			m_vertexAllocator.Reset(c_maxVertices);
+			m_indexAllocator.Reset(c_maxIndices);
+		}
 
 		m_globalVertexArray = nullptr;
 		m_globalVertexData = nullptr;
@@ -3,11 +3,15 @@
 #include "system.h"
 #include "model.h"
 #include "model_asset.h"
+#include "asset_registry.h"
+#include "asset_array.h"
 #include "core/mutex.h"
+#include "core/offset_allocator.h"
 #include "render/mesh_builder.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
 
 namespace Engine
 {
@@ -25,46 +29,92 @@ namespace Engine
 		Model* GetModel(const ModelHandle& h);
 		std::string GetModelPath(const ModelHandle& h);
 		void ReloadAll();
+		void ReloadModel(const std::string& path);	// if the model is loaded, replace it with the current file contents
 
 		Render::VertexArray* GetVertexArray() { return m_globalVertexArray.get(); }
 		Render::RenderBuffer* GetIndexBuffer() { return m_globalIndexData.get(); }
 
+		// Space in the global buffers, can be used by anything that draws with the model vertex layout
+		// Allocate/upload are thread safe, uploads from jobs must flush the context before the data is used
+		GeometryAllocation AllocateGeometry(uint32_t vertexCount, uint32_t indexCount);	// invalid if there is no space
+		void UploadVertices(const GeometryAllocation& g, uint32_t firstVertex, uint32_t count, const Assets::MeshVertex* vertices);	// firstVertex is relative to the allocation
+		void UploadIndices(const GeometryAllocation& g, uint32_t firstIndex, uint32_t count, const uint32_t* indices);
+		void ReleaseGeometry(GeometryAllocation& g);	// the space is reused once the gpu can no longer be reading it
+		void Defragment();		// moves model geometry down into free space, main thread only
+
 		virtual bool Initialise();
+		virtual bool PostInit();
 		virtual bool Tick(float timeDelta);
 		virtual void Shutdown();
 
 	private:
+		using OnFinishFn = std::function<void(bool, ModelHandle)>;
+		void StartModelLoad(const std::string& path, ModelHandle destination);
 		void ProcessLoadedModels();
 		bool ShowGui(DebugGuiSystem& gui);
 
+		// m_name is set once when the model is added, m_current can be read without a lock
+		// everything else is protected by the registry mutex
 		struct ModelDesc 
 		{
 			std::unique_ptr<Model> m_renderModel;
+			std::atomic<Model*> m_current = nullptr;	// m_renderModel.get()
 			std::string m_name;
+			bool m_isLoading = false;				// first load is in flight
+			std::vector<OnFinishFn> m_onFinish;		// everyone that asked for the model while it was loading
 		};
 		struct ModelLoadResult
 		{
 			std::unique_ptr<Assets::Model> m_model;
-			std::unique_ptr<Model> m_renderModel;
+			std::unique_ptr<Model> m_renderModel;	// null if the load failed
 			ModelHandle m_destinationHandle;
-			std::function<void(bool, ModelHandle)> m_onFinish;
 		};
 		std::unique_ptr<Model> CreateNewModel(const Assets::Model&);
 		void FinaliseModel(Assets::Model& model, Model& renderModel);
 
-		std::vector<ModelDesc> m_models;
+		AssetArray<ModelDesc> m_models;		// added to with the registry mutex held, lookups don't lock
+		AssetRegistry m_registry;		// path -> index into m_models
 	
 		Core::Mutex m_loadedModelsMutex;
-		std::vector<ModelLoadResult> m_loadedModels;	// models to process after successful load
+		std::vector<ModelLoadResult> m_loadedModels;	// models to process after load, successful or not
 		std::atomic<int32_t> m_inFlightModels = 0;
 
+		// load times, cold = imported from source and cooked, warm = loaded from the cooked file
+		struct LoadStats
+		{
+			uint32_t m_coldLoads = 0;
+			double m_coldLoadSeconds = 0.0;
+			uint32_t m_warmLoads = 0;
+			double m_warmLoadSeconds = 0.0;
+		};
+		LoadStats m_loadStats;			// protected by m_loadedModelsMutex
+
 		// all models are loaded into these buffers
-		uint32_t AllocateIndices(uint32_t count);
-		uint32_t AllocateVertices(uint32_t count);
 		std::unique_ptr<Render::VertexArray> m_globalVertexArray;
 		std::unique_ptr<Render::RenderBuffer> m_globalVertexData;
-		std::atomic<uint32_t> m_nextVertex = 0;
 		std::unique_ptr<Render::RenderBuffer> m_globalIndexData;
-		std::atomic<uint32_t> m_nextIndex = 0;
+
+		// free space in the global buffers, released ranges wait a few frames before they can be reused
+		void ProcessPendingFrees();
+		struct PendingFree
+		{
+			uint32_t m_firstVertex;
+			uint32_t m_firstIndex;
+			uint32_t m_framesRemaining;
+		};
+		Core::Mutex m_allocatorMutex;
+		Core::OffsetAllocator m_vertexAllocator;
+		Core::OffsetAllocator m_indexAllocator;
+		std::vector<PendingFree> m_pendingFrees;
+		uint32_t m_failedAllocations = 0;
+
+		struct DefragmentStats
+		{
+			uint32_t m_modelsMoved = 0;
+			uint32_t m_verticesMoved = 0;
+			uint32_t m_indicesMoved = 0;
+			double m_seconds = 0.0;
+		};
+		DefragmentStats m_lastDefragment;
 	};
 }
\ No newline at end of file
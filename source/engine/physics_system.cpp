@@ -363,15 +363,16 @@ namespace Engine
 		m_scene->addActor(*body);
 	}
 
-	EntityHandle PhysicsSystem::Raycast(glm::vec3 start, glm::vec3 end, float& tHit, glm::vec3& hitNormal)
-	{
-		SDE_PROF_EVENT();
+	const uint32_t c_queriesPerJob = 256;
 
+	// shared by the single and batched queries, safe to call from multiple threads while nothing writes to the scene
+	EntityHandle PhysicsSystem::RaycastScene(physx::PxScene& scene, glm::vec3 start, glm::vec3 end, float& tHit, glm::vec3& hitNormal)
+	{
 		const auto origin = physx::PxVec3(start.x, start.y, start.z);
 		const auto dir = glm::normalize(end - start);
 		const auto pxDir = physx::PxVec3(dir.x, dir.y, dir.z);
 		physx::PxRaycastBuffer hitResult;
-		bool hit = m_scene->raycast(origin, pxDir, glm::length(end - start), hitResult);
+		bool hit = scene.raycast(origin, pxDir, glm::length(end - start), hitResult);
 		if (hit)
 		{
 			const auto& pxHitPos = hitResult.block.position;
@@ -387,14 +388,13 @@ namespace Engine
 		return {};
 	}
 
-	bool PhysicsSystem::SweepCapsule(float radius, float halfHeight, glm::vec3 pos, glm::quat rot, glm::vec3 direction, float distance,
-		glm::vec3& hitPos, glm::vec3& hitNormal, float& hitDistance, EntityHandle& hitEntity, EntityHandle ignoreEntity)
+	static bool SweepCapsuleScene(physx::PxScene& scene, const PhysicsSystem::CapsuleSweep& sweep,
+		glm::vec3& hitPos, glm::vec3& hitNormal, float& hitDistance, EntityHandle& hitEntity)
 	{
-		SDE_PROF_EVENT();
-
-		physx::PxCapsuleGeometry capsuleGeom(radius, halfHeight);
-		physx::PxVec3 origin(pos.x, pos.y, pos.z);
-		physx::PxVec3 unitDir(direction.x, direction.y, direction.z);
+		physx::PxCapsuleGeometry capsuleGeom(sweep.m_radius, sweep.m_halfHeight);
+		physx::PxVec3 origin(sweep.m_position.x, sweep.m_position.y, sweep.m_position.z);
+		physx::PxVec3 unitDir(sweep.m_direction.x, sweep.m_direction.y, sweep.m_direction.z);
+		const glm::quat& rot = sweep.m_orientation;
 
 		// physx capsules are oriented on x axis, but we prefer y
 		physx::PxTransform capsulePose(origin, { rot.x, rot.y, rot.z, rot.w });
@@ -402,10 +402,10 @@ namespace Engine
 
 		// passing an array allows us to get a list of everything touched
 		// we don't get any blocking touches, so we need to figure out the closes hit ourselves
-		static physx::PxSweepHit sweepResults[4];
+		physx::PxSweepHit sweepResults[4];
 		physx::PxSweepBuffer results(sweepResults, 4);
 		auto flags = physx::PxHitFlag::eDEFAULT | physx::PxHitFlag::eMTD;	// mtd = depth of penetration
-		bool hitSomething = m_scene->sweep(capsuleGeom, capsulePose, unitDir, distance, results, flags);
+		bool hitSomething = scene.sweep(capsuleGeom, capsulePose, unitDir, sweep.m_distance, results, flags);
 		if (hitSomething && results.getNbAnyHits() > 0)
 		{
 			physx::PxVec3 hitPosPx;
@@ -416,10 +416,10 @@ namespace Engine
 			{
 				if (results.touches[t].distance < closestHitDist)
 				{
-					if (ignoreEntity.GetID() != -1 && results.touches[t].actor)
+					if (sweep.m_ignoreEntity.GetID() != -1 && results.touches[t].actor)
 					{
 						auto entityId = reinterpret_cast<uintptr_t>(results.touches[t].actor->userData);
-						if (entityId == ignoreEntity.GetID())
+						if (entityId == sweep.m_ignoreEntity.GetID())
 						{
 							continue;
 						}
@@ -448,6 +448,91 @@ namespace Engine
 		return hitSomething;
 	}
 
+	EntityHandle PhysicsSystem::Raycast(glm::vec3 start, glm::vec3 end, float& tHit, glm::vec3& hitNormal)
+	{
+		SDE_PROF_EVENT();
+		return RaycastScene(*m_scene.Get(), start, end, tHit, hitNormal);
+	}
+
+	bool PhysicsSystem::SweepCapsule(float radius, float halfHeight, glm::vec3 pos, glm::quat rot, glm::vec3 direction, float distance,
+		glm::vec3& hitPos, glm::vec3& hitNormal, float& hitDistance, EntityHandle& hitEntity, EntityHandle ignoreEntity)
+	{
+		SDE_PROF_EVENT();
+		const CapsuleSweep sweep = { radius, halfHeight, pos, rot, direction, distance, ignoreEntity };
+		return SweepCapsuleScene(*m_scene.Get(), sweep, hitPos, hitNormal, hitDistance, hitEntity);
+	}
+
+	void PhysicsSystem::RaycastBatchResults::Resize(size_t count)
+	{
+		m_hitEntity.resize(count);
+		m_tHit.resize(count);
+		m_hitNormal.resize(count);
+	}
+
+	void PhysicsSystem::SweepBatchResults::Resize(size_t count)
+	{
+		m_hit.resize(count);
+		m_hitPos.resize(count);
+		m_hitNormal.resize(count);
+		m_hitDistance.resize(count);
+		m_hitEntity.resize(count);
+	}
+
+	void PhysicsSystem::RaycastBatch(const glm::vec3* starts, const glm::vec3* ends, uint32_t count, RaycastBatchResults& results)
+	{
+		RaycastBatch(*m_scene.Get(), *m_jobSystem, starts, ends, count, results);
+	}
+
+	void PhysicsSystem::RaycastBatch(physx::PxScene& scene, JobSystem& jobs, const glm::vec3* starts, const glm::vec3* ends, uint32_t count, RaycastBatchResults& results)
+	{
+		SDE_PROF_EVENT();
+		results.Resize(count);
+		auto runJob = [&](int32_t job) {
+			SDE_PROF_EVENT("RaycastBatchJob");
+			const uint32_t firstQuery = job * c_queriesPerJob;
+			const uint32_t lastQuery = std::min(firstQuery + c_queriesPerJob, count);
+			for (uint32_t i = firstQuery; i < lastQuery; ++i)
+			{
+				results.m_hitEntity[i] = RaycastScene(scene, starts[i], ends[i], results.m_tHit[i], results.m_hitNormal[i]);
+			}
+		};
+		const int32_t jobCount = (count + c_queriesPerJob - 1) / c_queriesPerJob;
+		if (jobCount == 1)
+		{
+			runJob(0);
+		}
+		else
+		{
+			jobs.ForEachAsync(0, jobCount, 1, 1, runJob);
+		}
+	}
+
+	void PhysicsSystem::SweepCapsuleBatch(const CapsuleSweep* sweeps, uint32_t count, SweepBatchResults& results)
+	{
+		SDE_PROF_EVENT();
+		results.Resize(count);
+		physx::PxScene& scene = *m_scene.Get();
+		auto runJob = [&](int32_t job) {
+			SDE_PROF_EVENT("SweepBatchJob");
+			const uint32_t firstQuery = job * c_queriesPerJob;
+			const uint32_t lastQuery = std::min(firstQuery + c_queriesPerJob, count);
+			for (uint32_t i = firstQuery; i < lastQuery; ++i)
+			{
+				results.m_hitEntity[i] = EntityHandle();
+				results.m_hit[i] = SweepCapsuleScene(scene, sweeps[i], results.m_hitPos[i], results.m_hitNormal[i], results.m_hitDistance[i], results.m_hitEntity[i]);
+			}
+		};
+		const int32_t jobCount = (count + c_queriesPerJob - 1) / c_queriesPerJob;
+		if (jobCount == 1)
+		{
+			runJob(0);
+		}
+		else
+		{
+			m_jobSystem->ForEachAsync(0, jobCount, 1, 1, runJob);
+		}
+	}
+
 	void PhysicsSystem::UpdateGui()
 	{
 		SDE_PROF_EVENT();
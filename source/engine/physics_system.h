@@ -35,6 +35,7 @@ namespace Engine
 		virtual ~PhysicsSystem();
 
 		bool PreInit();
+		bool CanInitOnWorkerThread(InitPhase phase) const { return phase == InitPhase::PreInit; }	// physx + cuda setup is slow and touches nothing else
 		bool PostInit();
 		bool Tick(float timeDelta);
 		void Shutdown();
@@ -64,6 +65,42 @@ namespace Engine
 			glm::vec3& hitPos, glm::vec3& hitNormal, float& hitDistance, EntityHandle& hitEntity, EntityHandle ignoreEntity=-1);
 		glm::vec3 GetGlobalGravity() const { return m_globalGravity; }
 
+		// Batched scene queries, split across the job system. Results are stored as arrays with one entry per input
+		// The jobs read the scene without locking (no eREQUIRE_RW_LOCK), this is only safe because all writes to the scene
+		// happen on the main thread and the batch returns once all its jobs are done. Do not call these while writing to the scene
+		struct RaycastBatchResults
+		{
+			void Resize(size_t count);
+			std::vector<EntityHandle> m_hitEntity;		// invalid if nothing was hit
+			std::vector<float> m_tHit;					// 0-1 along start->end
+			std::vector<glm::vec3> m_hitNormal;
+		};
+		struct CapsuleSweep
+		{
+			float m_radius;
+			float m_halfHeight;
+			glm::vec3 m_position;
+			glm::quat m_orientation;
+			glm::vec3 m_direction;
+			float m_distance;
+			EntityHandle m_ignoreEntity;
+		};
+		struct SweepBatchResults
+		{
+			void Resize(size_t count);
+			std::vector<uint8_t> m_hit;
+			std::vector<glm::vec3> m_hitPos;
+			std::vector<glm::vec3> m_hitNormal;
+			std::vector<float> m_hitDistance;			// negative = penetration depth
+			std::vector<EntityHandle> m_hitEntity;
+		};
+		void RaycastBatch(const glm::vec3* starts, const glm::vec3* ends, uint32_t count, RaycastBatchResults& results);
+		void SweepCapsuleBatch(const CapsuleSweep* sweeps, uint32_t count, SweepBatchResults& results);
+
+		// queries against any scene, used by the members above and by tools that create their own scene
+		static EntityHandle RaycastScene(physx::PxScene& scene, glm::vec3 start, glm::vec3 end, float& tHit, glm::vec3& hitNormal);
+		static void RaycastBatch(physx::PxScene& scene, JobSystem& jobs, const glm::vec3* starts, const glm::vec3* ends, uint32_t count, RaycastBatchResults& results);
+
 		void SetSimulationEnabled(bool enabled) { m_simEnabled = enabled; }
 		void ScheduleRebuild(EntityHandle e);
 		void AddKinematic(Physics* p);
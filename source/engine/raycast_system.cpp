@@ -21,6 +21,8 @@
 #include "render/material.h"
 #include "core/log.h"
 #include "core/profiler.h"
+#include "sdf.h"
+#include "sdf_mesh_raycast.h"
 
 namespace Engine
 {
@@ -48,22 +50,40 @@ namespace Engine
 		// do the physics raycasts now to give gpu time to catch up
 		{
 			SDE_PROF_EVENT("PhysicsRaycasts");
-			for (int r = 0; r < m_parent->m_activeRays.size(); ++r)
+			const uint32_t rayCount = (uint32_t)m_parent->m_activeRays.size();
+			auto& starts = m_parent->m_physicsRayStarts;
+			auto& ends = m_parent->m_physicsRayEnds;
+			auto& physResults = m_parent->m_physicsRayResults;
+			starts.resize(rayCount);
+			ends.resize(rayCount);
+			for (uint32_t r = 0; r < rayCount; ++r)
 			{
-				const auto& ray = m_parent->m_activeRays[r];
-				glm::vec3 physHitNormal;
-				float tHitPoint;
-				auto physHitEntity = m_parent->m_physics->Raycast(ray.m_start, ray.m_end, tHitPoint, physHitNormal);
-				if (physHitEntity.IsValid())
+				starts[r] = m_parent->m_activeRays[r].m_start;
+				ends[r] = m_parent->m_activeRays[r].m_end;
+			}
+			m_parent->m_physics->RaycastBatch(starts.data(), ends.data(), rayCount, physResults);
+			for (uint32_t r = 0; r < rayCount; ++r)
+			{
+				if (physResults.m_hitEntity[r].IsValid())
 				{
-					closestResults[r].m_normalTPoint = glm::vec4(physHitNormal, tHitPoint);
-					closestResults[r].m_hitEntity = physHitEntity;
+					closestResults[r].m_normalTPoint = glm::vec4(physResults.m_hitNormal[r], physResults.m_tHit[r]);
+					closestResults[r].m_hitEntity = physResults.m_hitEntity[r];
 				}
 			}
 		}
 
+		// cpu SDF raycasts are already finished
+		for (const auto& hit : m_parent->m_cpuRayHits)
+		{
+			if (hit.m_normalTPos.w < closestResults[hit.m_rayIndex].m_normalTPoint.w)
+			{
+				closestResults[hit.m_rayIndex].m_normalTPoint = hit.m_normalTPos;
+				closestResults[hit.m_rayIndex].m_hitEntity = hit.m_entity;
+			}
+		}
+
 		// process SDF raycasts
-		if (m_parent->m_activeRays.size() > 0)
+		if (m_parent->m_activeRayIndices.size() > 0)
 		{
 			SDE_PROF_EVENT("CollectSDFResults");
 			m_parent->m_renderSys->GetDevice()->MemoryBarrier(Render::BarrierType::BufferData);
@@ -117,6 +137,7 @@ namespace Engine
 
 		m_parent->m_activeRays.clear();
 		m_parent->m_activeRayIndices.clear();
+		m_parent->m_cpuRayHits.clear();
 
 		return true;
 	}
@@ -209,6 +230,56 @@ namespace Engine
 			return true;
 		}
 
+		// broad phase against bounds and collect ray indices to test per sdf
+		// sdfs with a cpu sample function (and no compute available) are traced immediately
+		struct GPURaycast {
+			SDFMesh* m_mesh;
+			EntityHandle m_entity;
+			std::vector<uint32_t> m_rays;	// indices into active ray buffer
+		};
+		std::vector<GPURaycast> gpuRaycasts;
+		auto world = m_entitySystem->GetWorld();
+		auto shaders = Engine::GetSystem<Engine::ShaderManager>("Shaders");
+		static World::EntityIterator iterator = world->MakeIterator<SDFMesh, Transform>();
+		iterator.ForEach([&](SDFMesh& m, Transform& t, EntityHandle h) {
+			// transform ray to object space for aabb intersection
+			auto inverseTransform = glm::inverse(t.GetWorldspaceMatrix());
+			std::vector<uint32_t> raysToCast;	// indices into active ray buffer
+			for (const auto& r : m_activeRays)
+			{
+				const auto rs = glm::vec3(inverseTransform * glm::vec4(r.m_start, 1));
+				const auto re = glm::vec3(inverseTransform * glm::vec4(r.m_end, 1));
+				float t = 0.0f;
+				if (RayIntersectsAABB(rs, re, m.GetBoundsMin(), m.GetBoundsMax(), t))
+				{
+					raysToCast.push_back(&r - m_activeRays.data());
+				}
+			}
+			if (raysToCast.size() == 0)
+			{
+				return;
+			}
+			bool useCPU = m.GetBatchSampleFunction() != nullptr && m.GetBackend() == SDFMesh::Backend::CPU;
+			if (!useCPU && m.GetBatchSampleFunction() != nullptr)
+			{
+				Engine::ShaderManager::CustomDefines shaderDefines = { {"SDF_SHADER_INCLUDE", m.GetSDFShaderPath()} };
+				const auto shaderName = "SDF Raycast " + m.GetSDFShaderPath();
+				useCPU = shaders->GetShader(shaders->LoadComputeShader(shaderName.c_str(), "sdf_raycast.cs", shaderDefines)) == nullptr;
+			}
+			if (useCPU)
+			{
+				RaycastSDFOnCPU(m, t.GetWorldspaceMatrix(), h, raysToCast);
+			}
+			else
+			{
+				gpuRaycasts.push_back({ &m, h, std::move(raysToCast) });
+			}
+		});
+		if (gpuRaycasts.size() == 0)
+		{
+			return true;
+		}
+
 		void* activeRayBufferPtr = m_activeRayBuffer->Map(Render::RenderBufferMapHint::Write, 0, m_activeRayBuffer->GetSize());
 		float* rayBuff = reinterpret_cast<float*>(activeRayBufferPtr);
 		for (const auto& it : m_activeRays)
@@ -223,79 +294,125 @@ namespace Engine
 		}
 		m_activeRayBuffer->Unmap();
 
-		// broad phase against bounds and collect ray indices to test per sdf
 		uint32_t* indexBuffer = (uint32_t*)m_activeRayIndexBuffer->Map(Render::RenderBufferMapHint::Write, 0, m_activeRayIndexBuffer->GetSize());
 		m_activeRayIndices.clear();
 		uint32_t* currentIndex = indexBuffer;
-		auto world = m_entitySystem->GetWorld();
-		auto transforms = world->GetAllComponents<Transform>();
+		for (const auto& gpuRaycast : gpuRaycasts)
+		{
+			auto& m = *gpuRaycast.m_mesh;
+			const auto& raysToCast = gpuRaycast.m_rays;
 
-		static World::EntityIterator iterator = world->MakeIterator<SDFMesh, Transform>();
-		iterator.ForEach([&](SDFMesh& m, Transform& t, EntityHandle h) {
-			// transform ray to object space for aabb intersection
-			auto inverseTransform = glm::inverse(t.GetWorldspaceMatrix());
-			std::vector<uint32_t> raysToCast;	// indices into active ray buffer
-			for (const auto& r : m_activeRays)
+			// push the active ray indices to the gpu buffer
+			auto startIndexOffset = currentIndex - indexBuffer;
+			for (const auto& it : raysToCast)
 			{
-				const auto rs = glm::vec3(inverseTransform * glm::vec4(r.m_start, 1));
-				const auto re = glm::vec3(inverseTransform * glm::vec4(r.m_end, 1));
-				float t = 0.0f;
-				if (RayIntersectsAABB(rs, re, m.GetBoundsMin(), m.GetBoundsMax(), t))
-				{
-					raysToCast.push_back(&r - m_activeRays.data());
-				}
+				*currentIndex++ = it;
+				m_activeRayIndices.push_back(it);
 			}
-			if (raysToCast.size() > 0)
-			{
-				// push the active ray indices to the gpu buffer
-				auto startIndexOffset = currentIndex - indexBuffer;
-				for (const auto& it : raysToCast)
-				{
-					*currentIndex++ = it;
-					m_activeRayIndices.push_back(it);
-				}
 
-				// the data we just wrote is to be used as a ssbo
-				// may need some kind of flush for mapped buffer, not sure
-				m_renderSys->GetDevice()->MemoryBarrier(Render::BarrierType::ShaderStorage);
+			// the data we just wrote is to be used as a ssbo
+			// may need some kind of flush for mapped buffer, not sure
+			m_renderSys->GetDevice()->MemoryBarrier(Render::BarrierType::ShaderStorage);
 
-				Engine::ShaderManager::CustomDefines shaderDefines = { {"SDF_SHADER_INCLUDE", m.GetSDFShaderPath()} };
-				const auto shaderName = "SDF Raycast " + m.GetSDFShaderPath();
-				auto shaders = Engine::GetSystem<Engine::ShaderManager>("Shaders");
-				auto loadedShader = shaders->LoadComputeShader(shaderName.c_str(), "sdf_raycast.cs", shaderDefines);
-				auto raycastShader = shaders->GetShader(loadedShader);
-				if (raycastShader)
+			Engine::ShaderManager::CustomDefines shaderDefines = { {"SDF_SHADER_INCLUDE", m.GetSDFShaderPath()} };
+			const auto shaderName = "SDF Raycast " + m.GetSDFShaderPath();
+			auto loadedShader = shaders->LoadComputeShader(shaderName.c_str(), "sdf_raycast.cs", shaderDefines);
+			auto raycastShader = shaders->GetShader(loadedShader);
+			if (raycastShader)
+			{
+				// call raycast shader, passing ray indices, ray buffer, and start offset
+				// the shader will write for each ray index, normalAtIntersection, tDistance (<0 for no hit) as a vec4
+				auto device = m_renderSys->GetDevice();
+				device->BindShaderProgram(*raycastShader);
+				device->BindStorageBuffer(0, *m_activeRayBuffer);
+				device->BindStorageBuffer(1, *m_activeRayIndexBuffer);
+				device->BindStorageBuffer(2, *m_raycastOutputBuffer);
+				auto handle = raycastShader->GetUniformHandle("RayIndexOffset");
+				if (handle != -1)	device->SetUniformValue(handle, (uint32_t)startIndexOffset);
+				handle = raycastShader->GetUniformHandle("RayCount");
+				if (handle != -1)	device->SetUniformValue(handle, (uint32_t)raysToCast.size());
+				handle = raycastShader->GetUniformHandle("EntityID");
+				if (handle != -1)	device->SetUniformValue(handle, gpuRaycast.m_entity.GetID());
+				auto matComponent = m_entitySystem->GetWorld()->GetComponent<Material>(m.GetMaterialEntity());
+				if (matComponent != nullptr)
 				{
-					// call raycast shader, passing ray indices, ray buffer, and start offset
-					// the shader will write for each ray index, normalAtIntersection, tDistance (<0 for no hit) as a vec4
-					auto device = m_renderSys->GetDevice();
-					device->BindShaderProgram(*raycastShader);
-					device->BindStorageBuffer(0, *m_activeRayBuffer);
-					device->BindStorageBuffer(1, *m_activeRayIndexBuffer);
-					device->BindStorageBuffer(2, *m_raycastOutputBuffer);
-					auto handle = raycastShader->GetUniformHandle("RayIndexOffset");
-					if (handle != -1)	device->SetUniformValue(handle, (uint32_t)startIndexOffset);
-					handle = raycastShader->GetUniformHandle("RayCount");
-					if (handle != -1)	device->SetUniformValue(handle, (uint32_t)raysToCast.size());
-					handle = raycastShader->GetUniformHandle("EntityID");
-					if (handle != -1)	device->SetUniformValue(handle, h.GetID());
-					auto matComponent = m_entitySystem->GetWorld()->GetComponent<Material>(m.GetMaterialEntity());
-					if (matComponent != nullptr)
-					{
-						const auto& instanceMaterial = matComponent->GetRenderMaterial();
-						ApplyMaterial(*device, *raycastShader, instanceMaterial);
-					}
-					uint32_t dispatchCount = ((raysToCast.size() - 1) / 64 + 1) * 64;
-					device->DispatchCompute(dispatchCount, 1, 1);
+					const auto& instanceMaterial = matComponent->GetRenderMaterial();
+					ApplyMaterial(*device, *raycastShader, instanceMaterial);
 				}
+				uint32_t dispatchCount = ((raysToCast.size() - 1) / 64 + 1) * 64;
+				device->DispatchCompute(dispatchCount, 1, 1);
 			}
-		});
+		}
 		m_activeRayIndexBuffer->Unmap();
 		m_activeRayFence = m_renderSys->GetDevice()->MakeFence();
 
 		return true;
 	}
 
+	// Clips a segment to an aabb, returns the entry/exit t along the segment
+	static bool ClipSegmentToAABB(glm::vec3 s, glm::vec3 e, glm::vec3 bmin, glm::vec3 bmax, float& t0, float& t1)
+	{
+		const glm::vec3 d = e - s;
+		t0 = 0.0f;
+		t1 = 1.0f;
+		for (int i = 0; i < 3; ++i)
+		{
+			if (d[i] != 0.0f)
+			{
+				const float invD = 1.0f / d[i];
+				float tNear = (bmin[i] - s[i]) * invD;
+				float tFar = (bmax[i] - s[i]) * invD;
+				if (tNear > tFar)
+				{
+					std::swap(tNear, tFar);
+				}
+				t0 = glm::max(t0, tNear);
+				t1 = glm::min(t1, tFar);
+			}
+			else if (s[i] < bmin[i] || s[i] > bmax[i])
+			{
+				return false;
+			}
+		}
+		return t1 > t0;
+	}
+
+	// Rays are clipped to the sdf bounds in object space then traced 4 at a time (across jobs unless the mesh samples a script)
+	void RaycastSystem::RaycastSDFOnCPU(::SDFMesh& m, const glm::mat4& transform, EntityHandle h, const std::vector<uint32_t>& rayIndices)
+	{
+		SDE_PROF_EVENT();
+		const auto inverseTransform = glm::inverse(transform);
+		const auto normalTransform = glm::transpose(glm::mat3(inverseTransform));
+		const uint32_t rayCount = (uint32_t)rayIndices.size();
+		std::vector<glm::vec3> starts(rayCount), ends(rayCount);
+		std::vector<float> tEntry(rayCount), tExit(rayCount), tHit(rayCount, -1.0f);
+		std::vector<glm::vec3> normals(rayCount);
+		for (uint32_t i = 0; i < rayCount; ++i)
+		{
+			const auto& r = m_activeRays[rayIndices[i]];
+			const auto rs = glm::vec3(inverseTransform * glm::vec4(r.m_start, 1));
+			const auto re = glm::vec3(inverseTransform * glm::vec4(r.m_end, 1));
+			if (!ClipSegmentToAABB(rs, re, m.GetBoundsMin(), m.GetBoundsMax(), tEntry[i], tExit[i]))
+			{
+				tEntry[i] = 0.0f;	// culling above is conservative, trace the whole ray
+				tExit[i] = 1.0f;
+			}
+			starts[i] = rs + (re - rs) * tEntry[i];
+			ends[i] = rs + (re - rs) * tExit[i];
+		}
+
+		SDF::RaycastMesh(m, starts.data(), ends.data(), rayCount, *m_jobSystem, tHit.data(), normals.data());
+
+		for (uint32_t i = 0; i < rayCount; ++i)
+		{
+			if (tHit[i] >= 0.0f)
+			{
+				const float t = tEntry[i] + tHit[i] * (tExit[i] - tEntry[i]);	// back to t along the original ray
+				m_cpuRayHits.push_back({ rayIndices[i], glm::vec4(glm::normalize(normalTransform * normals[i]), t), h });
+			}
+		}
+	}
+
 	void RaycastSystem::Shutdown()
 	{
 		SDE_PROF_EVENT();
@@ -3,6 +3,7 @@
 #include "core/glm_headers.h"
 #include "entity/entity_handle.h"
 #include "render/fence.h"
+#include "physics_system.h"
 #include <functional>
 
 namespace Render
@@ -12,13 +13,13 @@ namespace Render
 
 class GraphicsSystem;
 class EntitySystem;
+class SDFMesh;
 namespace Engine
 {
 	class JobSystem;
 	class DebugGuiSystem;
 	class ScriptSystem;
 	class RenderSystem;
-	class PhysicsSystem;
 	class RaycastSystem : public System
 	{
 	public:
@@ -62,6 +63,12 @@ namespace Engine
 		ProcessResults* MakeResultProcessor();
 
 	private:
+		struct CPURayHit {
+			uint32_t m_rayIndex;	// index into m_activeRays
+			glm::vec4 m_normalTPos;
+			EntityHandle m_entity;
+		};
+		void RaycastSDFOnCPU(::SDFMesh& m, const glm::mat4& transform, EntityHandle h, const std::vector<uint32_t>& rayIndices);
 		struct RaycastRequest {		// input rays are pushed to m_activeRays, this tracks them for later
 			uint32_t m_firstRay;	// index into m_activeRays
 			uint32_t m_rayCount;	// count for above
@@ -72,6 +79,10 @@ namespace Engine
 		std::vector<RaycastRequest> m_activeRequests;	// these are in flight
 		std::vector<RayInput> m_activeRays;				// ^^
 		std::vector<uint32_t> m_activeRayIndices;		// each shader invocation uses a subset of indices
+		std::vector<CPURayHit> m_cpuRayHits;			// hits from sdfs traced on the cpu this frame
+		std::vector<glm::vec3> m_physicsRayStarts;		// physics batch inputs/outputs, kept to avoid reallocating every frame
+		std::vector<glm::vec3> m_physicsRayEnds;
+		PhysicsSystem::RaycastBatchResults m_physicsRayResults;
 		std::unique_ptr<Render::RenderBuffer> m_raycastOutputBuffer;
 		std::unique_ptr<Render::RenderBuffer> m_activeRayBuffer;
 		std::unique_ptr<Render::RenderBuffer> m_activeRayIndexBuffer;
@@ -98,13 +98,21 @@ namespace Engine
 		uint32_t chunkPtrLow = static_cast<uint32_t>((chunkPtr & 0x00000000ffffffff));
 		uint32_t vaChunkCombined = vaPtrLow ^ chunkPtrLow;
 
-		uint32_t distanceToCameraAsInt = static_cast<uint32_t>(distanceToCamera * 1000.0f);
+		// inverted so the furthest instances sort first (back to front)
+		uint32_t distanceToCameraAsInt = ~static_cast<uint32_t>(glm::clamp(distanceToCamera * 1000.0f, 0.0f, 4294967040.0f));
 		__m128i result = _mm_set_epi32(distanceToCameraAsInt, shader.m_index, vaChunkCombined, 0);
 
 		return result;
 	}
 
 	void RenderInstances::SubmitInstance(const glm::mat4& trns, const Render::Mesh& mesh, const ShaderHandle& shader, const Render::Material* matOverride, glm::vec3 boundsMin, glm::vec3 boundsMax)
+	{
+		const Render::Material& mat = matOverride != nullptr ? *matOverride : mesh.GetMaterial();
+		SubmitInstance(trns, mesh.GetVertexArray(), mesh.GetIndexBuffer().get(), mesh.GetChunks().data(), (uint32_t)mesh.GetChunks().size(), mat, shader, boundsMin, boundsMax);
+	}
+
+	void RenderInstances::SubmitInstance(const glm::mat4& trns, const Render::VertexArray& vertexArray, const Render::RenderBuffer* ib, const Render::MeshChunk* chunks, uint32_t chunkCount,
+		const Render::Material& meshMaterial, const ShaderHandle& shader, glm::vec3 boundsMin, glm::vec3 boundsMax)
 	{
 		static auto shaders = Engine::GetSystem<Engine::ShaderManager>("Shaders");
 		static auto textures = Engine::GetSystem<TextureManager>("Textures");
@@ -119,9 +127,8 @@ namespace Engine
 			ShaderHandle gBufferShader = shaders->GetGBufferShader(shader);
 			Render::ShaderProgram* shadowShaderPtr = shaders->GetShader(shadowShader);
 			Render::ShaderProgram* gBufferShaderPtr = renderer.GetDeferredRenderEnabled() ? shaders->GetShader(gBufferShader) : nullptr;
-			const Render::VertexArray* va = &mesh.GetVertexArray();
-			const Render::RenderBuffer* ib = mesh.GetIndexBuffer().get();
-			const Render::Material* mat = matOverride != nullptr ? matOverride : &mesh.GetMaterial();
+			const Render::VertexArray* va = &vertexArray;
+			const Render::Material* mat = &meshMaterial;
 
 			PerInstanceData pid;
 			pid.m_diffuseTexture = renderer.GetDefaultDiffuseTexture();
@@ -133,10 +140,10 @@ namespace Engine
 			if (mat->GetCastsShadows() && shadowShaderPtr != nullptr)
 			{
 				int baseIndex = m_shadowCasters.AddInstances(1);
-				const auto shadowSortKey = ShadowCasterKey(shadowShader, va, mesh.GetChunks().data(), nullptr);
+				const auto shadowSortKey = ShadowCasterKey(shadowShader, va, chunks, nullptr);
 				if (baseIndex != -1)
 				{
-					m_shadowCasters.SetInstance(baseIndex, shadowSortKey, trns, va, ib, mesh.GetChunks().data(), mesh.GetChunks().size(),
+					m_shadowCasters.SetInstance(baseIndex, shadowSortKey, trns, va, ib, chunks, chunkCount,
 						mat, shadowShaderPtr, boundsMin, boundsMax, pid);
 				}
 			}
@@ -146,8 +153,8 @@ namespace Engine
 				if (baseIndex != -1)
 				{
 					const float distanceToCamera = glm::length(glm::vec3(trns[3]) - mainCam.Position());
-					auto sortKey = TransparentKey(shader, va, mesh.GetChunks().data(), distanceToCamera);
-					m_transparents.SetInstance(baseIndex, sortKey, trns, va, ib, mesh.GetChunks().data(), mesh.GetChunks().size(),
+					auto sortKey = TransparentKey(shader, va, chunks, distanceToCamera);
+					m_transparents.SetInstance(baseIndex, sortKey, trns, va, ib, chunks, chunkCount,
 						mat, theShader, boundsMin, boundsMax, pid);
 				}
 			}
@@ -157,8 +164,8 @@ namespace Engine
 				const int baseIndex = instances.AddInstances(1);
 				if (baseIndex != -1)
 				{
-					const auto opaqueSortKey = OpaqueKey(shader, va, mesh.GetChunks().data(), nullptr);
-					instances.SetInstance(baseIndex, opaqueSortKey, trns, va, ib, mesh.GetChunks().data(), mesh.GetChunks().size(),
+					const auto opaqueSortKey = OpaqueKey(shader, va, chunks, nullptr);
+					instances.SetInstance(baseIndex, opaqueSortKey, trns, va, ib, chunks, chunkCount,
 						mat, gBufferShaderPtr ? gBufferShaderPtr : theShader, boundsMin, boundsMax, pid);
 				}
 			}
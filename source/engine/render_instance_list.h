@@ -73,6 +73,8 @@ namespace Engine
 	public:
 		void SubmitInstances(const __m128* positions, int count, const ModelHandle& model, const ShaderHandle& shader);
 		void SubmitInstance(const glm::mat4& trns, const Render::Mesh& mesh, const ShaderHandle& shader, const Render::Material* matOverride = nullptr, glm::vec3 boundsMin = glm::vec3(-FLT_MAX), glm::vec3 boundsMax = glm::vec3(FLT_MAX));
+		void SubmitInstance(const glm::mat4& trns, const Render::VertexArray& va, const Render::RenderBuffer* ib, const Render::MeshChunk* chunks, uint32_t chunkCount,
+			const Render::Material& mat, const ShaderHandle& shader, glm::vec3 boundsMin, glm::vec3 boundsMax);
 		void SubmitInstance(const glm::mat4& trns, const ModelHandle& model, const ShaderHandle& shader, const Model::MeshPart::DrawData* partOverride=nullptr, uint32_t overrideCount = 0);
 
 		void Reset();
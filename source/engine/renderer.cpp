@@ -68,6 +68,7 @@ namespace Engine
 		m_textureManager = Engine::GetSystem<TextureManager>("Textures");
 		m_shaderManager = Engine::GetSystem<ShaderManager>("Shaders");
 		g_defaultTextures["DiffuseTexture"] = m_textureManager->LoadTexture("white.bmp");
+		m_textureManager->SetCompressionEnabled("default_normalmap.png", false);
 		g_defaultTextures["NormalsTexture"] = m_textureManager->LoadTexture("default_normalmap.png");
 		g_defaultTextures["SpecularTexture"] = m_textureManager->LoadTexture("white.bmp");
 
@@ -169,6 +170,12 @@ namespace Engine
 	// https://stackoverflow.com/questions/56341434/compare-two-m128i-values-for-total-order/56346628
 	inline bool SortKeyLessThan(__m128i a, __m128i b)
 	{
+		/* The byte compares are signed, bias both keys so the comparison is unsigned
+		   (otherwise any byte >= 0x80 sorts before 0x00, breaking distance ordering) */
+		const __m128i c_bias = _mm_set1_epi8((char)0x80);
+		a = _mm_xor_si128(a, c_bias);
+		b = _mm_xor_si128(b, c_bias);
+
 		/* Compare 8-bit lanes for ( a < b ), store the bits in the low 16 bits of the
 		   scalar value: */
 		const int less = _mm_movemask_epi8(_mm_cmplt_epi8(a, b));
@@ -195,6 +202,12 @@ namespace Engine
 		m_allInstances.SubmitInstance(transform, mesh, shader, instanceMat, boundsMin, boundsMax);
 	}
 
+	void Renderer::SubmitInstance(const glm::mat4& transform, const Render::VertexArray& va, const Render::RenderBuffer* ib, const Render::MeshChunk* chunks, uint32_t chunkCount,
+		const Render::Material& mat, const struct ShaderHandle& shader, glm::vec3 boundsMin, glm::vec3 boundsMax)
+	{
+		m_allInstances.SubmitInstance(transform, va, ib, chunks, chunkCount, mat, shader, boundsMin, boundsMax);
+	}
+
 	void Renderer::SubmitInstance(const glm::mat4& transform, const Render::Mesh& mesh, const struct ShaderHandle& shader, const Render::Material* instanceMat)
 	{
 		SubmitInstance(transform, mesh, shader, { -FLT_MAX, -FLT_MAX, -FLT_MAX }, { FLT_MAX, FLT_MAX, FLT_MAX }, instanceMat);
@@ -610,7 +623,7 @@ namespace Engine
 						ip.m_indexCount = thisDrawData.m_chunks[c].m_vertexCount;
 						ip.m_instanceCount = 1;		// todo - we can (and should) do chunk instancing
 						ip.m_firstIndex = thisDrawData.m_chunks[c].m_firstVertex;
-						ip.m_baseVertex = 0;
+						ip.m_baseVertex = thisDrawData.m_chunks[c].m_baseVertex;
 						ip.m_baseInstance = firstInstanceIndex + baseIndex + drawCallCount;
 						tmpDrawList.emplace_back(ip);
 						++drawCallCount;
@@ -774,7 +787,7 @@ namespace Engine
 						const auto& chunk = drawData.m_chunks[c];
 						uint32_t firstIndex = (uint32_t)(firstInstance - entries.begin());
 						d.DrawPrimitivesInstancedIndexed(chunk.m_primitiveType,	chunk.m_firstVertex, chunk.m_vertexCount,
-							instanceCount, firstIndex + baseIndex);
+							instanceCount, firstIndex + baseIndex, chunk.m_baseVertex);
 						m_frameStats.m_drawCalls++;
 						m_frameStats.m_totalVertices += (uint64_t)chunk.m_vertexCount * instanceCount;
 					}
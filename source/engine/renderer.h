@@ -20,6 +20,7 @@ namespace Render
 	class UniformBuffer;
 	class VertexArray;
 	class MeshChunk;
+	class RenderBuffer;
 }
 
 namespace Engine
@@ -53,6 +54,9 @@ namespace Engine
 		void SubmitInstances(const __m128* positions, int count, const struct ModelHandle& model, const struct ShaderHandle& shader);
 		void SubmitInstance(const glm::mat4& transform, const Render::Mesh& mesh, const struct ShaderHandle& shader, const Render::Material* instanceMat = nullptr);
 		void SubmitInstance(const glm::mat4& transform, const Render::Mesh& mesh, const struct ShaderHandle& shader, glm::vec3 boundsMin, glm::vec3 boundsMax, const Render::Material* instanceMat = nullptr);
+		// chunks + material must stay alive until the frame is rendered
+		void SubmitInstance(const glm::mat4& transform, const Render::VertexArray& va, const Render::RenderBuffer* ib, const Render::MeshChunk* chunks, uint32_t chunkCount,
+			const Render::Material& mat, const struct ShaderHandle& shader, glm::vec3 boundsMin, glm::vec3 boundsMax);
 		void SubmitInstance(const glm::mat4& transform, const struct ModelHandle& model, const struct ShaderHandle& shader);
 		void SubmitInstance(const glm::mat4& transform, const struct ModelHandle& model, const struct ShaderHandle& shader, const Model::MeshPart::DrawData* partOverride, uint32_t overrideCount);
 		
@@ -1,6 +1,8 @@
 #pragma once
 #include "sdf.h"
 #include "core/profiler.h"
+#include <emmintrin.h>
+#include <algorithm>
 
 namespace Engine
 {
@@ -40,5 +42,238 @@ namespace Engine
 				}
 			}
 		}
+
+		BatchSampleFn MakeBatchSampleFn(SDF::SampleFn fn)
+		{
+			return [fn](__m128 x, __m128 y, __m128 z) -> __m128 {
+				alignas(16) float xs[4], ys[4], zs[4], ds[4];
+				_mm_store_ps(xs, x);
+				_mm_store_ps(ys, y);
+				_mm_store_ps(zs, z);
+				for (int i = 0; i < 4; ++i)
+				{
+					ds[i] = std::get<0>(fn(xs[i], ys[i], zs[i]));
+				}
+				return _mm_load_ps(ds);
+			};
+		}
+
+		void RaycastBatch(const glm::vec3* p0, const glm::vec3* p1, uint32_t count, float minStep, float maxStep, const BatchSampleFn& fn, float* tOut)
+		{
+			SDE_PROF_EVENT();
+			assert(minStep > 0.0f && maxStep >= minStep);
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+			const __m128 epsilon = _mm_set1_ps(0.00001f);
+			const __m128 vMinStep = _mm_set1_ps(minStep), vMaxStep = _mm_set1_ps(maxStep);
+			for (uint32_t first = 0; first < count; first += 4)
+			{
+				// load 4 rays as soa, unused lanes repeat the last ray and start inactive
+				alignas(16) float sx[4], sy[4], sz[4], dx[4], dy[4], dz[4], len[4], results[4] = { -1.0f, -1.0f, -1.0f, -1.0f };
+				const uint32_t lanes = std::min(4u, count - first);
+				int activeMask = (1 << lanes) - 1;
+				for (uint32_t l = 0; l < 4; ++l)
+				{
+					const uint32_t r = first + std::min(l, lanes - 1);
+					const glm::vec3 d = p1[r] - p0[r];
+					len[l] = glm::length(d);
+					const glm::vec3 dir = len[l] > 0.0f ? d / len[l] : glm::vec3(0.0f);	// zero length rays always miss
+					activeMask &= len[l] > 0.0f ? ~0 : ~(1 << l);
+					sx[l] = p0[r].x; sy[l] = p0[r].y; sz[l] = p0[r].z;
+					dx[l] = dir.x; dy[l] = dir.y; dz[l] = dir.z;
+				}
+				const __m128 startX = _mm_load_ps(sx), startY = _mm_load_ps(sy), startZ = _mm_load_ps(sz);
+				const __m128 dirX = _mm_load_ps(dx), dirY = _mm_load_ps(dy), dirZ = _mm_load_ps(dz);
+				const __m128 rayLength = _mm_load_ps(len);
+
+				__m128 d = fn(startX, startY, startZ);
+				const __m128 startOutside = _mm_cmpgt_ps(d, zero);
+				__m128 t = zero;
+				while (activeMask != 0)
+				{
+					// step by the distance (clamped), sign change or ~0 means a hit
+					const __m128 step = _mm_min_ps(_mm_max_ps(_mm_and_ps(d, absMask), vMinStep), vMaxStep);
+					t = _mm_add_ps(t, step);
+					const int pastEnd = _mm_movemask_ps(_mm_cmpgt_ps(t, rayLength));
+					activeMask &= ~pastEnd;
+					if (activeMask == 0)
+					{
+						break;
+					}
+					const __m128 px = _mm_add_ps(startX, _mm_mul_ps(dirX, t));
+					const __m128 py = _mm_add_ps(startY, _mm_mul_ps(dirY, t));
+					const __m128 pz = _mm_add_ps(startZ, _mm_mul_ps(dirZ, t));
+					d = fn(px, py, pz);
+					const __m128 signChanged = _mm_xor_ps(_mm_cmpgt_ps(d, zero), startOutside);
+					const __m128 onSurface = _mm_cmplt_ps(_mm_and_ps(d, absMask), epsilon);
+					const int hits = _mm_movemask_ps(_mm_or_ps(signChanged, onSurface)) & activeMask;
+					if (hits != 0)
+					{
+						alignas(16) float tHit[4];
+						_mm_store_ps(tHit, _mm_div_ps(t, rayLength));
+						for (int l = 0; l < 4; ++l)
+						{
+							if (hits & (1 << l))
+							{
+								results[l] = tHit[l];
+							}
+						}
+						activeMask &= ~hits;
+					}
+				}
+				for (uint32_t l = 0; l < lanes; ++l)
+				{
+					tOut[first + l] = results[l];
+				}
+			}
+		}
+
+		void SampleNormalBatch(const glm::vec3* p, uint32_t count, float sampleDelta, const BatchSampleFn& fn, glm::vec3* normalsOut)
+		{
+			SDE_PROF_EVENT();
+			const __m128 delta = _mm_set1_ps(sampleDelta);
+			for (uint32_t first = 0; first < count; first += 4)
+			{
+				alignas(16) float xs[4], ys[4], zs[4];
+				const uint32_t lanes = std::min(4u, count - first);
+				for (uint32_t l = 0; l < 4; ++l)
+				{
+					const uint32_t i = first + std::min(l, lanes - 1);
+					xs[l] = p[i].x; ys[l] = p[i].y; zs[l] = p[i].z;
+				}
+				const __m128 x = _mm_load_ps(xs), y = _mm_load_ps(ys), z = _mm_load_ps(zs);
+				alignas(16) float nx[4], ny[4], nz[4];
+				_mm_store_ps(nx, _mm_sub_ps(fn(_mm_add_ps(x, delta), y, z), fn(_mm_sub_ps(x, delta), y, z)));
+				_mm_store_ps(ny, _mm_sub_ps(fn(x, _mm_add_ps(y, delta), z), fn(x, _mm_sub_ps(y, delta), z)));
+				_mm_store_ps(nz, _mm_sub_ps(fn(x, y, _mm_add_ps(z, delta)), fn(x, y, _mm_sub_ps(z, delta))));
+				for (uint32_t l = 0; l < lanes; ++l)
+				{
+					normalsOut[first + l] = glm::normalize(glm::vec3(nx[l], ny[l], nz[l]));
+				}
+			}
+		}
+
+		void BuildMeshData(SDF::SampleFn fn, glm::vec3 worldOffset, glm::vec3 cellSize, glm::ivec3 sampleDims, int emitOffset, glm::ivec3 emitCells, MeshData& out)
+		{
+			SDE_PROF_EVENT();
+			auto sampleIndex = [&sampleDims](int x, int y, int z) {
+				return x + (y * sampleDims.x) + (z * sampleDims.x * sampleDims.y);
+			};
+
+			// sample the field at every grid point
+			std::vector<float> samples((size_t)sampleDims.x * sampleDims.y * sampleDims.z);
+			for (int z = 0; z < sampleDims.z; ++z)
+			{
+				for (int y = 0; y < sampleDims.y; ++y)
+				{
+					for (int x = 0; x < sampleDims.x; ++x)
+					{
+						const glm::vec3 p = worldOffset + cellSize * glm::vec3(x, y, z);
+						samples[sampleIndex(x, y, z)] = std::get<0>(fn(p.x, p.y, p.z));
+					}
+				}
+			}
+
+			// find a vertex per cell that can be referenced by an output quad (average of edge intersections)
+			const glm::ivec3 firstCell = glm::max(glm::ivec3(emitOffset - 1), glm::ivec3(0));
+			const glm::ivec3 lastCell = glm::min(glm::ivec3(emitOffset) + emitCells, sampleDims - 1);
+			std::vector<uint32_t> cellToVertex(samples.size(), -1);
+			for (int z = firstCell.z; z < lastCell.z; ++z)
+			{
+				for (int y = firstCell.y; y < lastCell.y; ++y)
+				{
+					for (int x = firstCell.x; x < lastCell.x; ++x)
+					{
+						float c[2][2][2];
+						for (int cz = 0; cz < 2; ++cz)
+							for (int cy = 0; cy < 2; ++cy)
+								for (int cx = 0; cx < 2; ++cx)
+									c[cx][cy][cz] = samples[sampleIndex(x + cx, y + cy, z + cz)];
+
+						const glm::vec3 worldPos = worldOffset + cellSize * glm::vec3(x, y, z);
+						glm::vec3 average(0.0f);
+						int intersections = 0;
+						for (int a = 0; a < 2; ++a)
+						{
+							for (int b = 0; b < 2; ++b)
+							{
+								if ((c[a][b][0] > 0.0f) != (c[a][b][1] > 0.0f))
+								{
+									float zero = (0.0f - c[a][b][0]) / (c[a][b][1] - c[a][b][0]);
+									average += worldPos + cellSize * glm::vec3(a, b, zero);
+									++intersections;
+								}
+								if ((c[a][0][b] > 0.0f) != (c[a][1][b] > 0.0f))
+								{
+									float zero = (0.0f - c[a][0][b]) / (c[a][1][b] - c[a][0][b]);
+									average += worldPos + cellSize * glm::vec3(a, zero, b);
+									++intersections;
+								}
+								if ((c[0][a][b] > 0.0f) != (c[1][a][b] > 0.0f))
+								{
+									float zero = (0.0f - c[0][a][b]) / (c[1][a][b] - c[0][a][b]);
+									average += worldPos + cellSize * glm::vec3(zero, a, b);
+									++intersections;
+								}
+							}
+						}
+						if (intersections > 0)
+						{
+							const glm::vec3 v = average / (float)intersections;
+							const glm::vec3 d = cellSize;	// matches NormalSampleBias of 1 cell
+							glm::vec3 n = {
+								std::get<0>(fn(v.x + d.x, v.y, v.z)) - std::get<0>(fn(v.x - d.x, v.y, v.z)),
+								std::get<0>(fn(v.x, v.y + d.y, v.z)) - std::get<0>(fn(v.x, v.y - d.y, v.z)),
+								std::get<0>(fn(v.x, v.y, v.z + d.z)) - std::get<0>(fn(v.x, v.y, v.z - d.z))
+							};
+							n = glm::normalize(n / (d * 2.0f));
+							cellToVertex[sampleIndex(x, y, z)] = (uint32_t)(out.m_vertices.size() / 8);
+							out.m_vertices.insert(out.m_vertices.end(), { v.x, v.y, v.z, 1.0f, n.x, n.y, n.z, 1.0f });
+						}
+					}
+				}
+			}
+
+			// connect vertices around each edge with a sign change
+			auto outputQuad = [&](int i0, int i1, int i2, int i3) {
+				const uint32_t v0 = cellToVertex[i0], v1 = cellToVertex[i1], v2 = cellToVertex[i2], v3 = cellToVertex[i3];
+				if (v0 != -1 && v1 != -1 && v2 != -1 && v3 != -1)
+				{
+					out.m_indices.insert(out.m_indices.end(), { v0, v1, v2, v2, v3, v0 });
+				}
+			};
+			const glm::ivec3 emitEnd = glm::min(glm::ivec3(emitOffset) + emitCells, sampleDims - 1);
+			for (int z = emitOffset; z < emitEnd.z; ++z)
+			{
+				for (int y = emitOffset; y < emitEnd.y; ++y)
+				{
+					for (int x = emitOffset; x < emitEnd.x; ++x)
+					{
+						const float s0 = samples[sampleIndex(x, y, z)];
+						float s1 = samples[sampleIndex(x, y, z + 1)];
+						if ((s0 > 0.0f) != (s1 > 0.0f))
+						{
+							const int i0 = sampleIndex(x - 1, y - 1, z), i1 = sampleIndex(x, y - 1, z);
+							const int i2 = sampleIndex(x, y, z), i3 = sampleIndex(x - 1, y, z);
+							s1 > 0.0f ? outputQuad(i0, i1, i2, i3) : outputQuad(i3, i2, i1, i0);
+						}
+						s1 = samples[sampleIndex(x, y + 1, z)];
+						if ((s0 > 0.0f) != (s1 > 0.0f))
+						{
+							const int i0 = sampleIndex(x - 1, y, z - 1), i1 = sampleIndex(x, y, z - 1);
+							const int i2 = sampleIndex(x, y, z), i3 = sampleIndex(x - 1, y, z);
+							s0 > 0.0f ? outputQuad(i0, i1, i2, i3) : outputQuad(i3, i2, i1, i0);
+						}
+						s1 = samples[sampleIndex(x + 1, y, z)];
+						if ((s0 > 0.0f) != (s1 > 0.0f))
+						{
+							const int i0 = sampleIndex(x, y - 1, z - 1), i1 = sampleIndex(x, y, z - 1);
+							const int i2 = sampleIndex(x, y, z), i3 = sampleIndex(x, y - 1, z);
+							s1 > 0.0f ? outputQuad(i0, i1, i2, i3) : outputQuad(i3, i2, i1, i0);
+						}
+					}
+				}
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "core/glm_headers.h"
 #include <functional>
+#include <vector>
+#include <xmmintrin.h>
 
 namespace Engine
 {
@@ -12,5 +14,27 @@ namespace Engine
 		// note: detects change from solid/air OR air/solid
 		// its up to you to detect if the initial point is solid or not!
 		bool Raycast(glm::vec3 p0, glm::vec3 p1, float maxstep, SDF::SampleFn fn, float& tOut, int& matHit);
+
+		// Batched sampling, evaluates 4 positions at once (x, y, z lanes), returns 4 distances
+		using BatchSampleFn = std::function<__m128(__m128, __m128, __m128)>;
+		BatchSampleFn MakeBatchSampleFn(SDF::SampleFn fn);	// wraps a scalar function for use with batch queries
+
+		// Sphere traces rays 4 at a time in lockstep, same hit rules as Raycast
+		// tOut = t along p0->p1 for hits, -1 for misses (zero length rays always miss)
+		void RaycastBatch(const glm::vec3* p0, const glm::vec3* p1, uint32_t count, float minStep, float maxStep, const BatchSampleFn& fn, float* tOut);
+
+		// Central difference normals for 4 points at once
+		void SampleNormalBatch(const glm::vec3* p, uint32_t count, float sampleDelta, const BatchSampleFn& fn, glm::vec3* normalsOut);
+
+		// Mesh data in the same layout as the SDF mesh compute shaders output
+		struct MeshData
+		{
+			std::vector<float> m_vertices;		// pos(4), normal(4) per vertex
+			std::vector<uint32_t> m_indices;	// triangles
+		};
+
+		// CPU surface net mesher matching compute_sdf_find_vertices/compute_sdf_make_triangles
+		// samples sampleDims points from worldOffset, quads are only output for cells [emitOffset, emitOffset + emitCells)
+		void BuildMeshData(SDF::SampleFn fn, glm::vec3 worldOffset, glm::vec3 cellSize, glm::ivec3 sampleDims, int emitOffset, glm::ivec3 emitCells, MeshData& out);
 	}
 }
\ No newline at end of file
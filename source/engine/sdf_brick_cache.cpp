@@ -0,0 +1,123 @@
+#include "sdf_brick_cache.h"
+#include "core/profiler.h"
+#include "render/texture.h"
+#include "render/texture_source.h"
+#include <algorithm>
+
+namespace Engine
+{
+	SDFBrickCache::SDFBrickCache()
+	{
+	}
+
+	SDFBrickCache::~SDFBrickCache()
+	{
+	}
+
+	uint64_t SDFBrickCache::BrickSizeBytes(glm::ivec3 dims)
+	{
+		return (uint64_t)dims.x * (uint64_t)dims.y * (uint64_t)dims.z * sizeof(uint16_t);	// RF16
+	}
+
+	void SDFBrickCache::CreateVolume(Brick& b, glm::ivec3 dims)
+	{
+		SDE_PROF_EVENT();
+		if (b.m_volume != nullptr)
+		{
+			m_stats.m_bytesResident -= BrickSizeBytes(b.m_dimensions);
+		}
+		auto volumedatadesc = Render::TextureSource(dims.x, dims.y, dims.z, Render::TextureSource::Format::RF16);
+		const auto clamp = Render::TextureSource::WrapMode::ClampToEdge;
+		volumedatadesc.SetWrapMode(clamp, clamp, clamp);
+		b.m_volume = std::make_unique<Render::Texture>();
+		b.m_volume->Create(volumedatadesc);
+		b.m_dimensions = dims;
+		m_stats.m_bytesResident += BrickSizeBytes(dims);
+	}
+
+	SDFBrickCache::Brick& SDFBrickCache::Acquire(uint32_t entityID, uint64_t nodeIndex, glm::ivec3 dims, uint64_t fieldVersion, bool& needsSampling)
+	{
+		SDE_PROF_EVENT();
+		const BrickKey key = { entityID, nodeIndex };
+		auto found = m_bricks.find(key);
+		if (found == m_bricks.end())
+		{
+			found = m_bricks.emplace(key, std::make_unique<Brick>()).first;
+			++m_stats.m_bricksResident;
+		}
+		Brick& b = *found->second;
+		b.m_lastUsedFrame = m_currentFrame;
+		b.m_inFlight++;
+		needsSampling = b.m_volume == nullptr || b.m_dimensions != dims || b.m_fieldVersion != fieldVersion;
+		if (needsSampling)
+		{
+			if (b.m_volume == nullptr || b.m_dimensions != dims)
+			{
+				CreateVolume(b, dims);
+			}
+			b.m_fieldVersion = fieldVersion;	// the caller is expected to write the field immediately
+			++m_stats.m_misses;
+		}
+		else
+		{
+			++m_stats.m_hits;
+		}
+		return b;
+	}
+
+	void SDFBrickCache::Release(uint32_t entityID, uint64_t nodeIndex)
+	{
+		auto found = m_bricks.find({ entityID, nodeIndex });
+		assert(found != m_bricks.end());
+		if (found != m_bricks.end())
+		{
+			assert(found->second->m_inFlight > 0);
+			found->second->m_inFlight--;
+		}
+	}
+
+	void SDFBrickCache::EvictToBudget()
+	{
+		SDE_PROF_EVENT();
+		if (m_stats.m_bytesResident <= m_memoryBudget)
+		{
+			return;
+		}
+
+		// oldest first, anything still in use by compute is skipped
+		std::vector<std::tuple<uint64_t, BrickKey>> candidates;
+		candidates.reserve(m_bricks.size());
+		for (const auto& it : m_bricks)
+		{
+			if (it.second->m_inFlight == 0)
+			{
+				candidates.push_back({ it.second->m_lastUsedFrame, it.first });
+			}
+		}
+		std::sort(candidates.begin(), candidates.end(), [](const auto& c0, const auto& c1) {
+			return std::get<0>(c0) < std::get<0>(c1);
+		});
+		for (int i = 0; i < candidates.size() && m_stats.m_bytesResident > m_memoryBudget; ++i)
+		{
+			auto found = m_bricks.find(std::get<1>(candidates[i]));
+			m_stats.m_bytesResident -= BrickSizeBytes(found->second->m_dimensions);
+			--m_stats.m_bricksResident;
+			++m_stats.m_evictions;
+			m_bricks.erase(found);
+		}
+	}
+
+	void SDFBrickCache::NewFrame()
+	{
+		SDE_PROF_EVENT();
+		++m_currentFrame;
+		EvictToBudget();
+	}
+
+	void SDFBrickCache::Clear()
+	{
+		m_bricks.clear();
+		m_stats.m_bricksResident = 0;
+		m_stats.m_bytesResident = 0;
+	}
+}
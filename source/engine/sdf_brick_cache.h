@@ -0,0 +1,72 @@
+#pragma once
+#include "core/glm_headers.h"
+#include <robin_hood.h>
+#include <memory>
+#include <vector>
+
+// Sparse cache of sampled SDF volumes ('bricks') keyed by octree node
+// Bricks are kept on the gpu so nodes can be remeshed without re-sampling the field
+// Each brick stores the field version of the node it was sampled from; a mismatch means the data is stale
+// Memory is limited by a budget, least recently used bricks are evicted first
+
+namespace Render
+{
+	class Texture;
+}
+
+namespace Engine
+{
+	class SDFBrickCache
+	{
+	public:
+		SDFBrickCache();
+		~SDFBrickCache();
+
+		struct Brick
+		{
+			std::unique_ptr<Render::Texture> m_volume;
+			glm::ivec3 m_dimensions = { 0,0,0 };
+			uint64_t m_fieldVersion = -1;	// matches SDFMeshOctree::GetNodeFieldVersion when the data is valid
+			uint64_t m_lastUsedFrame = 0;
+			uint32_t m_inFlight = 0;		// bricks being used by compute are never evicted
+		};
+		struct Stats
+		{
+			uint64_t m_hits = 0;
+			uint64_t m_misses = 0;
+			uint64_t m_evictions = 0;
+			uint64_t m_bricksResident = 0;
+			uint64_t m_bytesResident = 0;
+		};
+
+		// Returns a brick for this node with at least dims samples. needsSampling = true if the field must be (re)written
+		Brick& Acquire(uint32_t entityID, uint64_t nodeIndex, glm::ivec3 dims, uint64_t fieldVersion, bool& needsSampling);
+		void Release(uint32_t entityID, uint64_t nodeIndex);		// call when the gpu is finished with the brick
+		void NewFrame();											// evicts lru bricks if over budget
+		void Clear();
+
+		void SetMemoryBudget(uint64_t bytes) { m_memoryBudget = bytes; }
+		uint64_t GetMemoryBudget() const { return m_memoryBudget; }
+		const Stats& GetStats() const { return m_stats; }
+
+	private:
+		static uint64_t BrickSizeBytes(glm::ivec3 dims);
+		struct BrickKey
+		{
+			uint32_t m_entityID;
+			uint64_t m_nodeIndex;
+			bool operator==(const BrickKey& other) const { return m_entityID == other.m_entityID && m_nodeIndex == other.m_nodeIndex; }
+		};
+		struct BrickKeyHash
+		{
+			size_t operator()(const BrickKey& k) const { return robin_hood::hash_int(k.m_nodeIndex ^ ((uint64_t)k.m_entityID << 40)); }
+		};
+		void EvictToBudget();
+		void CreateVolume(Brick& b, glm::ivec3 dims);
+
+		robin_hood::unordered_map<BrickKey, std::unique_ptr<Brick>, BrickKeyHash> m_bricks;
+		uint64_t m_memoryBudget = 256 * 1024 * 1024;
+		uint64_t m_currentFrame = 0;
+		Stats m_stats;
+	};
+}
@@ -1,5 +1,5 @@
 #include "sdf_mesh_octree.h"
-#include "render/mesh.h"
+#include "model_asset.h"
 #include "core/profiler.h"
 #include <array>
 
@@ -35,62 +35,76 @@ namespace Engine
 
 	bool SDFMeshOctree::NodeIsStale(const Node& n)
 	{
-		return n.m_nodeGeneration != m_currentGeneration;
+		return n.m_isEvicted || n.m_nodeGeneration != m_currentGeneration || n.m_cleanVersion != n.m_dirtyVersion;
 	}
 
-	void SDFMeshOctree::Render(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldDrawFn shouldDraw, DrawFn draw)
+	bool SDFMeshOctree::GetChildrenToDraw(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldDrawFn& shouldDraw, ChildDrawList& children, int& childCount)
 	{
-		SDE_PROF_EVENT();
-		if (!shouldDraw(boundsMin, boundsMax, depth))
+		childCount = 0;
+		if (depth + 1 >= m_maxDepth)
 		{
-			return;
+			return false;
 		}
-
-		// Find how many visible children are fully loaded
-		int childCount = 0;
-		bool allVisibleReady = true;
-		std::array <std::tuple <Node*, glm::vec3, glm::vec3>, 8> childrenToDraw;
-		if (depth + 1 < m_maxDepth)
+		for (uint32_t i = 0; i < 8; ++i)
 		{
-			for (uint32_t i = 0; i < 8; ++i)
+			if (n.m_children[i])
 			{
-				if (n.m_children[i])
+				// the child is up to date + ready to draw
+				if (n.m_children[i]->m_mesh != nullptr || !NodeIsStale(*n.m_children[i]))
 				{
-					// the child is up to date + ready to draw
-					if (n.m_children[i]->m_mesh != nullptr || !NodeIsStale(*n.m_children[i]))
+					glm::vec3 nodeMin, nodeMax;
+					GetNodeDimensions(boundsMin, boundsMax, i, nodeMin, nodeMax);
+					if (shouldDraw(nodeMin, nodeMax, depth + 1))
 					{
-						glm::vec3 nodeMin, nodeMax;
-						GetNodeDimensions(boundsMin, boundsMax, i, nodeMin, nodeMax);
-						if (shouldDraw(nodeMin, nodeMax, depth + 1))
-						{
-							childrenToDraw[childCount++] = std::make_tuple(n.m_children[i].get(), nodeMin, nodeMax);
-						}
-						else
-						{
-							allVisibleReady = false;
-							break;
-						}
+						children[childCount++] = std::make_tuple(n.m_children[i].get(), nodeMin, nodeMax);
 					}
 					else
 					{
-						allVisibleReady = false;
-						break;
+						return false;
 					}
 				}
+				else
+				{
+					return false;
+				}
 			}
 		}
+		return childCount > 0;
+	}
+
+	bool SDFMeshOctree::NodeWillBeDrawn(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldDrawFn& shouldDraw)
+	{
+		if (!shouldDraw(boundsMin, boundsMax, depth))
+		{
+			return false;
+		}
+		ChildDrawList children;
+		int childCount = 0;
+		return !GetChildrenToDraw(n, depth, boundsMin, boundsMax, shouldDraw, children, childCount);
+	}
+
+	void SDFMeshOctree::Render(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldDrawFn& shouldDraw, DrawFn& draw)
+	{
+		SDE_PROF_EVENT();
+		if (!shouldDraw(boundsMin, boundsMax, depth))
+		{
+			return;
+		}
 
 		// If there are no children loaded, or they dont all have meshes, draw this node only
- 		if((childCount == 0 || !allVisibleReady))
+		ChildDrawList childrenToDraw;
+		int childCount = 0;
+		if (!GetChildrenToDraw(n, depth, boundsMin, boundsMax, shouldDraw, childrenToDraw, childCount))
 		{
 			if (n.m_mesh != nullptr)
 			{
+				n.m_lastDrawnFrame = m_currentFrame;
 				draw(boundsMin, boundsMax, *n.m_mesh);
 			}
 		}
 		else
 		{
-			for (uint32_t c = 0; c < childCount; ++c)
+			for (int c = 0; c < childCount; ++c)
 			{
 				auto [theNode, nodeMin, nodeMax] = childrenToDraw[c];
 				Render(*theNode, depth + 1, nodeMin, nodeMax, shouldDraw, draw);
@@ -98,11 +112,17 @@ namespace Engine
 		}
 	}
 
-	void SDFMeshOctree::Update(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldUpdateFn shouldUpdate, UpdateFn update)
+	void SDFMeshOctree::Update(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldUpdateFn& shouldUpdate, UpdateFn& update, ShouldDrawFn& shouldDraw)
 	{
 		if (!n.m_isBuilding && NodeIsStale(n))
 		{
-			update(boundsMin, boundsMax, depth, n.m_index);
+			// evicted meshes are only rebuilt once they are needed for drawing, otherwise prefetched/interior nodes
+			// would be rebuilt and evicted again forever while over budget
+			const bool onlyEvicted = n.m_isEvicted && n.m_nodeGeneration == m_currentGeneration && n.m_cleanVersion == n.m_dirtyVersion;
+			if (!onlyEvicted || NodeWillBeDrawn(n, depth, boundsMin, boundsMax, shouldDraw))
+			{
+				update(boundsMin, boundsMax, depth, n.m_index);
+			}
 		}
 
 		// go depth first through all children
@@ -118,7 +138,7 @@ namespace Engine
 					{
 						n.m_children[i] = MakeNode();
 					}
-					Update(*n.m_children[i], depth + 1, nodeMin, nodeMax, shouldUpdate, update);
+					Update(*n.m_children[i], depth + 1, nodeMin, nodeMax, shouldUpdate, update, shouldDraw);
 				}
 			}
 		}
@@ -127,11 +147,12 @@ namespace Engine
 	void SDFMeshOctree::Update(ShouldUpdateFn shouldUpdate, UpdateFn update, ShouldDrawFn shouldDraw, DrawFn draw)
 	{
 		SDE_PROF_EVENT();
+		++m_currentFrame;
 		if (m_root == nullptr)
 		{
 			m_root = MakeNode();
 		}
-		Update(*m_root, 0, m_minBounds, m_maxBounds, shouldUpdate, update);
+		Update(*m_root, 0, m_minBounds, m_maxBounds, shouldUpdate, update, shouldDraw);
 		Render(*m_root, 0, m_minBounds, m_maxBounds, shouldDraw, draw);
 	}
 
@@ -143,22 +164,62 @@ namespace Engine
 		if (found != m_lookupByIndex.end())
 		{
 			found->second->m_isBuilding = true;
+			found->second->m_buildGeneration = m_currentGeneration;
+			found->second->m_buildVersion = found->second->m_dirtyVersion;
 		}
 	}
 
-	void SDFMeshOctree::SetNodeData(NodeIndex node, std::unique_ptr<Render::Mesh>&& m)
+	void SDFMeshOctree::SetNodeData(NodeIndex node, std::unique_ptr<SDFNodeMesh>&& m)
 	{
 		SDE_PROF_EVENT();
 		auto found = m_lookupByIndex.find(node);
 		assert(found != m_lookupByIndex.end());
 		if (found != m_lookupByIndex.end())
 		{
+			// if the node was invalidated while building, it stays stale and will be rebuilt
+			Node& n = *found->second;
+			if (n.m_mesh != nullptr)
+			{
+				m_residentMeshBytes -= n.m_meshBytes;
+				--m_residentMeshCount;
+			}
+			n.m_meshBytes = m != nullptr ? GetMeshBytes(*m) : 0;
+			if (m != nullptr)
+			{
+				m_residentMeshBytes += n.m_meshBytes;
+				++m_residentMeshCount;
+			}
+			n.m_isEvicted = false;
 			found->second->m_mesh = std::move(m);
 			found->second->m_isBuilding = false;
-			found->second->m_nodeGeneration = m_currentGeneration;
+			found->second->m_nodeGeneration = found->second->m_buildGeneration;
+			found->second->m_cleanVersion = found->second->m_buildVersion;
 		}
 	}
 
+	void SDFMeshOctree::RetryNode(NodeIndex node)
+	{
+		auto found = m_lookupByIndex.find(node);
+		assert(found != m_lookupByIndex.end());
+		if (found != m_lookupByIndex.end())
+		{
+			// any old mesh is kept, the node is treated as if it was evicted so it rebuilds when it is next updated
+			found->second->m_isBuilding = false;
+			found->second->m_isEvicted = true;
+		}
+	}
+
+	uint64_t SDFMeshOctree::GetNodeFieldVersion(NodeIndex node)
+	{
+		auto found = m_lookupByIndex.find(node);
+		assert(found != m_lookupByIndex.end());
+		if (found != m_lookupByIndex.end())
+		{
+			return ((uint64_t)m_currentGeneration << 32) | found->second->m_dirtyVersion;
+		}
+		return -1;
+	}
+
 	void SDFMeshOctree::SetBounds(glm::vec3 minb, glm::vec3 maxb)
 	{
 		m_minBounds = minb;
@@ -179,7 +240,88 @@ namespace Engine
 		{
 			m_root = nullptr;
 			m_lookupByIndex.clear();
+			m_residentMeshBytes = 0;
+			m_residentMeshCount = 0;
 		}
 		++m_currentGeneration;
 	}
+
+	void SDFMeshOctree::InvalidateRegion(Node& n, glm::vec3 boundsMin, glm::vec3 boundsMax, glm::vec3 regionMin, glm::vec3 regionMax, float nodePadding)
+	{
+		const glm::vec3 padding = (boundsMax - boundsMin) * nodePadding;
+		const glm::vec3 paddedMin = boundsMin - padding, paddedMax = boundsMax + padding;
+		if (glm::any(glm::greaterThan(regionMin, paddedMax)) || glm::any(glm::lessThan(regionMax, paddedMin)))
+		{
+			return;
+		}
+		++n.m_dirtyVersion;
+		for (uint32_t i = 0; i < 8; ++i)
+		{
+			if (n.m_children[i])
+			{
+				glm::vec3 nodeMin, nodeMax;
+				GetNodeDimensions(boundsMin, boundsMax, i, nodeMin, nodeMax);
+				InvalidateRegion(*n.m_children[i], nodeMin, nodeMax, regionMin, regionMax, nodePadding);
+			}
+		}
+	}
+
+	void SDFMeshOctree::InvalidateRegion(glm::vec3 regionMin, glm::vec3 regionMax, float nodePadding)
+	{
+		SDE_PROF_EVENT();
+		if (m_root != nullptr)
+		{
+			InvalidateRegion(*m_root, m_minBounds, m_maxBounds, regionMin, regionMax, nodePadding);
+		}
+	}
+
+	size_t SDFMeshOctree::GetMeshBytes(const SDFNodeMesh& m)
+	{
+		return (size_t)m.m_geometry.m_vertexCount * sizeof(Assets::MeshVertex) + (size_t)m.m_geometry.m_indexCount * sizeof(uint32_t);
+	}
+
+	void SDFMeshOctree::ForEachEvictionCandidate(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, EvictionCandidateFn& fn)
+	{
+		// the root is never evicted so there is always something to draw
+		if (depth > 0 && n.m_mesh != nullptr && !n.m_isBuilding && n.m_lastDrawnFrame != m_currentFrame)
+		{
+			fn(boundsMin, boundsMax, depth, n.m_lastDrawnFrame, n.m_meshBytes, n.m_index);
+		}
+		for (uint32_t i = 0; i < 8; ++i)
+		{
+			if (n.m_children[i])
+			{
+				glm::vec3 nodeMin, nodeMax;
+				GetNodeDimensions(boundsMin, boundsMax, i, nodeMin, nodeMax);
+				ForEachEvictionCandidate(*n.m_children[i], depth + 1, nodeMin, nodeMax, fn);
+			}
+		}
+	}
+
+	void SDFMeshOctree::ForEachEvictionCandidate(EvictionCandidateFn fn)
+	{
+		SDE_PROF_EVENT();
+		if (m_root != nullptr)
+		{
+			ForEachEvictionCandidate(*m_root, 0, m_minBounds, m_maxBounds, fn);
+		}
+	}
+
+	bool SDFMeshOctree::EvictNode(NodeIndex node, size_t& bytesFreed)
+	{
+		bytesFreed = 0;
+		auto found = m_lookupByIndex.find(node);
+		if (found == m_lookupByIndex.end() || found->second->m_mesh == nullptr || found->second->m_isBuilding)
+		{
+			return false;
+		}
+		Node& n = *found->second;
+		bytesFreed = n.m_meshBytes;
+		m_residentMeshBytes -= n.m_meshBytes;
+		--m_residentMeshCount;
+		n.m_mesh = nullptr;
+		n.m_meshBytes = 0;
+		n.m_isEvicted = true;
+		return true;
+	}
 }
\ No newline at end of file
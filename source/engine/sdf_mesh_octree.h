@@ -1,18 +1,23 @@
 #pragma once
 #include "core/glm_headers.h"
+#include "engine/model.h"
 #include <memory>
 #include <functional>
+#include <array>
+#include <tuple>
 
 // Octree of SDF meshes with each level representing LODs
 // Root node = lowest LOD, leaf nodes = highest
 
-namespace Render
-{
-	class Mesh;
-}
-
 namespace Engine
 {
+	// Mesh data for a node lives in the global model buffers
+	struct SDFNodeMesh
+	{
+		GeometryAllocation m_geometry;
+		Render::MeshChunk m_chunk;
+	};
+
 	class SDFMeshOctree
 	{
 	public:
@@ -21,18 +26,32 @@ namespace Engine
 		using NodeIndex = uint64_t;													// identify a node in the tree
 
 		using ShouldDrawFn = std::function<bool(glm::vec3, glm::vec3, uint32_t)>;	// bounds min/max, depth, return true if this node should be drawn
-		using DrawFn = std::function<void(glm::vec3, glm::vec3, Render::Mesh&)>;	// bounds min/max, mesh, draw whatever is passed to you (or not)
+		using DrawFn = std::function<void(glm::vec3, glm::vec3, const SDFNodeMesh&)>;	// bounds min/max, mesh, draw whatever is passed to you (or not)
 		using ShouldUpdateFn = std::function<bool(glm::vec3, glm::vec3, uint32_t)>;	// bounds min/max, depth, return true if this node should be updated
 		// bounds, depth, node id-used to request updates
 		// (updater calls SignalNodeUpdating and then SetNodeData when finished)
 		using UpdateFn = std::function<void(glm::vec3, glm::vec3, uint32_t, uint64_t)>;	
+		// bounds, depth, last frame the node was drawn, mesh size in bytes, node id
+		using EvictionCandidateFn = std::function<void(glm::vec3, glm::vec3, uint32_t, uint64_t, size_t, NodeIndex)>;
 
 		void Update(ShouldUpdateFn shouldUpdate, UpdateFn update, ShouldDrawFn shouldDraw, DrawFn draw);
 		void SignalNodeUpdating(uint64_t node);										// user should call this once when building new data
-		void SetNodeData(uint64_t node, std::unique_ptr<Render::Mesh>&& m);			// pass null if no mesh was generated to stop the updates for this node
+		void SetNodeData(uint64_t node, std::unique_ptr<SDFNodeMesh>&& m);			// pass null if no mesh was generated to stop the updates for this node
+		void RetryNode(NodeIndex node);												// the build failed, the node will be updated again
 		void SetBounds(glm::vec3 min, glm::vec3 max);
 		void SetMaxDepth(uint32_t maxDepth);
 		void Invalidate(bool destroyAll=false);
+		// only invalidates nodes overlapping the region (+ their parents), padding is a fraction of each node size
+		void InvalidateRegion(glm::vec3 regionMin, glm::vec3 regionMax, float nodePadding = 0.0f);
+		uint64_t GetNodeFieldVersion(NodeIndex node);								// changes whenever the field inside a node is invalidated
+
+		// Residency control, meshes that are not drawn can be evicted and will be rebuilt on demand
+		void ForEachEvictionCandidate(EvictionCandidateFn fn);						// nodes with meshes that were not drawn this frame
+		bool EvictNode(NodeIndex node, size_t& bytesFreed);							// returns false if the node had no mesh to release
+		size_t GetResidentMeshBytes() const { return m_residentMeshBytes; }
+		size_t GetResidentMeshCount() const { return m_residentMeshCount; }
+		size_t GetNodeCount() const { return m_lookupByIndex.size(); }
+		uint64_t GetCurrentFrame() const { return m_currentFrame; }
 
 	private:
 		class Node
@@ -40,19 +59,36 @@ namespace Engine
 		public:
 			bool m_isBuilding = false;
 			uint32_t m_nodeGeneration = 0;	// used to track staleness of data
+			uint32_t m_buildGeneration = 0;	// generation when the current build started
+			uint32_t m_dirtyVersion = 0;	// incremented by region invalidation
+			uint32_t m_cleanVersion = 0;	// dirty version of the last built data
+			uint32_t m_buildVersion = 0;	// dirty version when the current build started
+			bool m_isEvicted = false;		// mesh was thrown away to save memory, needs rebuilding
+			uint64_t m_lastDrawnFrame = 0;
+			size_t m_meshBytes = 0;
 			NodeIndex m_index = -1;
-			std::unique_ptr<Render::Mesh> m_mesh;
+			std::unique_ptr<SDFNodeMesh> m_mesh;
 			std::unique_ptr<Node> m_children[8];
 		};
+		using ChildDrawList = std::array<std::tuple<Node*, glm::vec3, glm::vec3>, 8>;
 		std::unique_ptr<Node> MakeNode();
 		void GetNodeDimensions(glm::vec3 parentMin, glm::vec3 parentMax, uint32_t childIndex, glm::vec3& bMin, glm::vec3& bMax);
 		bool NodeIsStale(const Node& n);
-		void Update(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldUpdateFn shouldUpdate, UpdateFn update);
-		void Render(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldDrawFn shouldDraw, DrawFn draw);
+		void Update(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldUpdateFn& shouldUpdate, UpdateFn& update, ShouldDrawFn& shouldDraw);
+		void Render(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldDrawFn& shouldDraw, DrawFn& draw);
+		// true if the children are all ready and visible, so they are drawn instead of this node
+		bool GetChildrenToDraw(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldDrawFn& shouldDraw, ChildDrawList& children, int& childCount);
+		bool NodeWillBeDrawn(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, ShouldDrawFn& shouldDraw);
+		void InvalidateRegion(Node& n, glm::vec3 boundsMin, glm::vec3 boundsMax, glm::vec3 regionMin, glm::vec3 regionMax, float nodePadding);
+		void ForEachEvictionCandidate(Node& n, uint32_t depth, glm::vec3 boundsMin, glm::vec3 boundsMax, EvictionCandidateFn& fn);
+		static size_t GetMeshBytes(const SDFNodeMesh& m);
 		glm::vec3 m_minBounds;
 		glm::vec3 m_maxBounds;
 		uint32_t m_maxDepth = 5;		// depth 0 = root
 		uint32_t m_currentGeneration = 0;
+		uint64_t m_currentFrame = 1;
+		size_t m_residentMeshBytes = 0;
+		size_t m_residentMeshCount = 0;
 		NodeIndex m_nextNodeIndex = 0;
 		std::unique_ptr<Node> m_root;
 		std::unordered_map<NodeIndex, Node*> m_lookupByIndex;
@@ -0,0 +1,54 @@
+#include "sdf_mesh_raycast.h"
+#include "job_system.h"
+#include "components/component_sdf_mesh.h"
+#include "core/profiler.h"
+#include <algorithm>
+
+namespace Engine
+{
+	namespace SDF
+	{
+		void RaycastMesh(const ::SDFMesh& m, const glm::vec3* p0, const glm::vec3* p1, uint32_t count, JobSystem& jobs, float* tOut, glm::vec3* normalsOut)
+		{
+			SDE_PROF_EVENT();
+			const auto& sampleFn = m.GetBatchSampleFunction();
+			auto traceGroup = [&](int32_t group) {
+				const uint32_t first = group * c_meshRaysPerJob;
+				const uint32_t groupCount = std::min(c_meshRaysPerJob, count - first);
+				RaycastBatch(&p0[first], &p1[first], groupCount, c_meshRayMinStep, c_meshRayMaxStep, sampleFn, &tOut[first]);
+
+				// normals for the hits only
+				glm::vec3 hitPositions[c_meshRaysPerJob];
+				uint32_t hitIndices[c_meshRaysPerJob];
+				uint32_t hitCount = 0;
+				for (uint32_t i = first; i < first + groupCount; ++i)
+				{
+					if (tOut[i] >= 0.0f)
+					{
+						hitIndices[hitCount] = i;
+						hitPositions[hitCount++] = p0[i] + (p1[i] - p0[i]) * tOut[i];
+					}
+				}
+				glm::vec3 hitNormals[c_meshRaysPerJob];
+				SampleNormalBatch(hitPositions, hitCount, 0.0001f, sampleFn, hitNormals);
+				for (uint32_t i = 0; i < hitCount; ++i)
+				{
+					normalsOut[hitIndices[i]] = hitNormals[i];
+				}
+			};
+
+			const int32_t groupCount = (count + c_meshRaysPerJob - 1) / c_meshRaysPerJob;
+			if (m.IsSampleFunctionScript())
+			{
+				for (int32_t group = 0; group < groupCount; ++group)
+				{
+					traceGroup(group);
+				}
+			}
+			else
+			{
+				jobs.ForEachAsync(0, groupCount, 1, 1, traceGroup);
+			}
+		}
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include "sdf.h"
+
+class SDFMesh;
+namespace Engine
+{
+	class JobSystem;
+	namespace SDF
+	{
+		const uint32_t c_meshRaysPerJob = 256;
+		const float c_meshRayMinStep = 0.001f;	// matches sdf_raycast.cs
+		const float c_meshRayMaxStep = 0.5f;
+
+		// Traces object space rays against an sdf mesh using its batch sample function, c_meshRaysPerJob at a time across jobs
+		// tOut = t along p0->p1 for hits, -1 for misses. Normals are object space and only written for hits
+		// Script sample functions must stay on the main thread, those meshes are traced serially on the calling thread
+		void RaycastMesh(const ::SDFMesh& m, const glm::vec3* p0, const glm::vec3* p1, uint32_t count, JobSystem& jobs, float* tOut, glm::vec3* normalsOut);
+	}
+}
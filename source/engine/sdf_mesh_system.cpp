@@ -10,10 +10,12 @@
 #include "engine/debug_render.h"
 #include "entity/entity_system.h"
 #include "engine/debug_gui_system.h"
+#include "engine/debug_gui_menubar.h"
 #include "engine/render_system.h"
 #include "engine/renderer.h"
 #include "engine/texture_manager.h"
 #include "engine/shader_manager.h"
+#include "engine/model_manager.h"
 #include "material_helpers.h"
 #include "engine/graphics_system.h"
 #include "render/texture.h"
@@ -21,6 +23,8 @@
 #include "render/device.h"
 #include "render/render_buffer.h"
 #include "render/mesh.h"
+#include "render/material.h"
+#include <robin_hood.h>
 
 const std::string c_writeVolumeShader = "sdf_write_volume.cs";
 
@@ -48,6 +52,8 @@ bool SDFMeshSystem::PreInit()
 	m_entitySystem = Engine::GetSystem<EntitySystem>("Entities");
 	m_jobSystem = Engine::GetSystem<Engine::JobSystem>("Jobs");
 	m_cameras = Engine::GetSystem<Engine::CameraSystem>("Cameras");
+	m_models = Engine::GetSystem<Engine::ModelManager>("Models");
+	m_defaultMaterial = std::make_unique<Render::Material>();
 	
 	return true;
 }
@@ -107,14 +113,8 @@ std::unique_ptr<SDFMeshSystem::WorkingSet> SDFMeshSystem::MakeWorkingSet(glm::iv
 	glm::ivec3 actualDims = { nextPowerTwo(dimsRequired.x), nextPowerTwo(dimsRequired.y) , nextPowerTwo(dimsRequired.z) };
 	w->m_dimensions = actualDims;
 
-	// The distance field is written to this volume texture
-	auto volumedatadesc = Render::TextureSource(actualDims.x, actualDims.y, actualDims.z, Render::TextureSource::Format::RF16);
+	// Per-cell index data written as r32ui (the distance field itself lives in the brick cache)
 	const auto clamp = Render::TextureSource::WrapMode::ClampToEdge;
-	volumedatadesc.SetWrapMode(clamp, clamp, clamp);
-	w->m_volumeDataTexture = std::make_unique<Render::Texture>();
-	w->m_volumeDataTexture->Create(volumedatadesc);
-
-	// Per-cell index data written as r32ui
 	auto volumeDesc = Render::TextureSource(actualDims.x, actualDims.y, actualDims.z, Render::TextureSource::Format::R32UI);
 	volumeDesc.SetWrapMode(clamp, clamp, clamp);
 	w->m_cellLookupTexture = std::make_unique<Render::Texture>();
@@ -195,7 +195,7 @@ void SDFMeshSystem::FindVertices(WorkingSet& w, Render::ShaderProgram& shader, g
 }
 
 // build triangles from the vertices and indices we found earlier
-void SDFMeshSystem::FindTriangles(WorkingSet& w, Render::ShaderProgram& shader, glm::ivec3 dims, glm::vec3 offset, glm::vec3 cellSize)
+void SDFMeshSystem::FindTriangles(WorkingSet& w, Render::ShaderProgram& shader, glm::ivec3 emitCells, int emitOffset, glm::vec3 offset, glm::vec3 cellSize)
 {
 	SDE_PROF_EVENT();
 	
@@ -210,9 +210,19 @@ void SDFMeshSystem::FindTriangles(WorkingSet& w, Render::ShaderProgram& shader,
 	{
 		device->SetSampler(sampler, w.m_volumeDataTexture->GetResidentHandle());
 	}
+	auto handle = shader.GetUniformHandle("EmitOffset");
+	if (handle != -1)
+	{
+		device->SetUniformValue(handle, (int32_t)emitOffset);
+	}
+	handle = shader.GetUniformHandle("EmitCount");
+	if (handle != -1)
+	{
+		device->SetUniformValue(handle, glm::vec4(emitCells, 0.0f));
+	}
 	device->BindStorageBuffer(0, *w.m_workingIndexBuffer);
 	device->BindComputeImage(0, w.m_cellLookupTexture->GetHandle(), Render::ComputeImageFormat::R32UI, Render::ComputeImageAccess::ReadOnly, true);
-	dims = glm::vec3((dims.x + 3 - 5) & ~0x03, (dims.y + 3 - 5) & ~0x03, (dims.z + 3 - 5) & ~0x03);	// round up to next mul. 4
+	auto dims = glm::ivec3((emitCells.x + 3) & ~0x03, (emitCells.y + 3) & ~0x03, (emitCells.z + 3) & ~0x03);	// round up to next mul. 4
 	device->DispatchCompute(dims.x / 4, dims.y / 4, dims.z / 4);
 	w.m_buildMeshFence = device->MakeFence();
 }
@@ -220,6 +230,12 @@ void SDFMeshSystem::FindTriangles(WorkingSet& w, Render::ShaderProgram& shader,
 void SDFMeshSystem::KickoffRemesh(SDFMesh& mesh, EntityHandle handle, glm::vec3 boundsMin, glm::vec3 boundsMax, uint32_t depth, uint64_t nodeIndex)
 {
 	SDE_PROF_EVENT();
+
+	if (mesh.GetBackend() == SDFMesh::Backend::CPU && mesh.GetSampleFunction() != nullptr)
+	{
+		KickoffRemeshCPU(mesh, handle, boundsMin, boundsMax, nodeIndex);
+		return;
+	}
 	
 	Engine::ShaderManager::CustomDefines shaderDefines = { {"SDF_SHADER_INCLUDE", mesh.GetSDFShaderPath()} };
 	const auto shaderName = "SDF Volume " + mesh.GetSDFShaderPath();
@@ -243,9 +259,9 @@ void SDFMeshSystem::KickoffRemesh(SDFMesh& mesh, EntityHandle handle, glm::vec3
 
 		// vertices at the edges will get sampling artifacts due to filtering
 		// we add extra samples to ensure meshes can have seamless edges for the same lod
-		// for multiple lods, we just brute force add extra edges for now
+		// triangles are only output inside the node bounds, cracks between lods are hidden by skirts
 		// +1 since we can only output triangles for dims-1
-		const uint32_t extraLayers = 4;
+		const uint32_t extraLayers = SDFMesh::c_extraSampleLayers;
 		auto dims = mesh.GetResolution() + glm::ivec3(1 + extraLayers * 2);
 		const glm::vec3 cellSize = (boundsMax - boundsMin) / glm::vec3(mesh.GetResolution());
 		const glm::vec3 worldOffset = boundsMin -(cellSize * float(extraLayers));
@@ -255,12 +271,33 @@ void SDFMeshSystem::KickoffRemesh(SDFMesh& mesh, EntityHandle handle, glm::vec3
 		w->m_workingVertexBuffer->SetData(0, sizeof(newHeader), &newHeader);
 		w->m_workingIndexBuffer->SetData(0, sizeof(newHeader), &newHeader);
 
-		PopulateSDF(*w, *sdfVolumeShader, dims, instanceMaterial, worldOffset, cellSize);
+		// only sample the field if the cached brick for this node is missing or out of date
+		bool needsSampling = true;
+		const glm::ivec3 brickDims = { nextPowerTwo(dims.x), nextPowerTwo(dims.y), nextPowerTwo(dims.z) };
+		const uint64_t fieldVersion = mesh.GetOctree().GetNodeFieldVersion(nodeIndex);
+		auto& brick = m_brickCache.Acquire(handle.GetID(), nodeIndex, brickDims, fieldVersion, needsSampling);
+		w->m_volumeDataTexture = brick.m_volume.get();
+		if (needsSampling)
+		{
+			PopulateSDF(*w, *sdfVolumeShader, dims, instanceMaterial, worldOffset, cellSize);
+		}
 		FindVertices(*w, *findVerticesShader, dims, worldOffset, cellSize);
-		FindTriangles(*w, *makeTrianglesShader, dims, worldOffset, cellSize);
+		FindTriangles(*w, *makeTrianglesShader, mesh.GetResolution(), extraLayers, worldOffset, cellSize);
+		w->m_skirtLength = glm::compMax(cellSize) * m_skirtCells;
+		w->m_validateFn = (m_validateCPUBackend && !mesh.IsSampleFunctionScript()) ? mesh.GetSampleFunction() : nullptr;	// validation runs on jobs
+		w->m_worldOffset = worldOffset;
+		w->m_cellSize = cellSize;
+		w->m_sampleDims = dims;
+		w->m_emitOffset = extraLayers;
+		w->m_emitCells = mesh.GetResolution();
 		m_meshesComputing.emplace_back(std::move(w));
 		++m_meshesPending;
 	}
+	else if (mesh.GetSampleFunction() != nullptr)
+	{
+		// compute shaders are unavailable, fall back to the cpu
+		KickoffRemeshCPU(mesh, handle, boundsMin, boundsMax, nodeIndex);
+	}
 }
 
 void SDFMeshSystem::FinaliseMesh(WorkingSet& w)
@@ -271,15 +308,206 @@ void SDFMeshSystem::FinaliseMesh(WorkingSet& w)
 	auto meshComponent = world->GetComponent<SDFMesh>(w.m_remeshEntity);
 	if (meshComponent)
 	{
-		if (w.m_finalMesh != nullptr)
+		if (w.m_outOfSpace)
 		{
-			w.m_finalMesh->GetVertexArray().Create();		// this is the only thing we can't do in jobs
+			meshComponent->GetOctree().RetryNode(w.m_nodeIndex);
+		}
+		else
+		{
+			meshComponent->GetOctree().SetNodeData(w.m_nodeIndex, std::move(w.m_finalMesh));
 		}
-		meshComponent->GetOctree().SetNodeData(w.m_nodeIndex, std::move(w.m_finalMesh));
 	}
+	w.m_finalMesh = nullptr;
+	w.m_outOfSpace = false;
 	--m_meshesPending;
 }
 
+// Generates skirts hanging from the open edges of the mesh (i.e. the node boundaries)
+// Neighbouring nodes at a different lod will not share edge vertices, the skirts fill the gaps
+// vertices are pos(4), normal(4)
+void SDFMeshSystem::AddSkirts(const float* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, float skirtLength, std::vector<float>& outVertices, std::vector<uint32_t>& outIndices)
+{
+	SDE_PROF_EVENT();
+	const uint32_t c_floatsPerVertex = 8;
+	outVertices.assign(vertices, vertices + vertexCount * c_floatsPerVertex);
+	outIndices.assign(indices, indices + indexCount);
+
+	// an edge is open if no triangle uses it in the opposite direction
+	auto edgeKey = [](uint32_t v0, uint32_t v1) {
+		return ((uint64_t)v0 << 32) | (uint64_t)v1;
+	};
+	robin_hood::unordered_set<uint64_t> edges;
+	edges.reserve(indexCount);
+	for (uint32_t i = 0; i < indexCount; i += 3)
+	{
+		edges.insert(edgeKey(indices[i], indices[i + 1]));
+		edges.insert(edgeKey(indices[i + 1], indices[i + 2]));
+		edges.insert(edgeKey(indices[i + 2], indices[i]));
+	}
+
+	// one skirt vertex per open edge vertex, pushed inside the surface along the normal
+	robin_hood::unordered_map<uint32_t, uint32_t> skirtVertex;
+	auto getSkirtVertex = [&](uint32_t v) -> uint32_t {
+		auto found = skirtVertex.find(v);
+		if (found != skirtVertex.end())
+		{
+			return found->second;
+		}
+		const float* src = vertices + v * c_floatsPerVertex;
+		const uint32_t newIndex = (uint32_t)(outVertices.size() / c_floatsPerVertex);
+		for (int i = 0; i < 3; ++i)
+		{
+			outVertices.push_back(src[i] - src[4 + i] * skirtLength);
+		}
+		outVertices.push_back(src[3]);
+		outVertices.insert(outVertices.end(), src + 4, src + 8);	// keep the surface normal so lighting matches
+		skirtVertex[v] = newIndex;
+		return newIndex;
+	};
+	auto addSkirt = [&](uint32_t a, uint32_t b) {
+		if (a != b && edges.find(edgeKey(b, a)) == edges.end())
+		{
+			const uint32_t a1 = getSkirtVertex(a), b1 = getSkirtVertex(b);
+			outIndices.insert(outIndices.end(), { a, a1, b1, b1, b, a });
+		}
+	};
+	for (uint32_t i = 0; i < indexCount; i += 3)
+	{
+		addSkirt(indices[i], indices[i + 1]);
+		addSkirt(indices[i + 1], indices[i + 2]);
+		addSkirt(indices[i + 2], indices[i]);
+	}
+}
+
+// Creates the final mesh from raw vertex (pos(4), normal(4)) and index data, skirts are added here
+// Only vertices used by triangles are kept, they are converted to the model vertex layout and written to the global model buffers
+void SDFMeshSystem::BuildMesh(WorkingSet& w, const float* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+{
+	SDE_PROF_EVENT();
+	std::vector<float> skirtVertices;
+	std::vector<uint32_t> skirtIndices;
+	if (w.m_skirtLength > 0.0f)
+	{
+		AddSkirts(vertices, vertexCount, indices, indexCount, w.m_skirtLength, skirtVertices, skirtIndices);
+		vertices = skirtVertices.data();
+		indices = skirtIndices.data();
+		vertexCount = (uint32_t)(skirtVertices.size() / 8);
+		indexCount = (uint32_t)skirtIndices.size();
+	}
+
+	// the compute backend outputs a vertex for every cell, most of them are never used
+	std::vector<uint32_t> vertexRemap(vertexCount, (uint32_t)-1);
+	std::vector<Engine::Assets::MeshVertex> meshVertices;
+	std::vector<uint32_t> meshIndices(indexCount);
+	for (uint32_t i = 0; i < indexCount; ++i)
+	{
+		const uint32_t v = indices[i];
+		if (vertexRemap[v] == -1)
+		{
+			const float* src = vertices + v * 8;
+			Engine::Assets::MeshVertex newVertex = {
+				{ src[0], src[1], src[2] },
+				{ src[4], src[5], src[6] },
+				{ 0.0f, 0.0f, 0.0f },
+				{ 0.0f, 0.0f }
+			};
+			vertexRemap[v] = (uint32_t)meshVertices.size();
+			meshVertices.push_back(newVertex);
+		}
+		meshIndices[i] = vertexRemap[v];
+	}
+
+	// rebuild the entire mesh
+	// we dont try and change the old one since the gpu could be using it, its space is released when the node mesh is replaced
+	auto geometry = m_models->AllocateGeometry((uint32_t)meshVertices.size(), indexCount);
+	if (!geometry.IsValid())
+	{
+		++m_failedAllocations;
+		w.m_outOfSpace = true;
+		return;
+	}
+	m_models->UploadVertices(geometry, 0, (uint32_t)meshVertices.size(), meshVertices.data());
+	m_models->UploadIndices(geometry, 0, indexCount, meshIndices.data());
+
+	auto newMesh = std::make_unique<Engine::SDFNodeMesh>();
+	newMesh->m_chunk = Render::MeshChunk(geometry.m_firstIndex, indexCount, Render::PrimitiveType::Triangles, (int32_t)geometry.m_firstVertex);
+	newMesh->m_geometry = std::move(geometry);
+	w.m_finalMesh = std::move(newMesh);
+}
+
+// Compares triangle + referenced vertex counts of the compute output against the cpu backend for the same node
+// The vertex shader outputs a vertex for every cell in the volume, so only vertices used by triangles are compared
+void SDFMeshSystem::ValidateAgainstCPU(WorkingSet& w, const float* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+{
+	SDE_PROF_EVENT();
+	auto countUsedVertices = [](const uint32_t* indices, uint32_t indexCount) {
+		robin_hood::unordered_set<uint32_t> used;
+		used.insert(indices, indices + indexCount);
+		return used.size();
+	};
+	Engine::SDF::MeshData cpuData;
+	Engine::SDF::BuildMeshData(w.m_validateFn, w.m_worldOffset, w.m_cellSize, w.m_sampleDims, w.m_emitOffset, w.m_emitCells, cpuData);
+	const size_t gpuTris = indexCount / 3, cpuTris = cpuData.m_indices.size() / 3;
+	const size_t gpuVerts = countUsedVertices(indices, indexCount);
+	const size_t cpuVerts = countUsedVertices(cpuData.m_indices.data(), (uint32_t)cpuData.m_indices.size());
+	if (gpuTris == cpuTris && gpuVerts == cpuVerts)
+	{
+		++m_validationsPassed;
+	}
+	else
+	{
+		++m_validationsFailed;
+		SDE_LOG("SDF backend mismatch (node %llu): compute %zu verts/%zu tris, cpu %zu verts/%zu tris", w.m_nodeIndex, gpuVerts, gpuTris, cpuVerts, cpuTris);
+	}
+}
+
+void SDFMeshSystem::KickoffRemeshCPU(SDFMesh& mesh, EntityHandle handle, glm::vec3 boundsMin, glm::vec3 boundsMax, uint64_t nodeIndex)
+{
+	SDE_PROF_EVENT();
+
+	// same sampling layout as the compute path so meshes match
+	const uint32_t extraLayers = SDFMesh::c_extraSampleLayers;
+	const glm::ivec3 resolution = mesh.GetResolution();
+	const glm::ivec3 dims = resolution + glm::ivec3(1 + extraLayers * 2);
+	const glm::vec3 cellSize = (boundsMax - boundsMin) / glm::vec3(resolution);
+	const glm::vec3 worldOffset = boundsMin - (cellSize * float(extraLayers));
+
+	// working set owned by the job until it is pushed to the finalise list
+	auto* w = new WorkingSet();
+	w->m_remeshEntity = handle;
+	w->m_nodeIndex = nodeIndex;
+	w->m_skirtLength = glm::compMax(cellSize) * m_skirtCells;
+	auto sampleFn = mesh.GetSampleFunction();
+	++m_meshesPending;
+
+	// script sample functions cannot run on jobs, the mesh data is built here and only uploaded on a job
+	std::shared_ptr<Engine::SDF::MeshData> scriptData;
+	if (mesh.IsSampleFunctionScript())
+	{
+		scriptData = std::make_shared<Engine::SDF::MeshData>();
+		Engine::SDF::BuildMeshData(sampleFn, worldOffset, cellSize, dims, extraLayers, resolution, *scriptData);
+	}
+	// the job must not hold a copy of a script function either, releasing it would touch lua off the main thread
+	Engine::SDF::SampleFn jobSampleFn = mesh.IsSampleFunctionScript() ? nullptr : sampleFn;
+	m_jobSystem->PushSlowJob([this, w, jobSampleFn, scriptData, worldOffset, cellSize, dims, extraLayers, resolution](void*) {
+		Engine::SDF::MeshData localData;
+		if (scriptData == nullptr)
+		{
+			Engine::SDF::BuildMeshData(jobSampleFn, worldOffset, cellSize, dims, extraLayers, resolution, localData);
+		}
+		const Engine::SDF::MeshData& data = scriptData != nullptr ? *scriptData : localData;
+		if (data.m_indices.size() > 0)
+		{
+			BuildMesh(*w, data.m_vertices.data(), (uint32_t)(data.m_vertices.size() / 8), data.m_indices.data(), (uint32_t)data.m_indices.size());
+			Render::Device::FlushContext();
+		}
+		{
+			Core::ScopedMutex lock(m_finaliseMeshLock);
+			m_meshesToFinalise.emplace_back(std::unique_ptr<WorkingSet>(w));
+		}
+	});
+}
+
 void SDFMeshSystem::BuildMeshJob(WorkingSet& w)
 {
 	SDE_PROF_EVENT();
@@ -297,23 +525,13 @@ void SDFMeshSystem::BuildMeshJob(WorkingSet& w)
 
 		if (vertexCount > 0 && indexCount > 0)
 		{
-			float* vbase = reinterpret_cast<float*>(vheader + 1);
-			uint32_t* ibase = reinterpret_cast<uint32_t*>(iheader + 1);
-
-			// rebuild the entire mesh
-			// we dont try and change the old one since the gpu could be using it (gl lets us be lazy)
-			auto newMesh = std::make_unique<Render::Mesh>();
-			newMesh->GetStreams().push_back({});
-			auto& vb = newMesh->GetStreams()[0];
-			vb.Create(vbase, sizeof(float) * 4 * 2 * vertexCount, Render::RenderBufferModification::Static);
-			newMesh->GetVertexArray().AddBuffer(0, &vb, Render::VertexDataType::Float, 4, 0, sizeof(float) * 4 * 2);
-			newMesh->GetVertexArray().AddBuffer(1, &vb, Render::VertexDataType::Float, 4, sizeof(float) * 4, sizeof(float) * 4 * 2);
-			auto ib = std::make_unique<Render::RenderBuffer>();
-			ib->Create(ibase, sizeof(uint32_t) * indexCount, Render::RenderBufferModification::Static);
-			newMesh->GetIndexBuffer() = std::move(ib);
-
-			newMesh->GetChunks().push_back(Render::MeshChunk(0, indexCount, Render::PrimitiveType::Triangles));
-			w.m_finalMesh = std::move(newMesh);
+			const float* vbase = reinterpret_cast<float*>(vheader + 1);
+			const uint32_t* ibase = reinterpret_cast<uint32_t*>(iheader + 1);
+			if (w.m_validateFn != nullptr)
+			{
+				ValidateAgainstCPU(w, vbase, vertexCount, ibase, indexCount);
+			}
+			BuildMesh(w, vbase, vertexCount, ibase, indexCount);
 		}
 	}
 	w.m_workingVertexBuffer->Unmap();
@@ -344,6 +562,10 @@ void SDFMeshSystem::HandleFinishedComputeShaders()
 		// take ownership of the working set ptr since we can't capture unique_ptr
 		auto* theWorkingSet = m_meshesComputing[readyForJobs[i]].release();
 
+		// compute is finished with the distance field, the brick can be evicted again
+		m_brickCache.Release(theWorkingSet->m_remeshEntity.GetID(), theWorkingSet->m_nodeIndex);
+		theWorkingSet->m_volumeDataTexture = nullptr;
+
 		m_jobSystem->PushSlowJob([this, theWorkingSet](void*) {
 			BuildMeshJob(*theWorkingSet);
 			{
@@ -368,7 +590,8 @@ void SDFMeshSystem::FinaliseMeshes()
 	for (auto& it : finaliseMeshes)
 	{
 		FinaliseMesh(*it);
-		if (m_workingSetCache.size() < m_maxCachedSets)
+		const bool hasComputeBuffers = it->m_workingVertexBuffer != nullptr;	// cpu backend sets have nothing worth caching
+		if (hasComputeBuffers && m_workingSetCache.size() < m_maxCachedSets)
 		{
 			m_workingSetCache.emplace_back(std::move(it));
 		}
@@ -429,11 +652,13 @@ bool SDFMeshSystem::Tick(float timeDelta)
 
 	// Finalise vertex arrays on main thread
 	FinaliseMeshes();
+	m_brickCache.NewFrame();
 	
 	// depth/lod, distance to camera, mesh/entity, bounds, node index
 	using NodeToUpdate = std::tuple<uint32_t, float, SDFMesh*, EntityHandle, glm::vec3, glm::vec3, uint64_t >;
 	std::vector<NodeToUpdate> nodesToUpdate;
 	nodesToUpdate.reserve(64 * 1024);
+	std::vector<std::tuple<SDFMesh*, glm::mat4>> activeMeshes;
 
 	static World::EntityIterator iterator = world->MakeIterator<SDFMesh, Transform>();
 	iterator.ForEach([&](SDFMesh& m, Transform& t, EntityHandle h) {
@@ -479,9 +704,9 @@ bool SDFMeshSystem::Tick(float timeDelta)
 			}
 			return true;
 		};
-		auto drawFn = [&](glm::vec3 bmin, glm::vec3 bmax, Render::Mesh& nodemesh)
+		auto drawFn = [&](glm::vec3 bmin, glm::vec3 bmax, const Engine::SDFNodeMesh& nodemesh)
 		{
-			Render::Material* instanceMaterial = nullptr;
+			const Render::Material* instanceMaterial = m_defaultMaterial.get();
 			if (m.GetMaterialEntity().GetID() != -1)
 			{
 				auto matComponent = materials->Find(m.GetMaterialEntity());
@@ -490,7 +715,8 @@ bool SDFMeshSystem::Tick(float timeDelta)
 					instanceMaterial = &matComponent->GetRenderMaterial();
 				}
 			}
-			m_graphics->Renderer().SubmitInstance(t.GetWorldspaceMatrix(), nodemesh, m.GetRenderShader(), bmin, bmax, instanceMaterial);
+			m_graphics->Renderer().SubmitInstance(t.GetWorldspaceMatrix(), *m_models->GetVertexArray(), m_models->GetIndexBuffer(), &nodemesh.m_chunk, 1,
+				*instanceMaterial, m.GetRenderShader(), bmin, bmax);
 			if (m_graphics->ShouldDrawBounds())
 			{
 				auto colour = glm::vec4(1, 0, 0, 1);
@@ -503,7 +729,9 @@ bool SDFMeshSystem::Tick(float timeDelta)
 			m_graphics->DebugRenderer().DrawBox(m.GetBoundsMin(), m.GetBoundsMax(), colour, t.GetWorldspaceMatrix());
 		}
 		m.GetOctree().Update(shouldUpdateNode, requestUpdate, shouldDrawNode, drawFn);
+		activeMeshes.push_back({ &m, t.GetWorldspaceMatrix() });
 	});
+	EvictMeshesOverBudget(activeMeshes, camera.Position());
 
 	std::sort(nodesToUpdate.begin(), nodesToUpdate.end(), [this](const NodeToUpdate& c0, const NodeToUpdate& c1) {
 		if (std::get<0>(c0) < m_maxLODUpdatePrecedence || std::get<0>(c1) < m_maxLODUpdatePrecedence)
@@ -540,9 +768,105 @@ bool SDFMeshSystem::Tick(float timeDelta)
 	// Handle finished compute shaders
 	HandleFinishedComputeShaders();
 
+	ShowMenubar();
+	if (m_showStats)
+	{
+		ShowStats();
+	}
+
 	return true;
 }
 
+void SDFMeshSystem::EvictMeshesOverBudget(const std::vector<std::tuple<SDFMesh*, glm::mat4>>& meshes, glm::vec3 cameraPos)
+{
+	SDE_PROF_EVENT();
+
+	m_residentMeshBytes = 0;
+	m_residentMeshCount = 0;
+	m_octreeNodeCount = 0;
+	for (const auto& [mesh, transform] : meshes)
+	{
+		m_residentMeshBytes += mesh->GetOctree().GetResidentMeshBytes();
+		m_residentMeshCount += mesh->GetOctree().GetResidentMeshCount();
+		m_octreeNodeCount += mesh->GetOctree().GetNodeCount();
+	}
+	if (m_residentMeshBytes <= m_meshMemoryBudget)
+	{
+		return;
+	}
+
+	// least recently drawn first, then furthest from the camera
+	using Candidate = std::tuple<uint64_t, float, SDFMesh*, uint64_t>;	// last drawn, distance, mesh, node
+	std::vector<Candidate> candidates;
+	for (const auto& [mesh, transform] : meshes)
+	{
+		const uint64_t currentFrame = mesh->GetOctree().GetCurrentFrame();
+		const glm::vec3 localCamera = glm::vec3(glm::inverse(transform) * glm::vec4(cameraPos, 1.0f));
+		mesh->GetOctree().ForEachEvictionCandidate([&](glm::vec3 bmin, glm::vec3 bmax, uint32_t depth, uint64_t lastDrawn, size_t bytes, uint64_t node) {
+			if (currentFrame - lastDrawn >= m_minFramesBeforeEviction)
+			{
+				candidates.push_back({ lastDrawn, DistanceToAABB(bmin, bmax, localCamera), mesh, node });
+			}
+		});
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& c0, const Candidate& c1) {
+		if (std::get<0>(c0) != std::get<0>(c1))
+		{
+			return std::get<0>(c0) < std::get<0>(c1);
+		}
+		return std::get<1>(c0) > std::get<1>(c1);
+	});
+	for (int i = 0; i < candidates.size() && m_residentMeshBytes > m_meshMemoryBudget; ++i)
+	{
+		auto [lastDrawn, distance, mesh, node] = candidates[i];
+		size_t freed = 0;
+		if (mesh->GetOctree().EvictNode(node, freed))
+		{
+			m_residentMeshBytes -= freed;
+			--m_residentMeshCount;
+			++m_meshesEvicted;
+		}
+	}
+}
+
+void SDFMeshSystem::ShowMenubar()
+{
+	Engine::MenuBar mainMenu;
+	auto& sdfMenu = mainMenu.AddSubmenu(ICON_FK_CUBES " SDF Meshes");
+	sdfMenu.AddItem("Show stats", [this]() {
+		m_showStats = true;
+	});
+	m_debugGui->MainMenuBar(mainMenu);
+}
+
+void SDFMeshSystem::ShowStats()
+{
+	SDE_PROF_EVENT();
+	char statText[1024] = { '\0' };
+	m_debugGui->BeginWindow(m_showStats, "SDF Mesh Stats");
+	sprintf_s(statText, "Meshes pending: %d", m_meshesPending);	m_debugGui->Text(statText);
+	sprintf_s(statText, "Max compute per frame: %d", m_maxComputePerFrame);	m_debugGui->Text(statText);
+	m_skirtCells = m_debugGui->DragFloat("LOD skirt length (cells)", m_skirtCells, 0.1f, 0.0f, 8.0f);
+	m_validateCPUBackend = m_debugGui->Checkbox("Validate compute against CPU backend", m_validateCPUBackend);
+	sprintf_s(statText, "Validated nodes: %d passed, %d failed", (int)m_validationsPassed, (int)m_validationsFailed);	m_debugGui->Text(statText);
+	m_debugGui->Separator();
+	sprintf_s(statText, "Octree nodes: %llu", m_octreeNodeCount);	m_debugGui->Text(statText);
+	sprintf_s(statText, "Meshes resident: %llu (%.2f / %.2f mb)", m_residentMeshCount, m_residentMeshBytes / (1024.0 * 1024.0), m_meshMemoryBudget / (1024.0 * 1024.0));	m_debugGui->Text(statText);
+	sprintf_s(statText, "Meshes evicted: %llu", m_meshesEvicted);	m_debugGui->Text(statText);
+	sprintf_s(statText, "Failed allocations (model buffers full): %llu", (uint64_t)m_failedAllocations);	m_debugGui->Text(statText);
+	int meshBudgetMb = (int)(m_meshMemoryBudget / (1024 * 1024));
+	meshBudgetMb = m_debugGui->DragInt("Mesh budget (mb)", meshBudgetMb, 1, 0, 8192);
+	m_meshMemoryBudget = (uint64_t)meshBudgetMb * 1024 * 1024;
+	m_debugGui->Separator();
+	const auto& bs = m_brickCache.GetStats();
+	sprintf_s(statText, "Bricks resident: %llu (%.2f / %.2f mb)", bs.m_bricksResident, bs.m_bytesResident / (1024.0 * 1024.0), m_brickCache.GetMemoryBudget() / (1024.0 * 1024.0));	m_debugGui->Text(statText);
+	sprintf_s(statText, "Brick hits: %llu, misses: %llu, evictions: %llu", bs.m_hits, bs.m_misses, bs.m_evictions);	m_debugGui->Text(statText);
+	int budgetMb = (int)(m_brickCache.GetMemoryBudget() / (1024 * 1024));
+	budgetMb = m_debugGui->DragInt("Brick budget (mb)", budgetMb, 1, 0, 8192);
+	m_brickCache.SetMemoryBudget((uint64_t)budgetMb * 1024 * 1024);
+	m_debugGui->EndWindow();
+}
+
 void SDFMeshSystem::Shutdown()
 {
 	SDE_PROF_EVENT();
@@ -550,4 +874,5 @@ void SDFMeshSystem::Shutdown()
 	m_meshesToFinalise.clear();
 	m_meshesComputing.clear();
 	m_workingSetCache.clear();
+	m_brickCache.Clear();
 }
\ No newline at end of file
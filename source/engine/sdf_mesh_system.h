@@ -3,9 +3,12 @@
 #include "core/glm_headers.h"
 #include "engine/system.h"
 #include "engine/shader_manager.h"
+#include "engine/sdf_brick_cache.h"
+#include "engine/sdf.h"
 #include "render/fence.h"
 #include "entity/entity_handle.h"
 #include <memory>
+#include <atomic>
 
 namespace Render
 {
@@ -22,6 +25,8 @@ namespace Engine
 	class RenderSystem;
 	class JobSystem;
 	class CameraSystem;
+	class ModelManager;
+	struct SDFNodeMesh;
 }
 class GraphicsSystem;
 class EntitySystem;
@@ -39,14 +44,21 @@ public:
 
 private:
 	struct WorkingSet;
+	void ShowMenubar();
+	void ShowStats();
+	void EvictMeshesOverBudget(const std::vector<std::tuple<class SDFMesh*, glm::mat4>>& meshes, glm::vec3 cameraPos);
 	void FinaliseMeshes();
 	void HandleFinishedComputeShaders();
-	void FindTriangles(WorkingSet& w, Render::ShaderProgram& shader, glm::ivec3 dims, glm::vec3 offset, glm::vec3 cellSize);
+	void FindTriangles(WorkingSet& w, Render::ShaderProgram& shader, glm::ivec3 emitCells, int emitOffset, glm::vec3 offset, glm::vec3 cellSize);
 	void FindVertices(WorkingSet& w, Render::ShaderProgram& shader, glm::ivec3 dims, glm::vec3 offset, glm::vec3 cellSize);
 	void PopulateSDF(WorkingSet& w, Render::ShaderProgram& shader, glm::ivec3 dims, Render::Material* mat, glm::vec3 offset, glm::vec3 cellSize);
 	void KickoffRemesh(class SDFMesh& mesh, EntityHandle handle, glm::vec3 boundsMin, glm::vec3 boundsMax, uint32_t depth, uint64_t nodeIndex);
+	void KickoffRemeshCPU(class SDFMesh& mesh, EntityHandle handle, glm::vec3 boundsMin, glm::vec3 boundsMax, uint64_t nodeIndex);
 	void PushSharedUniforms(Render::ShaderProgram& shader, glm::vec3 offset, glm::vec3 cellSize);
 	void BuildMeshJob(WorkingSet& w);
+	void BuildMesh(WorkingSet& w, const float* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+	void ValidateAgainstCPU(WorkingSet& w, const float* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+	void AddSkirts(const float* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, float skirtLength, std::vector<float>& outVertices, std::vector<uint32_t>& outIndices);
 	void FinaliseMesh(WorkingSet& w);
 	std::unique_ptr<WorkingSet> MakeWorkingSet(glm::ivec3 dimsRequired, EntityHandle h, uint64_t nodeIndex);
 
@@ -58,19 +70,42 @@ private:
 		WorkingSet(const WorkingSet&) = delete;
 		EntityHandle m_remeshEntity;
 		uint64_t m_nodeIndex = -1;
+		float m_skirtLength = 0.0f;
 		Render::Fence m_buildMeshFence;
-		std::unique_ptr<Render::Mesh> m_finalMesh;
+		std::unique_ptr<Engine::SDFNodeMesh> m_finalMesh;
+		bool m_outOfSpace = false;		// the global model buffers were full, try again later
 		glm::ivec3 m_dimensions;
-		std::unique_ptr<Render::Texture> m_volumeDataTexture;
+		Render::Texture* m_volumeDataTexture = nullptr;		// owned by the brick cache
 		std::unique_ptr<Render::RenderBuffer> m_workingVertexBuffer;
 		std::unique_ptr<Render::RenderBuffer> m_workingIndexBuffer;
 		std::unique_ptr<Render::Texture> m_cellLookupTexture;	// pos -> vertex index
+
+		// set if the compute output should be validated against the cpu backend
+		Engine::SDF::SampleFn m_validateFn;
+		glm::vec3 m_worldOffset;
+		glm::vec3 m_cellSize;
+		glm::ivec3 m_sampleDims;
+		int m_emitOffset = 0;
+		glm::ivec3 m_emitCells;
 	};
 	int m_maxLODUpdatePrecedence = 4;	// lowest lod that will force update order (i.e. after this many lods, we prefer higher lod)
 	int m_maxComputePerFrame = 16;
 	int m_maxCachedSets = 64;
+	float m_skirtCells = 2.0f;		// skirts hide cracks between neighbouring lods, length in cells
+	bool m_validateCPUBackend = false;
+	std::atomic<int> m_validationsPassed = 0;
+	std::atomic<int> m_validationsFailed = 0;
 	int m_meshesPending = 0;
 	uint64_t m_meshGeneration = 0;	// used to control how often meshes are rebuilt when a lot exist
+	bool m_showStats = false;
+	uint64_t m_meshMemoryBudget = 512 * 1024 * 1024;	// octree meshes over this size will be evicted, least recently drawn first
+	uint64_t m_minFramesBeforeEviction = 60;			// stops nodes that are about to be drawn from thrashing
+	uint64_t m_meshesEvicted = 0;
+	std::atomic<uint64_t> m_failedAllocations = 0;
+	uint64_t m_residentMeshBytes = 0;
+	uint64_t m_residentMeshCount = 0;
+	uint64_t m_octreeNodeCount = 0;
+	Engine::SDFBrickCache m_brickCache;
 	Core::Mutex m_finaliseMeshLock;
 	std::vector<std::unique_ptr<WorkingSet>> m_meshesToFinalise;
 	std::vector<std::unique_ptr<WorkingSet>> m_workingSetCache;
@@ -81,6 +116,8 @@ private:
 	Engine::RenderSystem* m_renderSys = nullptr;
 	Engine::JobSystem* m_jobSystem = nullptr;
 	Engine::CameraSystem* m_cameras = nullptr;
+	Engine::ModelManager* m_models = nullptr;
+	std::unique_ptr<Render::Material> m_defaultMaterial;	// used when a mesh has no material entity
 	GraphicsSystem* m_graphics = nullptr;
 	EntitySystem* m_entitySystem = nullptr;
 };
@@ -11,6 +11,8 @@ namespace Engine
 	};
 }
 
+#include "binary_archive.h"
+
 // add this to the public interface of your class
 #define SERIALISED_CLASS()	\
 	void Serialise(nlohmann::json& json, Engine::SerialiseType op)
@@ -62,7 +64,10 @@ namespace Engine
 // robin hood containers need their own macros (avoids template madness)
 // i'm sure there is a better way to handle this
 #define SERIALISE_PROPERTY_ROBINHOOD(name,p)	\
-		if(op==Engine::SerialiseType::Write) {				\
+		if(auto binaryArchive = Engine::BinaryArchive::Get(json)) {	\
+			binaryArchive->SerialiseMap(name, p, op);		\
+		}													\
+		else if(op==Engine::SerialiseType::Write) {			\
 			std::unordered_map<decltype(p)::key_type,nlohmann::json> m;	\
 			for(const auto& it : p)	{						\
 				nlohmann::json storageJson;					\
@@ -86,7 +91,11 @@ namespace Engine
 // having parents overwrite it
 
 #define SERIALISE_END()	\
-		json["ClassName"] = c_myClassName;	\
+		if(auto binaryArchive = Engine::BinaryArchive::Get(json)) {	\
+			if(op == Engine::SerialiseType::Write) binaryArchive->WriteClassName(c_myClassName);	\
+		}	\
+		else json["ClassName"] = c_myClassName;	\
 	}
 
-#include "serialisation.inl"
\ No newline at end of file
+#include "serialisation.inl"
+#include "binary_archive.inl"
\ No newline at end of file
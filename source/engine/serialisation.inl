@@ -52,6 +52,11 @@ namespace Engine
 	template<class T>
 	void ToJson(const std::unique_ptr<T>& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->WriteValue(v);
+			return;
+		}
 		if constexpr (Serialisation::HasSerialiser<T>::value)
 		{
 			v->Serialise(json, Engine::SerialiseType::Write);
@@ -65,6 +70,11 @@ namespace Engine
 	template<class T>
 	void ToJson(std::unique_ptr<T>& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->WriteValue(v);
+			return;
+		}
 		if constexpr (Serialisation::HasSerialiser<T>::value)
 		{
 			v->Serialise(json, Engine::SerialiseType::Write);
@@ -77,6 +87,11 @@ namespace Engine
 
 	inline void ToJson(const char* name, glm::mat4& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Write(name, v);
+			return;
+		}
 		float values[16] = {	v[0].x, v[0].y, v[0].z, v[0].w,
 								v[1].x, v[1].y, v[1].z, v[1].w,
 								v[2].x, v[2].y, v[2].z, v[2].w ,
@@ -86,30 +101,55 @@ namespace Engine
 
 	inline void ToJson(const char* name, glm::quat& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Write(name, v);
+			return;
+		}
 		float values[4] = { v.x, v.y, v.z, v.w };
 		json[name] = values;
 	}
 
 	inline void ToJson(const char* name, glm::vec4& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Write(name, v);
+			return;
+		}
 		float values[4] = { v.x, v.y, v.z, v.w };
 		json[name] = values;
 	}
 
 	inline void ToJson(const char* name, glm::vec3& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Write(name, v);
+			return;
+		}
 		float values[3] = { v.x, v.y, v.z };
 		json[name] = values;
 	}
 
 	inline void ToJson(const char* name, glm::vec2& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Write(name, v);
+			return;
+		}
 		float values[2] = { v.x, v.y };
 		json[name] = values;
 	}
 
 	inline void ToJson(const char* name, glm::ivec2& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Write(name, v);
+			return;
+		}
 		int values[2] = { v.x, v.y };
 		json[name] = values;
 	}
@@ -117,6 +157,11 @@ namespace Engine
 	template<class T>
 	void ToJson(T& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->WriteValue(v);
+			return;
+		}
 		if constexpr (Serialisation::HasSerialiser<T>::value)	// I'm in love
 		{
 			v.Serialise(json, Engine::SerialiseType::Write);
@@ -130,6 +175,11 @@ namespace Engine
 	template<class T>
 	void ToJson(T* v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->WriteValue(*v);
+			return;
+		}
 		if constexpr (Serialisation::HasSerialiser<T>::value)
 		{
 			v->Serialise(json, Engine::SerialiseType::Write);
@@ -143,6 +193,11 @@ namespace Engine
 	template<class T>
 	void ToJson(const char* name, T& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Write(name, v);
+			return;
+		}
 		if constexpr (Serialisation::HasSerialiser<T>::value)
 		{
 			v.Serialise(json[name], Engine::SerialiseType::Write);
@@ -156,6 +211,11 @@ namespace Engine
 	template<class T>
 	void ToJson(const char* name, std::vector<T>& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Write(name, v);
+			return;
+		}
 		std::vector<nlohmann::json> listJson;
 		for (auto& it : v)
 		{
@@ -171,6 +231,11 @@ namespace Engine
 	template<class T>
 	void FromJson(std::shared_ptr<T>& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->ReadValue(v);
+			return;
+		}
 		if constexpr (Serialisation::HasSerialiser<T>::value)
 		{
 			// Get the actual class name from json
@@ -189,6 +254,11 @@ namespace Engine
 	template<class T>
 	void FromJson(std::unique_ptr<T>& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->ReadValue(v);
+			return;
+		}
 		if constexpr (Serialisation::HasSerialiser<T>::value)
 		{
 			// Get the actual class name from json
@@ -207,6 +277,11 @@ namespace Engine
 	template<class T>
 	void FromJson(T& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->ReadValue(v);
+			return;
+		}
 		if constexpr (Serialisation::HasSerialiser<T>::value)
 		{
 			v.Serialise(json, Engine::SerialiseType::Read);
@@ -220,6 +295,11 @@ namespace Engine
 	template<class T>
 	void FromJson(const char* name, std::vector<T>& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Read(name, v);
+			return;
+		}
 		auto& jj = json[name];
 		v.reserve(jj.size());
 		for (auto& it : jj)
@@ -232,6 +312,11 @@ namespace Engine
 
 	inline void FromJson(const char* name, glm::ivec2& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Read(name, v);
+			return;
+		}
 		auto& vjson = json[name];
 		if (vjson.size() == 2)
 		{
@@ -243,6 +328,11 @@ namespace Engine
 
 	inline void FromJson(const char* name, glm::vec2& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Read(name, v);
+			return;
+		}
 		auto& vjson = json[name];
 		if (vjson.size() == 2)
 		{
@@ -254,6 +344,11 @@ namespace Engine
 
 	inline void FromJson(const char* name, glm::vec3& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Read(name, v);
+			return;
+		}
 		auto& vjson = json[name];
 		if (vjson.size() == 3)
 		{
@@ -266,6 +361,11 @@ namespace Engine
 
 	inline void FromJson(const char* name, glm::quat& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Read(name, v);
+			return;
+		}
 		auto& vjson = json[name];
 		if (vjson.size() == 4)
 		{
@@ -279,6 +379,11 @@ namespace Engine
 
 	inline void FromJson(const char* name, glm::vec4& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Read(name, v);
+			return;
+		}
 		auto& vjson = json[name];
 		if (vjson.size() == 4)
 		{
@@ -292,6 +397,11 @@ namespace Engine
 
 	inline void FromJson(const char* name, glm::mat4& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Read(name, v);
+			return;
+		}
 		auto& vjson = json[name];
 		if (vjson.size() == 16)
 		{
@@ -305,6 +415,11 @@ namespace Engine
 	template<class T>
 	void FromJson(const char* name, T& v, nlohmann::json& json)
 	{
+		if (auto binaryArchive = BinaryArchive::Get(json))
+		{
+			binaryArchive->Read(name, v);
+			return;
+		}
 		if constexpr (Serialisation::HasSerialiser<T>::value)
 		{
 			v.Serialise(json[name], Engine::SerialiseType::Read);
@@ -2,14 +2,94 @@
 #include "system_manager.h"
 #include "debug_gui_system.h"
 #include "debug_gui_menubar.h"
+#include "job_system.h"
+#include "cooked_asset.h"
+#include "file_watcher_system.h"
 #include "render/shader_program.h"
 #include "render/shader_binary.h"
+#include "render/device.h"
 #include "core/profiler.h"
 #include "core/log.h"
 #include "core/file_io.h"
+#include "core/timer.h"
+#include <cstring>
+#include <algorithm>
 
 namespace Engine
 {
+	// Linked program binaries are cached by a hash of the preprocessed source + driver name
+	// Any change to a shader, its includes or the driver results in a new key, stale files are never read
+	struct CachedProgramHeader
+	{
+		static constexpr uint32_t c_magic = 0x47525053;		// 'SPRG'
+		static constexpr uint32_t c_version = 1;
+		uint32_t m_magic = c_magic;
+		uint32_t m_version = c_version;
+		uint64_t m_cacheKey;
+		uint32_t m_binaryFormat;
+		uint32_t m_binarySize;
+	};
+
+	// 64 bit FNV-1a
+	static uint64_t HashShaderText(const std::string& text, uint64_t hash = 14695981039346656037ull)
+	{
+		for (const char c : text)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	static std::string GetProgramCachePath(uint64_t cacheKey)
+	{
+		char name[64] = { '\0' };
+		sprintf_s(name, "shader_cache/%016llx", (unsigned long long)cacheKey);
+		return GetCookedPath(name, ".glprog");
+	}
+
+	static std::unique_ptr<Render::ShaderProgram> LoadCachedProgram(const std::string& cachePath, uint64_t cacheKey)
+	{
+		SDE_PROF_EVENT();
+
+		std::vector<uint8_t> data;
+		if (!Core::LoadBinaryFile(cachePath, data) || data.size() < sizeof(CachedProgramHeader))
+		{
+			return nullptr;
+		}
+		CachedProgramHeader header;
+		memcpy(&header, data.data(), sizeof(header));
+		if (header.m_magic != CachedProgramHeader::c_magic || header.m_version != CachedProgramHeader::c_version ||
+			header.m_cacheKey != cacheKey || header.m_binarySize != data.size() - sizeof(header))
+		{
+			return nullptr;
+		}
+		auto program = std::make_unique<Render::ShaderProgram>();
+		if (!program->CreateFromBinary(header.m_binaryFormat, data.data() + sizeof(header), header.m_binarySize))
+		{
+			return nullptr;		// driver may reject binaries even if the version string did not change
+		}
+		return program;
+	}
+
+	static bool SaveCachedProgram(const Render::ShaderProgram& program, const std::string& cachePath, uint64_t cacheKey)
+	{
+		SDE_PROF_EVENT();
+
+		CachedProgramHeader header;
+		std::vector<uint8_t> binary;
+		if (!program.GetBinary(header.m_binaryFormat, binary))
+		{
+			return false;
+		}
+		header.m_cacheKey = cacheKey;
+		header.m_binarySize = (uint32_t)binary.size();
+		std::vector<uint8_t> data(sizeof(header) + binary.size());
+		memcpy(data.data(), &header, sizeof(header));
+		memcpy(data.data() + sizeof(header), binary.data(), binary.size());
+		return SaveCookedFile(cachePath, data);
+	}
+
 	SERIALISE_BEGIN(ShaderHandle)
 		static ShaderManager* sm = GetSystem<ShaderManager>("Shaders");
 		std::string name;
@@ -91,26 +171,80 @@ namespace Engine
 		return results;
 	}
 
-	void ShaderManager::DoReloadAll()
+	void ShaderManager::ReloadShaders(const std::vector<uint32_t>& shaderIndices)
 	{
 		SDE_PROF_EVENT();
-		auto currentShaders = std::move(m_shaders);
-		for (auto &s : currentShaders)
+		Core::Timer timer;
+		const double startTime = timer.GetSeconds();
+
+		// sources are loaded on this thread, compiling + linking is the slow part so that happens on the jobs
+		// shader indices do not change, if a shader fails to build the old one is kept
+		const int32_t reloadCount = static_cast<int32_t>(shaderIndices.size());
+		std::vector<ShaderSource> sources(reloadCount);
+		std::vector<uint8_t> sourceLoaded(reloadCount, 0);
+		for (int32_t s = 0; s < reloadCount; ++s)
 		{
-			ShaderHandle newHandle;
-			if (s.m_fsPath.size() > 0)
+			auto& desc = m_shaders[shaderIndices[s]];
+			sourceLoaded[s] = LoadShaderSource(desc.m_vsPath.c_str(), desc.m_fsPath.c_str(), desc.m_defines, sources[s]);
+			if (sourceLoaded[s])
 			{
-				newHandle = LoadShader(s.m_name.c_str(), s.m_vsPath.c_str(), s.m_fsPath.c_str());
+				desc.m_dependencies = sources[s].m_dependencies;	// includes may have changed even if the build fails
 			}
-			else
+		}
+
+		std::vector<std::unique_ptr<Render::ShaderProgram>> newPrograms(reloadCount);
+		auto jobs = GetSystem<JobSystem>("Jobs");
+		jobs->ForEachAsync(0, reloadCount, 1, 1, [&](int32_t s) {
+			if (sourceLoaded[s])
 			{
-				newHandle = LoadComputeShader(s.m_name.c_str(), s.m_vsPath.c_str());
+				newPrograms[s] = BuildProgram(sources[s]);
+				Render::Device::FlushContext();		// make sure the program is visible to the main context
 			}
-			if (newHandle.m_index == ShaderHandle::Invalid().m_index)	// if compilation failed use the old shader
+		});
+
+		for (int32_t s = 0; s < reloadCount; ++s)
+		{
+			if (newPrograms[s] != nullptr)
 			{
-				m_shaders.emplace_back(std::move(s));
+				m_shaders[shaderIndices[s]].m_shader = std::move(newPrograms[s]);
+			}
+		}
+		m_lastReloadTime = timer.GetSeconds() - startTime;
+		m_lastReloadCount = reloadCount;
+	}
+
+	void ShaderManager::ReloadChangedShaders()
+	{
+		SDE_PROF_EVENT();
+		std::vector<uint32_t> toReload;
+		for (uint32_t s = 0; s < m_shaders.size(); ++s)
+		{
+			const auto& deps = m_shaders[s].m_dependencies;
+			for (const auto& changed : m_changedFiles)
+			{
+				if (std::find(deps.begin(), deps.end(), changed) != deps.end())
+				{
+					toReload.push_back(s);
+					break;
+				}
 			}
 		}
+		m_changedFiles.clear();
+		if (toReload.size() > 0)
+		{
+			SDE_LOG("Reloading %d shaders", (int)toReload.size());
+			ReloadShaders(toReload);
+		}
+	}
+
+	void ShaderManager::DoReloadAll()
+	{
+		std::vector<uint32_t> allShaders(m_shaders.size());
+		for (uint32_t s = 0; s < allShaders.size(); ++s)
+		{
+			allShaders[s] = s;
+		}
+		ReloadShaders(allShaders);
 	}
 
 	bool ShaderManager::HotReloader::Tick(float timeDelta)
@@ -120,121 +254,160 @@ namespace Engine
 		{
 			sm->DoReloadAll();
 			sm->m_shouldReloadAll = false;
+			sm->m_changedFiles.clear();
+		}
+		else if (sm->m_changedFiles.size() > 0)
+		{
+			sm->ReloadChangedShaders();
 		}
 		return true;
 	}
 
-	ShaderHandle ShaderManager::LoadComputeShader(const char* name, const char* path, const CustomDefines& customDefines)
+	bool ShaderManager::LoadShaderSource(const char* vsPath, const char* fsPath, const CustomDefines& customDefines, ShaderSource& result)
 	{
 		SDE_PROF_EVENT();
-		for (uint64_t i = 0; i < m_shaders.size(); ++i)
+
+		if (!Core::LoadTextFromFile(vsPath, result.m_vsOrCs))
 		{
-			if (m_shaders[i].m_name == name)
-			{
-				return { static_cast<uint32_t>(i) };
-			}
+			SDE_LOG("Failed to load shader source from %s", vsPath);
+			return false;
 		}
-
-		std::string shaderSource;
-		if (!Core::LoadTextFromFile(path, shaderSource))
+		if (fsPath[0] != '\0' && !Core::LoadTextFromFile(fsPath, result.m_fs))
 		{
-			SDE_LOG("Failed to load shader source from %s", path);
-			return ShaderHandle::Invalid();
+			SDE_LOG("Failed to load shader source from %s", fsPath);
+			return false;
 		}
-
 		for (const auto& it : customDefines)
 		{
-			size_t foundPos = shaderSource.find(std::get<0>(it), 0);
+			size_t foundPos = result.m_vsOrCs.find(std::get<0>(it), 0);
 			while (foundPos != std::string::npos)
 			{
-				shaderSource.replace(foundPos, std::get<0>(it).length(), std::get<1>(it));
-				foundPos = shaderSource.find(std::get<0>(it), foundPos);
+				result.m_vsOrCs.replace(foundPos, std::get<0>(it).length(), std::get<1>(it));
+				foundPos = result.m_vsOrCs.find(std::get<0>(it), foundPos);
 			}
 		}
-
-		std::string errorText;
-		auto computeShader = std::make_unique<Render::ShaderBinary>();
-		if (!computeShader->CompileFromBuffer(Render::ShaderType::ComputeShader, shaderSource, errorText))
+		std::vector<std::string> vsIncludes, fsIncludes;
+		Render::ParseIncludes(result.m_vsOrCs, vsIncludes);
+		Render::ParseIncludes(result.m_fs, fsIncludes);
+		result.m_vsPath = vsPath;
+		result.m_fsPath = fsPath;
+		result.m_dependencies.push_back(Core::FileWatcher::NormalisePath(vsPath));
+		if (fsPath[0] != '\0')
 		{
-			SDE_LOG("Compute shader compilation failed - \n%s\n%s", shaderSource.c_str(), errorText.c_str());
-			return ShaderHandle::Invalid();
+			result.m_dependencies.push_back(Core::FileWatcher::NormalisePath(fsPath));
 		}
-
-		auto shader = std::make_unique<Render::ShaderProgram>();
-		if (!shader->Create(*computeShader, errorText))
+		for (const auto& include : vsIncludes)
 		{
-			SDE_LOG("Shader linkage failed - %s", errorText.c_str());
-			return ShaderHandle::Invalid();
+			result.m_dependencies.push_back(Core::FileWatcher::NormalisePath(include));
+		}
+		for (const auto& include : fsIncludes)
+		{
+			result.m_dependencies.push_back(Core::FileWatcher::NormalisePath(include));
 		}
 
-		m_shaders.push_back({ std::move(shader), name, path, "" });
-		return ShaderHandle{ static_cast<uint32_t>(m_shaders.size() - 1) };
+		if (m_driverName.empty())
+		{
+			m_driverName = Render::Device::GetDriverName();
+		}
+		result.m_cacheKey = HashShaderText(result.m_fs, HashShaderText(result.m_vsOrCs, HashShaderText(m_driverName)));
+		return true;
 	}
 
-	ShaderHandle ShaderManager::LoadComputeShader(const char* name, const char* path)
+	std::unique_ptr<Render::ShaderProgram> ShaderManager::BuildProgram(const ShaderSource& src)
 	{
 		SDE_PROF_EVENT();
-		for (uint64_t i = 0; i < m_shaders.size(); ++i)
+
+		const std::string cachePath = GetProgramCachePath(src.m_cacheKey);
+		auto shader = LoadCachedProgram(cachePath, src.m_cacheKey);
+		if (shader != nullptr)
 		{
-			if (m_shaders[i].m_name == name)
-			{
-				return { static_cast<uint32_t>(i) };
-			}
+			++m_programsFromCache;
+			return shader;
 		}
 
-		auto shader = std::make_unique<Render::ShaderProgram>();
-		auto computeShader = std::make_unique<Render::ShaderBinary>();
+		shader = std::make_unique<Render::ShaderProgram>();
 		std::string errorText;
-		if (!computeShader->CompileFromFile(Render::ShaderType::ComputeShader, path, errorText))
+		if (src.m_fs.empty())
 		{
-			SDE_LOG("Compute shader compilation failed - %s\n%s", path, errorText.c_str());
-			return ShaderHandle::Invalid();
+			Render::ShaderBinary computeShader;
+			if (!computeShader.CompileFromBuffer(Render::ShaderType::ComputeShader, src.m_vsOrCs, errorText))
+			{
+				SDE_LOG("Compute shader compilation failed - %s\n%s", src.m_vsPath.c_str(), errorText.c_str());
+				return nullptr;
+			}
+			if (!shader->Create(computeShader, errorText))
+			{
+				SDE_LOG("Shader linkage failed - %s", errorText.c_str());
+				return nullptr;
+			}
 		}
-
-		if (!shader->Create(*computeShader, errorText))
+		else
 		{
-			SDE_LOG("Shader linkage failed - %s", errorText.c_str());
-			return ShaderHandle::Invalid();
+			Render::ShaderBinary vertexShader, fragmentShader;
+			if (!vertexShader.CompileFromBuffer(Render::ShaderType::VertexShader, src.m_vsOrCs, errorText))
+			{
+				SDE_LOG("Vertex shader compilation failed - %s\n%s", src.m_vsPath.c_str(), errorText.c_str());
+				return nullptr;
+			}
+			if (!fragmentShader.CompileFromBuffer(Render::ShaderType::FragmentShader, src.m_fs, errorText))
+			{
+				SDE_LOG("Fragment shader compilation failed - %s\n%s", src.m_fsPath.c_str(), errorText.c_str());
+				return nullptr;
+			}
+			if (!shader->Create(vertexShader, fragmentShader, errorText))
+			{
+				SDE_LOG("Shader linkage failed - %s", errorText.c_str());
+				return nullptr;
+			}
 		}
+		++m_programsCompiled;
 
-		m_shaders.push_back({ std::move(shader), name, path, "" });
-		return ShaderHandle{ static_cast<uint32_t>(m_shaders.size() - 1) };
+		if (!SaveCachedProgram(*shader, cachePath, src.m_cacheKey))
+		{
+			SDE_LOG("Failed to write shader cache '%s'", cachePath.c_str());
+		}
+		return shader;
 	}
 
-	ShaderHandle ShaderManager::LoadShader(const char* name, const char* vsPath, const char* fsPath)
+	ShaderHandle ShaderManager::AddShader(const char* name, const char* vsPath, const char* fsPath, const CustomDefines& customDefines)
 	{
 		SDE_PROF_EVENT();
-		for (uint64_t i = 0; i < m_shaders.size(); ++i)
+		const uint32_t existing = m_registry.Find(name);
+		if (existing != AssetRegistry::c_invalidIndex)
 		{
-			if (m_shaders[i].m_name == name)
-			{
-				return { static_cast<uint32_t>(i) };
-			}
+			return { existing };
 		}
 
-		auto shader = std::make_unique<Render::ShaderProgram>();
-		auto vertexShader = std::make_unique<Render::ShaderBinary>();
-		std::string errorText;
-		if (!vertexShader->CompileFromFile(Render::ShaderType::VertexShader, vsPath, errorText))
+		ShaderSource source;
+		if (!LoadShaderSource(vsPath, fsPath, customDefines, source))
 		{
-			SDE_LOG("Vertex shader compilation failed - %s\n%s", vsPath,errorText.c_str());
 			return ShaderHandle::Invalid();
 		}
-		auto fragmentShader = std::make_unique<Render::ShaderBinary>();
-		if (!fragmentShader->CompileFromFile(Render::ShaderType::FragmentShader, fsPath, errorText))
+		auto shader = BuildProgram(source);
+		if (shader == nullptr)
 		{
-			SDE_LOG("Fragment shader compilation failed - %s\n%s", fsPath, errorText.c_str());
 			return ShaderHandle::Invalid();
 		}
 
-		if (!shader->Create(*vertexShader, *fragmentShader, errorText))
-		{
-			SDE_LOG("Shader linkage failed - %s", errorText.c_str());
-			return ShaderHandle::Invalid();
-		}
+		m_shaders.push_back({ std::move(shader), name, vsPath, fsPath, customDefines, std::move(source.m_dependencies) });
+		const uint32_t newIndex = static_cast<uint32_t>(m_shaders.size() - 1);
+		m_registry.Add(name, newIndex);
+		return ShaderHandle{ newIndex };
+	}
 
-		m_shaders.push_back({ std::move(shader), name, vsPath, fsPath });
-		return ShaderHandle{ static_cast<uint32_t>(m_shaders.size() - 1) };
+	ShaderHandle ShaderManager::LoadComputeShader(const char* name, const char* path, const CustomDefines& customDefines)
+	{
+		return AddShader(name, path, "", customDefines);
+	}
+
+	ShaderHandle ShaderManager::LoadComputeShader(const char* name, const char* path)
+	{
+		return AddShader(name, path, "", {});
+	}
+
+	ShaderHandle ShaderManager::LoadShader(const char* name, const char* vsPath, const char* fsPath)
+	{
+		return AddShader(name, vsPath, fsPath, {});
 	}
 
 	std::string ShaderManager::GetShaderName(const ShaderHandle& h) const
@@ -295,6 +468,10 @@ namespace Engine
 				ReloadAll();
 			}
 			char text[1024] = { '\0' };
+			sprintf_s(text, "Programs compiled: %d, loaded from cache: %d", m_programsCompiled.load(), m_programsFromCache.load());
+			gui.Text(text);
+			sprintf_s(text, "Last reload: %d shaders in %.2fms", m_lastReloadCount, m_lastReloadTime * 1000.0);
+			gui.Text(text);
 			if (gui.BeginListbox("Loaded shaders"))
 			{
 				for (const auto& s : m_shaders)
@@ -334,6 +511,18 @@ namespace Engine
 		return s_showWindow;
 	}
 
+	bool ShaderManager::PostInit()
+	{
+		auto fileWatcher = GetSystem<FileWatcherSystem>("FileWatcher");
+		if (fileWatcher != nullptr)
+		{
+			fileWatcher->RegisterChangeHandler([this](const std::string& path) {
+				m_changedFiles.push_back(path);
+			});
+		}
+		return true;
+	}
+
 	bool ShaderManager::Tick(float timeDelta)
 	{
 		ShowGui();
@@ -344,5 +533,6 @@ namespace Engine
 	{
 		m_shadowShaders.clear();
 		m_shaders.clear();
+		m_registry.Clear();
 	}
 }
\ No newline at end of file
@@ -1,12 +1,14 @@
 #pragma once
 #include "serialisation.h"
 #include "system.h"
+#include "asset_registry.h"
 #include "render/shader_program.h"
 #include "robin_hood.h"
 #include <stdint.h>
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
 
 namespace Engine
 {
@@ -39,12 +41,26 @@ namespace Engine
 			bool Tick(float timeDelta);
 		};
 
+		virtual bool PostInit();
 		virtual bool Tick(float timeDelta);
 		virtual void Shutdown();
 
 		void ReloadAll() { m_shouldReloadAll = true; }
 
 	private:
+		struct ShaderSource {
+			std::string m_vsOrCs;	// preprocessed, includes and custom defines are already applied
+			std::string m_fs;		// empty for compute shaders
+			std::string m_vsPath;
+			std::string m_fsPath;
+			std::vector<std::string> m_dependencies;	// normalised paths of the source files + everything they include
+			uint64_t m_cacheKey = 0;
+		};
+		bool LoadShaderSource(const char* vsPath, const char* fsPath, const CustomDefines& customDefines, ShaderSource& result);
+		std::unique_ptr<Render::ShaderProgram> BuildProgram(const ShaderSource& src);	// thread-safe, uses the program binary cache if possible
+		ShaderHandle AddShader(const char* name, const char* vsPath, const char* fsPath, const CustomDefines& customDefines);
+		void ReloadShaders(const std::vector<uint32_t>& shaderIndices);
+		void ReloadChangedShaders();
 		void DoReloadAll();
 		bool ShowGui();
 		struct ShaderDesc {
@@ -52,10 +68,19 @@ namespace Engine
 			std::string m_name;
 			std::string m_vsPath;	// may also be compute shader path
 			std::string m_fsPath;
+			CustomDefines m_defines;
+			std::vector<std::string> m_dependencies;
 		};
 		std::vector<ShaderDesc> m_shaders;
+		AssetRegistry m_registry;		// name -> index into m_shaders
 		robin_hood::unordered_map<uint32_t, ShaderHandle> m_shadowShaders;	// map of lighting shader handle index -> shadow shader
 		robin_hood::unordered_map<uint32_t, ShaderHandle> m_gBufferShaders;	// map of lighting shader handle index -> gbuffer shader
 		bool m_shouldReloadAll = false;
+		std::vector<std::string> m_changedFiles;	// from the file watcher, shaders depending on these are reloaded
+		std::string m_driverName;			// part of the cache key, binaries are only valid for the driver that built them
+		std::atomic<uint32_t> m_programsFromCache = 0;
+		std::atomic<uint32_t> m_programsCompiled = 0;
+		double m_lastReloadTime = 0.0;
+		uint32_t m_lastReloadCount = 0;
 	};
 }
\ No newline at end of file
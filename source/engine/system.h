@@ -1,8 +1,16 @@
 #pragma once
 #include "core/profiler.h"
+#include <stdint.h>
 
 namespace Engine
 {
+	enum class InitPhase : uint32_t
+	{
+		PreInit,
+		Initialise,
+		PostInit
+	};
+
 	class System
 	{
 	public:
@@ -11,6 +19,10 @@ namespace Engine
 		virtual bool Initialise() { SDE_PROF_EVENT(); return true; }
 		virtual bool PostInit() { SDE_PROF_EVENT(); return true; }
 
+		// Init phases run on the main thread in registration order unless a system allows a worker thread
+		// Worker phases run concurrently with everything except their init dependencies, so no GL, window or script state!
+		virtual bool CanInitOnWorkerThread(InitPhase phase) const { return false; }
+
 		virtual bool Tick(float timeDelta) { SDE_PROF_EVENT(); return true; }
 
 		virtual void PreShutdown() { SDE_PROF_EVENT(); }
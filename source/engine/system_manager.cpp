@@ -4,8 +4,11 @@
 #include "core/log.h"
 #include "core/profiler.h"
 #include "core/timer.h"
+#include "core/thread.h"
 #include <cassert>
 #include <memory>
+#include <atomic>
+#include <algorithm>
 
 namespace Engine
 {
@@ -55,42 +58,215 @@ namespace Engine
 		return nullptr;
 	}
 
+	void SystemManager::AddInitDependency(const char* systemName, const char* dependsOn)
+	{
+		m_initDependencies.push_back({ systemName, dependsOn });
+	}
+
+	const char* GetInitPhaseName(InitPhase phase)
+	{
+		switch (phase)
+		{
+		case InitPhase::PreInit:
+			return "PreInit";
+		case InitPhase::Initialise:
+			return "Initialise";
+		case InitPhase::PostInit:
+			return "PostInit";
+		default:
+			return "Unknown";
+		}
+	}
+
+	bool SystemManager::RunInitPhase(uint32_t systemIndex, InitPhase phase, double initStartTime, bool onWorkerThread)
+	{
+		const std::string& name = std::get<0>(m_systems[systemIndex]);
+		System* theSystem = std::get<1>(m_systems[systemIndex]);
+		char debugName[256] = { '\0' };
+		sprintf_s(debugName, "%s::%s", name.c_str(), GetInitPhaseName(phase));
+		SDE_PROF_EVENT_DYN(debugName);
+
+		Core::Timer timer;
+		const double startTime = timer.GetSeconds() - initStartTime;
+		bool result = false;
+		switch (phase)
+		{
+		case InitPhase::PreInit:
+			result = theSystem->PreInit();
+			break;
+		case InitPhase::Initialise:
+			result = theSystem->Initialise();
+			break;
+		case InitPhase::PostInit:
+			result = theSystem->PostInit();
+			break;
+		}
+		const double endTime = timer.GetSeconds() - initStartTime;
+		if (!result)
+		{
+			SDE_LOG("%s failed", debugName);
+		}
+
+		Core::ScopedMutex guard(m_startupTimelineMutex);
+		m_startupTimeline.push_back({ name, phase, startTime, endTime, onWorkerThread });
+		return result;
+	}
+
 	bool SystemManager::Initialise()
 	{
 		SDE_PROF_FRAME("Main Thread");
 		SDE_PROF_EVENT();
+
+		Core::Timer timer;
+		const double initStartTime = timer.GetSeconds();
+
+		// Each phase of each system is a task, task index = (phase * system count) + system index
+		// A task waits for the previous phase of the same system and the same phase of its init dependencies
+		// Main thread tasks also wait for the previous main thread task, so they run in the same order as before
+		const uint32_t c_phaseCount = 3;
+		const uint32_t systemCount = static_cast<uint32_t>(m_systems.size());
+		enum TaskState : int32_t { Waiting, Running, Done };
+		struct InitTask
+		{
+			uint32_t m_systemIndex = 0;
+			InitPhase m_phase = InitPhase::PreInit;
+			bool m_onWorkerThread = false;
+			std::vector<uint32_t> m_waitFor;
+			std::atomic<int32_t> m_state = Waiting;
+			std::unique_ptr<Core::Thread> m_thread;
+		};
+		std::vector<InitTask> tasks(c_phaseCount * systemCount);
+
+		std::vector<std::vector<uint32_t>> systemDependencies(systemCount);
+		for (const auto& it : m_initDependencies)
 		{
-			SDE_PROF_EVENT("PreInit");
-			for (const auto it : m_systems)
+			int32_t systemIndex = -1, dependsOnIndex = -1;
+			for (uint32_t s = 0; s < systemCount; ++s)
+			{
+				systemIndex = std::get<0>(m_systems[s]) == std::get<0>(it) ? s : systemIndex;
+				dependsOnIndex = std::get<0>(m_systems[s]) == std::get<1>(it) ? s : dependsOnIndex;
+			}
+			if (systemIndex == -1 || dependsOnIndex == -1)
 			{
-				if (!std::get<1>(it)->PreInit())
+				SDE_LOG("Init dependency %s -> %s references a missing system", std::get<0>(it).c_str(), std::get<1>(it).c_str());
+				continue;
+			}
+			systemDependencies[systemIndex].push_back(dependsOnIndex);
+		}
+
+		int32_t lastMainThreadTask = -1;
+		for (uint32_t p = 0; p < c_phaseCount; ++p)
+		{
+			for (uint32_t s = 0; s < systemCount; ++s)
+			{
+				const uint32_t taskIndex = (p * systemCount) + s;
+				auto& task = tasks[taskIndex];
+				task.m_systemIndex = s;
+				task.m_phase = static_cast<InitPhase>(p);
+				task.m_onWorkerThread = std::get<1>(m_systems[s])->CanInitOnWorkerThread(task.m_phase);
+				if (p > 0)
 				{
-					return false;
+					task.m_waitFor.push_back(taskIndex - systemCount);
+				}
+				for (uint32_t dependsOn : systemDependencies[s])
+				{
+					task.m_waitFor.push_back((p * systemCount) + dependsOn);
+				}
+				if (!task.m_onWorkerThread)
+				{
+					if (lastMainThreadTask != -1)
+					{
+						task.m_waitFor.push_back(lastMainThreadTask);
+					}
+					lastMainThreadTask = taskIndex;
 				}
 			}
 		}
-		{
-			SDE_PROF_EVENT("Initialise");
-			for (const auto it : m_systems)
+
+		// Worker tasks get their own thread as soon as they are ready, the job system is not running yet
+		// Main thread tasks run here one at a time, when nothing is ready we wait for the workers to catch up
+		std::atomic<bool> initFailed = false;
+		auto isReady = [&tasks](const InitTask& task) {
+			for (uint32_t waitFor : task.m_waitFor)
 			{
-				if (!std::get<1>(it)->Initialise())
+				if (tasks[waitFor].m_state != Done)
 				{
 					return false;
 				}
 			}
-		}
+			return task.m_state == Waiting;
+		};
+		while (true)
 		{
-			SDE_PROF_EVENT("PostInit");
-			for (const auto it : m_systems)
+			bool allDone = true, anyRunning = false;
+			InitTask* nextMainThreadTask = nullptr;
+			for (auto& task : tasks)
 			{
-				if (!std::get<1>(it)->PostInit())
+				if (!initFailed && isReady(task))
 				{
-					return false;
+					if (task.m_onWorkerThread)
+					{
+						task.m_state = Running;
+						task.m_thread = std::make_unique<Core::Thread>();
+						task.m_thread->Create("SystemInit", [this, &task, &initFailed, initStartTime]() {
+							SDE_PROF_THREAD("SystemInit");
+							if (!RunInitPhase(task.m_systemIndex, task.m_phase, initStartTime, true))
+							{
+								initFailed = true;
+							}
+							task.m_state = Done;
+							return 0;
+						});
+					}
+					else if (nextMainThreadTask == nullptr)
+					{
+						nextMainThreadTask = &task;
+					}
 				}
+				const int32_t state = task.m_state;
+				allDone &= (state == Done);
+				anyRunning |= (state == Running);
+			}
+			if (nextMainThreadTask != nullptr)
+			{
+				if (!RunInitPhase(nextMainThreadTask->m_systemIndex, nextMainThreadTask->m_phase, initStartTime, false))
+				{
+					initFailed = true;
+				}
+				nextMainThreadTask->m_state = Done;
+			}
+			else if (allDone || (initFailed && !anyRunning))
+			{
+				break;
+			}
+			else if (!anyRunning)
+			{
+				SDE_LOG("Init dependencies contain a cycle, check AddInitDependency calls against the registration order");
+				initFailed = true;
+				break;
+			}
+			else
+			{
+				SDE_PROF_STALL("WaitForWorkerInit");
+				Core::Thread::Sleep(1);
+			}
+		}
+		tasks.clear();		// joins any worker threads
+
+		SDE_LOG("Systems initialised in %.2fms", (timer.GetSeconds() - initStartTime) * 1000.0);
+		std::sort(m_startupTimeline.begin(), m_startupTimeline.end(), [](const StartupEvent& a, const StartupEvent& b) {
+			return a.m_startTime < b.m_startTime;
+		});
+		for (const auto& it : m_startupTimeline)
+		{
+			if (it.m_endTime - it.m_startTime >= 0.001)	// the full list is in GetStartupTimeline()
+			{
+				SDE_LOG("\t%8.2fms - %8.2fms: %s::%s%s", it.m_startTime * 1000.0, it.m_endTime * 1000.0,
+					it.m_systemName.c_str(), GetInitPhaseName(it.m_phase), it.m_onWorkerThread ? " (worker)" : "");
 			}
 		}
 
-		return true;
+		return !initFailed;
 	}
 
 	std::function<bool()> SystemManager::GetTickFn(std::string name)
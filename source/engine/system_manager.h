@@ -1,14 +1,17 @@
 #pragma once
 
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include <tuple>
 #include <map>
 #include <functional>
+#include "core/mutex.h"
 
 namespace Engine
 {
 	class System;
+	enum class InitPhase : uint32_t;
 
 	// This class handles ownership and updates of systems
 	// It is the *only* singleton allowed!
@@ -22,6 +25,7 @@ namespace Engine
 		virtual System* GetSystem(const char* systemName);
 		void RegisterSystem(const char* systemName, System* theSystem);
 		void RegisterTickFn(std::string_view name, std::function<bool()> fn);
+		void AddInitDependency(const char* systemName, const char* dependsOn);	// each init phase of systemName waits for the same phase of dependsOn
 		bool Initialise();
 		bool Tick(float timeDelta);
 		void Shutdown();
@@ -30,8 +34,19 @@ namespace Engine
 		using ProfilerData = std::map<std::string, double>;
 		const ProfilerData& GetLastUpdateTimes() const { return m_lastUpdateTime; }
 
+		struct StartupEvent
+		{
+			std::string m_systemName;
+			InitPhase m_phase;
+			double m_startTime;		// seconds from the start of Initialise()
+			double m_endTime;
+			bool m_onWorkerThread;
+		};
+		const std::vector<StartupEvent>& GetStartupTimeline() const { return m_startupTimeline; }
+
 	private:
 		SystemManager();
+		bool RunInitPhase(uint32_t systemIndex, InitPhase phase, double initStartTime, bool onWorkerThread);
 
 		typedef std::vector<std::tuple<std::string, System*>> SystemArray;
 		typedef std::map<uint32_t, System*> SystemMap;
@@ -47,6 +62,9 @@ namespace Engine
 		SystemArray m_systems;
 		SystemMap m_systemMap;
 		TickFns m_tickFns;
+		std::vector<std::tuple<std::string, std::string>> m_initDependencies;	// system name, depends on
+		Core::Mutex m_startupTimelineMutex;
+		std::vector<StartupEvent> m_startupTimeline;
 	};
 
 	template<class T>
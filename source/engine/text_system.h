@@ -13,6 +13,7 @@ namespace Engine
 		TextSystem();
 		virtual ~TextSystem();
 		bool PreInit();
+		bool CanInitOnWorkerThread(InitPhase phase) const { return true; }		// freetype only
 		void PostShutdown();
 		struct FontData
 		{
@@ -0,0 +1,220 @@
+#include "texture_compression.h"
+#include "core/profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <climits>
+
+namespace Engine
+{
+	const uint32_t c_bc1BlockBytes = 8;
+	const uint32_t c_bc3BlockBytes = 16;
+
+	size_t GetBlockCompressedSize(uint32_t w, uint32_t h, uint32_t bytesPerBlock)
+	{
+		return (size_t)((w + 3) / 4) * (size_t)((h + 3) / 4) * bytesPerBlock;
+	}
+
+	// 4x4 pixels as rgba, edge pixels are repeated when the block hangs off the image
+	static void FetchBlock(const uint8_t* pixels, uint32_t components, uint32_t w, uint32_t h, uint32_t blockX, uint32_t blockY, uint8_t block[16][4])
+	{
+		for (uint32_t y = 0; y < 4; ++y)
+		{
+			const uint32_t srcY = std::min(blockY * 4 + y, h - 1);
+			for (uint32_t x = 0; x < 4; ++x)
+			{
+				const uint32_t srcX = std::min(blockX * 4 + x, w - 1);
+				const uint8_t* src = pixels + ((size_t)srcY * w + srcX) * components;
+				uint8_t* dst = block[y * 4 + x];
+				dst[0] = src[0];
+				dst[1] = components >= 3 ? src[1] : src[0];
+				dst[2] = components >= 3 ? src[2] : src[0];
+				dst[3] = components == 4 ? src[3] : 255;
+			}
+		}
+	}
+
+	static uint16_t PackRGB565(const uint8_t* c)
+	{
+		const uint32_t r = (c[0] * 31 + 127) / 255;
+		const uint32_t g = (c[1] * 63 + 127) / 255;
+		const uint32_t b = (c[2] * 31 + 127) / 255;
+		return (uint16_t)((r << 11) | (g << 5) | b);
+	}
+
+	static void UnpackRGB565(uint16_t c, int result[3])
+	{
+		const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+		result[0] = (r << 3) | (r >> 2);
+		result[1] = (g << 2) | (g >> 4);
+		result[2] = (b << 3) | (b >> 2);
+	}
+
+	// endpoints are the two pixels furthest apart along the principal axis of the block colours
+	static void CompressColourBlock(const uint8_t block[16][4], uint8_t* out)
+	{
+		float mean[3] = { 0.0f, 0.0f, 0.0f };
+		for (int p = 0; p < 16; ++p)
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				mean[c] += block[p][c] / 16.0f;
+			}
+		}
+		float cov[6] = { 0.0f };	// rr rg rb gg gb bb
+		for (int p = 0; p < 16; ++p)
+		{
+			const float r = block[p][0] - mean[0], g = block[p][1] - mean[1], b = block[p][2] - mean[2];
+			cov[0] += r * r;	cov[1] += r * g;	cov[2] += r * b;
+			cov[3] += g * g;	cov[4] += g * b;	cov[5] += b * b;
+		}
+		float axis[3] = { 1.0f, 1.0f, 1.0f };
+		for (int i = 0; i < 8; ++i)		// power iteration
+		{
+			const float x = axis[0] * cov[0] + axis[1] * cov[1] + axis[2] * cov[2];
+			const float y = axis[0] * cov[1] + axis[1] * cov[3] + axis[2] * cov[4];
+			const float z = axis[0] * cov[2] + axis[1] * cov[4] + axis[2] * cov[5];
+			const float largest = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+			if (largest < 1e-6f)
+			{
+				break;
+			}
+			axis[0] = x / largest;	axis[1] = y / largest;	axis[2] = z / largest;
+		}
+		int minPixel = 0, maxPixel = 0;
+		float minDot = FLT_MAX, maxDot = -FLT_MAX;
+		for (int p = 0; p < 16; ++p)
+		{
+			const float d = block[p][0] * axis[0] + block[p][1] * axis[1] + block[p][2] * axis[2];
+			if (d < minDot)
+			{
+				minDot = d;
+				minPixel = p;
+			}
+			if (d > maxDot)
+			{
+				maxDot = d;
+				maxPixel = p;
+			}
+		}
+
+		// colour0 > colour1 selects the opaque 4 colour mode
+		uint16_t c0 = PackRGB565(block[maxPixel]), c1 = PackRGB565(block[minPixel]);
+		if (c0 < c1)
+		{
+			std::swap(c0, c1);
+		}
+		uint32_t indices = 0;
+		if (c0 != c1)
+		{
+			int palette[4][3];
+			UnpackRGB565(c0, palette[0]);
+			UnpackRGB565(c1, palette[1]);
+			for (int c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			for (int p = 0; p < 16; ++p)
+			{
+				int best = 0, bestDistance = INT_MAX;
+				for (int i = 0; i < 4; ++i)
+				{
+					const int r = block[p][0] - palette[i][0], g = block[p][1] - palette[i][1], b = block[p][2] - palette[i][2];
+					const int distance = r * r + g * g + b * b;
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						best = i;
+					}
+				}
+				indices |= (uint32_t)best << (p * 2);
+			}
+		}
+		out[0] = (uint8_t)(c0 & 0xff);
+		out[1] = (uint8_t)(c0 >> 8);
+		out[2] = (uint8_t)(c1 & 0xff);
+		out[3] = (uint8_t)(c1 >> 8);
+		for (int i = 0; i < 4; ++i)
+		{
+			out[4 + i] = (uint8_t)(indices >> (i * 8));
+		}
+	}
+
+	// alpha0 > alpha1 selects the 8 value interpolated mode
+	static void CompressAlphaBlock(const uint8_t block[16][4], uint8_t* out)
+	{
+		int a0 = 0, a1 = 255;
+		for (int p = 0; p < 16; ++p)
+		{
+			a0 = std::max(a0, (int)block[p][3]);
+			a1 = std::min(a1, (int)block[p][3]);
+		}
+		uint64_t indices = 0;
+		if (a0 != a1)
+		{
+			int palette[8] = { a0, a1 };
+			for (int i = 1; i < 7; ++i)
+			{
+				palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+			}
+			for (int p = 0; p < 16; ++p)
+			{
+				int best = 0, bestDistance = INT_MAX;
+				for (int i = 0; i < 8; ++i)
+				{
+					const int distance = std::abs(block[p][3] - palette[i]);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						best = i;
+					}
+				}
+				indices |= (uint64_t)best << (p * 3);
+			}
+		}
+		out[0] = (uint8_t)a0;
+		out[1] = (uint8_t)a1;
+		for (int i = 0; i < 6; ++i)
+		{
+			out[2 + i] = (uint8_t)(indices >> (i * 8));
+		}
+	}
+
+	void CompressBC1(const uint8_t* pixels, uint32_t components, uint32_t w, uint32_t h, std::vector<uint8_t>& result)
+	{
+		SDE_PROF_EVENT();
+		const size_t firstBlock = result.size();
+		result.resize(firstBlock + GetBlockCompressedSize(w, h, c_bc1BlockBytes));
+		uint8_t* out = result.data() + firstBlock;
+		uint8_t block[16][4];
+		for (uint32_t y = 0; y < (h + 3) / 4; ++y)
+		{
+			for (uint32_t x = 0; x < (w + 3) / 4; ++x)
+			{
+				FetchBlock(pixels, components, w, h, x, y, block);
+				CompressColourBlock(block, out);
+				out += c_bc1BlockBytes;
+			}
+		}
+	}
+
+	void CompressBC3(const uint8_t* pixels, uint32_t components, uint32_t w, uint32_t h, std::vector<uint8_t>& result)
+	{
+		SDE_PROF_EVENT();
+		const size_t firstBlock = result.size();
+		result.resize(firstBlock + GetBlockCompressedSize(w, h, c_bc3BlockBytes));
+		uint8_t* out = result.data() + firstBlock;
+		uint8_t block[16][4];
+		for (uint32_t y = 0; y < (h + 3) / 4; ++y)
+		{
+			for (uint32_t x = 0; x < (w + 3) / 4; ++x)
+			{
+				FetchBlock(pixels, components, w, h, x, y, block);
+				CompressAlphaBlock(block, out);
+				CompressColourBlock(block, out + 8);
+				out += c_bc3BlockBytes;
+			}
+		}
+	}
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+// CPU block compression for cooked textures
+// Pixels are 8 bit per component rows (1, 3 or 4 components), compressed blocks are appended to 'result'
+// Images that are not a multiple of 4 in size have their edge pixels repeated to fill the last blocks
+namespace Engine
+{
+	size_t GetBlockCompressedSize(uint32_t w, uint32_t h, uint32_t bytesPerBlock);
+	void CompressBC1(const uint8_t* pixels, uint32_t components, uint32_t w, uint32_t h, std::vector<uint8_t>& result);	// opaque only, alpha is ignored
+	void CompressBC3(const uint8_t* pixels, uint32_t components, uint32_t w, uint32_t h, std::vector<uint8_t>& result);	// BC1 colour + interpolated alpha
+}
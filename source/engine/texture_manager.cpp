@@ -3,14 +3,59 @@
 #include "job_system.h"
 #include "debug_gui_system.h"
 #include "debug_gui_menubar.h"
+#include "cooked_texture.h"
+#include "file_watcher_system.h"
 #include "core/profiler.h"
 #include "core/thread.h"
+#include "core/timer.h"
+#include "core/log.h"
 #include "render/device.h"
-#include "stb_image.h"
 #include <cassert>
 
 namespace Engine
 {
+	// total size of all mips as uploaded
+	static size_t GetTextureSourceBytes(const Render::TextureSource& src)
+	{
+		size_t totalBytes = 0;
+		for (uint32_t m = 0; m < src.MipCount(); ++m)
+		{
+			uint32_t w = 0, h = 0;
+			size_t size = 0;
+			src.MipLevel(m, w, h, size);
+			totalBytes += size;
+		}
+		return totalBytes;
+	}
+
+	// cooked data if it is up to date, otherwise decode the source and cook it for next time
+	// uncompressed textures are cooked to a different file so switching a texture between the two never reads stale data
+	static std::unique_ptr<Render::TextureSource> LoadTextureSource(const std::string& path, bool allowCompression, bool& loadedFromCooked)
+	{
+		SDE_PROF_EVENT();
+
+		loadedFromCooked = false;
+		CookedSourceInfo sourceInfo;
+		const bool sourceExists = GetCookedSourceInfo(path, sourceInfo);
+		const std::string cookedPath = GetCookedPath(path, allowCompression ? ".stex" : ".raw.stex");
+		if (sourceExists)
+		{
+			auto cooked = LoadCookedTexture(cookedPath, sourceInfo);
+			if (cooked != nullptr)
+			{
+				loadedFromCooked = true;
+				return cooked;
+			}
+		}
+
+		auto result = CookTexture(path, allowCompression);
+		if (result != nullptr && sourceExists && !SaveCookedTexture(*result, cookedPath, sourceInfo))
+		{
+			SDE_LOG("Failed to write cooked texture '%s'", cookedPath.c_str());
+		}
+		return result;
+	}
+
 	SERIALISE_BEGIN(TextureHandle)
 		static TextureManager* texManager = GetSystem<TextureManager>("Textures");
 		if (op == Engine::SerialiseType::Write)
@@ -43,17 +88,33 @@ namespace Engine
 			int32_t inFlight = m_inFlightTextures;
 			sprintf_s(text, "Loading: %d", inFlight);
 			gui.Text(text);
+			LoadStats stats;
+			{
+				Core::ScopedMutex guard(m_loadedTexturesMutex);
+				stats = m_loadStats;
+			}
+			sprintf_s(text, "Cold loads (decode + cook): %d, %.2fms total, %.2fms avg", stats.m_coldLoads,
+				stats.m_coldLoadSeconds * 1000.0, stats.m_coldLoads > 0 ? (stats.m_coldLoadSeconds * 1000.0) / stats.m_coldLoads : 0.0);
+			gui.Text(text);
+			sprintf_s(text, "Warm loads (cooked): %d, %.2fms total, %.2fms avg", stats.m_warmLoads,
+				stats.m_warmLoadSeconds * 1000.0, stats.m_warmLoads > 0 ? (stats.m_warmLoadSeconds * 1000.0) / stats.m_warmLoads : 0.0);
+			gui.Text(text);
+			sprintf_s(text, "Uploaded: %.2fmb", stats.m_gpuBytes / (1024.0 * 1024.0));
+			gui.Text(text);
 			gui.Separator();
-			for (int t = 0; t < m_textures.size(); ++t)
 			{
-				sprintf_s(text, "%d: %s (0x%p) - %d components",
-					t,
-					m_textures[t].m_path.c_str(),
-					m_textures[t].m_texture.get(),
-					m_textures[t].m_texture ? m_textures[t].m_texture->GetComponentCount() : 0);
-				if (gui.Button(text))
+				Core::ScopedMutex guard(m_registry.GetMutex());
+				for (uint32_t t = 0; t < m_textures.Size(); ++t)
 				{
-					s_showTexture = { static_cast<uint32_t>(t) };
+					sprintf_s(text, "%d: %s (0x%p) - %d components",
+						t,
+						m_textures[t].m_path.c_str(),
+						m_textures[t].m_texture.get(),
+						m_textures[t].m_texture ? m_textures[t].m_texture->GetComponentCount() : 0);
+					if (gui.Button(text))
+					{
+						s_showTexture = { static_cast<uint32_t>(t) };
+					}
 				}
 			}
 			gui.EndWindow();
@@ -63,7 +124,7 @@ namespace Engine
 				if (previewTexture != nullptr)
 				{
 					bool show = true;
-					gui.BeginWindow(show, m_textures[s_showTexture.m_index].m_path.c_str());
+					gui.BeginWindow(show, GetTexturePath(s_showTexture).c_str());
 					gui.Image(*previewTexture, glm::vec2(512, 512));
 					gui.EndWindow();
 					if (!show)
@@ -92,15 +153,26 @@ namespace Engine
 			Core::ScopedMutex guard(m_loadedTexturesMutex);
 			m_loadedTextures.clear();
 		}
-		// now load the textures again
-		auto currentTextures = std::move(m_textures);
-		for (int t=0;t<currentTextures.size();++t)
+		// now load the textures again in place, handles stay valid and the old textures are used until the new ones arrive
+		Core::ScopedMutex guard(m_registry.GetMutex());
+		for (uint32_t t = 0; t < m_textures.Size(); ++t)
 		{
-			auto newHandle = LoadTexture(currentTextures[t].m_path.c_str());
-			assert(t == newHandle.m_index);
+			StartTextureLoad(m_textures[t].m_path, { t });
 		}
 	}
 
+	bool TextureManager::PostInit()
+	{
+		auto fileWatcher = GetSystem<FileWatcherSystem>("FileWatcher");
+		if (fileWatcher != nullptr)
+		{
+			fileWatcher->RegisterChangeHandler([this](const std::string& path) {
+				ReloadTexture(path);
+			});
+		}
+		return true;
+	}
+
 	bool TextureManager::Tick(float timeDelta)
 	{
 		SDE_PROF_EVENT();
@@ -126,18 +198,31 @@ namespace Engine
 			SDE_PROF_EVENT("CreateTextures");
 			for (auto& tex : loadedTextures)
 			{
-				if(tex.m_texture != nullptr && tex.m_texture->GetHandle() != -1)
+				const bool loaded = tex.m_texture != nullptr && tex.m_texture->GetHandle() != -1;
+				if (loaded)
 				{
 					tex.m_texture->MakeResidentHandle();
-					m_textures[tex.m_destination.m_index].m_texture = std::move(tex.m_texture);
-					if (tex.m_onFinish != nullptr)
+				}
+				else if (tex.m_texture != nullptr)
+				{
+					SDE_LOG("Invalid texture handle for loaded texture!");
+				}
+				std::vector<OnFinishFn> onFinish;
+				{
+					Core::ScopedMutex guard(m_registry.GetMutex());
+					auto& desc = m_textures[tex.m_destination.m_index];
+					if (loaded)
 					{
-						tex.m_onFinish(true, tex.m_destination);
+						desc.m_current = tex.m_texture.get();
+						desc.m_texture = std::move(tex.m_texture);
 					}
+					desc.m_isLoading = false;
+					onFinish = std::move(desc.m_onFinish);
+					desc.m_onFinish.clear();
 				}
-				else
+				for (auto& fn : onFinish)	// callbacks may load more textures, so no lock here
 				{
-					SDE_LOG("Invalid texture handle for loaded texture!");
+					fn(loaded, tex.m_destination);
 				}
 			}
 		}
@@ -146,85 +231,139 @@ namespace Engine
 	TextureHandle TextureManager::AddTexture(std::string name, std::unique_ptr<Render::Texture>&& t)
 	{
 		// if one exists, return invalid handle
-		for (uint64_t i = 0; i < m_textures.size(); ++i)
+		bool wasAdded = false;
+		const uint32_t index = m_registry.FindOrAdd(name, [&]() {
+			return m_textures.Add([&](TextureDesc& newTexture) {
+				newTexture.m_current = t.get();
+				newTexture.m_texture = std::move(t);
+				newTexture.m_path = name;
+			});
+		}, wasAdded);
+		return wasAdded ? TextureHandle{ index } : TextureHandle::Invalid();
+	}
+
+	TextureHandle TextureManager::LoadTexture(std::string path, std::function<void(bool, TextureHandle)> onFinish)
+	{
+		if (path.empty())
+		{
+			return TextureHandle::Invalid();
+		}
+
+		bool wasAdded = false;
+		const uint32_t index = m_registry.FindOrAdd(path, [&]() {
+			return m_textures.Add([&](TextureDesc& newTexture) {
+				newTexture.m_path = path;
+				newTexture.m_isLoading = true;
+				if (onFinish)
+				{
+					newTexture.m_onFinish.push_back(onFinish);
+				}
+			});
+		}, wasAdded);
+		auto newHandle = TextureHandle{ index };
+		if (wasAdded)
+		{
+			StartTextureLoad(path, newHandle);
+			return newHandle;
+		}
+
+		// already requested, if the first load is still in flight wait for it
+		if (onFinish)
 		{
-			if (m_textures[i].m_path == name)
+			bool isLoaded = false;
 			{
-				return TextureHandle::Invalid();
+				Core::ScopedMutex guard(m_registry.GetMutex());
+				auto& desc = m_textures[index];
+				if (desc.m_isLoading)
+				{
+					desc.m_onFinish.push_back(std::move(onFinish));
+					return newHandle;
+				}
+				isLoaded = desc.m_texture != nullptr;
 			}
+			onFinish(isLoaded, newHandle);
 		}
-
-		TextureDesc newTexture;
-		newTexture.m_texture = std::move(t);
-		newTexture.m_path = name;
-		m_textures.emplace_back(std::move(newTexture));
-		auto newHandle = TextureHandle{ static_cast<uint32_t>(m_textures.size() - 1) };
 		return newHandle;
 	}
 
-	TextureHandle TextureManager::LoadTexture(std::string path, std::function<void(bool, TextureHandle)> onFinish)
+	void TextureManager::SetCompressionEnabled(const std::string& path, bool enabled)
 	{
 		if (path.empty())
 		{
-			return TextureHandle::Invalid();
+			return;
 		}
+		const std::string normalisedPath = Core::FileWatcher::NormalisePath(path);
+		{
+			Core::ScopedMutex guard(m_uncompressedPathsMutex);
+			const bool wasEnabled = m_uncompressedPaths.find(normalisedPath) == m_uncompressedPaths.end();
+			if (wasEnabled == enabled)
+			{
+				return;
+			}
+			if (enabled)
+			{
+				m_uncompressedPaths.erase(normalisedPath);
+			}
+			else
+			{
+				m_uncompressedPaths.emplace(normalisedPath);
+			}
+		}
+		if (m_registry.Find(path) != AssetRegistry::c_invalidIndex)
+		{
+			ReloadTexture(path);
+		}
+	}
+
+	bool TextureManager::IsCompressionEnabled(const std::string& path)
+	{
+		Core::ScopedMutex guard(m_uncompressedPathsMutex);
+		return m_uncompressedPaths.find(Core::FileWatcher::NormalisePath(path)) == m_uncompressedPaths.end();
+	}
 
-		for (uint64_t i = 0; i < m_textures.size(); ++i)
+	void TextureManager::ReloadTexture(const std::string& path)
+	{
+		SDE_PROF_EVENT();
+		const std::string changedPath = Core::FileWatcher::NormalisePath(path);
+		Core::ScopedMutex guard(m_registry.GetMutex());
+		for (uint32_t t = 0; t < m_textures.Size(); ++t)
 		{
-			if (m_textures[i].m_path == path)
+			if (Core::FileWatcher::NormalisePath(m_textures[t].m_path) == changedPath)
 			{
-				TextureHandle index = { static_cast<uint32_t>(i) };
-				if(onFinish)
-					onFinish(true, index);
-				return index;
+				SDE_LOG("Reloading texture '%s'", m_textures[t].m_path.c_str());
+				StartTextureLoad(m_textures[t].m_path, { t });	// the old texture is used until the new one arrives
 			}
 		}
+	}
 
-		m_textures.push_back({nullptr, path });
-		auto newHandle = TextureHandle{ static_cast<uint32_t>(m_textures.size() - 1) };
+	// results always go through m_loadedTextures, even failures, so callbacks only ever run on the main thread
+	void TextureManager::StartTextureLoad(const std::string& path, TextureHandle newHandle)
+	{
 		m_inFlightTextures += 1;
 
 		std::string pathString = path;
-		GetSystem<JobSystem>("Jobs")->PushSlowJob([this, pathString, newHandle, onFinish](void*) {
+		const bool allowCompression = IsCompressionEnabled(path);
+		GetSystem<JobSystem>("Jobs")->PushSlowJob([this, pathString, allowCompression, newHandle](void*) {
 			char debugName[1024] = { '\0' };
 			sprintf_s(debugName, "LoadTexture %s", pathString.c_str());
 			SDE_PROF_EVENT_DYN(debugName);
 
-			int w, h, components;
-			stbi_set_flip_vertically_on_load(true);
-			unsigned char* loadedData = stbi_load(pathString.c_str(), &w, &h, &components, 0);
-			if (loadedData == nullptr)
+			double loadTime = 0.0;
+			bool loadedFromCooked = false;
+			std::unique_ptr<Render::TextureSource> ts;
 			{
-				m_inFlightTextures -= 1;
-				if(onFinish != nullptr)
-					onFinish(false, newHandle);
-				return;
+				Core::ScopedTimer timeLoad(loadTime);
+				ts = LoadTextureSource(pathString, allowCompression, loadedFromCooked);
 			}
-
-			std::vector<uint8_t> rawDataBuffer;
-			rawDataBuffer.resize(w * h * components);
-			memcpy(rawDataBuffer.data(), loadedData, w * h * components);
-			stbi_image_free(loadedData);
-
-			std::vector<Render::TextureSource::MipDesc> mip;
-			mip.push_back({ (uint32_t)w,(uint32_t)h,0,w * h * (size_t)components });
-			Render::TextureSource::Format format = Render::TextureSource::Format::Unsupported;
-			switch (components)
+			if (ts == nullptr)
 			{
-			case 1:
-				format = Render::TextureSource::Format::R8;
-				break;
-			case 3:
-				format = Render::TextureSource::Format::RGB8;
-				break;
-			case 4:
-				format = Render::TextureSource::Format::RGBA8;
-				break;
+				Core::ScopedMutex guard(m_loadedTexturesMutex);
+				m_loadedTextures.push_back({ nullptr, newHandle });
+				m_inFlightTextures -= 1;
+				return;
 			}
-			Render::TextureSource ts((uint32_t)w, (uint32_t)h, format, { mip }, rawDataBuffer);
-			ts.SetGenerateMips(true);
 			auto newTex = std::make_unique<Render::Texture>();
-			if (newTex->Create(ts, false))	// don't make textures resident here, do it on main thread
+			if (newTex->Create(*ts, false))	// don't make textures resident here, do it on main thread
 			{
 				// Ensure any writes are shared with all contexts
 				Render::Device::FlushContext();
@@ -232,41 +371,39 @@ namespace Engine
 				SDE_PROF_EVENT("PushToResultsList");
 				Core::ScopedMutex guard(m_loadedTexturesMutex);
 				{
-					m_loadedTextures.push_back({ std::move(newTex), newHandle, onFinish });
+					m_loadedTextures.push_back({ std::move(newTex), newHandle });
+					if (loadedFromCooked)
+					{
+						m_loadStats.m_warmLoads++;
+						m_loadStats.m_warmLoadSeconds += loadTime;
+					}
+					else
+					{
+						m_loadStats.m_coldLoads++;
+						m_loadStats.m_coldLoadSeconds += loadTime;
+					}
+					m_loadStats.m_gpuBytes += GetTextureSourceBytes(*ts);
 				}
 			}
-			else if(onFinish != nullptr)
+			else
 			{
-				onFinish(false, newHandle);
+				Core::ScopedMutex guard(m_loadedTexturesMutex);
+				m_loadedTextures.push_back({ nullptr, newHandle });
 			}
 			m_inFlightTextures -= 1;
 		});
-
-		return newHandle;
 	}
 
 	std::string TextureManager::GetTexturePath(const TextureHandle& h)
 	{
-		if (h.m_index != -1 && h.m_index < m_textures.size())
-		{
-			return m_textures[h.m_index].m_path;
-		}
-		else
-		{
-			return "";
-		}
+		const TextureDesc* desc = m_textures.TryGet(h.m_index);
+		return desc != nullptr ? desc->m_path : "";
 	}
 
 	Render::Texture* TextureManager::GetTexture(const TextureHandle& h)
 	{
-		if (h.m_index != -1 && h.m_index < m_textures.size())
-		{
-			return m_textures[h.m_index].m_texture.get();
-		}
-		else
-		{
-			return nullptr;
-		}
+		const TextureDesc* desc = m_textures.TryGet(h.m_index);
+		return desc != nullptr ? desc->m_current.load(std::memory_order_acquire) : nullptr;
 	}
 
 	void TextureManager::Shutdown()
@@ -285,6 +422,10 @@ namespace Engine
 		}
 
 		// remove all textures
-		m_textures.clear();
+		{
+			Core::ScopedMutex guard(m_registry.GetMutex());
+			m_textures.Clear();
+		}
+		m_registry.Clear();
 	}
 }
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 #include "serialisation.h"
 #include "system.h"
+#include "asset_registry.h"
+#include "asset_array.h"
 #include "render/texture.h"
 #include "render/texture_source.h"
 #include "core/mutex.h"
+#include <robin_hood.h>
 #include <stdint.h>
 #include <vector>
 #include <string>
@@ -31,28 +34,54 @@ namespace Engine
 		Render::Texture* GetTexture(const TextureHandle& h);
 		std::string GetTexturePath(const TextureHandle& h);
 		void ReloadAll();
+		void ReloadTexture(const std::string& path);	// if the texture is loaded, replace it with the current file contents
 
+		// BC1/BC3 compression is lossy, textures that can't take it (e.g. normal maps) opt out by path, ideally before loading
+		// a texture that is already loaded is reloaded with the new setting
+		void SetCompressionEnabled(const std::string& path, bool enabled);
+		bool IsCompressionEnabled(const std::string& path);
+
+		virtual bool PostInit();
 		virtual bool Tick(float timeDelta);
 		virtual void Shutdown();
 
 	private:
+		using OnFinishFn = std::function<void(bool, TextureHandle)>;
+		void StartTextureLoad(const std::string& path, TextureHandle destination);
 		void ProcessLoadedTextures();
 		bool ShowGui(DebugGuiSystem& gui);
 
+		// m_path is set once when the texture is added, m_current can be read without a lock
+		// everything else is protected by the registry mutex
 		struct TextureDesc {
 			std::unique_ptr<Render::Texture> m_texture;
+			std::atomic<Render::Texture*> m_current = nullptr;	// m_texture.get()
 			std::string m_path;
+			bool m_isLoading = false;				// first load is in flight
+			std::vector<OnFinishFn> m_onFinish;		// everyone that asked for the texture while it was loading
 		};
-		std::vector<TextureDesc> m_textures;
+		AssetArray<TextureDesc> m_textures;		// added to with the registry mutex held, lookups don't lock
+		AssetRegistry m_registry;		// path -> index into m_textures
+		Core::Mutex m_uncompressedPathsMutex;
+		robin_hood::unordered_set<std::string> m_uncompressedPaths;		// normalised paths that are never block compressed
 
 		struct LoadedTexture
 		{
-			std::unique_ptr<Render::Texture> m_texture;
+			std::unique_ptr<Render::Texture> m_texture;		// null if the load failed
 			TextureHandle m_destination;
-			std::function<void(bool, TextureHandle)> m_onFinish;
 		};
 		Core::Mutex m_loadedTexturesMutex;
 		std::vector<LoadedTexture> m_loadedTextures;
+		// load times, cold = decoded from source and cooked, warm = loaded from the cooked file
+		struct LoadStats
+		{
+			uint32_t m_coldLoads = 0;
+			double m_coldLoadSeconds = 0.0;
+			uint32_t m_warmLoads = 0;
+			double m_warmLoadSeconds = 0.0;
+			uint64_t m_gpuBytes = 0;		// mip data uploaded by loads
+		};
+		LoadStats m_loadStats;			// protected by m_loadedTexturesMutex
 		std::atomic<int32_t> m_inFlightTextures = 0;
 	};
 }
\ No newline at end of file
@@ -21,7 +21,10 @@ public:
 	virtual uint64_t GetTotalSizeBytes() = 0;
 	virtual uint64_t GetGeneration() const = 0;		// this is used to ensure pointers cached can be quickly tested for validity
 	virtual void Serialise(EntityHandle owner, nlohmann::json& json, Engine::SerialiseType op) = 0;
+	virtual void Serialise(EntityHandle owner, Engine::BinaryArchive& archive, Engine::SerialiseType op) = 0;
+	virtual void JsonToBinary(nlohmann::json& json, Engine::BinaryArchive& archive) = 0;	// converts component data without creating a component
 	virtual void Create(EntityHandle owner) = 0;
+	virtual void CreateMany(const EntityHandle* owners, uint32_t count) = 0;	// same as Create on each owner, but the storage only changes generation once
 	virtual bool Contains(EntityHandle owner) = 0;
 	virtual void Destroy(EntityHandle owner) = 0;
 	virtual void DestroyAll() = 0;
@@ -44,7 +47,10 @@ public:
 	virtual uint64_t GetTotalSizeBytes();
 	virtual uint64_t GetGeneration() const { return m_generation; }
 	virtual void Serialise(EntityHandle owner, nlohmann::json& json, Engine::SerialiseType op);
+	virtual void Serialise(EntityHandle owner, Engine::BinaryArchive& archive, Engine::SerialiseType op);
+	virtual void JsonToBinary(nlohmann::json& json, Engine::BinaryArchive& archive);
 	virtual void Create(EntityHandle owner);
+	virtual void CreateMany(const EntityHandle* owners, uint32_t count);
 	virtual bool Contains(EntityHandle owner) { return Find(owner) != nullptr; }
 	virtual void Destroy(EntityHandle owner);
 	virtual void DestroyAll();
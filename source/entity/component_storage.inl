@@ -169,6 +169,36 @@ void LinearComponentStorage<ComponentType>::Serialise(EntityHandle owner, nlohma
 	}
 }
 
+template<class ComponentType>
+void LinearComponentStorage<ComponentType>::Serialise(EntityHandle owner, Engine::BinaryArchive& archive, Engine::SerialiseType op)
+{
+	ComponentType* foundComponent = Find(owner);
+	if (op == Engine::SerialiseType::Write)
+	{
+		if (foundComponent)
+		{
+			archive.WriteValue(*foundComponent);
+		}
+	}
+	else
+	{
+		if (!foundComponent)
+		{
+			Create(owner);
+			foundComponent = Find(owner);
+		}
+		archive.ReadValue(*foundComponent);
+	}
+}
+
+template<class ComponentType>
+void LinearComponentStorage<ComponentType>::JsonToBinary(nlohmann::json& json, Engine::BinaryArchive& archive)
+{
+	ComponentType component;
+	Engine::FromJson(component, json);
+	archive.WriteValue(component);
+}
+
 template<class ComponentType>
 void LinearComponentStorage<ComponentType>::Create(EntityHandle owner)
 {
@@ -195,6 +225,34 @@ void LinearComponentStorage<ComponentType>::Create(EntityHandle owner)
 	assert(m_owners.size() == m_components.size() && m_entityToComponent.size() == m_owners.size());
 }
 
+template<class ComponentType>
+void LinearComponentStorage<ComponentType>::CreateMany(const EntityHandle* owners, uint32_t count)
+{
+	SDE_PROF_EVENT();
+
+	if (m_components.size() + count > c_maxComponents)
+	{
+		SDE_LOG("NO! Maximum components reached!");
+		assert(!"NO! Maximum components reached!");
+		*((int*)0x0) = 3;	// force crash
+	}
+
+	m_entityToComponent.reserve(m_entityToComponent.size() + count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const bool noDuplicate = m_entityToComponent.find(owners[i].GetID()) == m_entityToComponent.end();
+		assert(noDuplicate);
+		if (noDuplicate)
+		{
+			m_owners.push_back(owners[i]);
+			m_components.emplace_back();
+			m_entityToComponent.insert({ owners[i].GetID(), (uint32_t)(m_components.size() - 1) });
+		}
+	}
+	++m_generation;
+	assert(m_owners.size() == m_components.size() && m_entityToComponent.size() == m_owners.size());
+}
+
 template<class ComponentType>
 void LinearComponentStorage<ComponentType>::DestroyAll()
 {
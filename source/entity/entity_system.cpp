@@ -5,12 +5,47 @@
 #include "engine/debug_gui_menubar.h"
 #include "engine/script_system.h"
 #include "engine/components/component_tags.h"
+#include "engine/components/component_transform.h"
 #include "engine/tag.h"
+#include "core/timer.h"
+#include "core/thread.h"
+#include "core/file_io.h"
+#include "core/profiler.h"
+#include "engine/job_system.h"
 #include "basic_inspector.h"
 
 Engine::MenuBar g_entityMenu;
 bool g_showWindow = false;
 
+EntityHandle::OnLoaded EntitySystem::MakeRemapCallback(const std::unordered_map<uint32_t, uint32_t>& oldEntityToNewEntity)
+{
+	return [&oldEntityToNewEntity](EntityHandle& h) {
+		if (h.GetID() != -1)
+		{
+			auto foundRemap = oldEntityToNewEntity.find(h.GetID());
+			if (foundRemap != oldEntityToNewEntity.end())
+			{
+				h = EntityHandle(foundRemap->second);
+			}
+			else
+			{
+				SDE_LOG("Entity handle references ID that doesn't exist in the scene!");
+			}
+		}
+	};
+}
+
+std::vector<uint32_t> GetNewEntityIDs(const std::unordered_map<uint32_t, uint32_t>& oldEntityToNewEntity)
+{
+	std::vector<uint32_t> results;
+	results.reserve(oldEntityToNewEntity.size());
+	for (const auto& it : oldEntityToNewEntity)
+	{
+		results.emplace_back(it.second);
+	}
+	return results;
+}
+
 EntitySystem::EntitySystem()
 {
 	m_world = std::make_unique<World>();
@@ -19,6 +54,14 @@ EntitySystem::EntitySystem()
 void EntitySystem::NewWorld()
 {
 	SDE_PROF_EVENT();
+	for (auto& load : m_sceneLoads)
+	{
+		if (!load->m_cancelled && load->m_onComplete)
+		{
+			load->m_onComplete(false, {});
+		}
+		load->m_cancelled = true;
+	}
 	m_world->RemoveAllEntities();
 }
 
@@ -69,83 +112,278 @@ std::vector<uint32_t> EntitySystem::SerialiseEntities(nlohmann::json& data, bool
 	}
 
 	// First create the entities and build a remap table for the IDs
-	std::unordered_map<uint32_t, uint32_t> oldEntityToNewEntity;
+	std::unordered_map<uint32_t, uint32_t> oldEntityToNewEntity = AddEntitiesForLoad(oldEntityIDs, restoreIDsFromData);
+
+	// Hook the OnLoaded callback of EntityHandle and remap any IDs we find during loading
+	// This is how references to entities are fixed up!
+	EntityHandle::SetOnLoadFinishCallback(MakeRemapCallback(oldEntityToNewEntity));
+
+	// Load the data!
+	for (int index = 0; index < entityCount; ++index)
+	{
+		LoadEntityComponents(data["Entities"][index], oldEntityToNewEntity);
+	}
+
+	EntityHandle::SetOnLoadFinishCallback(nullptr);
+
+	return GetNewEntityIDs(oldEntityToNewEntity);
+}
+
+void EntitySystem::LoadEntityComponents(nlohmann::json& entityData, std::unordered_map<uint32_t, uint32_t>& oldEntityToNewEntity)
+{
+	uint32_t oldId = 0;
+	Engine::FromJson("ID", oldId, entityData);		// this is the OLD id
+	const uint32_t remappedId = oldEntityToNewEntity[oldId];
+	auto& cmpList = entityData["Components"];
+	int componentCount = cmpList.size();
+	for (int component = 0; component < componentCount; ++component)
+	{
+		std::string typeStr;
+		nlohmann::json& cmpJson = cmpList[component];
+		Engine::FromJson("Type", typeStr, cmpJson);
+
+		ComponentStorage* storage = m_world->GetStorage(typeStr);
+		if (storage)
+		{
+			nlohmann::json& dataJson = cmpJson["Data"];
+			storage->Serialise(remappedId, dataJson, Engine::SerialiseType::Read);
+		}
+	}
+}
+
+void EntitySystem::LoadSceneAsync(const std::string& path, bool restoreIDsFromData, SceneLoadProgressFn onProgress, SceneLoadCompleteFn onComplete, SceneLoadParsedFn onParsed)
+{
+	auto newLoad = std::make_unique<SceneLoad>();
+	newLoad->m_path = path;
+	newLoad->m_restoreIDsFromData = restoreIDsFromData;
+	newLoad->m_onProgress = onProgress;
+	newLoad->m_onComplete = onComplete;
+	newLoad->m_onParsed = onParsed;
+	StartSceneLoad(std::move(newLoad));
+}
+
+void EntitySystem::LoadSceneTextAsync(std::string sceneText, const std::string& name, bool restoreIDsFromData, SceneLoadProgressFn onProgress, SceneLoadCompleteFn onComplete)
+{
+	auto newLoad = std::make_unique<SceneLoad>();
+	newLoad->m_path = name;
+	newLoad->m_sceneText = std::move(sceneText);
+	newLoad->m_restoreIDsFromData = restoreIDsFromData;
+	newLoad->m_onProgress = onProgress;
+	newLoad->m_onComplete = onComplete;
+	StartSceneLoad(std::move(newLoad));
+}
+
+void EntitySystem::StartSceneLoad(std::unique_ptr<SceneLoad>&& load)
+{
+	SDE_PROF_EVENT();
+	load->m_startTime = Core::Timer().GetSeconds();
+	SceneLoad* loadPtr = load.get();
+	m_sceneLoads.push_back(std::move(load));
+	Engine::GetSystem<Engine::JobSystem>("Jobs")->PushSlowJob([loadPtr](void*) {
+		char debugName[1024] = { '\0' };
+		sprintf_s(debugName, "ParseScene %s", loadPtr->m_path.c_str());
+		SDE_PROF_EVENT_DYN(debugName);
+		if (loadPtr->m_sceneText.size() == 0 && !Core::LoadTextFromFile(loadPtr->m_path, loadPtr->m_sceneText))
+		{
+			SDE_LOG("Failed to load scene '%s'", loadPtr->m_path.c_str());
+			loadPtr->m_parseState = SceneParseState::Failed;
+			return;
+		}
+		loadPtr->m_json = nlohmann::json::parse(loadPtr->m_sceneText, nullptr, false);
+		loadPtr->m_sceneText = {};
+		if (loadPtr->m_json.is_discarded())
+		{
+			SDE_LOG("Failed to parse scene '%s'", loadPtr->m_path.c_str());
+			loadPtr->m_parseState = SceneParseState::Failed;
+			return;
+		}
+		loadPtr->m_parseState = SceneParseState::Parsed;
+	});
+}
+
+// Scene loads are processed in order, the oldest one gets as much of the budget as it needs
+void EntitySystem::UpdateSceneLoads()
+{
+	SDE_PROF_EVENT();
+	Core::Timer timer;
+	const double startTime = timer.GetSeconds();
+	for (int i = 0; i < m_sceneLoads.size() && (timer.GetSeconds() - startTime) < m_sceneLoadBudgetSeconds; ++i)
 	{
-		SDE_PROF_EVENT("AddEntities");
-		oldEntityToNewEntity.reserve(oldEntityIDs.size());
-		if (restoreIDsFromData)
+		SceneLoad& load = *m_sceneLoads[i];
+		const SceneParseState parseState = load.m_parseState;
+		if (parseState == SceneParseState::Parsing)
+		{
+			continue;
+		}
+		if (load.m_cancelled)
 		{
-			for (uint32_t oldID : oldEntityIDs)
+			m_sceneLoads.erase(m_sceneLoads.begin() + i--);
+			continue;
+		}
+
+		const double loadStartTime = timer.GetSeconds();
+		bool failed = parseState == SceneParseState::Failed;
+		if (!failed && !load.m_entitiesAdded)
+		{
+			uint32_t entityCount = 0;
+			Engine::FromJson("EntityCount", entityCount, load.m_json);
+			std::vector<uint32_t> oldEntityIDs;
+			Engine::FromJson("EntityIDs", oldEntityIDs, load.m_json);
+			if (oldEntityIDs.size() != entityCount || load.m_json["Entities"].size() != entityCount)
 			{
-				auto newEntity = m_world->AddEntityFromHandle(oldID);
-				if (newEntity.GetID() == -1)
+				SDE_LOG("Error - ID list size does not match entity count! Bad data?");
+				failed = true;
+			}
+			else
+			{
+				if (load.m_onParsed)
 				{
-					SDE_LOG("Error - failed to recreate entity with fixed ID %d. References to this entity will break!", oldID);
-					newEntity = m_world->AddEntity().GetID();
+					load.m_onParsed(load.m_json);
 				}
-				oldEntityToNewEntity[oldID] = newEntity.GetID();
+				load.m_oldEntityToNewEntity = AddEntitiesForLoad(oldEntityIDs, load.m_restoreIDsFromData);
+				load.m_entitiesAdded = true;
 			}
 		}
-		else
+		if (failed)
 		{
-			for (uint32_t oldID : oldEntityIDs)
+			if (load.m_onComplete)
 			{
-				oldEntityToNewEntity[oldID] = m_world->AddEntity().GetID();
+				load.m_onComplete(false, {});
 			}
+			m_sceneLoads.erase(m_sceneLoads.begin() + i--);
+			continue;
 		}
-	}
 
-	// Hook the OnLoaded callback of EntityHandle and remap any IDs we find during loading
-	// This is how references to entities are fixed up!
-	EntityHandle::OnLoaded remapId = [&oldEntityToNewEntity](EntityHandle& h) {
-		if (h.GetID() != -1)
+		nlohmann::json& entitiesJson = load.m_json["Entities"];
+		const uint32_t entityCount = (uint32_t)entitiesJson.size();
+		EntityHandle::SetOnLoadFinishCallback(MakeRemapCallback(load.m_oldEntityToNewEntity));
+		while (load.m_entitiesLoaded < entityCount && (timer.GetSeconds() - startTime) < m_sceneLoadBudgetSeconds)
 		{
-			auto foundRemap = oldEntityToNewEntity.find(h.GetID());
-			if (foundRemap != oldEntityToNewEntity.end())
-			{
-				h = EntityHandle(foundRemap->second);
-			}
-			else
+			LoadEntityComponents(entitiesJson[load.m_entitiesLoaded++], load.m_oldEntityToNewEntity);
+		}
+		EntityHandle::SetOnLoadFinishCallback(nullptr);
+		load.m_framesTaken++;
+		load.m_longestFrameSeconds = std::max(load.m_longestFrameSeconds, timer.GetSeconds() - loadStartTime);
+
+		if (load.m_onProgress)
+		{
+			load.m_onProgress(entityCount > 0 ? (float)load.m_entitiesLoaded / (float)entityCount : 1.0f);
+		}
+		if (load.m_entitiesLoaded == entityCount)
+		{
+			SDE_LOG("Loaded scene '%s' (%d entities) in %.2fms over %d frames, longest frame %.2fms", load.m_path.c_str(), entityCount,
+				(timer.GetSeconds() - load.m_startTime) * 1000.0, load.m_framesTaken, load.m_longestFrameSeconds * 1000.0);
+			std::unique_ptr<SceneLoad> completed = std::move(m_sceneLoads[i]);
+			m_sceneLoads.erase(m_sceneLoads.begin() + i--);
+			if (completed->m_onComplete)
 			{
-				SDE_LOG("Entity handle references ID that doesn't exist in the scene!");
+				completed->m_onComplete(true, GetNewEntityIDs(completed->m_oldEntityToNewEntity));
 			}
 		}
-	};
-	EntityHandle::SetOnLoadFinishCallback(remapId);
+	}
+}
 
-	// Load the data!
-	for (int index = 0; index < entityCount; ++index)
+void EntitySystem::SerialiseEntities(const std::vector<uint32_t>& entityIDs, Engine::BinaryArchive& archive)
+{
+	SDE_PROF_EVENT();
+	archive.Write("EntityIDs", entityIDs);
+	archive.BeginWriteField("Entities");
+	for (uint32_t entityID : entityIDs)
 	{
-		nlohmann::json& thisEntityData = data["Entities"][index];
-		uint32_t oldId = 0;
-		Engine::FromJson("ID", oldId, thisEntityData);		// this is the OLD id
-		const uint32_t remappedId = oldEntityToNewEntity[oldId];
-		auto& cmpList = thisEntityData["Components"];
-		int componentCount = cmpList.size();
-		for (int component = 0; component < componentCount; ++component)
+		archive.BeginWriteField(nullptr);
+		archive.Write("ID", entityID);
+		archive.BeginWriteField("Components");
+		std::vector<ComponentType> cmpTypes = m_world->GetOwnedComponentTypes(entityID);
+		for (auto& type : cmpTypes)
 		{
-			std::string typeStr;
-			nlohmann::json& cmpJson = cmpList[component];
-			Engine::FromJson("Type", typeStr, cmpJson);
+			archive.BeginWriteField(nullptr);
+			archive.Write("Type", type);
+			archive.BeginWriteField("Data");
+			m_world->GetStorage(type)->Serialise(entityID, archive, Engine::SerialiseType::Write);
+			archive.EndWriteField();
+			archive.EndWriteField();
+		}
+		archive.EndWriteField();
+		archive.EndWriteField();
+	}
+	archive.EndWriteField();
+}
 
-			ComponentStorage* storage = m_world->GetStorage(typeStr);
-			if (storage)
+std::vector<uint32_t> EntitySystem::SerialiseEntities(Engine::BinaryArchive& archive, bool restoreIDsFromData)
+{
+	SDE_PROF_EVENT();
+	std::vector<uint32_t> oldEntityIDs;
+	if (!archive.Read("EntityIDs", oldEntityIDs) || !archive.IsValid())
+	{
+		SDE_LOG("Error - binary entity data is missing the ID list! Bad data?");
+		return {};
+	}
+
+	std::unordered_map<uint32_t, uint32_t> oldEntityToNewEntity = AddEntitiesForLoad(oldEntityIDs, restoreIDsFromData);
+	EntityHandle::SetOnLoadFinishCallback(MakeRemapCallback(oldEntityToNewEntity));
+	if (archive.BeginReadField("Entities"))
+	{
+		std::string typeStr;
+		while (archive.BeginReadField(nullptr))
+		{
+			uint32_t oldId = 0;
+			archive.Read("ID", oldId);		// this is the OLD id
+			const uint32_t remappedId = oldEntityToNewEntity[oldId];
+			if (archive.BeginReadField("Components"))
 			{
-				nlohmann::json& dataJson = cmpJson["Data"];
-				storage->Serialise(remappedId, dataJson, Engine::SerialiseType::Read);
+				while (archive.BeginReadField(nullptr))
+				{
+					typeStr.clear();
+					archive.Read("Type", typeStr);
+					ComponentStorage* storage = m_world->GetStorage(typeStr);
+					if (storage && archive.BeginReadField("Data"))
+					{
+						storage->Serialise(remappedId, archive, Engine::SerialiseType::Read);
+						archive.EndReadField();
+					}
+					archive.EndReadField();
+				}
+				archive.EndReadField();
 			}
+			archive.EndReadField();
 		}
+		archive.EndReadField();
 	}
-
 	EntityHandle::SetOnLoadFinishCallback(nullptr);
 
-	std::vector<uint32_t> results;
-	results.reserve(oldEntityToNewEntity.size());
-	for (const auto& it : oldEntityToNewEntity)
+	if (!archive.IsValid())
 	{
-		results.emplace_back(it.second);
+		SDE_LOG("Error - binary entity data was truncated, some components may not have loaded");
 	}
-	return results;
+	return GetNewEntityIDs(oldEntityToNewEntity);
+}
+
+std::unordered_map<uint32_t, uint32_t> EntitySystem::AddEntitiesForLoad(const std::vector<uint32_t>& oldEntityIDs, bool restoreIDsFromData)
+{
+	SDE_PROF_EVENT();
+	std::unordered_map<uint32_t, uint32_t> oldEntityToNewEntity;
+	oldEntityToNewEntity.reserve(oldEntityIDs.size());
+	if (restoreIDsFromData)
+	{
+		for (uint32_t oldID : oldEntityIDs)
+		{
+			auto newEntity = m_world->AddEntityFromHandle(oldID);
+			if (newEntity.GetID() == -1)
+			{
+				SDE_LOG("Error - failed to recreate entity with fixed ID %d. References to this entity will break!", oldID);
+				newEntity = m_world->AddEntity().GetID();
+			}
+			oldEntityToNewEntity[oldID] = newEntity.GetID();
+		}
+	}
+	else
+	{
+		for (uint32_t oldID : oldEntityIDs)
+		{
+			oldEntityToNewEntity[oldID] = m_world->AddEntity().GetID();
+		}
+	}
+	return oldEntityToNewEntity;
 }
 
 std::string EntitySystem::GetEntityNameWithTags(EntityHandle e) const
@@ -279,14 +517,25 @@ EntityHandle EntitySystem::GetFirstEntityWithTag(Engine::Tag tag)
 	return result;
 }
 
+// Components can't just be copied, some own runtime state (physics actors, etc) that would end up shared
+// Instead each component is written to a binary archive and read straight back into the new entity
 EntityHandle EntitySystem::CloneEntity(EntityHandle src)
 {
-	std::vector<uint32_t> srcIDs;
-	srcIDs.push_back(src.GetID());
-	nlohmann::json srcJson = SerialiseEntities(srcIDs);
-	std::vector<uint32_t> newIDs = SerialiseEntities(srcJson);
-	assert(newIDs.size() == 1);
-	return newIDs[0];
+	SDE_PROF_EVENT();
+	EntityHandle newEntity = m_world->AddEntity();
+	const std::unordered_map<uint32_t, uint32_t> srcToNew = { { src.GetID(), newEntity.GetID() } };
+	EntityHandle::SetOnLoadFinishCallback(MakeRemapCallback(srcToNew));
+	std::vector<ComponentType> cmpTypes = m_world->GetOwnedComponentTypes(src);
+	for (const auto& type : cmpTypes)
+	{
+		ComponentStorage* storage = m_world->GetStorage(type);
+		m_cloneArchive.Reset();
+		storage->Serialise(src, m_cloneArchive, Engine::SerialiseType::Write);
+		m_cloneArchive.BeginReading();
+		storage->Serialise(newEntity, m_cloneArchive, Engine::SerialiseType::Read);
+	}
+	EntityHandle::SetOnLoadFinishCallback(nullptr);
+	return newEntity;
 }
 
 bool EntitySystem::PreInit()
@@ -323,6 +572,15 @@ bool EntitySystem::PreInit()
 	world["RemoveEntitiesWithTag"] = [this](Engine::Tag t) {
 		RemoveEntitiesWithTag(t);
 	};
+	world["LoadSceneAsync"] = [this](std::string path, bool restoreIDs, SceneLoadProgressFn onProgress, SceneLoadCompleteFn onComplete) {
+		LoadSceneAsync(path, restoreIDs, onProgress, onComplete);
+	};
+	world["IsLoadingScene"] = [this]() {
+		return IsLoadingScene();
+	};
+	world["SetSceneLoadBudgetMs"] = [this](double ms) {
+		SetSceneLoadBudget(ms / 1000.0);
+	};
 
 	return true;
 }
@@ -393,6 +651,8 @@ bool EntitySystem::Tick(float timeDelta)
 	}
 	m_debugGui->MainMenuBar(g_entityMenu);
 
+	UpdateSceneLoads();
+
 	if (m_showStats)
 	{
 		ShowStats();
@@ -405,5 +665,15 @@ bool EntitySystem::Tick(float timeDelta)
 void EntitySystem::Shutdown()
 {
 	SDE_PROF_EVENT();
+
+	// jobs may still be parsing scenes
+	for (const auto& load : m_sceneLoads)
+	{
+		while (load->m_parseState == SceneParseState::Parsing)
+		{
+			Core::Thread::Sleep(1);
+		}
+	}
+	m_sceneLoads.clear();
 	m_world = nullptr;
 }
\ No newline at end of file
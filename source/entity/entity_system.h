@@ -3,6 +3,7 @@
 #include "engine/tag.h"
 #include "world.h"
 #include <memory>
+#include <atomic>
 
 namespace Engine
 {
@@ -38,18 +39,68 @@ public:
 	nlohmann::json SerialiseEntities(const std::vector<uint32_t>& entityIDs);
 	std::vector<uint32_t> SerialiseEntities(nlohmann::json& data, bool restoreIDsFromData=false);
 
+	// binary versions, much faster and smaller than json but not human readable
+	void SerialiseEntities(const std::vector<uint32_t>& entityIDs, Engine::BinaryArchive& archive);
+	std::vector<uint32_t> SerialiseEntities(Engine::BinaryArchive& archive, bool restoreIDsFromData=false);
+
+	// Loads a scene over several frames. The file is read and parsed on a job, then entities are created in Tick() within a time budget
+	// onProgress is called once a frame with 0-1, onComplete gets the new entities (or false if the scene could not be loaded)
+	// onParsed runs on the main thread before any entities are created, for reading anything else stored in the scene
+	using SceneLoadProgressFn = std::function<void(float)>;
+	using SceneLoadCompleteFn = std::function<void(bool, std::vector<uint32_t>)>;
+	using SceneLoadParsedFn = std::function<void(nlohmann::json&)>;
+	void LoadSceneAsync(const std::string& path, bool restoreIDsFromData, SceneLoadProgressFn onProgress = nullptr, SceneLoadCompleteFn onComplete = nullptr, SceneLoadParsedFn onParsed = nullptr);	// NewWorld() cancels any loads in progress
+	void LoadSceneTextAsync(std::string sceneText, const std::string& name, bool restoreIDsFromData, SceneLoadProgressFn onProgress = nullptr, SceneLoadCompleteFn onComplete = nullptr);	// scene json already in memory, name is only used for logging
+	bool IsLoadingScene() const { return m_sceneLoads.size() > 0; }
+	void SetSceneLoadBudget(double seconds) { m_sceneLoadBudgetSeconds = seconds; }
+	double GetSceneLoadBudget() const { return m_sceneLoadBudgetSeconds; }
+	void UpdateSceneLoads();	// called from Tick(), only needs the world and the job system so it can be driven without the rest of the engine
+
+	// remaps any entity handles found while loading, the table must outlive the callback
+	static EntityHandle::OnLoaded MakeRemapCallback(const std::unordered_map<uint32_t, uint32_t>& oldEntityToNewEntity);
+
 	std::string GetEntityNameWithTags(EntityHandle e) const;
 	EntityHandle GetFirstEntityWithTag(Engine::Tag tag);
 	void RemoveEntitiesWithTag(Engine::Tag tag);
 
 private:
 	void ShowStats();
+	enum class SceneParseState
+	{
+		Parsing,
+		Parsed,
+		Failed
+	};
+	struct SceneLoad
+	{
+		std::string m_path;
+		std::string m_sceneText;				// if not empty this is parsed instead of loading m_path
+		bool m_restoreIDsFromData = false;
+		bool m_cancelled = false;				// removed once parsing finishes, callbacks are not called again
+		SceneLoadProgressFn m_onProgress;
+		SceneLoadCompleteFn m_onComplete;
+		SceneLoadParsedFn m_onParsed;
+		std::atomic<SceneParseState> m_parseState = SceneParseState::Parsing;
+		nlohmann::json m_json;
+		bool m_entitiesAdded = false;
+		std::unordered_map<uint32_t, uint32_t> m_oldEntityToNewEntity;
+		uint32_t m_entitiesLoaded = 0;
+		uint32_t m_framesTaken = 0;
+		double m_longestFrameSeconds = 0.0;
+		double m_startTime = 0.0;
+	};
+	std::unordered_map<uint32_t, uint32_t> AddEntitiesForLoad(const std::vector<uint32_t>& oldEntityIDs, bool restoreIDsFromData);
+	void LoadEntityComponents(nlohmann::json& entityData, std::unordered_map<uint32_t, uint32_t>& oldEntityToNewEntity);
+	void StartSceneLoad(std::unique_ptr<SceneLoad>&& load);
 
 	std::map<ComponentType, InspectorFn> m_componentInspectors;
 	std::unique_ptr<World> m_world;
 	Engine::ScriptSystem* m_scriptSystem;
 	Engine::DebugGuiSystem* m_debugGui;
 	bool m_showStats = false;
+	Engine::BinaryArchive m_cloneArchive;
+	std::vector<std::unique_ptr<SceneLoad>> m_sceneLoads;	// oldest first
+	double m_sceneLoadBudgetSeconds = 0.004;				// time spent creating entities for scene loads each frame
 };
 
 template<class ComponentType>
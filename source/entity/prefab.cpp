@@ -0,0 +1,170 @@
+#include "prefab.h"
+#include "world.h"
+#include "entity_system.h"
+#include "core/file_io.h"
+#include "core/timer.h"
+#include "core/profiler.h"
+#include <algorithm>
+
+std::unique_ptr<Prefab> Prefab::FromJson(nlohmann::json& data, World& world)
+{
+	SDE_PROF_EVENT();
+	auto prefab = std::make_unique<Prefab>();
+	Engine::FromJson("EntityIDs", prefab->m_entityIDs, data);
+
+	// component data is converted directly, references to other entities keep the ids from the source data
+	Engine::BinaryArchive archive;
+	std::unordered_map<ComponentType, uint32_t> typeToIndex;
+	auto& entitiesJson = data["Entities"];
+	const uint32_t entityCount = prefab->GetEntityCount();
+	if (entitiesJson.size() != entityCount)
+	{
+		SDE_LOG("Error - ID list size does not match entity count! Bad data?");
+		return nullptr;
+	}
+	prefab->m_firstComponent.reserve(entityCount + 1);
+	for (uint32_t index = 0; index < entityCount; ++index)
+	{
+		prefab->m_firstComponent.push_back((uint32_t)prefab->m_components.size());
+		auto& cmpList = entitiesJson[index]["Components"];
+		for (int component = 0; component < cmpList.size(); ++component)
+		{
+			std::string typeStr;
+			Engine::FromJson("Type", typeStr, cmpList[component]);
+			ComponentStorage* storage = world.GetStorage(typeStr);
+			if (storage == nullptr)
+			{
+				continue;
+			}
+			auto foundType = typeToIndex.find(typeStr);
+			if (foundType == typeToIndex.end())
+			{
+				foundType = typeToIndex.emplace(typeStr, (uint32_t)prefab->m_componentTypes.size()).first;
+				prefab->m_componentTypes.push_back(typeStr);
+			}
+			archive.Reset();
+			storage->JsonToBinary(cmpList[component]["Data"], archive);
+			prefab->m_components.push_back({ foundType->second, (uint32_t)prefab->m_data.size(), (uint32_t)archive.Data().size() });
+			prefab->m_data.insert(prefab->m_data.end(), archive.Data().begin(), archive.Data().end());
+		}
+	}
+	prefab->m_firstComponent.push_back((uint32_t)prefab->m_components.size());
+	return prefab;
+}
+
+PrefabInstance::PrefabInstance(std::shared_ptr<const Prefab> prefab, World& world)
+	: m_prefab(prefab)
+	, m_world(world)
+	, m_worldResetCount(world.GetResetCount())
+{
+	SDE_PROF_EVENT();
+	m_storages.reserve(prefab->m_componentTypes.size());
+	for (const auto& type : prefab->m_componentTypes)
+	{
+		m_storages.push_back(world.GetStorage(type));
+	}
+	m_batchOwners.resize(m_storages.size());
+	const uint32_t entityCount = prefab->GetEntityCount();
+	m_entities.reserve(entityCount);
+	m_oldEntityToNewEntity.reserve(entityCount);
+	for (uint32_t oldID : prefab->m_entityIDs)
+	{
+		const uint32_t newID = world.AddEntity().GetID();
+		m_entities.push_back(newID);
+		m_oldEntityToNewEntity[oldID] = newID;
+	}
+}
+
+bool PrefabInstance::IsCancelled() const
+{
+	return m_world.GetResetCount() != m_worldResetCount;
+}
+
+bool PrefabInstance::Continue(double timeBudgetSeconds)
+{
+	SDE_PROF_EVENT();
+	if (IsCancelled())
+	{
+		return false;
+	}
+	Core::Timer timer;
+	const double startTime = timer.GetSeconds();
+	const Prefab& prefab = *m_prefab;
+	EntityHandle::SetOnLoadFinishCallback(EntitySystem::MakeRemapCallback(m_oldEntityToNewEntity));
+	while (!IsComplete())
+	{
+		const uint32_t firstEntity = m_entitiesCreated;
+		const uint32_t lastEntity = std::min(firstEntity + c_entitiesPerBatch, (uint32_t)m_entities.size());
+		for (auto& owners : m_batchOwners)
+		{
+			owners.clear();
+		}
+		for (uint32_t index = firstEntity; index < lastEntity; ++index)
+		{
+			for (uint32_t c = prefab.m_firstComponent[index]; c < prefab.m_firstComponent[index + 1]; ++c)
+			{
+				m_batchOwners[prefab.m_components[c].m_typeIndex].push_back(m_entities[index]);
+			}
+		}
+		for (uint32_t t = 0; t < m_storages.size(); ++t)
+		{
+			if (m_batchOwners[t].size() > 0)
+			{
+				m_storages[t]->CreateMany(m_batchOwners[t].data(), (uint32_t)m_batchOwners[t].size());
+			}
+		}
+		for (uint32_t index = firstEntity; index < lastEntity; ++index)
+		{
+			for (uint32_t c = prefab.m_firstComponent[index]; c < prefab.m_firstComponent[index + 1]; ++c)
+			{
+				const auto& cmp = prefab.m_components[c];
+				m_archive.BeginReading(prefab.m_data.data() + cmp.m_offset, cmp.m_size);
+				m_storages[cmp.m_typeIndex]->Serialise(m_entities[index], m_archive, Engine::SerialiseType::Read);
+			}
+		}
+		m_entitiesCreated = lastEntity;
+		if (timer.GetSeconds() - startTime >= timeBudgetSeconds)
+		{
+			break;
+		}
+	}
+	EntityHandle::SetOnLoadFinishCallback(nullptr);
+	return IsComplete();
+}
+
+std::shared_ptr<const Prefab> PrefabCache::Load(const std::string& path, World& world)
+{
+	SDE_PROF_EVENT();
+	auto found = m_prefabs.find(path);
+	if (found != m_prefabs.end())
+	{
+		return found->second;
+	}
+
+	std::string sceneText;
+	if (!Core::LoadTextFromFile(path, sceneText))
+	{
+		return nullptr;
+	}
+	nlohmann::json sceneJson;
+	{
+		SDE_PROF_EVENT("ParseJson");
+		sceneJson = nlohmann::json::parse(sceneText);
+	}
+	std::shared_ptr<const Prefab> prefab = Prefab::FromJson(sceneJson, world);
+	if (prefab != nullptr)
+	{
+		m_prefabs[path] = prefab;
+	}
+	return prefab;
+}
+
+size_t PrefabCache::GetSizeBytes() const
+{
+	size_t totalSize = 0;
+	for (const auto& it : m_prefabs)
+	{
+		totalSize += it.second->GetSizeBytes();
+	}
+	return totalSize;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "engine/serialisation.h"
+#include "component.h"
+#include "entity_handle.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class World;
+
+// An immutable binary copy of the entities in a scene/prefab file
+// Built once from json, then instantiated any number of times without touching json or the file again
+class Prefab
+{
+public:
+	static std::unique_ptr<Prefab> FromJson(nlohmann::json& data, World& world);
+	uint32_t GetEntityCount() const { return (uint32_t)m_entityIDs.size(); }
+	size_t GetSizeBytes() const { return m_data.size(); }
+
+private:
+	friend class PrefabInstance;
+	struct ComponentData
+	{
+		uint32_t m_typeIndex;		// into m_componentTypes
+		uint32_t m_offset;			// archive in m_data
+		uint32_t m_size;
+	};
+	std::vector<uint32_t> m_entityIDs;			// ids in the source data, references between entities are remapped from these
+	std::vector<uint32_t> m_firstComponent;		// index into m_components per entity, one extra at the end
+	std::vector<ComponentData> m_components;
+	std::vector<ComponentType> m_componentTypes;
+	std::vector<uint8_t> m_data;				// one binary archive per component
+};
+
+// Creates the entities of a prefab, all entity IDs are allocated up front and components are added in Continue()
+// This lets large prefabs be spread over multiple frames
+// Entities are completed in small batches, within a batch each component type is created in one go before any data is read
+class PrefabInstance
+{
+public:
+	PrefabInstance(std::shared_ptr<const Prefab> prefab, World& world);
+	bool Continue(double timeBudgetSeconds);		// returns true when all entities are complete, always completes at least 1 batch
+	bool IsComplete() const { return m_entitiesCreated == m_entities.size(); }
+	bool IsCancelled() const;						// the world was emptied since this was created, Continue does nothing
+	const std::vector<uint32_t>& GetEntities() const { return m_entities; }		// includes ones with no components yet
+	uint32_t GetCreatedCount() const { return m_entitiesCreated; }					// the first n entities are complete
+
+private:
+	static constexpr uint32_t c_entitiesPerBatch = 64;
+	std::shared_ptr<const Prefab> m_prefab;
+	World& m_world;
+	uint32_t m_worldResetCount;
+	std::vector<ComponentStorage*> m_storages;	// per prefab component type
+	std::vector<std::vector<EntityHandle>> m_batchOwners;	// per prefab component type, owners created in the current batch
+	std::vector<uint32_t> m_entities;
+	std::unordered_map<uint32_t, uint32_t> m_oldEntityToNewEntity;
+	uint32_t m_entitiesCreated = 0;
+	Engine::BinaryArchive m_archive;
+};
+
+// Prefabs by path, each file is only loaded and parsed once
+class PrefabCache
+{
+public:
+	std::shared_ptr<const Prefab> Load(const std::string& path, World& world);	// nullptr if the file could not be loaded
+	void Clear() { m_prefabs.clear(); }
+	size_t GetSizeBytes() const;
+
+private:
+	std::unordered_map<std::string, std::shared_ptr<const Prefab>> m_prefabs;
+};
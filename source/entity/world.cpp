@@ -115,6 +115,7 @@ void World::RemoveAllEntities()
 	{
 		components.second->DestroyAll();
 	}
+	++m_resetCount;
 }
 
 void World::RemoveEntity(EntityHandle h)
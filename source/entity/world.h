@@ -23,6 +23,7 @@ public:
 	void RemoveEntity(EntityHandle h);	// defers actual deletion until CollectGarbage() called
 	const std::vector<uint32_t>& AllEntities() const { return m_activeEntities; }
 	void RemoveAllEntities();		// instant, use with caution
+	uint32_t GetResetCount() const { return m_resetCount; }		// bumped by RemoveAllEntities, entity ids held from before it changed are gone
 
 	template<class ComponentType>
 	void RegisterComponentType();
@@ -79,6 +80,7 @@ private:
 	uint32_t m_entityIDCounter;
 	std::vector<uint32_t> m_activeEntities;	// all active entity IDs
 	std::vector<uint32_t> m_pendingDelete;	// all entities to be deleted
+	uint32_t m_resetCount = 0;
 	robin_hood::unordered_map<ComponentType, std::unique_ptr<ComponentStorage>> m_components;	// all active component data
 };
 
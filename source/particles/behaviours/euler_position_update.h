@@ -8,6 +8,9 @@ namespace Particles
 	public:
 		SERIALISED_CLASS();
 		void Update(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container);
+		bool CanFuse() { return true; }
+		Integrator GetIntegrator() { return Integrator::EulerPosition; }
+		void UpdateRange(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container, uint32_t startIndex, uint32_t endIndex);
 		std::unique_ptr<UpdateBehaviour> MakeNew() { return std::make_unique<EulerPositionUpdater>(); }
 		std::string_view GetName() { return "Euler Position Updater"; }
 		void Inspect(EditorValueInspector&) {}
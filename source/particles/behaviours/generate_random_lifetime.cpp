@@ -18,11 +18,19 @@ namespace Particles
 	void GenerateRandomLifetime::Generate(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container, uint32_t startIndex, uint32_t endIndex)
 	{
 		SDE_PROF_EVENT();
-		for (uint32_t i = startIndex; i < endIndex; ++i)
+		// 4 lifetimes per random block
+		auto& random = container.RandomStream();
+		const __m128 c_minLife = _mm_set1_ps(m_minLifetime);
+		const __m128 c_maxLife = _mm_set1_ps(m_maxLifetime);
+		float* lifetimes = container.Lifetimes().Data();
+		uint32_t i = startIndex;
+		for (; i + 4 <= endIndex; i += 4)
 		{
-			float v = ((float)rand() / (float)RAND_MAX);
-			float particleLife = m_minLifetime + (m_maxLifetime- m_minLifetime) * v;
-			container.Lifetimes().GetValue(i) = particleLife;
+			_mm_storeu_ps(lifetimes + i, random.NextFloat4(c_minLife, c_maxLife));
+		}
+		for (; i < endIndex; ++i)
+		{
+			lifetimes[i] = random.NextFloat(m_minLifetime, m_maxLifetime);
 		}
 		_mm_sfence();
 	}
@@ -20,13 +20,13 @@ namespace Particles
 		SDE_PROF_EVENT();
 		glm::mat4 emitterTransform = glm::translate(emitterPos) * glm::toMat4(orientation);
 		glm::vec4 range = glm::abs(glm::vec4(m_boundsMin - m_boundsMax, 0.0f));
+		auto& random = container.RandomStream();
+		__declspec(align(16)) glm::vec4 v;
 		for (uint32_t i = startIndex; i < endIndex; ++i)
 		{
-			float vX = ((float)rand() / (float)RAND_MAX);
-			float vY = ((float)rand() / (float)RAND_MAX);
-			float vZ = ((float)rand() / (float)RAND_MAX);
+			_mm_store_ps(glm::value_ptr(v), random.NextFloat4());
 
-			__declspec(align(16)) glm::vec4 newPos(m_boundsMin.x + (vX * range.x), m_boundsMin.y + (vY * range.y), m_boundsMin.z + (vZ * range.z), 1.0f);
+			__declspec(align(16)) glm::vec4 newPos(m_boundsMin.x + (v.x * range.x), m_boundsMin.y + (v.y * range.y), m_boundsMin.z + (v.z * range.z), 1.0f);
 			newPos = emitterTransform * newPos;
 			__m128 posVec = _mm_load_ps(glm::value_ptr(newPos));
 			container.Positions().GetValue(i) = posVec;
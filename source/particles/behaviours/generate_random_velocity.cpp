@@ -21,13 +21,13 @@ namespace Particles
 
 		glm::vec4 range = glm::abs(glm::vec4(m_minimum - m_maximum, 0.0f));
 		glm::mat4 emitterTransform = glm::toMat4(orientation);
+		auto& random = container.RandomStream();
+		__declspec(align(16)) glm::vec4 v;
 		for (uint32_t i = startIndex; i < endIndex; ++i)
 		{
-			float vX = ((float)rand() / (float)RAND_MAX);
-			float vY = ((float)rand() / (float)RAND_MAX);
-			float vZ = ((float)rand() / (float)RAND_MAX);
+			_mm_store_ps(glm::value_ptr(v), random.NextFloat4());
 
-			__declspec(align(16)) glm::vec4 newVel(m_minimum.x + (vX * range.x), m_minimum.y + (vY * range.y), m_minimum.z + (vZ * range.z), 0.0f);
+			__declspec(align(16)) glm::vec4 newVel(m_minimum.x + (v.x * range.x), m_minimum.y + (v.y * range.y), m_minimum.z + (v.z * range.z), 0.0f);
 			__m128 velVec = _mm_load_ps(glm::value_ptr(emitterTransform * newVel));
 			container.Velocities().GetValue(i) = velVec;
 		}
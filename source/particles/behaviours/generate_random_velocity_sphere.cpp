@@ -33,11 +33,14 @@ namespace Particles
 
 		float range = glm::abs(m_minMagnitude - m_maxMagnitude);
 		glm::mat4 emitterTransform = glm::toMat4(orientation);
+		auto& random = container.RandomStream();
+		__declspec(align(16)) glm::vec4 v;
 		for (uint32_t i = startIndex; i < endIndex; ++i)
 		{
-			float theta = m_minTheta + ((float)rand() / (float)RAND_MAX) * glm::abs(m_maxTheta - m_minTheta);
-			float phi = m_minPhi + ((float)rand() / (float)RAND_MAX) * glm::abs(m_maxPhi - m_minPhi);
-			float r = m_minMagnitude + ((float)rand() / (float)RAND_MAX) * range;
+			_mm_store_ps(glm::value_ptr(v), random.NextFloat4());
+			float theta = m_minTheta + v.x * glm::abs(m_maxTheta - m_minTheta);
+			float phi = m_minPhi + v.y * glm::abs(m_maxPhi - m_minPhi);
+			float r = m_minMagnitude + v.z * range;
 			__declspec(align(16)) glm::vec4 newVel(r * glm::cos(theta) * glm::sin(phi), r * glm::sin(theta) * glm::sin(phi), r * glm::cos(phi), 0.0f);
 			__m128 velVec = _mm_load_ps(glm::value_ptr(newVel * emitterTransform));
 			container.Velocities().GetValue(i) = velVec;
@@ -27,7 +27,7 @@ namespace Particles
 		{
 			// needs to go After position is set!
 			_mm_store_ps(glm::value_ptr(particlePos), container.Positions().GetValue(i));
-			uint32_t newEmitter = particles->StartEmitter(m_emitterFile, glm::vec3(particlePos));
+			uint32_t newEmitter = particles->StartEmitter(m_emitterFile, glm::vec3(particlePos), glm::quat(), container.RandomStream().NextUInt64());
 			if (m_attachToParticle)
 			{
 				container.EmitterIDs().GetValue(i) = newEmitter;
@@ -8,6 +8,10 @@ namespace Particles
 	public:
 		SERIALISED_CLASS();
 		void Update(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container);
+		bool CanFuse() { return true; }
+		Integrator GetIntegrator() { return Integrator::Gravity; }
+		void UpdateRange(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container, uint32_t startIndex, uint32_t endIndex);
+		static glm::vec3 GetGravity();
 		std::unique_ptr<UpdateBehaviour> MakeNew() { return std::make_unique<GravityUpdate>(); }
 		std::string_view GetName() { return "Apply Gravity"; }
 		void Inspect(EditorValueInspector&) {}
@@ -5,6 +5,7 @@
 #include "engine/debug_gui_system.h"
 #include "engine/file_picker_dialog.h"
 #include "engine/renderer.h"
+#include "engine/camera_system.h"
 #include "particles/particle_container.h"
 #include "particles/editor_value_inspector.h"
 
@@ -14,6 +15,10 @@ namespace Particles
 	{
 		SERIALISE_PROPERTY("Shader", m_shader);
 		SERIALISE_PROPERTY("Model", m_model);
+		SERIALISE_PROPERTY("MaxDrawDistance", m_maxDrawDistance);
+		SERIALISE_PROPERTY("LodStartDistance", m_lodStartDistance);
+		SERIALISE_PROPERTY("LodEndDistance", m_lodEndDistance);
+		SERIALISE_PROPERTY("LodMinParticleFraction", m_lodMinParticleFraction);
 	}
 	SERIALISE_END()
 
@@ -21,11 +26,42 @@ namespace Particles
 	{
 		SDE_PROF_EVENT();
 		static auto graphics = Engine::GetSystem<GraphicsSystem>("Graphics");
+		static auto cameras = Engine::GetSystem<Engine::CameraSystem>("Cameras");
 		const uint32_t count = container.AliveParticles();
-		if (count > 0)
+		if (count == 0)
+		{
+			return;
+		}
+
+		// cull/lod based on emitter distance from the camera
+		const float distanceToCamera = glm::length(emitterPos - cameras->MainCamera().Position());
+		if (m_maxDrawDistance > 0.0f && distanceToCamera > m_maxDrawDistance)
+		{
+			return;
+		}
+		float lodFraction = 1.0f;
+		if (m_lodEndDistance > m_lodStartDistance)
+		{
+			const float t = glm::clamp((distanceToCamera - m_lodStartDistance) / (m_lodEndDistance - m_lodStartDistance), 0.0f, 1.0f);
+			lodFraction = glm::mix(1.0f, glm::clamp(m_lodMinParticleFraction, 0.0f, 1.0f), t);
+		}
+		const uint32_t drawCount = glm::max(1u, (uint32_t)(count * lodFraction));
+		if (drawCount == count)
 		{
 			graphics->Renderer().SubmitInstances(&container.Positions().GetValue(0), count, m_model, m_shader);
 		}
+		else
+		{
+			// take an even spread of particles so the overall shape is kept
+			static thread_local std::vector<__m128> lodPositions;
+			lodPositions.resize(drawCount);
+			const float step = (float)count / (float)drawCount;
+			for (uint32_t i = 0; i < drawCount; ++i)
+			{
+				lodPositions[i] = container.Positions().GetValue((uint32_t)(i * step));
+			}
+			graphics->Renderer().SubmitInstances(lodPositions.data(), drawCount, m_model, m_shader);
+		}
 	}
 
 	void MeshRenderer::Inspect(EditorValueInspector& v)
@@ -44,6 +80,19 @@ namespace Particles
 			}
 		}
 
+		v.Inspect("Max draw distance", m_maxDrawDistance, [this](float val) {
+			m_maxDrawDistance = val;
+		});
+		v.Inspect("LOD start distance", m_lodStartDistance, [this](float val) {
+			m_lodStartDistance = val;
+		});
+		v.Inspect("LOD end distance", m_lodEndDistance, [this](float val) {
+			m_lodEndDistance = val;
+		});
+		v.Inspect("LOD min particle fraction", m_lodMinParticleFraction, [this](float val) {
+			m_lodMinParticleFraction = val;
+		});
+
 		auto allShaders = shaders->AllShaders();
 		std::vector<std::string> shaderpaths;
 		std::string vs, fs;
@@ -16,5 +16,9 @@ namespace Particles
 		
 		Engine::ShaderHandle m_shader;
 		Engine::ModelHandle m_model;
+		float m_maxDrawDistance = 0.0f;			// emitters further than this from the camera are not drawn, 0 = no limit
+		float m_lodStartDistance = 0.0f;		// particle count is reduced linearly between the lod start/end distances
+		float m_lodEndDistance = 0.0f;			// 0 = no lod
+		float m_lodMinParticleFraction = 1.0f;	// fraction of particles drawn at lod end distance
 	};
 }
\ No newline at end of file
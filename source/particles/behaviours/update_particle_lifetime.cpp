@@ -22,9 +22,69 @@ namespace Particles
 	}
 
 	void UpdateParticleLifetime::Update(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container)
+	{
+		SDE_PROF_EVENT();
+		KillExpired(emitterAge, container, m_killAttachedEmitters);
+	}
+
+	uint32_t UpdateParticleLifetime::KillExpired(double emitterAge, ParticleContainer& container, bool killAttachedEmitters)
+	{
+		SDE_PROF_EVENT();
+		static auto particles = Engine::GetSystem<ParticleSystem>("Particles");
+		static thread_local std::vector<uint8_t> killMask;
+		const uint32_t aliveCount = container.AliveParticles();
+		killMask.resize(aliveCount);
+
+		// mark, 4 at a time. age is calculated in double precision to match the serial path exactly
+		const float* spawnTimes = container.SpawnTimes().Data();
+		const float* lifetimes = container.Lifetimes().Data();
+		const __m128d c_emitterAge = _mm_set1_pd(emitterAge);
+		uint32_t anyKilled = 0;
+		uint32_t p = 0;
+		for (; p + 4 <= aliveCount; p += 4)
+		{
+			const __m128 spawn = _mm_load_ps(spawnTimes + p);
+			const __m128d ageLo = _mm_sub_pd(c_emitterAge, _mm_cvtps_pd(spawn));
+			const __m128d ageHi = _mm_sub_pd(c_emitterAge, _mm_cvtps_pd(_mm_movehl_ps(spawn, spawn)));
+			const __m128 age = _mm_movelh_ps(_mm_cvtpd_ps(ageLo), _mm_cvtpd_ps(ageHi));
+			const int mask = _mm_movemask_ps(_mm_cmpge_ps(age, _mm_load_ps(lifetimes + p)));
+			killMask[p] = mask & 1;
+			killMask[p + 1] = (mask >> 1) & 1;
+			killMask[p + 2] = (mask >> 2) & 1;
+			killMask[p + 3] = (mask >> 3) & 1;
+			anyKilled |= mask;
+		}
+		for (; p < aliveCount; ++p)
+		{
+			const float currentAge = emitterAge - spawnTimes[p];
+			killMask[p] = currentAge >= lifetimes[p] ? 1 : 0;
+			anyKilled |= killMask[p];
+		}
+		if (anyKilled == 0)
+		{
+			return 0;
+		}
+
+		if (killAttachedEmitters)
+		{
+			const uint32_t* emitterIDs = container.EmitterIDs().Data();
+			for (uint32_t i = 0; i < aliveCount; ++i)
+			{
+				if (killMask[i] && emitterIDs[i] != -1)
+				{
+					particles->StopEmitter(emitterIDs[i]);
+				}
+			}
+		}
+
+		return container.Compact(killMask.data());
+	}
+
+	uint32_t UpdateParticleLifetime::KillExpiredSerial(double emitterAge, ParticleContainer& container, bool killAttachedEmitters)
 	{
 		SDE_PROF_EVENT();
 		static auto particles = Engine::GetSystem<ParticleSystem>("Particles");
+		uint32_t killed = 0;
 		uint32_t currentP = 0;
 		while (currentP < container.AliveParticles())
 		{
@@ -32,7 +92,7 @@ namespace Particles
 			const float maxLifetime = container.Lifetimes().GetValue(currentP);
 			if (currentAge >= maxLifetime)
 			{
-				if (m_killAttachedEmitters)
+				if (killAttachedEmitters)
 				{
 					uint32_t attachedEmitter = container.EmitterIDs().GetValue(currentP);
 					if (attachedEmitter != -1)
@@ -41,11 +101,13 @@ namespace Particles
 					}
 				}
 				container.Kill(currentP);
+				++killed;
 			}
 			else
 			{
 				currentP++;
 			}
 		}
+		return killed;
 	}
-}
\ No newline at end of file
+}
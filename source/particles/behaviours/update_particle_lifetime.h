@@ -13,6 +13,11 @@ namespace Particles
 		void Update(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container);
 		void Inspect(EditorValueInspector&);
 
+		// Marks expired particles with SIMD then compacts all buffers together
+		static uint32_t KillExpired(double emitterAge, ParticleContainer& container, bool killAttachedEmitters);
+		// Reference implementation, kills one particle at a time
+		static uint32_t KillExpiredSerial(double emitterAge, ParticleContainer& container, bool killAttachedEmitters);
+
 		bool m_killAttachedEmitters = true;
 	};
 }
\ No newline at end of file
@@ -56,7 +56,7 @@ namespace Particles
 					_mm_store_ps(glm::value_ptr(particlePos), container.Positions().GetValue(i));
 					for (int em = 0; em < m_burstCount; ++em)
 					{
-						uint32_t newEmitter = particles->StartEmitter(m_emitterFile, glm::vec3(particlePos));
+						uint32_t newEmitter = particles->StartEmitter(m_emitterFile, glm::vec3(particlePos), glm::quat(), container.RandomStream().NextUInt64());
 						if (m_attachToParticle)
 						{
 							container.EmitterIDs().GetValue(i) = newEmitter;
@@ -0,0 +1,103 @@
+#include "particle_arena.h"
+#include "emitter_instance.h"
+#include "core/aligned_alloc.h"
+#include "core/profiler.h"
+
+namespace Particles
+{
+	ParticleArena::ParticleArena()
+	{
+	}
+
+	ParticleArena::~ParticleArena()
+	{
+		m_freeInstances.clear();
+		m_instanceSlabs.clear();	// containers return their blocks here
+		for (auto& bucket : m_freeBlocks)
+		{
+			for (auto block : bucket.second)
+			{
+				Core::AlignedFree(block);
+			}
+		}
+	}
+
+	EmitterInstance* ParticleArena::AcquireInstance()
+	{
+		SDE_PROF_EVENT();
+		Core::ScopedMutex lock(m_mutex);
+		if (m_freeInstances.size() == 0)
+		{
+			m_instanceSlabs.push_back(std::make_unique<EmitterInstance[]>(c_instancesPerSlab));
+			EmitterInstance* slab = m_instanceSlabs.back().get();
+			for (int i = c_instancesPerSlab - 1; i >= 0; --i)
+			{
+				m_freeInstances.push_back(slab + i);
+			}
+			m_stats.m_instancesAllocated += c_instancesPerSlab;
+		}
+		else
+		{
+			++m_stats.m_instancesReused;
+		}
+		EmitterInstance* result = m_freeInstances.back();
+		m_freeInstances.pop_back();
+		++m_stats.m_instancesActive;
+		return result;
+	}
+
+	void ParticleArena::ReleaseInstance(EmitterInstance* instance)
+	{
+		SDE_PROF_EVENT();
+		instance->m_particles.Destroy();
+		instance->m_emitter = nullptr;
+		instance->m_timeActive = 0.0;
+
+		Core::ScopedMutex lock(m_mutex);
+		m_freeInstances.push_back(instance);
+		--m_stats.m_instancesActive;
+	}
+
+	void* ParticleArena::AcquireBlock(size_t sizeBytes)
+	{
+		SDE_PROF_EVENT();
+		{
+			Core::ScopedMutex lock(m_mutex);
+			m_stats.m_bytesActive += sizeBytes;
+			auto found = m_freeBlocks.find(sizeBytes);
+			if (found != m_freeBlocks.end() && found->second.size() > 0)
+			{
+				void* block = found->second.back();
+				found->second.pop_back();
+				m_stats.m_bytesPooled -= sizeBytes;
+				++m_stats.m_blocksReused;
+				return block;
+			}
+			++m_stats.m_blocksAllocated;
+		}
+		return Core::AlignedAlloc(sizeBytes, 16);
+	}
+
+	void ParticleArena::ReleaseBlock(void* block, size_t sizeBytes)
+	{
+		SDE_PROF_EVENT();
+		{
+			Core::ScopedMutex lock(m_mutex);
+			m_stats.m_bytesActive -= sizeBytes;
+			if (m_stats.m_bytesPooled + sizeBytes <= m_maxPooledBytes)
+			{
+				m_freeBlocks[sizeBytes].push_back(block);
+				m_stats.m_bytesPooled += sizeBytes;
+				return;
+			}
+			++m_stats.m_blocksFreed;
+		}
+		Core::AlignedFree(block);
+	}
+
+	ParticleArena::Stats ParticleArena::GetStats()
+	{
+		Core::ScopedMutex lock(m_mutex);
+		return m_stats;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "core/mutex.h"
+#include <robin_hood.h>
+#include <memory>
+#include <vector>
+
+namespace Particles
+{
+	class EmitterInstance;
+
+	// Pools emitter instances and particle buffer memory so starting/stopping emitters does not hit the heap
+	// Instances are allocated in slabs, buffer blocks are kept in free lists bucketed by size (i.e. particle capacity)
+	// Thread-safe, emitters can be started from jobs
+	class ParticleArena
+	{
+	public:
+		ParticleArena();
+		~ParticleArena();
+
+		struct Stats
+		{
+			uint64_t m_instancesAllocated = 0;
+			uint64_t m_instancesReused = 0;
+			uint64_t m_instancesActive = 0;
+			uint64_t m_blocksAllocated = 0;
+			uint64_t m_blocksReused = 0;
+			uint64_t m_blocksFreed = 0;		// released while the pool was full
+			uint64_t m_bytesActive = 0;
+			uint64_t m_bytesPooled = 0;
+		};
+
+		EmitterInstance* AcquireInstance();
+		void ReleaseInstance(EmitterInstance* instance);	// also returns the particle buffers to the pool
+
+		void* AcquireBlock(size_t sizeBytes);				// 16 byte aligned
+		void ReleaseBlock(void* block, size_t sizeBytes);
+
+		void SetMaxPooledBytes(uint64_t bytes) { m_maxPooledBytes = bytes; }
+		uint64_t GetMaxPooledBytes() const { return m_maxPooledBytes; }
+		Stats GetStats();
+
+	private:
+		static constexpr uint32_t c_instancesPerSlab = 64;
+		Core::Mutex m_mutex;
+		Stats m_stats;
+		uint64_t m_maxPooledBytes = 64 * 1024 * 1024;
+		robin_hood::unordered_map<size_t, std::vector<void*>> m_freeBlocks;
+		std::vector<EmitterInstance*> m_freeInstances;
+		std::vector<std::unique_ptr<EmitterInstance[]>> m_instanceSlabs;
+	};
+}
@@ -19,12 +19,17 @@ namespace Particles
 		};
 
 		void Create(uint32_t maxValues, const ValueType* defaultValue = nullptr);
+		void CreateInPlace(uint32_t maxValues, void* storage);	// storage is owned by the caller
+		void Destroy();
 		uint32_t Wake(uint32_t count, const ValueType* defaultValue = nullptr);
 		void Kill(uint32_t index);
 		void SetValue(uint32_t index, const ValueType& t);
 		ValueType& GetValue(uint32_t index);
 		const ValueType& GetValue(uint32_t index) const;
 		inline const uint32_t AliveCount() const { return m_aliveCount; }
+		inline ValueType* Data() { return m_dataBuffer.get(); }
+		inline const ValueType* Data() const { return m_dataBuffer.get(); }
+		void Truncate(uint32_t aliveCount);		// drops everything after aliveCount, used after compaction
 
 	private:
 		std::unique_ptr<ValueType, std::function<void(ValueType*)>> m_dataBuffer;
@@ -1,3 +1,5 @@
+#include "core/aligned_alloc.h"
+
 namespace Particles
 {
 
@@ -27,7 +29,7 @@ namespace Particles
 	template<class ValueType>
 	inline void ParticleBuffer<ValueType>::Create(uint32_t maxValues, const ValueType* defaultValue)
 	{
-		void* rawBuffer = _aligned_malloc(maxValues * sizeof(ValueType), 16);
+		void* rawBuffer = Core::AlignedAlloc(maxValues * sizeof(ValueType), 16);
 		assert(rawBuffer);
 
 		ValueType* newValues = reinterpret_cast<ValueType*>(rawBuffer);
@@ -44,11 +46,30 @@ namespace Particles
 
 		auto deleter = [](ValueType* p)
 		{
-			_aligned_free(p);
+			Core::AlignedFree(p);
 		};
 		m_dataBuffer = std::unique_ptr<ValueType, decltype(deleter)>(newValues, deleter);
 	}
 
+	template<class ValueType>
+	inline void ParticleBuffer<ValueType>::CreateInPlace(uint32_t maxValues, void* storage)
+	{
+		m_maxValues = maxValues;
+		m_aliveCount = 0;
+		auto noDelete = [](ValueType* p)
+		{
+		};
+		m_dataBuffer = std::unique_ptr<ValueType, decltype(noDelete)>(reinterpret_cast<ValueType*>(storage), noDelete);
+	}
+
+	template<class ValueType>
+	inline void ParticleBuffer<ValueType>::Destroy()
+	{
+		m_dataBuffer = nullptr;
+		m_maxValues = 0;
+		m_aliveCount = 0;
+	}
+
 	template<class ValueType>
 	inline uint32_t ParticleBuffer<ValueType>::Wake(uint32_t count, const ValueType* defaultValue)
 	{
@@ -87,6 +108,13 @@ namespace Particles
 		}
 	}
 
+	template<class ValueType>
+	inline void ParticleBuffer<ValueType>::Truncate(uint32_t aliveCount)
+	{
+		assert(aliveCount <= m_aliveCount);
+		m_aliveCount = aliveCount;
+	}
+
 	template<class ValueType>
 	inline void ParticleBuffer<ValueType>::SetValue(uint32_t index, const ValueType& t)
 	{
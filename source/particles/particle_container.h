@@ -2,9 +2,11 @@
 
 #include "particle_buffer.h"
 #include "core/glm_headers.h"
+#include "core/random_stream.h"
 
 namespace Particles
 {
+	class ParticleArena;
 	class ParticleContainer
 	{
 	public:
@@ -12,7 +14,8 @@ namespace Particles
 		ParticleContainer(uint32_t maxParticles);
 		~ParticleContainer();
 
-		void Create(uint32_t maxParticles);
+		void Create(uint32_t maxParticles, ParticleArena* arena = nullptr);	// with an arena all buffers share one pooled block
+		void Destroy();
 
 		typedef __m128 PositionType;
 		typedef __m128 VelocityType;
@@ -33,16 +36,22 @@ namespace Particles
 		inline ParticleBuffer<LifetimeType>& Lifetimes() { return m_lifetime; }
 		inline const ParticleBuffer<EmitterID>& EmitterIDs() const { return m_emitterIDs; }
 		inline ParticleBuffer<EmitterID>& EmitterIDs() { return m_emitterIDs; }
+		inline Core::RandomStream& RandomStream() { return m_randomStream; }	// per-emitter, generators should use this instead of rand()
 
 		uint32_t Wake(uint32_t count, float spawnTime);
 		void Kill(uint32_t index);
+		uint32_t Compact(const uint8_t* killMask);	// removes all particles with killMask[i] != 0 from every buffer, returns # killed
 		inline uint32_t MaxParticles() const { return m_maxParticles; }
 		inline uint32_t AliveParticles() const { return m_livingParticles; }
 		inline size_t ParticleSizeBytes() const;
 
 	private:
-		uint32_t m_maxParticles;
-		uint32_t m_livingParticles;
+		static size_t BufferBytes(uint32_t maxParticles, size_t valueSize) { return (maxParticles * valueSize + 15) & ~(size_t)15; }
+		uint32_t m_maxParticles = 0;
+		uint32_t m_livingParticles = 0;
+		ParticleArena* m_arena = nullptr;
+		void* m_arenaBlock = nullptr;
+		size_t m_arenaBlockSize = 0;
 
 		ParticleBuffer<PositionType> m_position;
 		ParticleBuffer<VelocityType> m_velocity;
@@ -50,6 +59,7 @@ namespace Particles
 		ParticleBuffer<LifetimeType> m_lifetime;
 		ParticleBuffer<SpawnTimeType> m_spawntime;;
 		ParticleBuffer<EmitterID> m_emitterIDs;
+		Core::RandomStream m_randomStream;
 	};
 }
 #include "particle_container.inl"
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include "particle_arena.h"
+
 namespace Particles
 {
 	inline ParticleContainer::ParticleContainer(uint32_t maxParticles)
@@ -6,13 +8,12 @@ namespace Particles
 	}
 
 	inline ParticleContainer::ParticleContainer()
-		: m_maxParticles(0)
-		, m_livingParticles(0)
 	{
 	}
 
 	inline ParticleContainer::~ParticleContainer()
 	{
+		Destroy();
 	}
 
 	inline size_t ParticleContainer::ParticleSizeBytes() const
@@ -25,17 +26,61 @@ namespace Particles
 			m_emitterIDs.DataSize;
 	}
 
-	inline void ParticleContainer::Create(uint32_t maxParticles)
+	inline void ParticleContainer::Create(uint32_t maxParticles, ParticleArena* arena)
 	{
+		Destroy();
 		m_maxParticles = maxParticles;
 		m_livingParticles = 0;
 
-		m_position.Create(maxParticles);
-		m_velocity.Create(maxParticles);
-		m_colour.Create(maxParticles);
-		m_lifetime.Create(maxParticles);
-		m_spawntime.Create(maxParticles);
-		m_emitterIDs.Create(maxParticles);
+		if (arena != nullptr)
+		{
+			const size_t positionBytes = BufferBytes(maxParticles, m_position.DataSize);
+			const size_t velocityBytes = BufferBytes(maxParticles, m_velocity.DataSize);
+			const size_t colourBytes = BufferBytes(maxParticles, m_colour.DataSize);
+			const size_t lifetimeBytes = BufferBytes(maxParticles, m_lifetime.DataSize);
+			const size_t spawnTimeBytes = BufferBytes(maxParticles, m_spawntime.DataSize);
+			const size_t emitterIdBytes = BufferBytes(maxParticles, m_emitterIDs.DataSize);
+			m_arena = arena;
+			m_arenaBlockSize = positionBytes + velocityBytes + colourBytes + lifetimeBytes + spawnTimeBytes + emitterIdBytes;
+			m_arenaBlock = arena->AcquireBlock(m_arenaBlockSize);
+			assert(m_arenaBlock);
+
+			uint8_t* ptr = reinterpret_cast<uint8_t*>(m_arenaBlock);
+			m_position.CreateInPlace(maxParticles, ptr);		ptr += positionBytes;
+			m_velocity.CreateInPlace(maxParticles, ptr);		ptr += velocityBytes;
+			m_colour.CreateInPlace(maxParticles, ptr);			ptr += colourBytes;
+			m_lifetime.CreateInPlace(maxParticles, ptr);		ptr += lifetimeBytes;
+			m_spawntime.CreateInPlace(maxParticles, ptr);		ptr += spawnTimeBytes;
+			m_emitterIDs.CreateInPlace(maxParticles, ptr);
+		}
+		else
+		{
+			m_position.Create(maxParticles);
+			m_velocity.Create(maxParticles);
+			m_colour.Create(maxParticles);
+			m_lifetime.Create(maxParticles);
+			m_spawntime.Create(maxParticles);
+			m_emitterIDs.Create(maxParticles);
+		}
+	}
+
+	inline void ParticleContainer::Destroy()
+	{
+		m_position.Destroy();
+		m_velocity.Destroy();
+		m_colour.Destroy();
+		m_lifetime.Destroy();
+		m_spawntime.Destroy();
+		m_emitterIDs.Destroy();
+		if (m_arenaBlock != nullptr)
+		{
+			m_arena->ReleaseBlock(m_arenaBlock, m_arenaBlockSize);
+			m_arenaBlock = nullptr;
+			m_arenaBlockSize = 0;
+			m_arena = nullptr;
+		}
+		m_maxParticles = 0;
+		m_livingParticles = 0;
 	}
 
 	inline uint32_t ParticleContainer::Wake(uint32_t count, float spawnTime)
@@ -82,4 +127,47 @@ namespace Particles
 			--m_livingParticles;
 		}
 	}
+
+	// Stream compaction across all buffers in one pass, order of the survivors is preserved
+	// Every particle is copied and the write index only advances for survivors, so there are no branches on the kill mask
+	inline uint32_t ParticleContainer::Compact(const uint8_t* killMask)
+	{
+		uint32_t firstKill = 0;
+		while (firstKill < m_livingParticles && killMask[firstKill] == 0)
+		{
+			++firstKill;
+		}
+		if (firstKill == m_livingParticles)
+		{
+			return 0;
+		}
+
+		PositionType* positions = m_position.Data();
+		VelocityType* velocities = m_velocity.Data();
+		ColourType* colours = m_colour.Data();
+		LifetimeType* lifetimes = m_lifetime.Data();
+		SpawnTimeType* spawnTimes = m_spawntime.Data();
+		EmitterID* emitterIDs = m_emitterIDs.Data();
+		uint32_t writeIndex = firstKill;
+		for (uint32_t readIndex = firstKill; readIndex < m_livingParticles; ++readIndex)
+		{
+			positions[writeIndex] = positions[readIndex];
+			velocities[writeIndex] = velocities[readIndex];
+			colours[writeIndex] = colours[readIndex];
+			lifetimes[writeIndex] = lifetimes[readIndex];
+			spawnTimes[writeIndex] = spawnTimes[readIndex];
+			emitterIDs[writeIndex] = emitterIDs[readIndex];
+			writeIndex += killMask[readIndex] == 0 ? 1 : 0;
+		}
+
+		const uint32_t killed = m_livingParticles - writeIndex;
+		m_position.Truncate(writeIndex);
+		m_velocity.Truncate(writeIndex);
+		m_colour.Truncate(writeIndex);
+		m_lifetime.Truncate(writeIndex);
+		m_spawntime.Truncate(writeIndex);
+		m_emitterIDs.Truncate(writeIndex);
+		m_livingParticles = writeIndex;
+		return killed;
+	}
 }
\ No newline at end of file
@@ -45,6 +45,14 @@ namespace Particles
 	{
 	public:
 		virtual void Update(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container) = 0;
+
+		// Updaters that only touch particles in [startIndex, endIndex) and never kill/wake can be fused with their neighbours
+		// The update pipeline then calls UpdateRange on blocks of particles instead of Update
+		virtual bool CanFuse() { return false; }
+		virtual void UpdateRange(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container, uint32_t startIndex, uint32_t endIndex) {}
+		// Simple integrators are recognised by the update pipeline and run together in a single loop with no virtual calls
+		enum class Integrator { None, Gravity, EulerPosition };
+		virtual Integrator GetIntegrator() { return Integrator::None; }
 		virtual SERIALISED_CLASS() {}
 		virtual std::unique_ptr<UpdateBehaviour> MakeNew() = 0;
 		virtual std::string_view GetName() = 0;
@@ -5,6 +5,7 @@
 #include "engine/system_manager.h"
 #include "engine/debug_gui_system.h"
 #include "engine/debug_gui_menubar.h"
+#include "engine/file_watcher_system.h"
 #include "engine/graphics_system.h"
 #include "engine/script_system.h"
 #include "engine/renderer.h"
@@ -12,6 +13,8 @@
 #include "entity/entity_system.h"
 #include "components/component_particle_emitter.h"
 #include "core/timer.h"
+#include "core/log.h"
+#include <algorithm>
 
 namespace Particles
 {
@@ -40,10 +43,43 @@ namespace Particles
 		particles["SetUpdateEnabled"] = [this](bool v) {
 			m_updateEmitters = v;
 		};
+		particles["SetRandomSeed"] = [this](uint64_t seed) {
+			SetRandomSeed(seed);
+		};
+
+		auto fileWatcher = Engine::GetSystem<Engine::FileWatcherSystem>("FileWatcher");
+		if (fileWatcher != nullptr)
+		{
+			fileWatcher->RegisterChangeHandler([this](const std::string& path) {
+				InvalidateChangedEmitters(path);
+			});
+		}
 
 		return true;
 	}
 
+	void ParticleSystem::InvalidateChangedEmitters(const std::string& changedPath)
+	{
+		SDE_PROF_EVENT();
+
+		std::vector<std::string> changedEmitters;
+		{
+			Core::ScopedMutex lock(m_loadedEmittersMutex);
+			for (const auto& it : m_loadedEmitters)
+			{
+				if (Core::FileWatcher::NormalisePath(it.first) == changedPath)
+				{
+					changedEmitters.push_back(it.first);
+				}
+			}
+		}
+		for (const auto& path : changedEmitters)
+		{
+			SDE_LOG("Reloading emitter '%s'", path.c_str());
+			InvalidateEmitter(path);
+		}
+	}
+
 	bool ParticleSystem::LoadEmitter(std::string_view path, EmitterDescriptor& result)
 	{
 		SDE_PROF_EVENT();
@@ -85,7 +121,7 @@ namespace Particles
 		m_emittersToStop.push_back(emitterID);
 	}
 
-	ParticleSystem::EmitterID ParticleSystem::StartEmitter(std::string_view filename, glm::vec3 pos, glm::quat rot)
+	ParticleSystem::EmitterID ParticleSystem::StartEmitter(std::string_view filename, glm::vec3 pos, glm::quat rot, uint64_t randomStream)
 	{
 		SDE_PROF_EVENT();
 
@@ -110,15 +146,16 @@ namespace Particles
 		}
 		if (loadedEmitter)
 		{
-			auto newInstance = new EmitterInstance();
+			auto newInstance = m_arena.AcquireInstance();
 			newInstance->m_emitter = loadedEmitter;
-			newInstance->m_particles.Create(newInstance->m_emitter->GetMaxParticles());
+			newInstance->m_particles.Create(newInstance->m_emitter->GetMaxParticles(), &m_arena);
 			newInstance->m_position = pos;
 			newInstance->m_orientation = rot;
 			newInstance->m_timeActive = 0.0;
 
 			ActiveEmitter activeEmitter;
 			activeEmitter.m_id = m_nextEmitterId++;
+			newInstance->m_particles.RandomStream().Reset(m_randomSeed, randomStream != -1 ? randomStream : (uint64_t)activeEmitter.m_id << 32);
 			activeEmitter.m_instance = newInstance;
 			{
 				Core::ScopedMutex lock(m_startEmittersMutex);
@@ -166,9 +203,17 @@ namespace Particles
 		}
 
 		// Update pass - run on all particles
-		for (const auto& it : emitterDesc->GetUpdaters())
+		auto foundPipeline = m_fuseUpdaters ? m_updatePipelines.find(emitterDesc) : m_updatePipelines.end();
+		if (foundPipeline != m_updatePipelines.end())
 		{
-			it->Update(em.m_instance->m_position, em.m_instance->m_orientation, emitterAge, timeDelta, particles);		// Particles may be killed during this
+			foundPipeline->second.Run(em.m_instance->m_position, em.m_instance->m_orientation, emitterAge, timeDelta, particles);
+		}
+		else
+		{
+			for (const auto& it : emitterDesc->GetUpdaters())
+			{
+				it->Update(em.m_instance->m_position, em.m_instance->m_orientation, emitterAge, timeDelta, particles);		// Particles may be killed during this
+			}
 		}
 
 		em.m_instance->m_timeActive += timeDelta;
@@ -195,6 +240,8 @@ namespace Particles
 			{
 				foundEmitter->second->Reset();
 				LoadEmitter(path, *foundEmitter->second);
+				m_updatePipelines.erase(foundEmitter->second.get());
+				m_updateOrderDirty = true;
 			}
 		}
 		m_invalidatedEmitters.clear();
@@ -216,8 +263,20 @@ namespace Particles
 		statText = "Active Particles: " + std::to_string(particleCount);
 		dbgGui->Text(statText.c_str());
 
+		const auto arenaStats = m_arena.GetStats();
+		statText = "Emitter Instances: " + std::to_string(arenaStats.m_instancesActive) + " active, " + std::to_string(arenaStats.m_instancesAllocated) + " allocated, "
+			+ std::to_string(arenaStats.m_instancesReused) + " reused";
+		dbgGui->Text(statText.c_str());
+		statText = "Particle Blocks: " + std::to_string(arenaStats.m_blocksAllocated) + " allocated, " + std::to_string(arenaStats.m_blocksReused) + " reused, "
+			+ std::to_string(arenaStats.m_blocksFreed) + " freed";
+		dbgGui->Text(statText.c_str());
+		statText = "Particle Memory (KB): " + std::to_string(arenaStats.m_bytesActive / 1024) + " active, " + std::to_string(arenaStats.m_bytesPooled / 1024) + " pooled";
+		dbgGui->Text(statText.c_str());
+
 		float updateMs = float(m_lastUpdateTime * 1000.0);
 		float renderMs = float(m_lastRenderTime * 1000.0);
+		statText = "Update Pipelines: " + std::to_string(m_updatePipelines.size());
+		dbgGui->Text(statText.c_str());
 		statText = "Update Time(ms): " + std::to_string(updateMs);
 		dbgGui->Text(statText.c_str());
 		statText = "Render Time(ms): " + std::to_string(renderMs);
@@ -230,6 +289,7 @@ namespace Particles
 	{
 		SDE_PROF_EVENT();
 		Core::ScopedMutex lock(m_startEmittersMutex);
+		m_updateOrderDirty |= m_emittersToStart.size() > 0;
 		for (auto& toAdd : m_emittersToStart)
 		{
 			const EmitterID newId = toAdd.m_id;
@@ -245,17 +305,53 @@ namespace Particles
 		SDE_PROF_EVENT();
 		Core::ScopedTimer timeUpdate(m_lastUpdateTime);
 		auto jobs = Engine::GetSystem<Engine::JobSystem>("Jobs");
+		CompileUpdatePipelines();
 		if (m_updateEmittersAsync)
 		{
-			jobs->ForEachAsync(0, m_activeEmitters.size(), 1, 32, [this, timeDelta](int32_t i) {
-				UpdateActiveInstance(m_activeEmitters[i], 0.016f);
+			jobs->ForEachAsync(0, m_updateOrder.size(), 1, 32, [this, timeDelta](int32_t i) {
+				UpdateActiveInstance(m_activeEmitters[m_updateOrder[i]], 0.016f);
 			});
 		}
 		else
 		{
-			for (int i = 0; i < m_activeEmitters.size(); ++i)
+			for (int i = 0; i < m_updateOrder.size(); ++i)
 			{
-				UpdateActiveInstance(m_activeEmitters[i], 0.016f);
+				UpdateActiveInstance(m_activeEmitters[m_updateOrder[i]], 0.016f);
+			}
+		}
+	}
+
+	// Instances sharing a descriptor are updated together so they share one compiled pipeline (and its code/data stays hot)
+	// The order + pipelines are only rebuilt when emitters start, stop or are reloaded
+	void ParticleSystem::CompileUpdatePipelines()
+	{
+		SDE_PROF_EVENT();
+		if (!m_updateOrderDirty)
+		{
+			return;
+		}
+		m_updateOrderDirty = false;
+		m_updateOrder.resize(m_activeEmitters.size());
+		for (uint32_t i = 0; i < m_activeEmitters.size(); ++i)
+		{
+			m_updateOrder[i] = i;
+		}
+		std::sort(m_updateOrder.begin(), m_updateOrder.end(), [this](uint32_t a, uint32_t b) {
+			return m_activeEmitters[a].m_instance->m_emitter < m_activeEmitters[b].m_instance->m_emitter;
+		});
+
+		const EmitterDescriptor* lastDescriptor = nullptr;
+		for (auto index : m_updateOrder)
+		{
+			EmitterDescriptor* desc = m_activeEmitters[index].m_instance->m_emitter;
+			if (desc != lastDescriptor)
+			{
+				auto& pipeline = m_updatePipelines[desc];
+				if (!pipeline.IsCompiledFrom(*desc))
+				{
+					pipeline.Compile(*desc);
+				}
+				lastDescriptor = desc;
 			}
 		}
 	}
@@ -292,7 +388,7 @@ namespace Particles
 				const uint32_t emitterIndex = foundIt->second;
 
 				DoStopEmitter(*m_activeEmitters[emitterIndex].m_instance);
-				delete m_activeEmitters[emitterIndex].m_instance;	// pool these
+				m_arena.ReleaseInstance(m_activeEmitters[emitterIndex].m_instance);
 				m_activeEmitters[emitterIndex].m_instance = nullptr;
 
 				// swap back, update mappings
@@ -304,6 +400,7 @@ namespace Particles
 				}
 				m_activeEmitters.resize(m_activeEmitters.size() - 1);
 				assert(m_activeEmitterIDToIndex.size() == m_activeEmitters.size());
+				m_updateOrderDirty = true;
 			}
 		}
 	}
@@ -387,6 +484,9 @@ namespace Particles
 		particlesMenu.AddItem(m_renderEmittersAsync ? "Disable async render" : "Enable async render", [this]() {
 			m_renderEmittersAsync = !m_renderEmittersAsync;
 		});
+		particlesMenu.AddItem(m_fuseUpdaters ? "Disable fused update" : "Enable fused update", [this]() {
+			m_fuseUpdaters = !m_fuseUpdaters;
+		});
 		particlesMenu.AddItem("Show stats", [this]() {
 			m_showStats = true;
 		});
@@ -3,6 +3,8 @@
 #include "core/glm_headers.h"
 #include "core/mutex.h"
 #include "emitter_descriptor.h"
+#include "update_pipeline.h"
+#include "particle_arena.h"
 #include <robin_hood.h>
 #include <string_view>
 #include <memory>
@@ -17,7 +19,10 @@ namespace Particles
 		virtual ~ParticleSystem();
 		using EmitterID = uint32_t;
 		void InvalidateEmitter(std::string_view filename);	// force reload
-		EmitterID StartEmitter(std::string_view filename, glm::vec3 pos = glm::vec3(0, 0, 0), glm::quat rot = glm::quat());
+		// randomStream selects the emitters random numbers, by default it is derived from the emitter id
+		// Emitters started from other emitters should pass a value from the parents stream so they are deterministic
+		EmitterID StartEmitter(std::string_view filename, glm::vec3 pos = glm::vec3(0, 0, 0), glm::quat rot = glm::quat(), uint64_t randomStream = -1);
+		void SetRandomSeed(uint64_t seed) { m_randomSeed = seed; }
 		void StopEmitter(EmitterID emitterID);
 		bool SetEmitterTransform(EmitterID emitterID, glm::vec3 pos = glm::vec3(0, 0, 0), glm::quat rot = glm::quat());
 		virtual bool PostInit();
@@ -36,9 +41,12 @@ namespace Particles
 		void StopEmitters();
 		void RenderEmitters(float timeDelta);
 		void ReloadInvalidatedEmitters();
+		void InvalidateChangedEmitters(const std::string& changedPath);	// from the file watcher
 		void DoStopEmitter(EmitterInstance& i);
 		void UpdateEmitterComponents();
+		void CompileUpdatePipelines();
 
+		ParticleArena m_arena;	// declared first so it is destroyed last
 		Core::Mutex m_loadedEmittersMutex;
 		std::unordered_map<std::string, std::unique_ptr<EmitterDescriptor>> m_loadedEmitters;
 		bool m_updateEmitters = true;
@@ -46,6 +54,11 @@ namespace Particles
 		bool m_renderEmitters = true;
 		bool m_renderEmittersAsync = true;
 		bool m_showStats = false;
+		bool m_fuseUpdaters = true;
+		uint64_t m_randomSeed = 0;
+		robin_hood::unordered_map<const EmitterDescriptor*, UpdatePipeline> m_updatePipelines;	// compiled once per descriptor, removed when it is reloaded
+		std::vector<uint32_t> m_updateOrder;	// active emitter indices grouped by descriptor
+		bool m_updateOrderDirty = true;			// emitters were started/stopped/reloaded since the order was built
 		robin_hood::unordered_map<EmitterID, uint32_t> m_activeEmitterIDToIndex;
 		std::vector<ActiveEmitter> m_activeEmitters;
 		Core::Mutex m_startEmittersMutex;
@@ -0,0 +1,150 @@
+#include "update_pipeline.h"
+#include "emitter_descriptor.h"
+#include "particle_container.h"
+#include "core/profiler.h"
+#include "behaviours/gravity_update.h"
+
+namespace Particles
+{
+	void UpdatePipeline::Compile(EmitterDescriptor& desc)
+	{
+		SDE_PROF_EVENT();
+		m_stages.clear();
+		m_compiledFrom.clear();
+		for (const auto& it : desc.GetUpdaters())
+		{
+			const bool canFuse = it->CanFuse();
+			if (m_stages.size() == 0 || !canFuse || !m_stages.back().m_fused)
+			{
+				m_stages.push_back({});
+				m_stages.back().m_fused = canFuse;
+			}
+			m_stages.back().m_behaviours.push_back(it.get());
+			m_compiledFrom.push_back(it.get());
+		}
+		for (auto& stage : m_stages)
+		{
+			CompileIntegration(stage);
+		}
+	}
+
+	bool UpdatePipeline::IsCompiledFrom(EmitterDescriptor& desc) const
+	{
+		const auto& updaters = desc.GetUpdaters();
+		if (updaters.size() != m_compiledFrom.size())
+		{
+			return false;
+		}
+		for (size_t i = 0; i < updaters.size(); ++i)
+		{
+			if (updaters[i].get() != m_compiledFrom[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void UpdatePipeline::CompileIntegration(Stage& stage)
+	{
+		// only stages with at most one of each integrator can be replaced
+		int gravityCount = 0, positionCount = 0;
+		for (auto b : stage.m_behaviours)
+		{
+			const auto integrator = b->GetIntegrator();
+			gravityCount += integrator == UpdateBehaviour::Integrator::Gravity ? 1 : 0;
+			positionCount += integrator == UpdateBehaviour::Integrator::EulerPosition ? 1 : 0;
+			if (integrator == UpdateBehaviour::Integrator::None)
+			{
+				return;
+			}
+		}
+		if (!stage.m_fused || gravityCount > 1 || positionCount > 1)
+		{
+			return;
+		}
+		stage.m_integrate = true;
+		stage.m_applyGravity = gravityCount > 0;
+		stage.m_integratePosition = positionCount > 0;
+		stage.m_gravityFirst = stage.m_behaviours[0]->GetIntegrator() == UpdateBehaviour::Integrator::Gravity;
+	}
+
+	void UpdatePipeline::RunIntegration(const Stage& stage, float deltaTime, ParticleContainer& container)
+	{
+		SDE_PROF_EVENT();
+		const glm::vec4 gravity = stage.m_applyGravity ? glm::vec4(GravityUpdate::GetGravity(), 0.0f) : glm::vec4(0.0f);
+		__declspec(align(16)) const glm::vec4 c_deltaTime(deltaTime);
+		const __m128 c_deltaVec = _mm_load_ps(glm::value_ptr(c_deltaTime));
+		const __m128 c_gravMulDelta = _mm_mul_ps(_mm_loadu_ps(glm::value_ptr(gravity)), c_deltaVec);
+		const uint32_t endIndex = container.AliveParticles();
+		if (!stage.m_integratePosition)
+		{
+			for (uint32_t i = 0; i < endIndex; ++i)
+			{
+				__m128& v = container.Velocities().GetValue(i);
+				v = _mm_add_ps(v, c_gravMulDelta);
+			}
+		}
+		else if (stage.m_gravityFirst)
+		{
+			for (uint32_t i = 0; i < endIndex; ++i)
+			{
+				__m128& v = container.Velocities().GetValue(i);
+				__m128& p = container.Positions().GetValue(i);
+				v = _mm_add_ps(v, c_gravMulDelta);
+				p = _mm_add_ps(p, _mm_mul_ps(v, c_deltaVec));
+			}
+		}
+		else
+		{
+			for (uint32_t i = 0; i < endIndex; ++i)
+			{
+				__m128& v = container.Velocities().GetValue(i);
+				__m128& p = container.Positions().GetValue(i);
+				p = _mm_add_ps(p, _mm_mul_ps(v, c_deltaVec));
+				v = _mm_add_ps(v, c_gravMulDelta);	// zero if there is no gravity
+			}
+		}
+	}
+
+	uint32_t UpdatePipeline::GetFusedBehaviourCount() const
+	{
+		uint32_t count = 0;
+		for (const auto& stage : m_stages)
+		{
+			count += stage.m_fused ? (uint32_t)stage.m_behaviours.size() : 0;
+		}
+		return count;
+	}
+
+	void UpdatePipeline::Run(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container) const
+	{
+		SDE_PROF_EVENT();
+		for (const auto& stage : m_stages)
+		{
+			if (stage.m_integrate)
+			{
+				RunIntegration(stage, deltaTime, container);
+			}
+			else if (stage.m_fused)
+			{
+				const uint32_t endIndex = container.AliveParticles();
+				for (uint32_t block = 0; block < endIndex; block += c_blockSize)
+				{
+					const uint32_t blockEnd = glm::min(block + c_blockSize, endIndex);
+					for (auto b : stage.m_behaviours)
+					{
+						b->UpdateRange(emitterPos, orientation, emitterAge, deltaTime, container, block, blockEnd);
+					}
+				}
+			}
+			else
+			{
+				for (auto b : stage.m_behaviours)
+				{
+					b->Update(emitterPos, orientation, emitterAge, deltaTime, container);	// Particles may be killed during this
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "core/glm_headers.h"
+#include <vector>
+
+namespace Particles
+{
+	class EmitterDescriptor;
+	class UpdateBehaviour;
+	class ParticleContainer;
+
+	// Compiled form of an emitter descriptors update behaviours
+	// Consecutive fusable updaters are run together on small blocks of particles, so each block is only pulled
+	// into cache once per frame instead of once per behaviour. Anything else (e.g. killing particles) runs as before
+	// Stages made only of gravity/euler integration are fused into a single loop over the particles
+	class UpdatePipeline
+	{
+	public:
+		void Compile(EmitterDescriptor& desc);
+		void Run(glm::vec3 emitterPos, glm::quat orientation, double emitterAge, float deltaTime, ParticleContainer& container) const;
+		uint32_t GetStageCount() const { return (uint32_t)m_stages.size(); }
+		uint32_t GetFusedBehaviourCount() const;
+		bool IsCompiledFrom(EmitterDescriptor& desc) const;	// false if the descriptors updaters changed since Compile
+
+		static constexpr uint32_t c_blockSize = 512;	// position + velocity for a block fits in L1
+	private:
+		struct Stage
+		{
+			std::vector<UpdateBehaviour*> m_behaviours;
+			bool m_fused = false;
+			bool m_integrate = false;			// behaviours are replaced by one loop
+			bool m_applyGravity = false;
+			bool m_integratePosition = false;
+			bool m_gravityFirst = false;
+		};
+		static void CompileIntegration(Stage& stage);
+		static void RunIntegration(const Stage& stage, float deltaTime, ParticleContainer& container);
+		std::vector<Stage> m_stages;
+		std::vector<UpdateBehaviour*> m_compiledFrom;
+	};
+}
@@ -50,6 +50,7 @@ public:
 	// blackboard
 	Blackboard* GetBlackboard() { return &m_blackboard; }
 	void SetVisibleEntities(std::vector<EntityHandle>&& e) { m_visibleEntities = std::move(e); }
+	void SetVisibleEntities(const EntityHandle* e, size_t count) { m_visibleEntities.assign(e, e + count); }	// reuses existing storage
 	const std::vector<EntityHandle>& GetVisibleEntities() const { return m_visibleEntities; }
 	
 	// states and behaviours are simply tags
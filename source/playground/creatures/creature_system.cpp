@@ -1,6 +1,5 @@
 #include "creature_system.h"
 #include "core/log.h"
-#include "core/thread.h"
 #include "engine/system_manager.h"
 #include "engine/graphics_system.h"
 #include "engine/debug_render.h"
@@ -13,8 +12,6 @@
 #include "behaviour_library.h"
 #include "blackboard.h"
 
-glm::vec2 c_gridCellSize = {128.0f,128.0f};
-
 CreatureSystem::CreatureSystem()
 {
 
@@ -116,196 +113,24 @@ void CreatureSystem::Reset()
 	AddBehaviour("flee_enemy", BehaviourLibrary::Flee(*m_entitySystem, *m_graphicsSystem));
 }
 
-uint64_t VisHash(const glm::vec3& p)
-{
-	const auto i = glm::floor(p) / glm::vec3(c_gridCellSize.x, 1.0f, c_gridCellSize.y);
-	auto gridcell = (glm::ivec3)i;
-	return (uint64_t)(gridcell.x) << 32 | (uint64_t)gridcell.z;
-}
-
-uint64_t VisHash(const glm::ivec2& p)
-{
-	auto x = (((uint64_t)p.x) & 0x00000000ffffffff) << 32;
-	auto y = ((uint64_t)p.y) & 0x00000000ffffffff;
-	return x | y;
-}
-
-void CreatureSystem::UpdateVision(const std::vector<VisibilityRecord>& allCreatures, robin_hood::unordered_map<uint64_t, std::vector<VisibilityRecord>>& grid, Creature& looker, glm::vec3 pos)
-{
-	SDE_PROF_EVENT();
-
-	using VisRecord = std::pair<VisibilityRecord, float>;	// keep distance to creature for later
-	std::vector<VisRecord> visibleCreatures;
-	visibleCreatures.reserve(32);
-
-	const auto visionRadiusSq = looker.GetVisionRadius() * looker.GetVisionRadius();
-	const auto minBounds = glm::ivec3(glm::floor(pos - looker.GetVisionRadius()) / glm::vec3(c_gridCellSize.x, 1.0f, c_gridCellSize.y));
-	const auto maxBounds = glm::ivec3(glm::floor(pos + looker.GetVisionRadius()) / glm::vec3(c_gridCellSize.x, 1.0f, c_gridCellSize.y));
-	const auto tagCount = looker.GetVisionTags().size();
-	for (int gridx = minBounds.x; gridx <= maxBounds.x; ++gridx)
-	{
-		for (int gridz = minBounds.z; gridz <= maxBounds.z; ++gridz)
-		{
-			const uint64_t gridHash = VisHash(glm::ivec2(gridx, gridz));
-			const auto foundCell = grid.find(gridHash);
-			if (foundCell != grid.end())
-			{
-				for (const auto& record : foundCell->second)
-				{
-					const auto c = std::get<0>(record);
-					if (&looker != c)
-					{
-						float d = glm::distance2(std::get<3>(record), pos);		// distance squared
-						if (d < visionRadiusSq)
-						{
-							bool canSeeObject = tagCount == 0;
-							const auto tags = std::get<1>(record);
-							if (tags && tagCount > 0)
-							{
-								for (const auto& t : looker.GetVisionTags())
-								{
-									canSeeObject |= tags->ContainsTag(t);
-									if (canSeeObject)
-										break;
-								}
-							}
-							if (canSeeObject)
-							{
-								visibleCreatures.push_back({ record, d });
-							}
-						}
-					}
-				}
-			}
-		}
-	}
-
-	std::sort(visibleCreatures.begin(), visibleCreatures.end(), [](const VisRecord& s0, const VisRecord& s1)
-		{
-			return std::get<1>(s0) < std::get<1>(s1);
-		});
-	std::vector<EntityHandle> visibleEntities;
-	auto entitiesToAdd = glm::min((uint32_t)visibleCreatures.size(), looker.GetMaxVisibleEntities());
-	visibleEntities.reserve(entitiesToAdd);
-	for (int i = 0; i < entitiesToAdd; ++i)
-	{
-		visibleEntities.push_back(std::get<2>(std::get<0>(visibleCreatures[i])));
-	}
-	looker.SetVisibleEntities(std::move(visibleEntities));
-}
-
-void CreatureSystem::UpdateVision(const std::vector<VisibilityRecord>& allCreatures, Creature& looker, glm::vec3 pos)
-{
-	SDE_PROF_EVENT();
-
-	using VisRecord = std::pair<VisibilityRecord, float>;	// keep distance to creature for later
-	std::vector<VisRecord> visibleCreatures;
-	visibleCreatures.reserve(allCreatures.size());
-	const auto tagCount = looker.GetVisionTags().size();
-	for (const auto& oneCreature : allCreatures)
-	{
-		auto [c, tags, owner, testpos] = oneCreature;
-		if (&looker != c)
-		{
-			bool canSeeObject = true;
-			if (tagCount > 0)
-			{
-				if (tags)
-				{
-					bool tagMatch = false;
-					for (const auto& t : looker.GetVisionTags())
-					{
-						tagMatch |= tags->ContainsTag(t);
-						if (tagMatch)
-							break;
-					}
-					canSeeObject = tagMatch;
-				}
-			}
-			if (canSeeObject)
-			{
-				// use distance based on x and z axis only!
-				float d = glm::distance(testpos, pos);
-				if (d < looker.GetVisionRadius())
-				{
-					visibleCreatures.push_back({ oneCreature, d });
-				}
-			}
-		}
-	}
-
-	std::sort(visibleCreatures.begin(), visibleCreatures.end(), [](const VisRecord& s0, const VisRecord& s1)
-	{
-		return std::get<1>(s0) < std::get<1>(s1);
-	});
-	std::vector<EntityHandle> visibleEntities;
-	auto entitiesToAdd = glm::min((uint32_t)visibleCreatures.size(), looker.GetMaxVisibleEntities());
-	visibleEntities.reserve(entitiesToAdd);
-	for (int i = 0; i < entitiesToAdd; ++i)
-	{
-		visibleEntities.push_back(std::get<2>(std::get<0>(visibleCreatures[i])));
-	}
-	looker.SetVisibleEntities(std::move(visibleEntities));
-}
-
-void CreatureSystem::UpdateVision(Creature& looker, glm::vec3 pos)
+// Populate the full list of creatures along with their positions and tags, and which of them need vis queries
+void CreatureSystem::CollectCreatures()
 {
 	SDE_PROF_EVENT();
 
 	auto world = m_entitySystem->GetWorld();
 	auto transforms = world->GetAllComponents<Transform>();
-	auto tags = world->GetAllComponents<Tags>();
-	using VisRecord = std::pair<EntityHandle, float>;
-	std::vector<VisRecord> visibleCreatures;
-	visibleCreatures.reserve(32);
-	std::vector<EntityHandle> visibleEntities;
-	const auto tagCount = looker.GetVisionTags().size();
-	world->ForEachComponent<Creature>([this, &transforms, &tagCount , &tags, pos, &looker, &visibleCreatures](Creature& c, EntityHandle owner) {
-		if (&looker != &c)
+	auto alltags = world->GetAllComponents<Tags>();
+	m_vision.Clear();
+	world->ForEachComponent<Creature>([&](Creature& c, EntityHandle owner) {
+		auto transform = transforms->Find(owner);
+		auto tags = alltags->Find(owner);
+		if (transform != nullptr)
 		{
-			bool canSeeObject = true;
-			if (tags && tagCount > 0)
-			{
-				auto foundTags = tags->Find(owner);
-				if (foundTags != nullptr)
-				{
-					bool tagMatch = false;
-					for (const auto& t : looker.GetVisionTags())
-					{
-						tagMatch |= foundTags->ContainsTag(t);
-						if (tagMatch)
-							break;
-					}
-					canSeeObject = tagMatch;
-				}
-			}
-			if (canSeeObject)
-			{
-				auto trans = transforms->Find(owner);
-				if (trans)
-				{
-					// use distance based on x and z axis only!
-					auto p = trans->GetPosition();
-					float d = glm::distance(p, pos);
-					if (d < looker.GetVisionRadius())
-					{
-						visibleCreatures.push_back({ owner,d });
-					}
-				}
-			}
+			const bool canSee = c.GetVisionRadius() > 0.0f && c.GetEnergy() > 0.0f && c.GetState() != "dead";
+			m_vision.Add(transform->GetPosition(), c, tags, owner, canSee);
 		}
 	});
-	std::sort(visibleCreatures.begin(), visibleCreatures.end(), [](const VisRecord& s0, const VisRecord& s1)
-	{
-		return s0.second < s1.second;
-	});
-	auto maxToCollect = glm::min((uint32_t)visibleCreatures.size(), looker.GetMaxVisibleEntities());
-	visibleEntities.reserve(maxToCollect);
-	for (int i = 0; i < maxToCollect; ++i)
-	{
-		visibleEntities.push_back(visibleCreatures[i].first);
-	}
-	looker.SetVisibleEntities(std::move(visibleEntities));
 }
 
 bool CreatureSystem::Tick(float timeDelta)
@@ -314,74 +139,11 @@ bool CreatureSystem::Tick(float timeDelta)
 
 	auto world = m_entitySystem->GetWorld();
 	auto transforms = world->GetAllComponents<Transform>();
-	auto alltags = world->GetAllComponents<Tags>();
 
-	// Populate the full list of creatures along with their positions and tags
-	// Also populate of creatures that need vis queries
-	robin_hood::unordered_map<uint64_t, std::vector<VisibilityRecord>> grid;	// indexes into allcreatures
-	std::vector<VisibilityRecord> allCreatures;
-	std::vector<VisibilityRecord> creaturesToUpdate;
-	{
-		SDE_PROF_EVENT("CollectAll");
-		allCreatures.reserve(8000);
-		creaturesToUpdate.reserve(2000);
-		world->ForEachComponent<Creature>([&allCreatures, &grid, &creaturesToUpdate, &alltags, &transforms](Creature& c, EntityHandle owner) {
-			auto transform = transforms->Find(owner);
-			auto tags = alltags->Find(owner);
-			if (transform != nullptr)
-			{
-				auto hash = VisHash(transform->GetPosition());
-				VisibilityRecord r = { &c, tags, owner, transform->GetPosition() };
-				allCreatures.push_back(r);
-				grid[hash].push_back(r);
-				if (c.GetVisionRadius() > 0.0f && c.GetEnergy() > 0.0f && c.GetState() != "dead")
-				{
-					creaturesToUpdate.push_back(r);
-				}
-			}
-		});
-	}
+	CollectCreatures();
+	m_vision.Build();
 	const bool s_useJobs = true;
-	if(!s_useJobs)
-	{
-		SDE_PROF_EVENT("TestVisNaive");
-		for (const auto& c : creaturesToUpdate)
-		{
-			auto creature = std::get<0>(c);
-			UpdateVision(allCreatures, grid, *creature, std::get<3>(c));
-		}
-	}
-	else
-	{
-		SDE_PROF_EVENT("TestVisJobs");
-		const int c_testsPerJob = 32;
-		std::atomic<int> jobsRemaining = 0;
-		for (int c = 0; c < creaturesToUpdate.size(); c += c_testsPerJob)
-		{
-			int startIndex = c;
-			int endIndex = std::min(c + c_testsPerJob, (int)creaturesToUpdate.size());
-			auto visJob = [this,&allCreatures,&grid,&creaturesToUpdate,&jobsRemaining,startIndex,endIndex](void*)
-			{
-				SDE_PROF_EVENT("VisJob");
-				for (int index = startIndex; index < endIndex; ++index)
-				{
-					auto creature = std::get<0>(creaturesToUpdate[index]);
-					UpdateVision(allCreatures, grid, *creature, std::get<3>(creaturesToUpdate[index]));
-				}
-				jobsRemaining--;
-			};
-			jobsRemaining++;
-			m_jobSystem->PushJob(visJob);
-		}
-		{
-			SDE_PROF_STALL("WaitForVisJobs");
-			while (jobsRemaining > 0)
-			{	
-				m_jobSystem->ProcessJobThisThread();
-				Core::Thread::Sleep(0);
-			}
-		}
-	}
+	m_vision.UpdateAll(s_useJobs ? m_jobSystem : nullptr);
 
 	// tick all behaviours for current state
 	{
@@ -5,11 +5,11 @@
 #include "entity/entity_handle.h"
 #include "core/glm_headers.h"
 #include "component_creature.h"
+#include "creature_vision.h"
 #include <robin_hood.h>
 
 class EntitySystem;
 class GraphicsSystem;
-class Tags;
 
 namespace Engine
 {
@@ -31,10 +31,9 @@ public:
 	void AddScriptBehaviour(Engine::Tag tag, sol::protected_function fn);
 	void AddBehaviour(Engine::Tag tag, Creature::Behaviour b);
 private:
-	using VisibilityRecord = std::tuple<Creature*, Tags*, EntityHandle, glm::vec3>;
-	void __vectorcall UpdateVision(const std::vector<VisibilityRecord>& allCreatures, robin_hood::unordered_map<uint64_t, std::vector<VisibilityRecord>>& grid, Creature& c, glm::vec3 pos);
-	void UpdateVision(const std::vector<VisibilityRecord>& allCreatures, Creature& c, glm::vec3 pos);
-	void UpdateVision(Creature& c, glm::vec3 pos);	// old
+	void CollectCreatures();
+
+	CreatureVision m_vision;
 	EntitySystem* m_entitySystem = nullptr;
 	GraphicsSystem* m_graphicsSystem = nullptr;
 	Engine::ScriptSystem* m_scriptSystem = nullptr;
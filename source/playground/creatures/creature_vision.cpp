@@ -0,0 +1,161 @@
+#include "creature_vision.h"
+#include "component_creature.h"
+#include "engine/job_system.h"
+#include "engine/components/component_tags.h"
+#include "core/profiler.h"
+#include <algorithm>
+
+const glm::vec2 c_gridCellSize = { 128.0f, 128.0f };
+
+CreatureVision::CreatureVision()
+	: m_visibilityGrid(c_gridCellSize)
+{
+}
+
+void CreatureVision::Clear()
+{
+	m_allCreatures.clear();
+	m_creaturesToUpdate.clear();
+	m_visionTagBits.clear();
+	m_visibilityGrid.Reset();
+}
+
+// every tag a looker can see gets a bit, records are given their bits in Build once all the lookers are known
+void CreatureVision::Add(glm::vec3 position, Creature& c, Tags* tags, EntityHandle owner, bool canSee)
+{
+	if (canSee)
+	{
+		m_creaturesToUpdate.push_back((uint32_t)m_allCreatures.size());
+		for (const auto& t : c.GetVisionTags())
+		{
+			if (m_visionTagBits.size() < 64 && m_visionTagBits.find(t.GetHash()) == m_visionTagBits.end())
+			{
+				m_visionTagBits[t.GetHash()] = 1ull << m_visionTagBits.size();
+			}
+		}
+	}
+	m_allCreatures.push_back({ position, &c, tags, owner, 0 });
+}
+
+void CreatureVision::Build()
+{
+	SDE_PROF_EVENT();
+	for (auto& record : m_allCreatures)
+	{
+		if (record.m_tags != nullptr)
+		{
+			for (const auto& t : record.m_tags->AllTags())
+			{
+				auto foundBit = m_visionTagBits.find(t.GetHash());
+				if (foundBit != m_visionTagBits.end())
+				{
+					record.m_visionTagBits |= foundBit->second;
+				}
+			}
+		}
+	}
+	m_visibilityGrid.Reset();
+	for (const auto& record : m_allCreatures)
+	{
+		m_visibilityGrid.AddEntry(record.m_position, record.m_position, record);
+	}
+	m_visibilityGrid.Build();
+}
+
+void CreatureVision::UpdateVision(Creature& looker, glm::vec3 pos)
+{
+	SDE_PROF_EVENT();
+
+	// per-thread scratch, reused across lookers and frames
+	using VisRecord = std::pair<float, EntityHandle>;	// distance squared
+	static thread_local std::vector<VisRecord> visibleCreatures;
+	static thread_local std::vector<EntityHandle> visibleEntities;
+	visibleCreatures.clear();
+
+	// tags map to bits unless there were more than 64 unique vision tags, then fall back to testing each tag
+	const auto tagCount = looker.GetVisionTags().size();
+	uint64_t lookerTagBits = 0;
+	bool allTagsHaveBits = true;
+	for (const auto& t : looker.GetVisionTags())
+	{
+		auto foundBit = m_visionTagBits.find(t.GetHash());
+		if (foundBit != m_visionTagBits.end())
+		{
+			lookerTagBits |= foundBit->second;
+		}
+		else
+		{
+			allTagsHaveBits = false;
+		}
+	}
+
+	const auto visionRadiusSq = looker.GetVisionRadius() * looker.GetVisionRadius();
+	const glm::vec3 visionExtents(looker.GetVisionRadius());
+	m_visibilityGrid.ForEachNearby(pos - visionExtents, pos + visionExtents, [&](const VisibilityRecord& record) {
+		if (&looker == record.m_creature)
+		{
+			return;
+		}
+		const float d = glm::distance2(record.m_position, pos);
+		if (d >= visionRadiusSq)
+		{
+			return;
+		}
+		bool canSeeObject = tagCount == 0;
+		if (record.m_tags && tagCount > 0)
+		{
+			canSeeObject = (record.m_visionTagBits & lookerTagBits) != 0;
+			if (!canSeeObject && !allTagsHaveBits)
+			{
+				for (const auto& t : looker.GetVisionTags())
+				{
+					canSeeObject |= record.m_tags->ContainsTag(t);
+					if (canSeeObject)
+						break;
+				}
+			}
+		}
+		if (canSeeObject)
+		{
+			visibleCreatures.push_back({ d, record.m_owner });
+		}
+	});
+
+	// only the closest GetMaxVisibleEntities() are kept
+	const auto byDistance = [](const VisRecord& s0, const VisRecord& s1) {
+		return s0.first < s1.first;
+	};
+	const auto entitiesToAdd = glm::min((uint32_t)visibleCreatures.size(), looker.GetMaxVisibleEntities());
+	if (entitiesToAdd < visibleCreatures.size())
+	{
+		std::nth_element(visibleCreatures.begin(), visibleCreatures.begin() + entitiesToAdd, visibleCreatures.end(), byDistance);
+	}
+	std::sort(visibleCreatures.begin(), visibleCreatures.begin() + entitiesToAdd, byDistance);
+	visibleEntities.clear();
+	for (uint32_t i = 0; i < entitiesToAdd; ++i)
+	{
+		visibleEntities.push_back(visibleCreatures[i].second);
+	}
+	looker.SetVisibleEntities(visibleEntities.data(), visibleEntities.size());
+}
+
+void CreatureVision::UpdateAll(Engine::JobSystem* jobs)
+{
+	if (jobs == nullptr)
+	{
+		SDE_PROF_EVENT("TestVisNaive");
+		for (const auto& c : m_creaturesToUpdate)
+		{
+			UpdateVision(*m_allCreatures[c].m_creature, m_allCreatures[c].m_position);
+		}
+	}
+	else
+	{
+		SDE_PROF_EVENT("TestVisJobs");
+		const int c_testsPerJob = 64;
+		jobs->ForEachAsync(0, (int)m_creaturesToUpdate.size(), 1, c_testsPerJob, [this](int32_t index) {
+			const auto& record = m_allCreatures[m_creaturesToUpdate[index]];
+			UpdateVision(*record.m_creature, record.m_position);
+		});
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "core/glm_headers.h"
+#include "entity/entity_handle.h"
+#include "engine/entity_grid.h"
+#include <robin_hood.h>
+#include <vector>
+
+class Creature;
+class Tags;
+
+namespace Engine
+{
+	class JobSystem;
+}
+
+// Finds the closest visible creatures for every creature that looks around, rebuilt each frame
+// Creatures are added, then Build() makes the grid and UpdateAll() sets each lookers visible entities
+// Storage is kept between frames
+class CreatureVision
+{
+public:
+	CreatureVision();
+	void Clear();
+	void Add(glm::vec3 position, Creature& c, Tags* tags, EntityHandle owner, bool canSee);	// canSee = update this creatures vision
+	void Build();
+	void UpdateAll(Engine::JobSystem* jobs);	// runs serially if jobs is null
+
+private:
+	struct VisibilityRecord
+	{
+		glm::vec3 m_position;
+		Creature* m_creature;
+		Tags* m_tags;
+		EntityHandle m_owner;
+		uint64_t m_visionTagBits;	// one bit per tag in m_visionTagBits
+	};
+	void UpdateVision(Creature& looker, glm::vec3 pos);
+
+	std::vector<VisibilityRecord> m_allCreatures;
+	std::vector<uint32_t> m_creaturesToUpdate;				// indexes into m_allCreatures
+	WorldGrid<VisibilityRecord> m_visibilityGrid;
+	robin_hood::unordered_map<uint32_t, uint64_t> m_visionTagBits;	// tag hash -> bit, for every tag any creature looks for (first 64)
+};
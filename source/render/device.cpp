@@ -266,6 +266,16 @@ namespace Render
 		glFlush();	// Ensures any writes in shared contexts are pushed to all of them
 	}
 
+	std::string Device::GetDriverName()
+	{
+		const GLubyte* vendor = glGetString(GL_VENDOR);
+		const GLubyte* renderer = glGetString(GL_RENDERER);
+		const GLubyte* version = glGetString(GL_VERSION);
+		char name[1024] = { '\0' };
+		sprintf_s(name, "%s-%s-%s", vendor, renderer, version);
+		return name;
+	}
+
 	void Device::SetGLContext(void* context)
 	{
 		SDL_GL_MakeCurrent(m_window.GetWindowHandle(), context);
@@ -549,7 +559,7 @@ namespace Render
 		glMultiDrawElementsIndirect(primitiveType, GL_UNSIGNED_INT, offsetPtr, drawCount, 0);
 	}
 
-	void Device::DrawPrimitivesInstancedIndexed(PrimitiveType primitive, uint32_t indexStart, uint32_t indexCount, uint32_t instanceCount, uint32_t firstInstance)
+	void Device::DrawPrimitivesInstancedIndexed(PrimitiveType primitive, uint32_t indexStart, uint32_t indexCount, uint32_t instanceCount, uint32_t firstInstance, int32_t baseVertex)
 	{
 		SDE_PROF_EVENT();
 
@@ -558,7 +568,7 @@ namespace Render
 
 		// this is confusing as hell, but the 4th param is not a pointer, but an OFFSET into the element (index) buffer
 		const void* indexDataPtr = (void*)(indexStart * sizeof(uint32_t));
-		glDrawElementsInstancedBaseVertexBaseInstance(primitiveType, indexCount, GL_UNSIGNED_INT, indexDataPtr, instanceCount, 0, firstInstance);
+		glDrawElementsInstancedBaseVertexBaseInstance(primitiveType, indexCount, GL_UNSIGNED_INT, indexDataPtr, instanceCount, baseVertex, firstInstance);
 	}
 
 	void Device::DrawPrimitivesInstanced(PrimitiveType primitive, uint32_t vertexStart, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstInstance)
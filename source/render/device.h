@@ -3,6 +3,7 @@
 #include "core/glm_headers.h"
 #include "render/fence.h"
 #include <stdint.h>
+#include <string>
 
 namespace Render
 {
@@ -87,6 +88,7 @@ namespace Render
 		void* CreateSharedGLContext();
 		void* GetGLContext();
 		static void FlushContext();
+		static std::string GetDriverName();		// vendor, renderer and version of the current context
 		void SetWireframeDrawing(bool wireframe);
 		void SetGLContext(void* context);	// Sets context PER THREAD
 		void SetViewport(glm::ivec2 pos, glm::ivec2 size);
@@ -123,7 +125,7 @@ namespace Render
 		void BindDrawIndirectBuffer(const RenderBuffer& buffer);
 		void DrawPrimitivesIndirectIndexed(PrimitiveType primitive, uint32_t startDrawCall, uint32_t drawCount);
 		void DrawPrimitives(PrimitiveType primitive, uint32_t vertexStart, uint32_t vertexCount);
-		void DrawPrimitivesInstancedIndexed(PrimitiveType primitive, uint32_t indexStart, uint32_t indexCount, uint32_t instanceCount, uint32_t firstInstance = 0);
+		void DrawPrimitivesInstancedIndexed(PrimitiveType primitive, uint32_t indexStart, uint32_t indexCount, uint32_t instanceCount, uint32_t firstInstance = 0, int32_t baseVertex = 0);
 		void DrawPrimitivesInstanced(PrimitiveType primitive, uint32_t vertexStart, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstInstance=0);
 		void BindUniformBufferIndex(ShaderProgram& p, const char* bufferName, uint32_t bindingIndex);
 		void SetUniforms(ShaderProgram& p, const RenderBuffer& ubo, uint32_t uboBindingIndex);
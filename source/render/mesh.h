@@ -11,15 +11,17 @@ namespace Render
 	class Material;
 
 	// Note that for indexed meshes, firstVertex/vertexCount apply to indices
+	// baseVertex is added to each index (only used by indexed meshes)
 	struct MeshChunk
 	{
 		MeshChunk() 
-			: m_firstVertex(0), m_vertexCount(0), m_primitiveType(Render::PrimitiveType::Triangles) { }
-		MeshChunk(uint32_t fv, uint32_t count, Render::PrimitiveType primitive) 
-			: m_firstVertex(fv), m_vertexCount(count), m_primitiveType(primitive) { }
+			: m_firstVertex(0), m_vertexCount(0), m_primitiveType(Render::PrimitiveType::Triangles), m_baseVertex(0) { }
+		MeshChunk(uint32_t fv, uint32_t count, Render::PrimitiveType primitive, int32_t baseVertex = 0) 
+			: m_firstVertex(fv), m_vertexCount(count), m_primitiveType(primitive), m_baseVertex(baseVertex) { }
 		uint32_t m_firstVertex;
 		uint32_t m_vertexCount;
 		Render::PrimitiveType m_primitiveType;
+		int32_t m_baseVertex;
 	};
 
 	class Mesh
@@ -122,7 +122,7 @@ namespace Render
 		}
 	}
 
-	void RenderBuffer::SetData(size_t offset, size_t size, void* srcData)
+	void RenderBuffer::SetData(size_t offset, size_t size, const void* srcData)
 	{
 		SDE_PROF_EVENT();
 		assert(offset < m_bufferSize);
@@ -143,6 +143,17 @@ namespace Render
 		}
 	}
 
+	void RenderBuffer::CopyData(const RenderBuffer& src, size_t srcOffset, size_t dstOffset, size_t size)
+	{
+		SDE_PROF_EVENT();
+		assert((srcOffset + size) <= src.m_bufferSize);
+		assert((dstOffset + size) <= m_bufferSize);
+		assert(&src != this || srcOffset + size <= dstOffset || dstOffset + size <= srcOffset);
+		assert(m_handle != 0 && src.m_handle != 0);
+
+		glCopyNamedBufferSubData(src.m_handle, m_handle, srcOffset, dstOffset, size);
+	}
+
 	bool RenderBuffer::Destroy()
 	{
 		SDE_PROF_EVENT();
@@ -27,7 +27,8 @@ namespace Render
 		bool Create(size_t bufferSize, RenderBufferModification modification, bool usePersistentMapping=false, bool isReadable=false);
 		bool Create(void* sourceData, size_t bufferSize, RenderBufferModification modification, bool usePersistentMapping = false, bool isReadable = false);
 		bool Destroy();
-		void SetData(size_t offset, size_t size, void* srcData);
+		void SetData(size_t offset, size_t size, const void* srcData);
+		void CopyData(const RenderBuffer& src, size_t srcOffset, size_t dstOffset, size_t size);	// gpu side copy, ranges must not overlap if src is this buffer
 		void* Map(uint32_t hint, size_t offset, size_t size);
 		void Unmap();
 
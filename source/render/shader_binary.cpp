@@ -19,10 +19,16 @@ namespace Render
 	}
 
 	void ParseIncludes(std::string& src)
+	{
+		std::vector<std::string> includedFiles;
+		ParseIncludes(src, includedFiles);
+	}
+
+	void ParseIncludes(std::string& src, std::vector<std::string>& includedFiles)
 	{
 		SDE_PROF_EVENT();
 
-		std::vector<std::string> includedFiles;		// make sure we don't include multiple times (also avoids circular dependencies)
+		// includedFiles makes sure we don't include multiple times (also avoids circular dependencies)
 		const std::string c_includeDirectivePrefix = "#pragma sde include";
 		size_t foundInclude = 0;
 		while ((foundInclude = src.find(c_includeDirectivePrefix, foundInclude)) != std::string::npos)
@@ -66,6 +72,10 @@ namespace Render
 					src = prefix + "\n" + includeSrc + postfix;
 					includedFiles.push_back(includePath);
 				}
+				else
+				{
+					src.erase(foundInclude, secondQuote + 1 - foundInclude);	// already included, just remove the directive
+				}
 			}
 			foundInclude = 0;
 		}
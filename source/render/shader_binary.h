@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 namespace Render
 {
@@ -12,6 +13,9 @@ namespace Render
 		ComputeShader
 	};
 
+	void ParseIncludes(std::string& src);	// replaces each '#pragma sde include "path"' with the contents of path
+	void ParseIncludes(std::string& src, std::vector<std::string>& includedFiles);	// includedFiles = paths that were included
+
 	// This represents a single compiled shader. It can be vertex, fragment, hull, whatever
 	// Shaders must be linked in a ShaderProgram to be usable for rendering
 	class ShaderBinary
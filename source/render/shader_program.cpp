@@ -28,6 +28,7 @@ namespace Render
 
 		glAttachShader(m_handle, computeShader.GetHandle());
 
+		glProgramParameteri(m_handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram(m_handle);
 
 		// check the results
@@ -59,6 +60,7 @@ namespace Render
 
 		glAttachShader(m_handle, fragmentShader.GetHandle());
 
+		glProgramParameteri(m_handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram(m_handle);
 
 		// check the results
@@ -75,6 +77,42 @@ namespace Render
 		return linkResult == GL_TRUE;
 	}
 
+	bool ShaderProgram::CreateFromBinary(uint32_t binaryFormat, const void* data, size_t size)
+	{
+		SDE_PROF_EVENT();
+
+		m_handle = glCreateProgram();
+		glProgramBinary(m_handle, binaryFormat, data, (GLsizei)size);
+
+		int32_t linkResult = 0;
+		glGetProgramiv(m_handle, GL_LINK_STATUS, &linkResult);
+		if (linkResult != GL_TRUE)
+		{
+			Destroy();
+			return false;
+		}
+		return true;
+	}
+
+	bool ShaderProgram::GetBinary(uint32_t& binaryFormat, std::vector<uint8_t>& data) const
+	{
+		SDE_PROF_EVENT();
+
+		int32_t binaryLength = 0;
+		glGetProgramiv(m_handle, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+		if (binaryLength <= 0)
+		{
+			return false;
+		}
+		data.resize(binaryLength);
+		GLenum format = 0;
+		GLsizei bytesWritten = 0;
+		glGetProgramBinary(m_handle, binaryLength, &bytesWritten, &format, data.data());
+		data.resize(bytesWritten);
+		binaryFormat = format;
+		return bytesWritten > 0;
+	}
+
 	uint32_t ShaderProgram::GetUniformHandle(const char* uniformName)
 	{
 		return GetUniformHandle(uniformName, Core::StringHashing::GetHash(uniformName));
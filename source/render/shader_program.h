@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace Render
 {
@@ -17,6 +18,8 @@ namespace Render
 
 		bool Create(const ShaderBinary& computeShader, std::string& result);
 		bool Create(const ShaderBinary& vertexShader, const ShaderBinary& fragmentShader, std::string& result);
+		bool CreateFromBinary(uint32_t binaryFormat, const void* data, size_t size);	// fails if the driver changed since the binary was saved
+		bool GetBinary(uint32_t& binaryFormat, std::vector<uint8_t>& data) const;		// driver specific, only valid on this machine
 		void Destroy();
 
 		uint32_t GetUniformHandle(const char* uniformName, uint32_t nameHash);	// lazily updates cache
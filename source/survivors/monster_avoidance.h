@@ -0,0 +1,31 @@
+#pragma once
+#include "core/glm_headers.h"
+#include "engine/entity_grid.h"
+#include <vector>
+
+namespace Engine
+{
+	class JobSystem;
+}
+
+namespace Survivors
+{
+	// Pushes overlapping monsters apart on the xz plane, split across jobs
+	// Jacobi-style solver, each monster only ever moves itself using neighbour positions from the previous iteration
+	// Nothing is shared between jobs and neighbours are visited in grid order, so results do not depend on scheduling
+	// Pairs split the push like the old in-place solver; the smaller monster moves, equal sized monsters both move half
+	class MonsterAvoidance
+	{
+	public:
+		// Monster needs glm::vec3 m_targetPosition and float m_radius, the grid holds indices into monsters
+		// Monsters further than maxDistance from the player are not moved (but still push the others)
+		template<class Monster>
+		void Solve(std::vector<Monster>& monsters, WorldGrid<uint32_t>& grid, glm::vec3 playerPos, float maxDistance, int iterations, Engine::JobSystem& jobs);
+
+	private:
+		std::vector<glm::vec3> m_srcPositions;	// each iteration reads from src and writes to dst, storage is kept between frames
+		std::vector<glm::vec3> m_dstPositions;
+	};
+}
+
+#include "monster_avoidance.inl"
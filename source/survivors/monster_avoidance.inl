@@ -0,0 +1,82 @@
+#include "engine/job_system.h"
+#include "core/profiler.h"
+#include <algorithm>
+#include <atomic>
+
+namespace Survivors
+{
+	template<class Monster>
+	void MonsterAvoidance::Solve(std::vector<Monster>& monsters, WorldGrid<uint32_t>& grid, glm::vec3 playerPos, float maxDistance, int iterations, Engine::JobSystem& jobs)
+	{
+		SDE_PROF_EVENT();
+		const int32_t c_monstersPerJob = 256;
+		const int32_t monsterCount = (int32_t)monsters.size();
+		const int32_t jobCount = (monsterCount + c_monstersPerJob - 1) / c_monstersPerJob;
+
+		m_srcPositions.resize(monsterCount);
+		m_dstPositions.resize(monsterCount);
+		for (int32_t m = 0; m < monsterCount; ++m)
+		{
+			m_srcPositions[m] = monsters[m].m_targetPosition;
+		}
+
+		auto solveMonster = [&](int32_t m) -> bool {
+			const auto& monster = monsters[m];
+			const glm::vec3 myPos = m_srcPositions[m];
+			glm::vec3 offset(0.0f);
+			bool touched = false;
+			auto posToPlayer = (playerPos - monster.m_targetPosition) * glm::vec3(1.0f, 0.0f, 1.0f);
+			if (glm::length(posToPlayer) <= maxDistance)
+			{
+				const float collideRadius = monster.m_radius;
+				const auto aabMin = myPos - glm::vec3(collideRadius, 0.0f, collideRadius);
+				const auto aabMax = myPos + glm::vec3(collideRadius, 0.0f, collideRadius);
+				grid.ForEachNearby(aabMin, aabMax, [&](uint32_t& index) {
+					if (index == (uint32_t)m)
+						return;
+					const float neighbourRadius = monsters[index].m_radius;
+					if (neighbourRadius < collideRadius)
+						return;		// the neighbour gets out of our way
+					const glm::vec3 nearbyToMonster = myPos - m_srcPositions[index];
+					const float d = glm::length(nearbyToMonster);
+					if (d < (neighbourRadius + collideRadius))
+					{
+						touched = true;
+						// monsters on top of each other are split along x by index so the result stays stable
+						const glm::vec3 pushDirection = d > 0.0f ? nearbyToMonster / d : glm::vec3(index < (uint32_t)m ? 1.0f : -1.0f, 0.0f, 0.0f);
+						const float shiftDistance = ((neighbourRadius + collideRadius) - d) * 0.2f;
+						const float weight = neighbourRadius == collideRadius ? 0.501f : 1.0f;
+						offset = offset + pushDirection * shiftDistance * weight;
+					}
+				});
+			}
+			m_dstPositions[m] = myPos + offset;
+			return touched;
+		};
+
+		for (int iteration = 0; iteration < iterations; ++iteration)
+		{
+			std::atomic<int32_t> touchedCount = 0;
+			jobs.ForEachAsync(0, jobCount, 1, 1, [&](int32_t job) {
+				const int32_t firstMonster = job * c_monstersPerJob;
+				const int32_t lastMonster = std::min(firstMonster + c_monstersPerJob, monsterCount);
+				int32_t touched = 0;
+				for (int32_t m = firstMonster; m < lastMonster; ++m)
+				{
+					touched += solveMonster(m) ? 1 : 0;
+				}
+				touchedCount += touched;
+			});
+			std::swap(m_srcPositions, m_dstPositions);
+			if (touchedCount == 0)
+			{
+				break;
+			}
+		}
+
+		for (int32_t m = 0; m < monsterCount; ++m)
+		{
+			monsters[m].m_targetPosition = m_srcPositions[m];
+		}
+	}
+}
@@ -1,6 +1,6 @@
 #include "survivors_main.h"
 #include "core/random.h"
-#include "core/file_io.h"
+#include "core/log.h"
 #include "engine/system_manager.h"
 #include "engine/script_system.h"
 #include "engine/debug_gui_system.h"
@@ -18,11 +18,12 @@
 #include "world_tile_system.h"
 #include "engine/character_controller_system.h"
 #include "engine/time_system.h"
+#include "engine/job_system.h"
 #include "engine/components/component_character_controller.h"
 #include "engine/components/component_model.h"
 #include "engine/components/component_model_part_materials.h"
 #include "engine/components/component_physics.h"
-#include "entity_grid.h"
+#include "engine/entity_grid.h"
 #include "editor/editor.h"
 #include "particles/particle_system.h"
 
@@ -196,20 +197,18 @@ namespace Survivors
 	{
 		SDE_PROF_EVENT();
 
+		// the scene streams in over a few frames, the game does not tick until it has finished
+		// the player may be created long before the rest of the scene
 		auto entities = Engine::GetSystem<EntitySystem>("Entities");
-		std::string sceneText;
-		if (!Core::LoadTextFromFile("survivors.scn", sceneText))
-		{
-			SDE_LOG("Failed to load survivors.scn!");
-			return;
-		}
-		nlohmann::json sceneJson;
-		{
-			SDE_PROF_EVENT("ParseJson");
-			sceneJson = nlohmann::json::parse(sceneText);
-		}
 		entities->NewWorld();
-		entities->SerialiseEntities(sceneJson, true);
+		m_mainSceneLoading = true;
+		entities->LoadSceneAsync("survivors.scn", true, nullptr, [this](bool success, std::vector<uint32_t>) {
+			if (!success)
+			{
+				SDE_LOG("Failed to load survivors.scn!");
+			}
+			m_mainSceneLoading = false;
+		});
 	}
 
 	void SurvivorsMain::DamageMonster(SurvivorsMain::ActiveMonster& monster, float damage, glm::vec2 knockback)
@@ -336,57 +335,8 @@ namespace Survivors
 	{
 		SDE_PROF_EVENT();
 
-		for (int m = 0; m < m_activeMonsters.size(); ++m)
-		{
-			auto& monster = m_activeMonsters[m];
-			auto posToPlayer = (playerPos - monster.m_targetPosition) * glm::vec3(1.0f, 0.0f, 1.0f);
-			float distanceToPlayer = glm::length(posToPlayer);
-			if (distanceToPlayer > m_avoidanceMaxDistance)
-			{
-				continue;
-			}
-			const float collideRadius = monster.m_radius;
-			const auto aabMin = monster.m_targetPosition - glm::vec3(collideRadius, 0.0f, collideRadius);
-			const auto aabMax = monster.m_targetPosition + glm::vec3(collideRadius, 0.0f, collideRadius);
-			for (int iteration = 0; iteration < m_avoidanceIterations; ++iteration)
-			{
-				int touched = 0;
-				m_activeMonsterGrid.ForEachNearby(aabMin, aabMax, [&](uint32_t& index) {
-					auto& neighbour = m_activeMonsters[index];
-					if (neighbour.m_cc == monster.m_cc)
-						return;
-					const glm::vec3 neighbourPos = neighbour.m_targetPosition;
-					glm::vec3 monsterToNearby = monster.m_targetPosition - neighbourPos;
-					const float d = glm::length(monsterToNearby);
-					const float neighbourRadius = neighbour.m_radius;
-					if (d < (neighbourRadius + collideRadius))
-					{
-						++touched;
-						monsterToNearby = -monsterToNearby / d;
-						float shiftDistance = (neighbourRadius + collideRadius) - d;
-						shiftDistance = shiftDistance * 0.2f;
-						const glm::vec3 shift = monsterToNearby * shiftDistance;
-						if (neighbourRadius < collideRadius)
-						{
-							neighbour.m_targetPosition = neighbour.m_targetPosition + shift;
-						}
-						else if (neighbourRadius == collideRadius)
-						{
-							monster.m_targetPosition = monster.m_targetPosition - shift * 0.501f;
-							neighbour.m_targetPosition = neighbour.m_targetPosition + shift * 0.501f;
-						}
-						else
-						{
-							monster.m_targetPosition = monster.m_targetPosition - shift;
-						}
-					}
-				});
-				if (touched == 0)
-				{
-					break;
-				}
-			}
-		}
+		auto jobs = Engine::GetSystem<Engine::JobSystem>("Jobs");
+		m_avoidance.Solve(m_activeMonsters, m_activeMonsterGrid, playerPos, m_avoidanceMaxDistance, m_avoidanceIterations, *jobs);
 		for (int m = 0; m < m_activeMonsters.size(); ++m)
 		{
 			auto& monster = m_activeMonsters[m];
@@ -570,6 +520,7 @@ namespace Survivors
 		m_monstersToDespawn.clear();
 		m_monstersToKill.clear();
 		CollectActiveAndDespawning(playerPos, timeDelta);
+		m_activeMonsterGrid.Build();
 		ApplyDamageAreas();
 		DoEnemyAvoidance(playerPos, timeDelta);
 		UpdateAttackingMonsters(playerCmp, playerPos);
@@ -644,6 +595,10 @@ namespace Survivors
 			}
 			m_firstFrame = false;
 		}
+		if (m_mainSceneLoading)
+		{
+			return true;
+		}
 
 		auto entities = Engine::GetSystem<EntitySystem>("Entities");
 		auto world = entities->GetWorld();
@@ -1,7 +1,8 @@
 #pragma once
 #include "engine/system.h"
 #include "core/glm_headers.h"
-#include "entity_grid.h"
+#include "engine/entity_grid.h"
+#include "monster_avoidance.h"
 #include "entity/entity_handle.h"
 #include <functional>
 #include <string>
@@ -50,6 +51,7 @@ namespace Survivors
 		void ApplyDamageAreas();
 
 		bool m_firstFrame = true;
+		bool m_mainSceneLoading = false;			// set until the main scene load completes (or fails)
 		double m_damagedMaterialTime = 0.25;			// time that a monster will show damaged material
 		bool m_enemiesEnabled = false;
 		bool m_attractorsEnabled = false;
@@ -65,6 +67,7 @@ namespace Survivors
 		};
 		std::vector<DamageArea> m_damageAreas;
 		std::vector<ActiveMonster> m_activeMonsters;
+		MonsterAvoidance m_avoidance;
 		std::vector<EntityHandle> m_monstersToDespawn;
 		std::vector<EntityHandle> m_monstersToKill;
 		EntityHandle m_xpTemplateEntity;
@@ -5,7 +5,7 @@
 #include "entity/entity_system.h"
 #include "engine/components/component_transform.h"
 #include "engine/components/component_tags.h"
-#include "core/file_io.h"
+#include "core/timer.h"
 
 namespace Survivors
 {
@@ -19,6 +19,17 @@ namespace Survivors
 		return glm::ivec2(p.x / m_tileSize, p.z / m_tileSize);
 	}
 
+	// NewWorld() removes every entity at once, the tiles and any half created prefabs went with them
+	void WorldTileSystem::ForgetTilesIfWorldReset(World& world)
+	{
+		if (world.GetResetCount() != m_worldResetCount)
+		{
+			m_activeTiles.clear();
+			m_pendingTiles.clear();
+			m_worldResetCount = world.GetResetCount();
+		}
+	}
+
 	bool WorldTileSystem::PostInit()
 	{
 		SDE_PROF_EVENT();
@@ -35,6 +46,51 @@ namespace Survivors
 		survivors["DestroyTileAt"] = [this](glm::ivec2 target) {
 			DestroyTileAt(target);
 		};
+		survivors["SetTileSpawnBudgetMs"] = [this](double ms) {
+			m_spawnBudgetSeconds = ms / 1000.0;
+		};
+
+		return true;
+	}
+
+	bool WorldTileSystem::Tick(float timeDelta)
+	{
+		SDE_PROF_EVENT();
+
+		// create entities for tiles that are streaming in, oldest tiles first, until the budget runs out
+		auto world = Engine::GetSystem<EntitySystem>("Entities")->GetWorld();
+		ForgetTilesIfWorldReset(*world);
+		Core::Timer timer;
+		const double startTime = timer.GetSeconds();
+		for (auto& pending : m_pendingTiles)
+		{
+			const double timeRemaining = m_spawnBudgetSeconds - (timer.GetSeconds() - startTime);
+			if (timeRemaining <= 0.0)
+			{
+				break;
+			}
+			const uint32_t firstNewEntity = pending.m_instance->GetCreatedCount();
+			pending.m_instance->Continue(timeRemaining);
+			const auto& entities = pending.m_instance->GetEntities();
+			for (uint32_t i = firstNewEntity; i < pending.m_instance->GetCreatedCount(); ++i)
+			{
+				// transform all children with no parent relative to the tile
+				// we dont use parent transform since it messes with physx
+				auto transform = world->GetComponent<Transform>(entities[i]);
+				if (transform)
+				{
+					if (transform->GetParent().GetEntity().GetID() == -1)
+					{
+						auto newMat = pending.m_tileTransform * transform->GetMatrix();
+						auto newPos = glm::vec3(newMat[3]);
+						transform->SetPosition(newPos);
+					}
+				}
+			}
+		}
+		m_pendingTiles.erase(std::remove_if(m_pendingTiles.begin(), m_pendingTiles.end(), [](const PendingTile& p) {
+			return p.m_instance->IsComplete();
+		}), m_pendingTiles.end());
 
 		return true;
 	}
@@ -42,7 +98,8 @@ namespace Survivors
 	void WorldTileSystem::Shutdown()
 	{
 		SDE_PROF_EVENT();
-		m_loadedTileData.clear();
+		m_pendingTiles.clear();
+		m_prefabs.Clear();
 	}
 
 	void WorldTileSystem::DestroyAll()
@@ -57,6 +114,7 @@ namespace Survivors
 	void WorldTileSystem::EnsureLoadedExclusive(glm::ivec2 tileMin, glm::ivec2 tileMax, SpawnTileFn spawnFn)
 	{
 		SDE_PROF_EVENT();
+		ForgetTilesIfWorldReset(*Engine::GetSystem<EntitySystem>("Entities")->GetWorld());
 
 		std::vector<glm::ivec2> tilesToRemove;
 		for (auto& it : m_activeTiles)
@@ -95,6 +153,7 @@ namespace Survivors
 
 		auto entities = Engine::GetSystem<EntitySystem>("Entities");
 		World* world = entities->GetWorld();
+		ForgetTilesIfWorldReset(*world);
 
 		// if there is already a tile then return the existing one
 		uint64_t tileHash = TilePositionHash(tileOrigin);
@@ -104,22 +163,12 @@ namespace Survivors
 			return foundTile->second.m_tileEntity;
 		}
 
-		// load the json if we need to
-		auto foundIt = m_loadedTileData.find(tileSrcPath);
-		if(foundIt == m_loadedTileData.end())
+		// each tile file is only loaded once, after that tiles are created from the cached prefab
+		auto prefab = m_prefabs.Load(tileSrcPath, *world);
+		if (prefab == nullptr)
 		{
-			SDE_PROF_EVENT("LoadAndParseJson");
-
-			std::string sceneText;
-			if (!Core::LoadTextFromFile(tileSrcPath, sceneText))
-			{
-				return -1;
-			}
-			m_loadedTileData[tileSrcPath] = std::make_unique<nlohmann::json>();
-			foundIt = m_loadedTileData.find(tileSrcPath);
-			*foundIt->second = nlohmann::json::parse(sceneText);
+			return -1;
 		}
-		assert(foundIt != m_loadedTileData.end());
 
 		// create the tile entity
 		EntityHandle newTileEntity = world->AddEntity();
@@ -134,26 +183,16 @@ namespace Survivors
 		tileTags->AddTag("Survivors::WorldTile");
 		tileTags->AddTag(tileSrcPath.c_str());
 
-		// serialise the tile entities
-		glm::mat4 tileTransformMatrix = glm::translate(tileTransform->GetPosition());
-		std::vector<uint32_t> newEntities = entities->SerialiseEntities(*foundIt->second, false);
-		for (const auto id : newEntities)
+		// the tile entities are created over the next few frames in Tick()
+		PendingTile pending;
+		pending.m_tileHash = tileHash;
+		pending.m_tileTransform = glm::translate(tileTransform->GetPosition());
+		pending.m_instance = std::make_unique<PrefabInstance>(prefab, *world);
+		for (const auto id : pending.m_instance->GetEntities())
 		{
 			worldTile->OwnedChildren().emplace_back(id);
-
-			// transform all children with no parent relative to the tile
-			// we dont use parent transform since it messes with physx
-			auto transform = world->GetComponent<Transform>(id);
-			if (transform)
-			{
-				if (transform->GetParent().GetEntity().GetID() == -1)
-				{
-					auto newMat = tileTransformMatrix * transform->GetMatrix();
-					auto newPos = glm::vec3(newMat[3]);
-					transform->SetPosition(newPos);
-				}
-			}
 		}
+		m_pendingTiles.push_back(std::move(pending));
 
 		return newTileEntity;
 	}
@@ -179,6 +218,9 @@ namespace Survivors
 			}
 			world->RemoveEntity(foundTile->second.m_tileEntity);
 			m_activeTiles.erase(foundTile);
+			m_pendingTiles.erase(std::remove_if(m_pendingTiles.begin(), m_pendingTiles.end(), [tileHash](const PendingTile& p) {
+				return p.m_tileHash == tileHash;
+			}), m_pendingTiles.end());
 		}
 	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "engine/system.h"
 #include "engine/serialisation.h"
 #include "entity/entity_handle.h"
+#include "entity/prefab.h"
 #include "core/glm_headers.h"
 #include <string>
 #include <memory>
@@ -23,6 +24,7 @@ namespace Survivors
 		glm::ivec2 PositionToTile(glm::vec3 p);
 
 		virtual bool PostInit();
+		virtual bool Tick(float timeDelta);
 		virtual void Shutdown();
 
 	private:
@@ -31,9 +33,19 @@ namespace Survivors
 			glm::ivec2 m_origin;
 			EntityHandle m_tileEntity;
 		};
+		struct PendingTile
+		{
+			uint64_t m_tileHash;
+			glm::mat4 m_tileTransform;
+			std::unique_ptr<PrefabInstance> m_instance;
+		};
 		uint64_t TilePositionHash(glm::ivec2 p);
+		void ForgetTilesIfWorldReset(World& world);
 		std::unordered_map<uint64_t, ActiveTileRecord> m_activeTiles;	// key = TilePositionHash
-		std::unordered_map<std::string, std::unique_ptr<nlohmann::json>> m_loadedTileData;
+		PrefabCache m_prefabs;							// one per tile file
+		std::vector<PendingTile> m_pendingTiles;		// tiles with entities still to create
+		double m_spawnBudgetSeconds = 0.002;			// time spent creating tile entities per frame
+		uint32_t m_worldResetCount = 0;					// World::GetResetCount() when the tiles were last valid
 		const float m_tileSize = 64.0f;
 
 	};
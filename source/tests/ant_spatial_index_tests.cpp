@@ -0,0 +1,105 @@
+#include "test.h"
+#include "ants/ant_spatial_index.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	const uint32_t c_layerKey = 1;
+
+	uint32_t s_seed = 4321;
+	float NextRandom(float minV, float maxV)
+	{
+		s_seed = s_seed * 1664525u + 1013904223u;
+		return minV + (maxV - minV) * ((s_seed >> 8) / float(1 << 24));
+	}
+
+	void BuildIndex(AntSpatialIndex& index, std::vector<AntSpatialIndex::Entry>& entries)
+	{
+		for (uint32_t i = 0; i < 3000; ++i)
+		{
+			const glm::vec3 p(NextRandom(-400.0f, 400.0f), NextRandom(-5.0f, 5.0f), NextRandom(-400.0f, 400.0f));
+			entries.push_back({ p, EntityHandle(i) });
+			index.Add(c_layerKey, p, EntityHandle(i));
+		}
+		index.Build();
+	}
+
+	bool IsEven(const AntSpatialIndex::Entry& e)
+	{
+		return (e.m_entity.GetID() % 2) == 0;
+	}
+}
+
+// k nearest must match a brute force sort of the filtered entries, closest first
+TEST_CASE(AntSpatialIndexKNearestMatchesBruteForce)
+{
+	AntSpatialIndex index(24.0f);
+	std::vector<AntSpatialIndex::Entry> entries;
+	BuildIndex(index, entries);
+	for (int q = 0; q < 200; ++q)
+	{
+		const glm::vec3 p(NextRandom(-600.0f, 600.0f), 0.0f, NextRandom(-600.0f, 600.0f));
+		const uint32_t k = 1 + (q % 20);
+		std::vector<float> bruteForce;
+		for (const auto& e : entries)
+		{
+			if (IsEven(e))
+			{
+				bruteForce.push_back(glm::distance(e.m_position, p));
+			}
+		}
+		std::sort(bruteForce.begin(), bruteForce.end());
+		bruteForce.resize(k);
+
+		std::vector<AntSpatialIndex::Entry> results;
+		index.FindKNearest(c_layerKey, p, k, results, IsEven);
+		TEST_CHECK(results.size() == k);
+		for (uint32_t i = 0; i < k; ++i)
+		{
+			TEST_CHECK(IsEven(results[i]));
+			TEST_CHECK(glm::distance(results[i].m_position, p) == bruteForce[i]);
+		}
+	}
+
+	// asking for more than exist returns everything that passes the filter
+	std::vector<AntSpatialIndex::Entry> results;
+	index.FindKNearest(c_layerKey, glm::vec3(0.0f), (uint32_t)entries.size(), results, IsEven);
+	TEST_CHECK(results.size() == entries.size() / 2);
+	results.clear();
+	index.FindKNearest(c_layerKey + 1, glm::vec3(0.0f), 4, results, IsEven);
+	TEST_CHECK(results.size() == 0);
+	return true;
+}
+
+// radius queries return exactly the filtered entries within the radius, once each
+TEST_CASE(AntSpatialIndexInRadiusMatchesBruteForce)
+{
+	AntSpatialIndex index(24.0f);
+	std::vector<AntSpatialIndex::Entry> entries;
+	BuildIndex(index, entries);
+	for (int q = 0; q < 200; ++q)
+	{
+		const glm::vec3 p(NextRandom(-500.0f, 500.0f), 0.0f, NextRandom(-500.0f, 500.0f));
+		const float radius = NextRandom(0.0f, 120.0f);
+		std::vector<uint32_t> bruteForce;
+		for (const auto& e : entries)
+		{
+			if (IsEven(e) && glm::distance(e.m_position, p) <= radius)
+			{
+				bruteForce.push_back(e.m_entity.GetID());
+			}
+		}
+
+		std::vector<AntSpatialIndex::Entry> results;
+		index.FindInRadius(c_layerKey, p, radius, results, IsEven);
+		std::vector<uint32_t> found;
+		for (const auto& e : results)
+		{
+			found.push_back(e.m_entity.GetID());
+		}
+		std::sort(found.begin(), found.end());
+		TEST_CHECK(found == bruteForce);
+	}
+	return true;
+}
@@ -0,0 +1,70 @@
+#include "test.h"
+#include "engine/asset_array.h"
+#include "core/thread.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct TestAsset
+	{
+		uint32_t m_id = -1u;
+		std::string m_path;
+	};
+}
+
+// readers on other threads must only ever see fully initialised elements while the array grows across many chunks
+TEST_CASE(AssetArrayReadsWhileGrowing)
+{
+	const uint32_t c_assetCount = 20000;
+	const int c_readerCount = 4;
+	Engine::AssetArray<TestAsset, 64> assets;
+	std::atomic<bool> addsFinished = false;
+	std::atomic<uint32_t> badReads = 0;
+
+	std::vector<Core::Thread> readers(c_readerCount);
+	for (auto& reader : readers)
+	{
+		reader.Create("AssetArrayReader", [&]() {
+			uint32_t seed = 1234;
+			while (!addsFinished)
+			{
+				const uint32_t count = assets.Size();
+				seed = seed * 1664525u + 1013904223u;
+				const uint32_t index = count > 0 ? (seed >> 8) % count : 0;
+				const TestAsset* asset = assets.TryGet(index);
+				if (count > 0 && (asset == nullptr || asset->m_id != index || asset->m_path != std::to_string(index)))
+				{
+					badReads++;
+				}
+			}
+			return 0;
+		});
+	}
+	bool indicesMatch = true;
+	for (uint32_t i = 0; i < c_assetCount; ++i)
+	{
+		const uint32_t index = assets.Add([i](TestAsset& a) {
+			a.m_id = i;
+			a.m_path = std::to_string(i);
+		});
+		indicesMatch = indicesMatch && index == i;
+	}
+	addsFinished = true;
+	for (auto& reader : readers)
+	{
+		reader.WaitForFinish();
+	}
+	TEST_CHECK(indicesMatch);
+	TEST_CHECK(badReads == 0);
+	TEST_CHECK(assets.Size() == c_assetCount);
+	TEST_CHECK(assets.TryGet(c_assetCount) == nullptr);
+	TEST_CHECK(assets.TryGet(-1u) == nullptr);
+	TEST_CHECK(assets[c_assetCount - 1].m_path == std::to_string(c_assetCount - 1));
+
+	assets.Clear();
+	TEST_CHECK(assets.Size() == 0 && assets.TryGet(0) == nullptr);
+	TEST_CHECK(assets.Add([](TestAsset& a) { a.m_id = 0; }) == 0);
+	return true;
+}
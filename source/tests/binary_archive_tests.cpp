@@ -0,0 +1,42 @@
+#include "test.h"
+#include "engine/serialisation.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+// A vector of non-raw elements stores a count then one field per element, a corrupt count must fail the read
+// rather than reserve space for billions of elements
+TEST_CASE(BinaryArchiveRejectsImpossibleVectorCount)
+{
+	Engine::BinaryArchive archive;
+	std::vector<std::string> written = { "one", "two" };
+	archive.Write("Names", written);
+	std::vector<uint8_t> data = archive.Data();
+
+	// header | field hash | field size | element count | ...
+	const size_t countOffset = sizeof(uint32_t) * 2 + Engine::BinaryArchive::c_fieldHeaderSize;
+	TEST_CHECK(data.size() > countOffset + sizeof(uint32_t));
+	uint32_t count = 0;
+	memcpy(&count, data.data() + countOffset, sizeof(count));
+	TEST_CHECK(count == 2);
+
+	// a valid archive reads back as written
+	{
+		Engine::BinaryArchive reader(data.data(), data.size());
+		std::vector<std::string> read;
+		TEST_CHECK(reader.Read("Names", read));
+		TEST_CHECK(reader.IsValid());
+		TEST_CHECK(read == written);
+	}
+
+	count = 0x7fffffff;
+	memcpy(data.data() + countOffset, &count, sizeof(count));
+	{
+		Engine::BinaryArchive reader(data.data(), data.size());
+		std::vector<std::string> read;
+		reader.Read("Names", read);
+		TEST_CHECK(!reader.IsValid());
+		TEST_CHECK(read.capacity() < 1024);
+	}
+	return true;
+}
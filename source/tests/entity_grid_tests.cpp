@@ -0,0 +1,153 @@
+#include "test.h"
+#include "engine/entity_grid.h"
+#include <cfloat>
+
+namespace
+{
+	struct TestEntry
+	{
+		glm::vec3 m_min;
+		glm::vec3 m_max;
+		uint32_t m_id;
+	};
+
+	float DistanceToBox(glm::vec3 p, const TestEntry& e)
+	{
+		return glm::distance(p, glm::clamp(p, e.m_min, e.m_max));
+	}
+
+	uint32_t s_seed = 1234;
+	float NextRandom(float minV, float maxV)
+	{
+		s_seed = s_seed * 1664525u + 1013904223u;
+		return minV + (maxV - minV) * ((s_seed >> 8) / float(1 << 24));
+	}
+}
+
+// closest entry found by ring search must match brute force, including entries spanning several tiles
+TEST_CASE(EntityGridClosestMatchesBruteForce)
+{
+	WorldGrid<TestEntry> grid({ 16.0f, 16.0f });
+	std::vector<TestEntry> entries;
+	for (uint32_t i = 0; i < 2000; ++i)
+	{
+		const glm::vec3 p(NextRandom(-500.0f, 500.0f), 0.0f, NextRandom(-500.0f, 500.0f));
+		const glm::vec3 halfSize = (i % 10) == 0 ? glm::vec3(NextRandom(0.0f, 40.0f), 0.0f, NextRandom(0.0f, 40.0f)) : glm::vec3(0.0f);
+		entries.push_back({ p - halfSize, p + halfSize, i });
+		grid.AddEntry(p - halfSize, p + halfSize, entries.back());
+	}
+	grid.Build();
+
+	for (int q = 0; q < 500; ++q)
+	{
+		const glm::vec3 p(NextRandom(-700.0f, 700.0f), 0.0f, NextRandom(-700.0f, 700.0f));
+		float bruteForce = FLT_MAX;
+		for (const auto& e : entries)
+		{
+			bruteForce = glm::min(bruteForce, DistanceToBox(p, e));
+		}
+		float closest = FLT_MAX;
+		std::vector<uint32_t> timesVisited(entries.size(), 0);
+		grid.ForEachByDistance(p, [&](const TestEntry& e) {
+			closest = glm::min(closest, DistanceToBox(p, e));
+			timesVisited[e.m_id]++;
+		}, [&](float nextRingDistance) {
+			return closest <= nextRingDistance;
+		});
+		TEST_CHECK(closest == bruteForce);
+		for (auto v : timesVisited)
+		{
+			TEST_CHECK(v <= 1);
+		}
+	}
+	return true;
+}
+
+// every entry overlapping the query tiles is visited exactly once
+TEST_CASE(EntityGridNearbyVisitsOnce)
+{
+	WorldGrid<TestEntry> grid({ 8.0f, 8.0f });
+	std::vector<TestEntry> entries;
+	for (uint32_t i = 0; i < 500; ++i)
+	{
+		const glm::vec3 p(NextRandom(-100.0f, 100.0f), 0.0f, NextRandom(-100.0f, 100.0f));
+		const glm::vec3 halfSize(NextRandom(0.0f, 20.0f), 0.0f, NextRandom(0.0f, 20.0f));
+		entries.push_back({ p - halfSize, p + halfSize, i });
+		grid.AddEntry(p - halfSize, p + halfSize, entries.back());
+	}
+	grid.Build();
+	const glm::vec3 queryMin(-30.0f, 0.0f, -10.0f), queryMax(25.0f, 0.0f, 40.0f);
+	std::vector<uint32_t> timesVisited(entries.size(), 0);
+	grid.ForEachNearby(queryMin, queryMax, [&](TestEntry& e) {
+		timesVisited[e.m_id]++;
+	});
+	for (const auto& e : entries)
+	{
+		// tile overlap is conservative, anything overlapping the query box itself must be found
+		const bool overlaps = glm::all(glm::lessThanEqual(e.m_min, queryMax)) && glm::all(glm::greaterThanEqual(e.m_max, queryMin));
+		TEST_CHECK(timesVisited[e.m_id] <= 1);
+		TEST_CHECK(!overlaps || timesVisited[e.m_id] == 1);
+	}
+	return true;
+}
+
+// a few entries far from the rest (or spanning most of the world) must not blow up the cell array
+// they go to the overflow list and queries still match brute force
+TEST_CASE(EntityGridFarOutliers)
+{
+	WorldGrid<TestEntry> grid({ 16.0f, 16.0f });
+	std::vector<TestEntry> entries;
+	auto addEntry = [&](glm::vec3 minP, glm::vec3 maxP) {
+		entries.push_back({ minP, maxP, (uint32_t)entries.size() });
+		grid.AddEntry(minP, maxP, entries.back());
+	};
+	for (uint32_t i = 0; i < 1000; ++i)
+	{
+		const glm::vec3 p(NextRandom(-500.0f, 500.0f), 0.0f, NextRandom(-500.0f, 500.0f));
+		addEntry(p, p);
+	}
+	addEntry({ 1.0e7f, 0.0f, 1.0e7f }, { 1.0e7f, 0.0f, 1.0e7f });
+	addEntry({ -3.0e6f, 0.0f, 2.0e6f }, { -3.0e6f, 0.0f, 2.0e6f });
+	addEntry({ -1.0e6f, 0.0f, 20.0f }, { 1.0e6f, 0.0f, 30.0f });
+	grid.Build();
+	TEST_CHECK(grid.GetCellCount() <= WorldGrid<TestEntry>::c_maxCells);
+	TEST_CHECK(grid.GetOverflowCount() == 3);
+
+	std::vector<glm::vec3> queries = { { 1.0e7f, 0.0f, 1.0e7f }, { 9.0e6f, 0.0f, 1.1e7f }, { -3.0e6f, 0.0f, 0.0f }, { 0.0f, 0.0f, 5.0e6f } };
+	for (int q = 0; q < 200; ++q)
+	{
+		queries.push_back({ NextRandom(-700.0f, 700.0f), 0.0f, NextRandom(-700.0f, 700.0f) });
+	}
+	for (const glm::vec3& p : queries)
+	{
+		float bruteForce = FLT_MAX;
+		for (const auto& e : entries)
+		{
+			bruteForce = glm::min(bruteForce, DistanceToBox(p, e));
+		}
+		float closest = FLT_MAX;
+		std::vector<uint32_t> timesVisited(entries.size(), 0);
+		grid.ForEachByDistance(p, [&](const TestEntry& e) {
+			closest = glm::min(closest, DistanceToBox(p, e));
+			timesVisited[e.m_id]++;
+		}, [&](float nextRingDistance) {
+			return closest <= nextRingDistance;
+		});
+		TEST_CHECK(closest == bruteForce);
+		for (auto v : timesVisited)
+		{
+			TEST_CHECK(v <= 1);
+		}
+	}
+
+	// everything visited once by a query covering the whole world
+	std::vector<uint32_t> timesVisited(entries.size(), 0);
+	grid.ForEachNearby(glm::vec3(-2.0e7f), glm::vec3(2.0e7f), [&](TestEntry& e) {
+		timesVisited[e.m_id]++;
+	});
+	for (auto v : timesVisited)
+	{
+		TEST_CHECK(v == 1);
+	}
+	return true;
+}
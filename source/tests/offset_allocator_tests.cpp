@@ -0,0 +1,138 @@
+#include "test.h"
+#include "core/offset_allocator.h"
+#include <algorithm>
+#include <vector>
+
+using Core::OffsetAllocator;
+
+// freeing merges with free neighbours on either side, in any order
+TEST_CASE(OffsetAllocatorFreeMergesNeighbours)
+{
+	OffsetAllocator allocator(1000);
+	const uint32_t a = allocator.Allocate(100);
+	const uint32_t b = allocator.Allocate(200);
+	const uint32_t c = allocator.Allocate(300);
+	TEST_CHECK(a != OffsetAllocator::c_invalidOffset && b != OffsetAllocator::c_invalidOffset && c != OffsetAllocator::c_invalidOffset);
+	TEST_CHECK(allocator.GetAllocationSize(b) == 200);
+
+	// c is a neighbour of the remaining free space, a and b are not yet
+	allocator.Free(a);
+	TEST_CHECK(allocator.GetStats().m_freeBlockCount == 2);
+	allocator.Free(c);
+	TEST_CHECK(allocator.GetStats().m_freeBlockCount == 2);
+	allocator.Free(b);		// merges with both sides
+	OffsetAllocator::Stats stats = allocator.GetStats();
+	TEST_CHECK(stats.m_freeBlockCount == 1);
+	TEST_CHECK(stats.m_largestFreeBlock == 1000);
+	TEST_CHECK(stats.m_usedSize == 0 && stats.m_allocationCount == 0);
+	TEST_CHECK(allocator.GetAllocationSize(b) == 0);
+
+	// the whole space is usable again
+	TEST_CHECK(allocator.Allocate(1000) == 0);
+	return true;
+}
+
+// best fit picks the smallest free block that is big enough, running out returns c_invalidOffset and changes nothing
+TEST_CASE(OffsetAllocatorBestFitAndOutOfSpace)
+{
+	OffsetAllocator allocator(1000);
+	std::vector<uint32_t> blocks;
+	for (int i = 0; i < 10; ++i)
+	{
+		blocks.push_back(allocator.Allocate(100));
+	}
+	TEST_CHECK(allocator.Allocate(1) == OffsetAllocator::c_invalidOffset);
+	TEST_CHECK(allocator.Allocate(0) == OffsetAllocator::c_invalidOffset);
+
+	// holes of 100 (blocks 1) and 200 (blocks 4 + 5)
+	allocator.Free(blocks[1]);
+	allocator.Free(blocks[4]);
+	allocator.Free(blocks[5]);
+	const OffsetAllocator::Stats before = allocator.GetStats();
+	TEST_CHECK(before.m_freeBlockCount == 2 && before.m_largestFreeBlock == 200);
+	TEST_CHECK(allocator.Allocate(300) == OffsetAllocator::c_invalidOffset);
+	const OffsetAllocator::Stats after = allocator.GetStats();
+	TEST_CHECK(after.m_usedSize == before.m_usedSize && after.m_freeBlockCount == before.m_freeBlockCount);
+
+	TEST_CHECK(allocator.Allocate(80) == blocks[1]);
+	TEST_CHECK(allocator.Allocate(150) == blocks[4]);
+	TEST_CHECK(allocator.AllocateLowest(20) == blocks[1] + 80);
+	return true;
+}
+
+// stats track every allocate and free
+TEST_CASE(OffsetAllocatorStats)
+{
+	OffsetAllocator allocator(4096);
+	OffsetAllocator::Stats stats = allocator.GetStats();
+	TEST_CHECK(stats.m_totalSize == 4096 && stats.m_usedSize == 0 && stats.m_allocationCount == 0);
+	TEST_CHECK(stats.m_freeBlockCount == 1 && stats.m_largestFreeBlock == 4096);
+
+	const uint32_t a = allocator.Allocate(1000);
+	const uint32_t b = allocator.Allocate(24);
+	allocator.Allocate(72);
+	allocator.Free(b);
+	stats = allocator.GetStats();
+	TEST_CHECK(stats.m_usedSize == 1072 && stats.m_allocationCount == 2);
+	TEST_CHECK(stats.m_freeBlockCount == 2 && stats.m_largestFreeBlock == 4096 - 1096);
+
+	allocator.Free(a);
+	stats = allocator.GetStats();
+	TEST_CHECK(stats.m_usedSize == 72 && stats.m_allocationCount == 1 && stats.m_largestFreeBlock == 4096 - 1096);
+
+	allocator.Reset(512);
+	stats = allocator.GetStats();
+	TEST_CHECK(stats.m_totalSize == 512 && stats.m_usedSize == 0 && stats.m_allocationCount == 0 && stats.m_largestFreeBlock == 512);
+	return true;
+}
+
+// fragment the space then compact it the way ModelManager::Defragment does, everything should end up in one free block at the end
+TEST_CASE(OffsetAllocatorDefragment)
+{
+	const uint32_t c_totalSize = 64 * 1024;
+	OffsetAllocator allocator(c_totalSize);
+	uint32_t seed = 1234;
+	auto nextRandom = [&seed](uint32_t maxValue) {
+		seed = seed * 1664525u + 1013904223u;
+		return 1 + (seed >> 8) % maxValue;
+	};
+
+	std::vector<uint32_t> live;
+	for (int i = 0; i < 2000; ++i)
+	{
+		const uint32_t offset = allocator.Allocate(nextRandom(64));
+		if (offset != OffsetAllocator::c_invalidOffset)
+		{
+			live.push_back(offset);
+		}
+		if (live.size() > 0 && nextRandom(3) == 1)
+		{
+			const size_t toFree = nextRandom((uint32_t)live.size()) - 1;
+			allocator.Free(live[toFree]);
+			live.erase(live.begin() + toFree);
+		}
+	}
+	const OffsetAllocator::Stats fragmented = allocator.GetStats();
+	TEST_CHECK(fragmented.m_freeBlockCount > 10);
+	TEST_CHECK(fragmented.m_allocationCount == live.size());
+
+	std::sort(live.begin(), live.end());
+	for (uint32_t& offset : live)
+	{
+		const uint32_t newOffset = allocator.AllocateBelow(offset);
+		if (newOffset != OffsetAllocator::c_invalidOffset)
+		{
+			TEST_CHECK(newOffset < offset);
+			TEST_CHECK(allocator.GetAllocationSize(newOffset) == allocator.GetAllocationSize(offset));
+			allocator.Free(offset);
+			offset = newOffset;
+		}
+	}
+	const OffsetAllocator::Stats compacted = allocator.GetStats();
+	TEST_CHECK(compacted.m_usedSize == fragmented.m_usedSize);
+	TEST_CHECK(compacted.m_allocationCount == fragmented.m_allocationCount);
+	TEST_CHECK(compacted.m_freeBlockCount == 1);
+	TEST_CHECK(compacted.m_largestFreeBlock == c_totalSize - compacted.m_usedSize);
+	TEST_CHECK(allocator.Allocate(compacted.m_largestFreeBlock) == compacted.m_usedSize);
+	return true;
+}
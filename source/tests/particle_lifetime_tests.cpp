@@ -0,0 +1,70 @@
+#include "test.h"
+#include "particles/particle_container.h"
+#include "particles/behaviours/update_particle_lifetime.h"
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+// Compacted lifetime kills must match the serial reference for empty, odd sized, mass-death and no-death containers
+TEST_CASE(ParticleLifetimeCompactionMatchesSerial)
+{
+	using namespace Particles;
+
+	// (particle count, fraction of particles that should die)
+	const std::vector<std::tuple<uint32_t, float>> c_cases = {
+		{ 0, 0.5f }, { 1, 1.0f }, { 7, 0.5f }, { 1023, 0.0f }, { 4096, 0.1f }, { 4097, 0.9f }, { 65536, 1.0f }, { 65533, 0.5f }
+	};
+	const double c_emitterAge = 10.0;
+	uint32_t seed = 1234;
+	auto nextRandom = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / float(1 << 24);
+	};
+
+	// serial kills reorder the survivors, compare them as sets keyed by original index
+	auto survivors = [](ParticleContainer& c) {
+		std::vector<uint32_t> ids;
+		for (uint32_t p = 0; p < c.AliveParticles(); ++p)
+		{
+			const uint32_t id = c.EmitterIDs().GetValue(p);
+			const bool consistent = _mm_cvtss_f32(c.Positions().GetValue(p)) == (float)id && _mm_cvtss_f32(c.Velocities().GetValue(p)) == (float)id
+				&& _mm_cvtss_f32(c.Colours().GetValue(p)) == (float)id;
+			ids.push_back(consistent ? id : -1);
+		}
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	};
+
+	for (const auto& testCase : c_cases)
+	{
+		const uint32_t count = std::get<0>(testCase);
+		ParticleContainer serial(glm::max(count, 1u)), compacted(glm::max(count, 1u));
+		serial.Wake(count, 0.0f);
+		compacted.Wake(count, 0.0f);
+		for (uint32_t p = 0; p < count; ++p)
+		{
+			const bool shouldDie = nextRandom() < std::get<1>(testCase);
+			const float spawnTime = nextRandom() * (float)c_emitterAge;
+			const float age = (float)(c_emitterAge - spawnTime);
+			const float lifetime = shouldDie ? age * nextRandom() : age + 0.001f + nextRandom();
+			for (auto c : { &serial, &compacted })
+			{
+				c->Positions().GetValue(p) = _mm_set_ps(0.0f, 0.0f, 0.0f, (float)p);	// x = original index
+				c->Velocities().GetValue(p) = _mm_set1_ps((float)p);
+				c->Colours().GetValue(p) = _mm_set1_ps((float)p);
+				c->SpawnTimes().GetValue(p) = spawnTime;
+				c->Lifetimes().GetValue(p) = lifetime;
+				c->EmitterIDs().GetValue(p) = p;
+			}
+		}
+		const uint32_t serialKilled = UpdateParticleLifetime::KillExpiredSerial(c_emitterAge, serial, false);
+		const uint32_t compactedKilled = UpdateParticleLifetime::KillExpired(c_emitterAge, compacted, false);
+		if (serialKilled != compactedKilled)
+		{
+			printf("%d particles: serial killed %d, compacted killed %d\n", count, serialKilled, compactedKilled);
+		}
+		TEST_CHECK(serialKilled == compactedKilled);
+		TEST_CHECK(survivors(serial) == survivors(compacted));
+	}
+	return true;
+}
@@ -0,0 +1,103 @@
+#include "test.h"
+#include "core/random_stream.h"
+#include <vector>
+
+// Known answer vectors for Philox4x32-10 from the Random123 distribution (kat_vectors)
+TEST_CASE(RandomStreamPhiloxKnownAnswers)
+{
+	struct KnownAnswer
+	{
+		uint32_t m_counter[4];
+		uint32_t m_key[2];
+		uint32_t m_expected[4];
+	};
+	const KnownAnswer c_vectors[] = {
+		{ { 0, 0, 0, 0 }, { 0, 0 }, { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+		{ { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff }, { 0xffffffff, 0xffffffff }, { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } },
+		{ { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, { 0xa4093822, 0x299f31d0 }, { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } },
+	};
+	for (const auto& v : c_vectors)
+	{
+		uint32_t result[4];
+		Core::RandomStream::Philox(v.m_counter, v.m_key, result);
+		for (int i = 0; i < 4; ++i)
+		{
+			TEST_CHECK(result[i] == v.m_expected[i]);
+		}
+	}
+
+	// the stream is the counter (block index, stream id) with the seed as the key
+	Core::RandomStream stream(0, 0);
+	for (int i = 0; i < 4; ++i)
+	{
+		TEST_CHECK(stream.NextUInt() == c_vectors[0].m_expected[i]);
+	}
+	const uint64_t seed = 0x299f31d0a4093822ull, streamId = 0x0370734413198a2eull;
+	const uint32_t key[2] = { 0xa4093822, 0x299f31d0 };
+	const uint32_t counter[4] = { 5, 0, 0x13198a2e, 0x03707344 };
+	uint32_t expected[4];
+	Core::RandomStream::Philox(counter, key, expected);
+	stream.Reset(seed, streamId);
+	stream.Skip(5 * 4);
+	for (int i = 0; i < 4; ++i)
+	{
+		TEST_CHECK(stream.NextUInt() == expected[i]);
+	}
+	return true;
+}
+
+// Streams share no state, the values from one never depend on another being used, and skipping matches drawing
+TEST_CASE(RandomStreamsAreIndependent)
+{
+	const uint32_t c_valueCount = 1024;
+	auto draw = [](Core::RandomStream& s, uint32_t count) {
+		std::vector<uint32_t> values(count);
+		for (auto& v : values)
+		{
+			v = s.NextUInt();
+		}
+		return values;
+	};
+
+	Core::RandomStream a(1234, 0), b(1234, 1), c(4321, 0);
+	const std::vector<uint32_t> valuesA = draw(a, c_valueCount);
+	const std::vector<uint32_t> valuesB = draw(b, c_valueCount);
+	const std::vector<uint32_t> valuesC = draw(c, c_valueCount);
+	uint32_t matchesAB = 0, matchesAC = 0;
+	for (uint32_t i = 0; i < c_valueCount; ++i)
+	{
+		matchesAB += valuesA[i] == valuesB[i] ? 1 : 0;
+		matchesAC += valuesA[i] == valuesC[i] ? 1 : 0;
+	}
+	TEST_CHECK(matchesAB == 0);
+	TEST_CHECK(matchesAC == 0);
+
+	// interleaving two streams gives the same values as drawing from each alone
+	Core::RandomStream a2(1234, 0), b2(1234, 1);
+	for (uint32_t i = 0; i < c_valueCount; ++i)
+	{
+		TEST_CHECK(a2.NextUInt() == valuesA[i]);
+		TEST_CHECK(b2.NextUInt() == valuesB[i]);
+	}
+
+	// jumping ahead lands on the same values, including part way through a block
+	for (uint32_t skip : { 1u, 3u, 4u, 517u })
+	{
+		Core::RandomStream skipped(1234, 0);
+		skipped.Skip(skip);
+		TEST_CHECK(skipped.GetPosition() == skip);
+		TEST_CHECK(skipped.NextUInt() == valuesA[skip]);
+	}
+
+	// 4-wide draws start at the next whole block
+	Core::RandomStream wide(1234, 0);
+	wide.NextUInt();
+	alignas(16) uint32_t block[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(block), wide.NextUInt4());
+	for (int i = 0; i < 4; ++i)
+	{
+		TEST_CHECK(block[i] == valuesA[4 + i]);
+	}
+	TEST_CHECK(wide.NextUInt() == valuesA[8]);
+	return true;
+}
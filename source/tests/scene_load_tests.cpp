@@ -0,0 +1,85 @@
+#include "test.h"
+#include "engine/system_manager.h"
+#include "engine/job_system.h"
+#include "engine/components/component_transform.h"
+#include "engine/components/component_tags.h"
+#include "entity/entity_system.h"
+#include "core/timer.h"
+#include "core/thread.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Drives EntitySystem::UpdateSceneLoads frame by frame on a generated scene, no window or gl needed
+// A budgeted load must be spread over several frames and still load everything, frame times are only logged
+// (wall clock limits are too noisy for ctest)
+TEST_CASE(SceneLoadSpreadsOverFrames)
+{
+	const int c_entityCount = 2000;
+	const double c_budgetSeconds = 0.002;
+	const int c_maxFrames = 10000;
+
+	auto jobs = std::make_unique<Engine::JobSystem>();
+	Engine::SystemManager::GetInstance().RegisterSystem("Jobs", jobs.get());
+	TEST_CHECK(jobs->PostInit());
+
+	bool passed = false;
+	int frames = 0;
+	{
+		EntitySystem entities;
+		World* world = entities.GetWorld();
+		world->RegisterComponentType<Transform>();
+		world->RegisterComponentType<Tags>();
+
+		std::vector<uint32_t> srcIDs;
+		for (int i = 0; i < c_entityCount; ++i)
+		{
+			EntityHandle e = world->AddEntity();
+			world->AddComponent(e, Transform::GetType());
+			world->AddComponent(e, Tags::GetType());
+			world->GetComponent<Transform>(e)->SetPosition({ (float)i, 0.0f, (float)i * 0.5f });
+			world->GetComponent<Tags>(e)->AddTag("SceneLoadTest");
+			srcIDs.push_back(e.GetID());
+		}
+		std::string sceneText = entities.SerialiseEntities(srcIDs).dump();
+		entities.NewWorld();
+		world->CollectGarbage();
+
+		int timesCompleted = 0;
+		bool succeeded = false, loadingWhenCompleted = true;
+		std::vector<uint32_t> loadedIDs;
+		entities.SetSceneLoadBudget(c_budgetSeconds);
+		entities.LoadSceneTextAsync(std::move(sceneText), "SceneLoadTest", false, nullptr, [&](bool success, std::vector<uint32_t> ids) {
+			timesCompleted++;
+			succeeded = success;
+			loadingWhenCompleted = entities.IsLoadingScene();
+			loadedIDs = std::move(ids);
+		});
+
+		Core::Timer timer;
+		double longestFrame = 0.0;
+		while (entities.IsLoadingScene() && frames++ < c_maxFrames)
+		{
+			const double frameStart = timer.GetSeconds();
+			entities.UpdateSceneLoads();
+			longestFrame = std::max(longestFrame, timer.GetSeconds() - frameStart);
+			Core::Thread::Sleep(1);		// the rest of the frame, gives the parse job time to run
+		}
+		printf("Scene load test: %d entities over %d frames, longest frame %.3fms (budget %.3fms)\n", c_entityCount, frames, longestFrame * 1000.0, c_budgetSeconds * 1000.0);
+
+		// the completion callback runs once the load is finished, with every entity created
+		passed = timesCompleted == 1 && succeeded && !loadingWhenCompleted;
+		passed = passed && loadedIDs.size() == c_entityCount && world->AllEntities().size() == c_entityCount;
+		for (uint32_t id : loadedIDs)
+		{
+			const Tags* tags = world->GetComponent<Tags>(id);
+			passed = passed && tags != nullptr && tags->ContainsTag("SceneLoadTest");
+		}
+	}
+
+	jobs->PostShutdown();
+	TEST_CHECK(frames > 1);
+	TEST_CHECK(passed);
+	return true;
+}
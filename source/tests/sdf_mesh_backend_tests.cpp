@@ -0,0 +1,164 @@
+#include "test.h"
+#include "engine/sdf.h"
+#include <vector>
+
+// Compares the cpu mesher against the compute backend without needing gl
+// The compute backend is emulated by running compute_sdf_find_vertices/compute_sdf_make_triangles on the cpu
+// over the same sample volume, cell for cell (texture fetches are clamped to the edge as the gpu does)
+
+namespace
+{
+	struct ComputeEmulation
+	{
+		glm::ivec3 m_dims;
+		std::vector<float> m_volume;
+		std::vector<uint32_t> m_cellLookup;	// pos -> vertex index, 0 if the cell has no vertex
+		uint32_t m_vertexCount = 0;
+		std::vector<uint32_t> m_indices;
+
+		int Index(glm::ivec3 p) const
+		{
+			p = glm::clamp(p, glm::ivec3(0), m_dims - 1);
+			return p.x + (p.y * m_dims.x) + (p.z * m_dims.x * m_dims.y);
+		}
+		float Sample(glm::ivec3 p) const { return m_volume[Index(p)]; }
+	};
+
+	void WriteVolume(Engine::SDF::SampleFn fn, glm::vec3 worldOffset, glm::vec3 cellSize, ComputeEmulation& c)
+	{
+		c.m_volume.resize((size_t)c.m_dims.x * c.m_dims.y * c.m_dims.z);
+		for (int z = 0; z < c.m_dims.z; ++z)
+			for (int y = 0; y < c.m_dims.y; ++y)
+				for (int x = 0; x < c.m_dims.x; ++x)
+				{
+					const glm::vec3 p = worldOffset + cellSize * glm::vec3(x, y, z);
+					c.m_volume[c.Index({ x, y, z })] = std::get<0>(fn(p.x, p.y, p.z));
+				}
+	}
+
+	// compute_sdf_find_vertices, one invocation per cell of the volume
+	void FindVertices(ComputeEmulation& c)
+	{
+		c.m_cellLookup.resize(c.m_volume.size(), 0);
+		for (int z = 0; z < c.m_dims.z; ++z)
+			for (int y = 0; y < c.m_dims.y; ++y)
+				for (int x = 0; x < c.m_dims.x; ++x)
+				{
+					const glm::ivec3 p(x, y, z);
+					float s[2][2][2];
+					for (int cz = 0; cz < 2; ++cz)
+						for (int cy = 0; cy < 2; ++cy)
+							for (int cx = 0; cx < 2; ++cx)
+								s[cx][cy][cz] = c.Sample(p + glm::ivec3(cx, cy, cz));
+					bool hasIntersection = false;
+					for (int a = 0; a < 2; ++a)
+						for (int b = 0; b < 2; ++b)
+						{
+							hasIntersection |= (s[a][b][0] > 0.0f) != (s[a][b][1] > 0.0f);
+							hasIntersection |= (s[a][0][b] > 0.0f) != (s[a][1][b] > 0.0f);
+							hasIntersection |= (s[0][a][b] > 0.0f) != (s[1][a][b] > 0.0f);
+						}
+					c.m_cellLookup[c.Index(p)] = hasIntersection ? c.m_vertexCount++ : 0;
+				}
+	}
+
+	// compute_sdf_make_triangles, one invocation per emitted cell
+	void MakeTriangles(ComputeEmulation& c, int emitOffset, glm::ivec3 emitCount)
+	{
+		auto outputQuad = [&c](glm::ivec3 p0, glm::ivec3 p1, glm::ivec3 p2, glm::ivec3 p3) {
+			const uint32_t v0 = c.m_cellLookup[c.Index(p0)], v1 = c.m_cellLookup[c.Index(p1)];
+			const uint32_t v2 = c.m_cellLookup[c.Index(p2)], v3 = c.m_cellLookup[c.Index(p3)];
+			c.m_indices.insert(c.m_indices.end(), { v0, v1, v2, v2, v3, v0 });
+		};
+		const glm::ivec3 maxCell = glm::ivec3(emitOffset) + emitCount;
+		for (int z = emitOffset; z < maxCell.z; ++z)
+			for (int y = emitOffset; y < maxCell.y; ++y)
+				for (int x = emitOffset; x < maxCell.x; ++x)
+				{
+					const glm::ivec3 p(x, y, z);
+					const float s0 = c.Sample(p);
+					if (p.x > 0 && p.y > 0)
+					{
+						const float s1 = c.Sample(p + glm::ivec3(0, 0, 1));
+						if ((s0 > 0.0f) != (s1 > 0.0f))
+						{
+							const glm::ivec3 q[] = { p + glm::ivec3(-1,-1,0), p + glm::ivec3(0,-1,0), p, p + glm::ivec3(-1,0,0) };
+							s1 > 0.0f ? outputQuad(q[0], q[1], q[2], q[3]) : outputQuad(q[3], q[2], q[1], q[0]);
+						}
+					}
+					if (p.x > 0 && p.z > 0)
+					{
+						const float s1 = c.Sample(p + glm::ivec3(0, 1, 0));
+						if ((s0 > 0.0f) != (s1 > 0.0f))
+						{
+							const glm::ivec3 q[] = { p + glm::ivec3(-1,0,-1), p + glm::ivec3(0,0,-1), p, p + glm::ivec3(-1,0,0) };
+							s0 > 0.0f ? outputQuad(q[0], q[1], q[2], q[3]) : outputQuad(q[3], q[2], q[1], q[0]);
+						}
+					}
+					if (p.y > 0 && p.z > 0)
+					{
+						const float s1 = c.Sample(p + glm::ivec3(1, 0, 0));
+						if ((s0 > 0.0f) != (s1 > 0.0f))
+						{
+							const glm::ivec3 q[] = { p + glm::ivec3(0,-1,-1), p + glm::ivec3(0,0,-1), p, p + glm::ivec3(0,-1,0) };
+							s1 > 0.0f ? outputQuad(q[0], q[1], q[2], q[3]) : outputQuad(q[3], q[2], q[1], q[0]);
+						}
+					}
+				}
+	}
+
+	uint32_t CountReferencedVertices(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		std::vector<bool> referenced(vertexCount, false);
+		uint32_t count = 0;
+		for (uint32_t i : indices)
+		{
+			if (i < vertexCount && !referenced[i])
+			{
+				referenced[i] = true;
+				++count;
+			}
+		}
+		return count;
+	}
+}
+
+// Mesh one octree node of a sphere with the same sampling layout as SDFMeshSystem
+TEST_CASE(SDFMeshBackendsMatch)
+{
+	Engine::SDF::SampleFn sphere = [](float x, float y, float z) -> std::tuple<float, int> {
+		return { glm::length(glm::vec3(x, y, z) - glm::vec3(0.1f, -0.2f, 0.05f)) - 0.7f, 0 };
+	};
+	const int extraLayers = 4;	// SDFMesh::c_extraSampleLayers
+	const glm::ivec3 resolution(24, 20, 16);
+	const glm::ivec3 dims = resolution + glm::ivec3(1 + extraLayers * 2);
+	const glm::vec3 boundsMin(-1.0f), boundsMax(1.0f);
+	const glm::vec3 cellSize = (boundsMax - boundsMin) / glm::vec3(resolution);
+	const glm::vec3 worldOffset = boundsMin - (cellSize * float(extraLayers));
+
+	Engine::SDF::MeshData cpuData;
+	Engine::SDF::BuildMeshData(sphere, worldOffset, cellSize, dims, extraLayers, resolution, cpuData);
+	const uint32_t cpuVertexCount = (uint32_t)(cpuData.m_vertices.size() / 8);
+	TEST_CHECK(cpuData.m_indices.size() > 0);
+	TEST_CHECK(cpuData.m_indices.size() % 3 == 0);
+
+	ComputeEmulation compute;
+	compute.m_dims = dims;
+	WriteVolume(sphere, worldOffset, cellSize, compute);
+	FindVertices(compute);
+	MakeTriangles(compute, extraLayers, resolution);
+
+	// compute writes a vertex for every cell with a surface, only the referenced ones end up in the final mesh
+	TEST_CHECK(compute.m_indices.size() == cpuData.m_indices.size());
+	TEST_CHECK(CountReferencedVertices(compute.m_indices, compute.m_vertexCount) == CountReferencedVertices(cpuData.m_indices, cpuVertexCount));
+
+	// cpu vertices must lie on the surface, within the node plus the cells around the edge
+	for (uint32_t i : cpuData.m_indices)
+	{
+		TEST_CHECK(i < cpuVertexCount);
+		const glm::vec3 v(cpuData.m_vertices[i * 8], cpuData.m_vertices[i * 8 + 1], cpuData.m_vertices[i * 8 + 2]);
+		TEST_CHECK(glm::all(glm::greaterThanEqual(v, boundsMin - cellSize)) && glm::all(glm::lessThanEqual(v, boundsMax + cellSize)));
+		TEST_CHECK(glm::abs(std::get<0>(sphere(v.x, v.y, v.z))) < glm::compMax(cellSize));
+	}
+	return true;
+}
@@ -0,0 +1,93 @@
+#include "test.h"
+#include "engine/sdf.h"
+#include "engine/sdf_mesh_raycast.h"
+#include "engine/job_system.h"
+#include "engine/components/component_sdf_mesh.h"
+#include "engine/sdf_mesh_octree.h"
+#include "render/mesh.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE(SDFRaycastBatchZeroLengthRays)
+{
+	Engine::SDF::SampleFn sphere = [](float x, float y, float z) -> std::tuple<float, int> {
+		return { glm::length(glm::vec3(x, y, z)) - 1.0f, 0 };
+	};
+	auto sphereBatch = Engine::SDF::MakeBatchSampleFn(sphere);
+	bool sampledNaN = false;
+	Engine::SDF::BatchSampleFn batchFn = [&](__m128 x, __m128 y, __m128 z) {
+		sampledNaN |= _mm_movemask_ps(_mm_or_ps(_mm_cmpunord_ps(x, y), _mm_cmpunord_ps(z, z))) != 0;
+		return sphereBatch(x, y, z);
+	};
+
+	// mix of hits, misses and zero length rays in the same batch
+	const glm::vec3 p0[] = { {-3,0,0}, {-3,0,0}, {0,5,0}, {0,-3,0}, {2,2,2} };
+	const glm::vec3 p1[] = { {3,0,0}, {-3,0,0}, {0,5,0}, {0,3,0}, {3,3,3} };
+	float t[5];
+	Engine::SDF::RaycastBatch(p0, p1, 5, 0.01f, 0.5f, batchFn, t);
+	TEST_CHECK(t[0] > 0.3f && t[0] < 0.36f);
+	TEST_CHECK(t[1] == -1.0f);
+	TEST_CHECK(t[2] == -1.0f);
+	TEST_CHECK(t[3] > 0.3f && t[3] < 0.36f);
+	TEST_CHECK(t[4] == -1.0f);
+	TEST_CHECK(!sampledNaN);
+	return true;
+}
+
+// Lua can only run on the main thread, so meshes with a script sample function must never be traced on jobs
+TEST_CASE(SDFScriptMeshRaycastsStayOnMainThread)
+{
+	Engine::JobSystem jobs;
+	TEST_CHECK(jobs.PostInit());
+
+	const std::thread::id mainThread = std::this_thread::get_id();
+	std::atomic<uint32_t> scriptSamples = 0, scriptSamplesOffMainThread = 0;
+	sol::state lua;
+	lua.open_libraries(sol::lib::base, sol::lib::math);
+	lua["OnSample"] = [&]() {
+		++scriptSamples;
+		scriptSamplesOffMainThread += std::this_thread::get_id() != mainThread ? 1 : 0;
+	};
+	lua.script("function SampleSphere(x, y, z) OnSample() return math.sqrt(x * x + y * y + z * z) - 1.0, 0 end");
+
+	SDFMesh scriptMesh;
+	scriptMesh.SetSampleScriptFunction(lua["SampleSphere"]);
+	TEST_CHECK(scriptMesh.IsSampleFunctionScript());
+	SDFMesh nativeMesh;
+	nativeMesh.SetSampleFunction([](float x, float y, float z) -> std::tuple<float, int> {
+		return { glm::length(glm::vec3(x, y, z)) - 1.0f, 0 };
+	});
+
+	// enough groups that the job path would hand some to the worker threads
+	const uint32_t rayCount = Engine::SDF::c_meshRaysPerJob * 16;
+	std::vector<glm::vec3> starts(rayCount), ends(rayCount);
+	for (uint32_t i = 0; i < rayCount; ++i)
+	{
+		const float y = -1.2f + 2.4f * (float)(i % 64) / 63.0f;
+		const float z = -1.2f + 2.4f * (float)(i / 64) / (float)(rayCount / 64 - 1);
+		starts[i] = { -3.0f, y, z };
+		ends[i] = { 3.0f, y, z };
+	}
+	std::vector<float> scriptT(rayCount), nativeT(rayCount);
+	std::vector<glm::vec3> scriptNormals(rayCount), nativeNormals(rayCount);
+	Engine::SDF::RaycastMesh(scriptMesh, starts.data(), ends.data(), rayCount, jobs, scriptT.data(), scriptNormals.data());
+	Engine::SDF::RaycastMesh(nativeMesh, starts.data(), ends.data(), rayCount, jobs, nativeT.data(), nativeNormals.data());
+	jobs.PostShutdown();
+
+	TEST_CHECK(scriptSamples > 0);
+	TEST_CHECK(scriptSamplesOffMainThread == 0);
+	uint32_t hits = 0;
+	for (uint32_t i = 0; i < rayCount; ++i)
+	{
+		TEST_CHECK((scriptT[i] >= 0.0f) == (nativeT[i] >= 0.0f));
+		if (scriptT[i] >= 0.0f)
+		{
+			++hits;
+			TEST_CHECK(glm::abs(scriptT[i] - nativeT[i]) < 0.001f);
+			TEST_CHECK(glm::dot(glm::normalize(scriptNormals[i]), glm::normalize(nativeNormals[i])) > 0.99f);
+		}
+	}
+	TEST_CHECK(hits > 0 && hits < rayCount);
+	return true;
+}
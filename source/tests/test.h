@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdio>
+
+// Minimal test harness, tests register themselves and are run by name from ctest
+// Tests must not need a window or gl context
+
+namespace Tests
+{
+	using TestFn = bool(*)();
+	bool Register(const char* name, TestFn fn);
+}
+
+#define TEST_CASE(name)	\
+	static bool name();	\
+	static bool s_registered_##name = Tests::Register(#name, name);	\
+	static bool name()
+
+#define TEST_CHECK(condition)	\
+	if (!(condition))	\
+	{	\
+		printf("%s(%d): check failed: %s\n", __FILE__, __LINE__, #condition);	\
+		return false;	\
+	}
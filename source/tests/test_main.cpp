@@ -0,0 +1,52 @@
+#include "test.h"
+#include <vector>
+#include <cstring>
+
+namespace Tests
+{
+	struct TestEntry
+	{
+		const char* m_name;
+		TestFn m_fn;
+	};
+
+	std::vector<TestEntry>& GetAllTests()
+	{
+		static std::vector<TestEntry> s_allTests;
+		return s_allTests;
+	}
+
+	bool Register(const char* name, TestFn fn)
+	{
+		GetAllTests().push_back({ name, fn });
+		return true;
+	}
+}
+
+// LeanTests [test name...], runs everything if no names are passed
+int main(int argc, char** argv)
+{
+	int testsRun = 0;
+	int testsFailed = 0;
+	for (const auto& test : Tests::GetAllTests())
+	{
+		bool shouldRun = argc < 2;
+		for (int a = 1; a < argc; ++a)
+		{
+			shouldRun |= strcmp(argv[a], test.m_name) == 0;
+		}
+		if (shouldRun)
+		{
+			++testsRun;
+			const bool passed = test.m_fn();
+			printf("%s: %s\n", test.m_name, passed ? "passed" : "FAILED");
+			testsFailed += passed ? 0 : 1;
+		}
+	}
+	if (testsRun == 0)
+	{
+		printf("No tests matched\n");
+		return 1;
+	}
+	return testsFailed > 0 ? 1 : 0;
+}